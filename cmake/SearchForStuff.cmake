@@ -31,6 +31,23 @@ else()
   set(VTK_LIBS vtkHybrid vtkWidgets)
 endif()
 
+#################################################
+# Find Bullet. Optional, only needed for BulletPhysicsWorld
+# which uses the Bullet collision world without Gazebo.
+find_package(Bullet)
+
+#################################################
+# Find FCL. Optional, only needed for FCLPhysicsWorld, which is written
+# against the API of FCL 0.5 (the API changed with 0.6).
+find_package(PkgConfig)
+if (PKG_CONFIG_FOUND)
+  pkg_check_modules(FCL fcl)
+endif()
+if (FCL_FOUND AND NOT FCL_VERSION VERSION_LESS 0.6)
+  message(STATUS "FCL ${FCL_VERSION} is not supported, FCL 0.5 is required")
+  set(FCL_FOUND FALSE)
+endif()
+
 #################################################
 # Set variables with all dependencies
 set(dependencies_INCLUDE_DIRS
@@ -40,6 +57,12 @@ set(dependencies_INCLUDE_DIRS
   ${QT_INCLUDE_DIR}
   ${VTK_INCLUDE_DIRS}
 )
+if (BULLET_FOUND)
+  list(APPEND dependencies_INCLUDE_DIRS ${BULLET_INCLUDE_DIRS})
+endif()
+if (FCL_FOUND)
+  list(APPEND dependencies_INCLUDE_DIRS ${FCL_INCLUDE_DIRS})
+endif()
 
 set(dependencies_LIBRARY_DIRS
   ${assimp_LIBRARY_DIRS}
@@ -47,6 +70,9 @@ set(dependencies_LIBRARY_DIRS
   ${GAZEBO_LIBRARY_DIRS}
   ${VTK_LIBRARY_DIRS}
 )
+if (FCL_FOUND)
+  list(APPEND dependencies_LIBRARY_DIRS ${FCL_LIBRARY_DIRS})
+endif()
 
 set(dependencies_LIBRARIES
   ${assimp_LIBRARIES}
@@ -56,3 +82,9 @@ set(dependencies_LIBRARIES
   ${Qt5Widgets_LIBRARIES}
   ${VTK_LIBS}
 )
+if (BULLET_FOUND)
+  list(APPEND dependencies_LIBRARIES ${BULLET_LIBRARIES})
+endif()
+if (FCL_FOUND)
+  list(APPEND dependencies_LIBRARIES ${FCL_LIBRARIES})
+endif()
@@ -0,0 +1,510 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/BulletPhysicsWorld.hh>
+#include <collision_benchmark/GazeboWorldState.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+#include <collision_benchmark/SimpleTriMeshShape.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <BulletCollision/Gimpact/btGImpactShape.h>
+#include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
+
+#include <map>
+
+using collision_benchmark::BulletPhysicsWorld;
+using collision_benchmark::ShapeModelState;
+using collision_benchmark::PrimitiveShape;
+using collision_benchmark::PrimitiveShapeParameters;
+using collision_benchmark::SimpleTriMeshShape;
+
+/////////////////////////////////////////////////////////////////////////////
+static btVector3 ToBullet(const ignition::math::Vector3d& v)
+{
+  return btVector3(v.X(), v.Y(), v.Z());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+static btTransform ToBullet(const ignition::math::Pose3d& p)
+{
+  return btTransform(btQuaternion(p.Rot().X(), p.Rot().Y(),
+                                  p.Rot().Z(), p.Rot().W()),
+                     ToBullet(p.Pos()));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+static ignition::math::Vector3d ToIgn(const btVector3& v)
+{
+  return ignition::math::Vector3d(v.x(), v.y(), v.z());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+BulletPhysicsWorld::BulletPhysicsWorld(const std::string& name_,
+                                       const double stepSize_):
+  ParentClass(name_, stepSize_),
+  contactsDirty(true)
+{
+  configuration.reset(new btDefaultCollisionConfiguration());
+  dispatcher.reset(new btCollisionDispatcher(configuration.get()));
+  // needed for the collisions of meshes
+  btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher.get());
+  broadphase.reset(new btDbvtBroadphase());
+  world.reset(new btCollisionWorld(dispatcher.get(), broadphase.get(),
+                                   configuration.get()));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+BulletPhysicsWorld::~BulletPhysicsWorld()
+{
+  Clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+BulletPhysicsWorld::WorldState BulletPhysicsWorld::GetWorldState() const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  std::map<ModelID, ShapeModelState> modelStates;
+  for (ModelMap::const_iterator it = models.begin(); it != models.end(); ++it)
+  {
+    ShapeModelState& modelState = modelStates[it->first];
+    modelState.pose = it->second.pose;
+    modelState.scale = it->second.scale;
+  }
+  WorldState state;
+  if (!MakeShapeWorldState(name, simTime, iterations, modelStates,
+                           PartID(), state))
+  {
+    LOG_ERROR("physics", "World " << GetName()
+                         << ": Could not build the world state");
+  }
+  return state;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+BulletPhysicsWorld::WorldState
+BulletPhysicsWorld::GetWorldStateDiff(const WorldState& other) const
+{
+  return other - GetWorldState();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::OpResult
+BulletPhysicsWorld::SetWorldState(const WorldState& state, bool isDiff)
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  OpResult ret = SUCCESS;
+  for (std::vector<std::string>::const_iterator
+       it = state.Deletions().begin(); it != state.Deletions().end(); ++it)
+  {
+    RemoveModel(*it);
+  }
+  if (!state.Insertions().empty())
+  {
+    LOG_ERROR("physics", "World " << GetName() << ": Models can't be "
+                         << "inserted with the world state");
+    ret = NOT_SUPPORTED;
+  }
+
+  const gazebo::physics::ModelState_M& modelStates = state.GetModelStates();
+  for (gazebo::physics::ModelState_M::const_iterator
+       it = modelStates.begin(); it != modelStates.end(); ++it)
+  {
+    if (!SetModelPose(it->first, it->second.Pose(), it->second.Scale()))
+      ret = NOT_SUPPORTED;
+  }
+  simTime = state.GetSimTime().Double();
+  iterations = state.GetIterations();
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool BulletPhysicsWorld::GetAABB(const ModelID& id,
+                                 Vector3& min, Vector3& max) const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  ModelMap::const_iterator m = models.find(id);
+  if (m == models.end()) return false;
+  const btCollisionObject * object = m->second.object.get();
+  btVector3 btMin, btMax;
+  object->getCollisionShape()->getAabb(object->getWorldTransform(),
+                                       btMin, btMax);
+  min = ToIgn(btMin);
+  max = ToIgn(btMax);
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<BulletPhysicsWorld::ContactInfoPtr>
+BulletPhysicsWorld::GetContactInfo() const
+{
+  ContactAnomalies anomalies;
+  std::vector<ContactInfoPtr> ret;
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    UpdateContacts();
+    ret = GetContactInfoHelper(anomalies);
+  }
+  AddContactAnomalies(anomalies);
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<BulletPhysicsWorld::ContactInfoPtr>
+BulletPhysicsWorld::GetContactInfo(const ModelID& m1, const ModelID& m2) const
+{
+  ContactAnomalies anomalies;
+  std::vector<ContactInfoPtr> ret;
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    UpdateContacts();
+    ret = GetContactInfoHelper(anomalies, &m1, &m2);
+  }
+  AddContactAnomalies(anomalies);
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<BulletPhysicsWorld::NativeContactPtr>
+BulletPhysicsWorld::GetNativeContacts() const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  UpdateContacts();
+  std::vector<const btPersistentManifold *> manifolds =
+    GetManifolds(NULL, NULL);
+  std::vector<NativeContactPtr> ret;
+  for (std::vector<const btPersistentManifold *>::const_iterator
+       it = manifolds.begin(); it != manifolds.end(); ++it)
+  {
+    ret.push_back(NativeContactPtr(new btPersistentManifold(**it)));
+  }
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<BulletPhysicsWorld::NativeContactPtr>
+BulletPhysicsWorld::GetNativeContacts(const ModelID& m1,
+                                      const ModelID& m2) const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  UpdateContacts();
+  std::vector<const btPersistentManifold *> manifolds =
+    GetManifolds(&m1, &m2);
+  std::vector<NativeContactPtr> ret;
+  for (std::vector<const btPersistentManifold *>::const_iterator
+       it = manifolds.begin(); it != manifolds.end(); ++it)
+  {
+    ret.push_back(NativeContactPtr(new btPersistentManifold(**it)));
+  }
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool BulletPhysicsWorld::IsAdaptor() const
+{
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::RefResult
+BulletPhysicsWorld::SetWorld(const WorldPtr& world_)
+{
+  LOG_ERROR("physics", "The bullet world of BulletPhysicsWorld can't be "
+                       << "replaced");
+  return collision_benchmark::ERROR;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+BulletPhysicsWorld::WorldPtr BulletPhysicsWorld::GetWorld() const
+{
+  return world;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+BulletPhysicsWorld::ModelPtr
+BulletPhysicsWorld::GetModel(const ModelID& model) const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  ModelMap::const_iterator m = models.find(model);
+  if (m == models.end()) return ModelPtr();
+  return m->second.object;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+BulletPhysicsWorld::PhysicsEnginePtr
+BulletPhysicsWorld::GetPhysicsEngine() const
+{
+  return dispatcher;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::OpResult
+BulletPhysicsWorld::CreateModel(const ModelID& id, ModelEntry& model)
+{
+  if (!CreateShape(model.GetCollisionShape(), model)) return NOT_SUPPORTED;
+  model.object.reset(new btCollisionObject());
+  model.object->setCollisionShape(model.shapes.back().get());
+  model.object->setWorldTransform(ToBullet(model.pose));
+  model.object->setUserIndex(model.index);
+  // the name is needed to identify the models of contacts
+  model.object->setUserPointer(const_cast<ModelID*>(&id));
+  if (model.scale != Vector3(1, 1, 1)) ApplyScale(model);
+  world->addCollisionObject(model.object.get());
+  contactsDirty = true;
+  return SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool BulletPhysicsWorld::UpdateModel(const ModelID& id, ModelEntry& model,
+                                     const Vector3& oldScale)
+{
+  model.object->setWorldTransform(ToBullet(model.pose));
+  if (model.scale != oldScale) ApplyScale(model);
+  world->updateSingleAabb(model.object.get());
+  contactsDirty = true;
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void BulletPhysicsWorld::DestroyModel(const ModelID& id, ModelEntry& model)
+{
+  world->removeCollisionObject(model.object.get());
+  contactsDirty = true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void BulletPhysicsWorld::Step()
+{
+  world->performDiscreteCollisionDetection();
+  contactsDirty = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool BulletPhysicsWorld::CreateShape(const Shape::Ptr& shape,
+                                     BulletModelData& model)
+{
+  std::vector<Shape::Ptr> collParts;
+  std::vector<Pose3> poses;
+  GetCollisionParts(shape, collParts, poses);
+  if (collParts[0] == shape) return CreatePartShape(shape, model) != NULL;
+
+  std::shared_ptr<btCompoundShape> compound(new btCompoundShape());
+  for (unsigned int i = 0; i < collParts.size(); ++i)
+  {
+    btCollisionShape * child = CreatePartShape(collParts[i], model);
+    if (!child) return false;
+    compound->addChildShape(ToBullet(poses[i]), child);
+  }
+  model.shapes.push_back(compound);
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+btCollisionShape *
+BulletPhysicsWorld::CreatePartShape(const Shape::Ptr& shape,
+                                    BulletModelData& model)
+{
+  btCollisionShape * ret = NULL;
+  PrimitiveShape::Ptr prim = std::dynamic_pointer_cast<PrimitiveShape>(shape);
+  SimpleTriMeshShape::Ptr mesh =
+    std::dynamic_pointer_cast<SimpleTriMeshShape>(shape);
+  if (prim)
+  {
+    PrimitiveShapeParameters::Ptr params = prim->GetParams();
+    switch (prim->GetType())
+    {
+      case Shape::BOX:
+        ret = new btBoxShape(
+          btVector3(params->Get(PrimitiveShapeParameters::DIMX) / 2,
+                    params->Get(PrimitiveShapeParameters::DIMY) / 2,
+                    params->Get(PrimitiveShapeParameters::DIMZ) / 2));
+        break;
+      case Shape::SPHERE:
+        ret = new btSphereShape(params->Get(PrimitiveShapeParameters::RADIUS));
+        break;
+      case Shape::CYLINDER:
+      {
+        const double radius = params->Get(PrimitiveShapeParameters::RADIUS);
+        const double length = params->Get(PrimitiveShapeParameters::LENGTH);
+        ret = new btCylinderShapeZ(btVector3(radius, radius, length / 2));
+        break;
+      }
+      case Shape::PLANE:
+      {
+        ignition::math::Vector3d n(params->Get(PrimitiveShapeParameters::VALX),
+                                   params->Get(PrimitiveShapeParameters::VALY),
+                                   params->Get(PrimitiveShapeParameters::VALZ));
+        const double len = n.Length();
+        if (len <= 0)
+        {
+          LOG_ERROR("physics", "Plane has no valid normal");
+          return NULL;
+        }
+        ret = new btStaticPlaneShape(ToBullet(n / len),
+                          params->Get(PrimitiveShapeParameters::LENGTH) / len);
+        break;
+      }
+      default:
+        LOG_ERROR("physics", "Unknown primitive type " << prim->GetType());
+        return NULL;
+    }
+  }
+  else if (mesh && mesh->GetMeshData() &&
+           !mesh->GetMeshData()->GetFaces().empty())
+  {
+    typedef SimpleTriMeshShape::MeshDataT MeshDataT;
+    const MeshDataT& data = *mesh->GetMeshData();
+    const std::vector<MeshDataT::Vertex>& verts = data.GetVertices();
+    std::shared_ptr<btTriangleMesh> triangles(new btTriangleMesh());
+    for (std::vector<MeshDataT::Face>::const_iterator
+         it = data.GetFaces().begin(); it != data.GetFaces().end(); ++it)
+    {
+      const MeshDataT::Vertex& v0 = verts[(*it)[0]];
+      const MeshDataT::Vertex& v1 = verts[(*it)[1]];
+      const MeshDataT::Vertex& v2 = verts[(*it)[2]];
+      triangles->addTriangle(btVector3(v0.X(), v0.Y(), v0.Z()),
+                             btVector3(v1.X(), v1.Y(), v1.Z()),
+                             btVector3(v2.X(), v2.Y(), v2.Z()));
+    }
+    btGImpactMeshShape * gimpact = new btGImpactMeshShape(triangles.get());
+    gimpact->updateBound();
+    model.meshes.push_back(triangles);
+    ret = gimpact;
+  }
+  else
+  {
+    LOG_ERROR("physics", "BulletPhysicsWorld does not support shapes of "
+                         << "type " << shape->GetType());
+    return NULL;
+  }
+  model.shapes.push_back(std::shared_ptr<btCollisionShape>(ret));
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void BulletPhysicsWorld::ApplyScale(ModelEntry& model)
+{
+  model.object->getCollisionShape()->setLocalScaling(ToBullet(model.scale));
+  // the bounds of meshes and compounds are cached
+  for (std::vector<std::shared_ptr<btCollisionShape> >::iterator
+       it = model.shapes.begin(); it != model.shapes.end(); ++it)
+  {
+    if ((*it)->getShapeType() == GIMPACT_SHAPE_PROXYTYPE)
+      static_cast<btGImpactMeshShape*>(it->get())->updateBound();
+    else if ((*it)->isCompound())
+      static_cast<btCompoundShape*>(it->get())->recalculateLocalAabb();
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void BulletPhysicsWorld::UpdateContacts() const
+{
+  if (!contactsDirty) return;
+  world->performDiscreteCollisionDetection();
+  contactsDirty = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+const BulletPhysicsWorld::ModelID&
+BulletPhysicsWorld::GetModelName(const btCollisionObject * object)
+{
+  return *static_cast<const ModelID*>(object->getUserPointer());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<const btPersistentManifold *>
+BulletPhysicsWorld::GetManifolds(const ModelID * m1, const ModelID * m2) const
+{
+  std::vector<const btPersistentManifold *> ret;
+  const int numManifolds = dispatcher->getNumManifolds();
+  for (int i = 0; i < numManifolds; ++i)
+  {
+    const btPersistentManifold * manifold =
+      dispatcher->getManifoldByIndexInternal(i);
+    if (m1 && m2)
+    {
+      const ModelID& name0 = GetModelName(
+        static_cast<const btCollisionObject*>(manifold->getBody0()));
+      const ModelID& name1 = GetModelName(
+        static_cast<const btCollisionObject*>(manifold->getBody1()));
+      if ((*m1 != name0 || *m2 != name1) &&
+          (*m1 != name1 || *m2 != name0)) continue;
+    }
+    ret.push_back(manifold);
+  }
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<BulletPhysicsWorld::ContactInfoPtr>
+BulletPhysicsWorld::GetContactInfoHelper(ContactAnomalies& anomalies,
+                                         const ModelID * m1,
+                                         const ModelID * m2) const
+{
+  std::vector<ContactInfoPtr> ret;
+  std::vector<const btPersistentManifold *> manifolds = GetManifolds(m1, m2);
+  for (std::vector<const btPersistentManifold *>::const_iterator
+       it = manifolds.begin(); it != manifolds.end(); ++it)
+  {
+    const btPersistentManifold * manifold = *it;
+    // bullet keeps manifolds for all pairs of overlapping bounding
+    // boxes, those without points are no contacts.
+    if (manifold->getNumContacts() == 0) continue;
+
+    const ModelID& name0 = GetModelName(
+      static_cast<const btCollisionObject*>(manifold->getBody0()));
+    const ModelID& name1 = GetModelName(
+      static_cast<const btCollisionObject*>(manifold->getBody1()));
+    ++anomalies.numContacts;
+    ContactInfoPtr cInfo(new ContactInfo(name0, PartID(), name1, PartID()));
+    // the normal of bullet points from body1 to body0, the one of
+    // the contacts from model1 to model2
+    const double normalSign = (cInfo->model1 == name0) ? -1 : 1;
+    anomalies.numPoints += manifold->getNumContacts();
+    for (int i = 0; i < manifold->getNumContacts(); ++i)
+    {
+      const btManifoldPoint& pt = manifold->getContactPoint(i);
+      const double depth = -pt.getDistance();
+      // bullet also returns points which are close, but not intersecting.
+      // Skip them in the same way as GazeboPhysicsWorld does.
+      static const double tol = 1e-03;
+      if (depth < -tol)
+      {
+        anomalies.Add(ContactAnomalies::NEGATIVE_DEPTH, name0, name1, depth);
+        LOG_DEBUG("physics", "Negative contact distance found in world "
+                             << GetName() << ", depth = " << depth
+                             << ". Skipping contact.");
+        continue;
+      }
+      cInfo->contacts.push_back(
+        Contact(ToIgn(pt.getPositionWorldOnB()),
+                ToIgn(pt.m_normalWorldOnB) * normalSign,
+                gazebo::physics::JointWrench(), depth));
+    }
+
+    if (cInfo->contacts.empty())
+    {
+      anomalies.Add(ContactAnomalies::ALL_POINTS_SKIPPED, name0, name1);
+      LOG_DEBUG("physics", "All contact points gotten from models "
+                           << name0 << ", " << name1 << " world " << GetName()
+                           << " skipped.");
+    }
+    else
+    {
+      ret.push_back(cInfo);
+    }
+  }
+  return ret;
+}
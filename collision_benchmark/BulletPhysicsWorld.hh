@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_BULLETPHYSICSWORLD_H
+#define COLLISION_BENCHMARK_BULLETPHYSICSWORLD_H
+
+#include <collision_benchmark/GazeboPhysicsWorld.hh>
+#include <collision_benchmark/ShapePhysicsWorld.hh>
+
+#include <btBulletCollisionCommon.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+struct BulletPhysicsEngineWorldTypes
+{
+  typedef btCollisionObject Model;
+  typedef btPersistentManifold Contact;
+  typedef btCollisionDispatcher PhysicsEngine;
+  typedef btCollisionWorld World;
+};
+
+/**
+ * \brief Bullet objects of a model in a BulletPhysicsWorld, in addition
+ * to the shape, pose and scale kept by ShapePhysicsWorld.
+ */
+struct BulletModelData
+{
+  std::shared_ptr<btCollisionObject> object;
+  // the shape of the object is the last one, the others are
+  // its children
+  std::vector<std::shared_ptr<btCollisionShape> > shapes;
+  std::vector<std::shared_ptr<btTriangleMesh> > meshes;
+};
+
+/**
+ * \brief PhysicsEngineWorld which uses the collision world of Bullet
+ * directly, without Gazebo.
+ *
+ * It uses the same types as GazeboPhysicsWorld (GazeboPhysicsWorldTypes),
+ * so that it can be added to the same WorldManager, in order to compare the
+ * raw collision detection of Bullet with the one wrapped by Gazebo.
+ * There is no transport, no namespace and no SDF involved in model
+ * insertion and collision queries.
+ *
+ * This is a collision-only world: models don't move by themselves.
+ * Update() runs the collision detection of Bullet, and GetContactInfo()
+ * returns its results, after running it again if models were changed since.
+ *
+ * Models can only be added with AddModelFromShape(). Supported are
+ * PrimitiveShape and SimpleTriMeshShape instances and shapes consisting of
+ * collision parts of these types (see Shape::GetCollisionParts()). Meshes
+ * are used as btGImpactMeshShape, as in the Bullet engine of Gazebo.
+ *
+ * World states are gazebo::physics::WorldState instances. They are built
+ * from the SDF of the state, so GetWorldState() is not meant to be called
+ * in the hot path of a benchmark. SetWorldState() applies model poses and
+ * deletions, but can't insert models.
+ */
+class BulletPhysicsWorld:
+  public ShapePhysicsWorld<PhysicsEngineWorld<GazeboPhysicsWorldTypes,
+                                              BulletPhysicsEngineWorldTypes>,
+                           BulletModelData>
+{
+  private: typedef ShapePhysicsWorld<
+             PhysicsEngineWorld<GazeboPhysicsWorldTypes,
+                                BulletPhysicsEngineWorldTypes>,
+             BulletModelData> ParentClass;
+
+  public: typedef std::shared_ptr<BulletPhysicsWorld> Ptr;
+  public: typedef std::shared_ptr<const BulletPhysicsWorld> ConstPtr;
+
+  public: typedef ParentClass::ModelID ModelID;
+  public: typedef ParentClass::WorldState WorldState;
+  public: typedef ParentClass::Vector3 Vector3;
+  public: typedef ParentClass::Contact Contact;
+  public: typedef ParentClass::ContactInfo ContactInfo;
+  public: typedef ParentClass::ContactInfoPtr ContactInfoPtr;
+  public: typedef ParentClass::ContactAnomalies ContactAnomalies;
+  public: typedef ParentClass::Shape Shape;
+  public: typedef ParentClass::ModelLoadResult ModelLoadResult;
+  public: typedef ParentClass::ModelPtr ModelPtr;
+  public: typedef ParentClass::NativeContactPtr NativeContactPtr;
+  public: typedef ParentClass::PhysicsEnginePtr PhysicsEnginePtr;
+  public: typedef ParentClass::WorldPtr WorldPtr;
+
+  // \param name the name of the world
+  // \param stepSize the time (seconds) which passes in one step of Update()
+  public: BulletPhysicsWorld(const std::string& name = "bullet_world",
+                             const double stepSize = 0.001);
+  public: virtual ~BulletPhysicsWorld();
+
+  public: virtual WorldState GetWorldState() const;
+
+  public: virtual WorldState GetWorldStateDiff(const WorldState& other) const;
+
+  // \retval NOT_SUPPORTED \e state contains insertions or models
+  //    which are not in the world. All other changes are still applied.
+  public: virtual OpResult SetWorldState(const WorldState& state,
+                                         bool isDiff = false);
+
+  public: virtual bool GetAABB(const ModelID& id,
+                               Vector3& min, Vector3& max) const;
+
+  public: virtual std::vector<ContactInfoPtr> GetContactInfo() const;
+
+  public: virtual std::vector<ContactInfoPtr>
+                  GetContactInfo(const ModelID& m1, const ModelID& m2) const;
+
+  // Returns copies of the bullet contact manifolds
+  public: virtual std::vector<NativeContactPtr> GetNativeContacts() const;
+
+  public: virtual std::vector<NativeContactPtr>
+                  GetNativeContacts(const ModelID& m1, const ModelID& m2) const;
+
+  public: virtual bool IsAdaptor() const;
+
+  // Returns ERROR, as the bullet world can't be replaced.
+  public: virtual RefResult SetWorld(const WorldPtr& world);
+
+  public: virtual WorldPtr GetWorld() const;
+
+  // The pose of the returned object must not be changed, use
+  // SetBasicModelState() instead.
+  public: virtual ModelPtr GetModel(const ModelID& model) const;
+
+  public: virtual PhysicsEnginePtr GetPhysicsEngine() const;
+
+  // Creates the bullet object and adds it to the bullet world. Its user
+  // index is the integer ID of the model.
+  // \retval NOT_SUPPORTED a collision part is of an unsupported type
+  protected: virtual OpResult CreateModel(const ModelID& id,
+                                          ModelEntry& model);
+
+  protected: virtual bool UpdateModel(const ModelID& id, ModelEntry& model,
+                                      const Vector3& oldScale);
+
+  protected: virtual void DestroyModel(const ModelID& id, ModelEntry& model);
+
+  // Runs the collision detection of bullet
+  protected: virtual void Step();
+
+  // Creates the bullet shape of \e shape and adds it to model.shapes,
+  // along with all its children.
+  // \return false if a collision part is not supported
+  private: static bool CreateShape(const Shape::Ptr& shape,
+                                   BulletModelData& model);
+
+  // Creates the bullet shape of a shape which has no collision parts and
+  // adds it to model.shapes.
+  // \return the shape, or NULL if it is not supported
+  private: static btCollisionShape * CreatePartShape(const Shape::Ptr& shape,
+                                                     BulletModelData& model);
+
+  // Applies the scale of \e model to its bullet shapes
+  private: static void ApplyScale(ModelEntry& model);
+
+  // Runs the collision detection if models were changed since it
+  // was last run. Has to be called with the mutex locked.
+  private: void UpdateContacts() const;
+
+  // Returns the name of the model of \e object
+  private: static const ModelID& GetModelName(const btCollisionObject *object);
+
+  // Computes the contact info between all pairs of models, or only
+  // between \e m1 and \e m2 if given. Has to be called with the mutex locked.
+  private: std::vector<ContactInfoPtr>
+           GetContactInfoHelper(ContactAnomalies& anomalies,
+                                const ModelID * m1 = NULL,
+                                const ModelID * m2 = NULL) const;
+
+  // Returns the manifolds between all pairs of models, or only
+  // between \e m1 and \e m2 if given. Has to be called with the mutex locked.
+  private: std::vector<const btPersistentManifold *>
+           GetManifolds(const ModelID * m1, const ModelID * m2) const;
+
+  private: std::shared_ptr<btDefaultCollisionConfiguration> configuration;
+  private: std::shared_ptr<btCollisionDispatcher> dispatcher;
+  private: std::shared_ptr<btBroadphaseInterface> broadphase;
+  private: std::shared_ptr<btCollisionWorld> world;
+
+  // true if models have changed since the collision detection was run.
+  // Protected by the mutex.
+  private: mutable bool contactsDirty;
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_BULLETPHYSICSWORLD_H
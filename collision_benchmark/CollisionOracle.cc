@@ -0,0 +1,783 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/CollisionOracle.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+#include <collision_benchmark/SimpleTriMeshShape.hh>
+#include <collision_benchmark/TriangleBVH.hh>
+#include <collision_benchmark/GjkEpa.hh>
+#include <collision_benchmark/Exception.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <ignition/math/Matrix3.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using collision_benchmark::CollisionOracle;
+using collision_benchmark::Shape;
+using collision_benchmark::PrimitiveShape;
+using collision_benchmark::PrimitiveShapeParameters;
+using collision_benchmark::SimpleTriMeshShape;
+using collision_benchmark::TriangleBVH;
+
+namespace collision_benchmark
+{
+namespace oracle
+{
+typedef ignition::math::Vector3d Vector3;
+typedef ignition::math::Matrix3d Matrix3;
+typedef TriangleBVH::Triangle Triangle;
+
+// squared length below which vectors are considered zero
+const double ZERO_SQ = 1e-20;
+
+// Rigid transform
+struct Transform
+{
+  Transform():
+    rot(Matrix3::Identity),
+    rotT(Matrix3::Identity) {}
+  explicit Transform(const Shape::Pose3& p):
+    rot(p.Rot()),
+    rotT(rot.Transposed()),
+    pos(p.Pos()) {}
+
+  Vector3 Apply(const Vector3& v) const { return rot * v + pos; }
+  Vector3 ApplyInverse(const Vector3& v) const { return rotT * (v - pos); }
+  Vector3 Axis(const int i) const
+  {
+    return Vector3(rot(0, i), rot(1, i), rot(2, i));
+  }
+  Transform Inverse() const
+  {
+    Transform t;
+    t.rot = rotT;
+    t.rotT = rot;
+    t.pos = -(rotT * pos);
+    return t;
+  }
+  Transform operator*(const Transform& o) const
+  {
+    Transform t;
+    t.rot = rot * o.rot;
+    t.rotT = t.rot.Transposed();
+    t.pos = rot * o.pos + pos;
+    return t;
+  }
+
+  Matrix3 rot;
+  Matrix3 rotT;
+  Vector3 pos;
+};
+
+struct Geometry
+{
+  Geometry():
+    type(Shape::SPHERE),
+    radius(0),
+    halfLength(0),
+    offset(0) {}
+
+  Shape::Type type;
+  // pose relative to the model
+  Shape::Pose3 pose;
+  // radius of spheres and cylinders
+  double radius;
+  // half of the length of cylinders, which are aligned with the z axis
+  double halfLength;
+  // half of the size of boxes
+  Vector3 halfSize;
+  // unit normal and offset of planes
+  Vector3 normal;
+  double offset;
+  // hierarchy of mesh triangles
+  TriangleBVH::ConstPtr bvh;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Signed distance of point \e p to the surface of \e g placed at \e t,
+// which is negative inside \e g.
+double SignedDistance(const Geometry& g, const Transform& t, const Vector3& p)
+{
+  Vector3 l = t.ApplyInverse(p);
+  switch (g.type)
+  {
+    case Shape::SPHERE:
+      return l.Length() - g.radius;
+    case Shape::BOX:
+    {
+      Vector3 q = l.Abs() - g.halfSize;
+      Vector3 outside(std::max(q.X(), 0.0), std::max(q.Y(), 0.0),
+                      std::max(q.Z(), 0.0));
+      return outside.Length() + std::min(q.Max(), 0.0);
+    }
+    case Shape::CYLINDER:
+    {
+      double dr = std::sqrt(l.X() * l.X() + l.Y() * l.Y()) - g.radius;
+      double dz = std::fabs(l.Z()) - g.halfLength;
+      double outR = std::max(dr, 0.0);
+      double outZ = std::max(dz, 0.0);
+      return std::sqrt(outR * outR + outZ * outZ) +
+             std::min(std::max(dr, dz), 0.0);
+    }
+    case Shape::PLANE:
+      return l.Dot(g.normal) - g.offset;
+    case Shape::MESH:
+      return g.bvh->SignedDistance(l);
+  }
+  THROW_EXCEPTION("Unknown shape type " << g.type);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Support point of the convex primitive \e g placed at \e t, which is the
+// point furthest in direction \e dir.
+Vector3 Support(const Geometry& g, const Transform& t, const Vector3& dir)
+{
+  Vector3 d = t.rotT * dir;
+  Vector3 s;
+  switch (g.type)
+  {
+    case Shape::SPHERE:
+    {
+      double len = d.Length();
+      if (len > 0) s = d * (g.radius / len);
+      else s.Set(g.radius, 0, 0);
+      break;
+    }
+    case Shape::BOX:
+      s.Set(d.X() >= 0 ? g.halfSize.X() : -g.halfSize.X(),
+            d.Y() >= 0 ? g.halfSize.Y() : -g.halfSize.Y(),
+            d.Z() >= 0 ? g.halfSize.Z() : -g.halfSize.Z());
+      break;
+    case Shape::CYLINDER:
+    {
+      double rho = std::sqrt(d.X() * d.X() + d.Y() * d.Y());
+      double z = d.Z() >= 0 ? g.halfLength : -g.halfLength;
+      if (rho > 0) s.Set(g.radius * d.X() / rho, g.radius * d.Y() / rho, z);
+      else s.Set(0, 0, z);
+      break;
+    }
+    default:
+      THROW_EXCEPTION("Shape type " << g.type << " is not a convex primitive");
+  }
+  return t.Apply(s);
+}
+
+// support function of a placed convex primitive, for use with GjkEpa()
+struct GeometrySupport
+{
+  GeometrySupport(const Geometry& g_, const Transform& t_): g(g_), t(t_) {}
+  Vector3 operator()(const Vector3& dir) const { return Support(g, t, dir); }
+  Vector3 Center() const { return t.pos; }
+  const Geometry& g;
+  const Transform& t;
+};
+
+// support function of a triangle, for use with GjkIntersect()
+struct TriangleSupport
+{
+  explicit TriangleSupport(const Vector3 * v_): v(v_) {}
+  Vector3 operator()(const Vector3& dir) const
+  {
+    double d0 = v[0].Dot(dir);
+    double d1 = v[1].Dot(dir);
+    double d2 = v[2].Dot(dir);
+    if (d0 >= d1 && d0 >= d2) return v[0];
+    return d1 >= d2 ? v[1] : v[2];
+  }
+  Vector3 Center() const { return (v[0] + v[1] + v[2]) / 3.0; }
+  const Vector3 * v;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Tests whether the triangle \e v intersects the box centred at the origin
+// with half size \e h, using the separating axis theorem
+// (Akenine-Moeller, "Fast 3D Triangle-Box Overlap Testing", 2001).
+bool TriangleBoxIntersect(const Vector3 * v, const Vector3& h)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    double min = std::min(v[0][i], std::min(v[1][i], v[2][i]));
+    double max = std::max(v[0][i], std::max(v[1][i], v[2][i]));
+    if (min > h[i] || max < -h[i]) return false;
+  }
+
+  Vector3 e[3] = {v[1] - v[0], v[2] - v[1], v[0] - v[2]};
+  std::vector<Vector3> axes;
+  axes.reserve(10);
+  axes.push_back(e[0].Cross(e[1]));
+  for (int i = 0; i < 3; ++i)
+  {
+    Vector3 unit(i == 0, i == 1, i == 2);
+    for (int j = 0; j < 3; ++j) axes.push_back(unit.Cross(e[j]));
+  }
+  for (std::vector<Vector3>::const_iterator it = axes.begin();
+       it != axes.end(); ++it)
+  {
+    const Vector3& a = *it;
+    if (a.SquaredLength() <= ZERO_SQ) continue;
+    double p0 = a.Dot(v[0]);
+    double p1 = a.Dot(v[1]);
+    double p2 = a.Dot(v[2]);
+    double r = h.Dot(a.Abs());
+    if (std::min(p0, std::min(p1, p2)) > r ||
+        std::max(p0, std::max(p1, p2)) < -r)
+      return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Returns true if \e axis separates the triangles \e a and \e b
+bool SeparatesTriangles(const Vector3& axis,
+                        const Vector3 * a, const Vector3 * b)
+{
+  double a0 = axis.Dot(a[0]), a1 = axis.Dot(a[1]), a2 = axis.Dot(a[2]);
+  double b0 = axis.Dot(b[0]), b1 = axis.Dot(b[1]), b2 = axis.Dot(b[2]);
+  return std::max(a0, std::max(a1, a2)) < std::min(b0, std::min(b1, b2)) ||
+         std::max(b0, std::max(b1, b2)) < std::min(a0, std::min(a1, a2));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Tests whether the triangles \e a and \e b intersect, using the
+// separating axis theorem.
+bool TrianglesIntersect(const Vector3 * a, const Vector3 * b)
+{
+  Vector3 ea[3] = {a[1] - a[0], a[2] - a[1], a[0] - a[2]};
+  Vector3 eb[3] = {b[1] - b[0], b[2] - b[1], b[0] - b[2]};
+  Vector3 na = ea[0].Cross(ea[1]);
+  Vector3 nb = eb[0].Cross(eb[1]);
+  if (na.SquaredLength() > ZERO_SQ && SeparatesTriangles(na, a, b))
+    return false;
+  if (nb.SquaredLength() > ZERO_SQ && SeparatesTriangles(nb, a, b))
+    return false;
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      Vector3 axis = ea[i].Cross(eb[j]);
+      if (axis.SquaredLength() >
+          ZERO_SQ * ea[i].SquaredLength() * eb[j].SquaredLength() &&
+          SeparatesTriangles(axis, a, b))
+        return false;
+    }
+  }
+  // co-planar triangles are separated by axes within the plane
+  if (na.Cross(nb).SquaredLength() <=
+      1e-12 * na.SquaredLength() * nb.SquaredLength())
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      if (SeparatesTriangles(na.Cross(ea[i]), a, b) ||
+          SeparatesTriangles(na.Cross(eb[i]), a, b))
+        return false;
+    }
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Returns by how much \e a and \e b, placed at \e ta and \e tb, overlap
+// along the direction \e n, which is the distance by which \e b would have
+// to be moved along \e n to separate them.
+double Overlap(const Geometry& a, const Transform& ta,
+               const Geometry& b, const Transform& tb, const Vector3& n)
+{
+  return Support(a, ta, n).Dot(n) - Support(b, tb, -n).Dot(n);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Adds the axes of symmetry of the placed primitive \e g to \e axes
+void AddAxes(const Geometry& g, const Transform& t, std::vector<Vector3>& axes)
+{
+  if (g.type == Shape::BOX)
+  {
+    for (int i = 0; i < 3; ++i) axes.push_back(t.Axis(i));
+  }
+  else if (g.type == Shape::CYLINDER)
+  {
+    axes.push_back(t.Axis(2));
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Returns the smallest overlap of the boxes \e a and \e b along any
+// direction, which is the penetration depth if it is positive.
+// The directions tried are the axes of the boxes and their cross products,
+// which are all separating axes, so the result is exact.
+double MinOverlap(const Geometry& a, const Transform& ta,
+                  const Geometry& b, const Transform& tb)
+{
+  std::vector<Vector3> axesA, axesB;
+  AddAxes(a, ta, axesA);
+  AddAxes(b, tb, axesB);
+  std::vector<Vector3> candidates(axesA);
+  candidates.insert(candidates.end(), axesB.begin(), axesB.end());
+  for (std::vector<Vector3>::const_iterator ia = axesA.begin();
+       ia != axesA.end(); ++ia)
+  {
+    for (std::vector<Vector3>::const_iterator ib = axesB.begin();
+         ib != axesB.end(); ++ib)
+    {
+      Vector3 c = ia->Cross(*ib);
+      if (c.SquaredLength() > 1e-12) candidates.push_back(c.Normalized());
+    }
+  }
+
+  double best = std::numeric_limits<double>::max();
+  for (std::vector<Vector3>::const_iterator it = candidates.begin();
+       it != candidates.end(); ++it)
+  {
+    best = std::min(best, Overlap(a, ta, b, tb, *it));
+    best = std::min(best, Overlap(a, ta, b, tb, -(*it)));
+  }
+  return best;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Collision of the sphere \e s with any geometry \e o
+bool CollideSphere(const Geometry& s, const Transform& ts,
+                   const Geometry& o, const Transform& to, double& depth)
+{
+  depth = s.radius - SignedDistance(o, to, ts.pos);
+  if (depth < 0)
+  {
+    depth = 0;
+    return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Collision of the plane \e p with any geometry \e o other than a plane
+bool CollidePlane(const Geometry& p, const Transform& tp,
+                  const Geometry& o, const Transform& to, double& depth)
+{
+  Vector3 n = tp.rot * p.normal;
+  double offset = p.offset + n.Dot(tp.pos);
+  // lowest projection of the other geometry onto the normal
+  double min;
+  if (o.type == Shape::MESH)
+  {
+    Vector3 nLocal = to.rotT * n;
+    min = std::numeric_limits<double>::max();
+    const std::vector<Vector3>& verts = o.bvh->GetVertices();
+    for (std::vector<Vector3>::const_iterator it = verts.begin();
+         it != verts.end(); ++it)
+      min = std::min(min, nLocal.Dot(*it));
+    min += n.Dot(to.pos);
+  }
+  else
+  {
+    min = Support(o, to, -n).Dot(n);
+  }
+  depth = offset - min;
+  if (depth < 0)
+  {
+    depth = 0;
+    return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Collision of two boxes or cylinders
+bool CollideConvex(const Geometry& a, const Transform& ta,
+                   const Geometry& b, const Transform& tb, double& depth)
+{
+  depth = 0;
+  if (a.type == Shape::BOX && b.type == Shape::BOX)
+  {
+    double overlap = MinOverlap(a, ta, b, tb);
+    if (overlap < 0) return false;
+    depth = overlap;
+    return true;
+  }
+  SignedDistanceResult result;
+  GjkEpa(GeometrySupport(a, ta), GeometrySupport(b, tb), result);
+  if (result.distance > 0) return false;
+  depth = -result.distance;
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Points on the surface of the convex primitive \e g, placed at \e t, which
+// are used to estimate how far it penetrates another shape.
+std::vector<Vector3> SamplePoints(const Geometry& g, const Transform& t)
+{
+  std::vector<Vector3> points;
+  if (g.type == Shape::BOX)
+  {
+    for (int i = 0; i < 8; ++i)
+      points.push_back(t.Apply(Vector3((i & 1) ? g.halfSize.X() :
+                                                 -g.halfSize.X(),
+                                       (i & 2) ? g.halfSize.Y() :
+                                                 -g.halfSize.Y(),
+                                       (i & 4) ? g.halfSize.Z() :
+                                                 -g.halfSize.Z())));
+  }
+  else if (g.type == Shape::CYLINDER)
+  {
+    const int numRim = 16;
+    for (int s = -1; s <= 1; s += 2)
+    {
+      points.push_back(t.Apply(Vector3(0, 0, s * g.halfLength)));
+      for (int i = 0; i < numRim; ++i)
+      {
+        double angle = 2 * M_PI * i / numRim;
+        points.push_back(t.Apply(Vector3(g.radius * cos(angle),
+                                         g.radius * sin(angle),
+                                         s * g.halfLength)));
+      }
+    }
+  }
+  return points;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Collision of the mesh \e m with a box or cylinder \e c
+bool CollideMeshConvex(const Geometry& m, const Transform& tm,
+                       const Geometry& c, const Transform& tc, double& depth)
+{
+  depth = 0;
+  const TriangleBVH& bvh = *m.bvh;
+  // place the convex shape in the frame of the mesh
+  Transform t = tm.Inverse() * tc;
+
+  // bounding box of the convex shape in the frame of the mesh
+  Vector3 min(Support(c, t, Vector3(-1, 0, 0)).X(),
+              Support(c, t, Vector3(0, -1, 0)).Y(),
+              Support(c, t, Vector3(0, 0, -1)).Z());
+  Vector3 max(Support(c, t, Vector3(1, 0, 0)).X(),
+              Support(c, t, Vector3(0, 1, 0)).Y(),
+              Support(c, t, Vector3(0, 0, 1)).Z());
+
+  struct NodeTest
+  {
+    NodeTest(const Vector3& min_, const Vector3& max_): min(min_), max(max_) {}
+    bool operator()(const TriangleBVH::Node& n) const
+    {
+      return n.min.X() <= max.X() && n.max.X() >= min.X() &&
+             n.min.Y() <= max.Y() && n.max.Y() >= min.Y() &&
+             n.min.Z() <= max.Z() && n.max.Z() >= min.Z();
+    }
+    const Vector3& min;
+    const Vector3& max;
+  };
+
+  struct TriangleTest
+  {
+    TriangleTest(const Geometry& c_, const Transform& t_): c(c_), t(t_) {}
+    bool operator()(const Triangle& tri) const
+    {
+      if (c.type == Shape::BOX)
+      {
+        Vector3 v[3] = {t.ApplyInverse(tri.v[0]), t.ApplyInverse(tri.v[1]),
+                        t.ApplyInverse(tri.v[2])};
+        return TriangleBoxIntersect(v, c.halfSize);
+      }
+      return GjkIntersect(TriangleSupport(tri.v), GeometrySupport(c, t));
+    }
+    const Geometry& c;
+    const Transform& t;
+  };
+
+  const std::vector<Vector3>& verts = bvh.GetVertices();
+  bool intersect = bvh.AnyTriangle(NodeTest(min, max), TriangleTest(c, t));
+  // if the surfaces don't intersect, one shape may contain the other
+  if (!intersect)
+    intersect = bvh.IsInside(t.pos) ||
+                (!verts.empty() && SignedDistance(c, t, verts[0]) <= 0);
+  if (!intersect) return false;
+
+  for (std::vector<Vector3>::const_iterator it = verts.begin();
+       it != verts.end(); ++it)
+    depth = std::max(depth, -SignedDistance(c, t, *it));
+  std::vector<Vector3> points = SamplePoints(c, t);
+  for (std::vector<Vector3>::const_iterator it = points.begin();
+       it != points.end(); ++it)
+    depth = std::max(depth, -bvh.SignedDistance(*it));
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Returns the largest distance by which a vertex of \e a lies inside \e b,
+// where \e t transforms from the frame of \e a to the frame of \e b.
+double VertexPenetration(const TriangleBVH& a, const TriangleBVH& b,
+                         const Transform& t)
+{
+  if (b.GetNodes().empty()) return 0;
+  const TriangleBVH::Node& root = b.GetNodes().front();
+  double depth = 0;
+  const std::vector<Vector3>& verts = a.GetVertices();
+  for (std::vector<Vector3>::const_iterator it = verts.begin();
+       it != verts.end(); ++it)
+  {
+    Vector3 p = t.Apply(*it);
+    if (p.X() < root.min.X() || p.X() > root.max.X() ||
+        p.Y() < root.min.Y() || p.Y() > root.max.Y() ||
+        p.Z() < root.min.Z() || p.Z() > root.max.Z())
+      continue;
+    if (b.IsInside(p)) depth = std::max(depth, b.Distance(p));
+  }
+  return depth;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Collision of two meshes
+bool CollideMeshes(const Geometry& a, const Transform& ta,
+                   const Geometry& b, const Transform& tb, double& depth)
+{
+  depth = 0;
+  const TriangleBVH& bvhA = *a.bvh;
+  const TriangleBVH& bvhB = *b.bvh;
+  const std::vector<TriangleBVH::Node>& nodesA = bvhA.GetNodes();
+  const std::vector<TriangleBVH::Node>& nodesB = bvhB.GetNodes();
+  if (nodesA.empty() || nodesB.empty()) return false;
+
+  // transform from frame of b to frame of a
+  Transform tba = ta.Inverse() * tb;
+  const Matrix3& r = tba.rot;
+  const Matrix3 absRot(std::fabs(r(0, 0)), std::fabs(r(0, 1)),
+                       std::fabs(r(0, 2)), std::fabs(r(1, 0)),
+                       std::fabs(r(1, 1)), std::fabs(r(1, 2)),
+                       std::fabs(r(2, 0)), std::fabs(r(2, 1)),
+                       std::fabs(r(2, 2)));
+
+  bool intersect = false;
+  std::vector<std::pair<unsigned int, unsigned int> > stack;
+  stack.push_back(std::make_pair(0u, 0u));
+  while (!stack.empty() && !intersect)
+  {
+    const unsigned int ia = stack.back().first;
+    const unsigned int ib = stack.back().second;
+    stack.pop_back();
+    const TriangleBVH::Node& na = nodesA[ia];
+    const TriangleBVH::Node& nb = nodesB[ib];
+
+    // bounding box of node b in the frame of a
+    Vector3 center = tba.Apply((nb.min + nb.max) / 2.0);
+    Vector3 extent = absRot * ((nb.max - nb.min) / 2.0);
+    if ((center - extent).X() > na.max.X() ||
+        (center + extent).X() < na.min.X() ||
+        (center - extent).Y() > na.max.Y() ||
+        (center + extent).Y() < na.min.Y() ||
+        (center - extent).Z() > na.max.Z() ||
+        (center + extent).Z() < na.min.Z())
+      continue;
+
+    if (na.IsLeaf() && nb.IsLeaf())
+    {
+      const std::vector<Triangle>& trisA = bvhA.GetTriangles();
+      const std::vector<Triangle>& trisB = bvhB.GetTriangles();
+      for (unsigned int j = nb.index; j < nb.index + nb.count && !intersect;
+           ++j)
+      {
+        Vector3 v[3] = {tba.Apply(trisB[j].v[0]), tba.Apply(trisB[j].v[1]),
+                        tba.Apply(trisB[j].v[2])};
+        for (unsigned int i = na.index; i < na.index + na.count; ++i)
+        {
+          if (TrianglesIntersect(trisA[i].v, v))
+          {
+            intersect = true;
+            break;
+          }
+        }
+      }
+    }
+    else if (nb.IsLeaf() ||
+             (!na.IsLeaf() &&
+              (na.max - na.min).SquaredLength() >=
+              (nb.max - nb.min).SquaredLength()))
+    {
+      // descend into a
+      stack.push_back(std::make_pair(na.index, ib));
+      stack.push_back(std::make_pair(ia + 1, ib));
+    }
+    else
+    {
+      // descend into b
+      stack.push_back(std::make_pair(ia, nb.index));
+      stack.push_back(std::make_pair(ia, ib + 1));
+    }
+  }
+
+  Transform tab = tba.Inverse();
+  // if the surfaces don't intersect, one mesh may contain the other
+  if (!intersect)
+    intersect = bvhA.IsInside(tba.Apply(bvhB.GetVertices().front())) ||
+                bvhB.IsInside(tab.Apply(bvhA.GetVertices().front()));
+  if (!intersect) return false;
+
+  depth = std::max(VertexPenetration(bvhA, bvhB, tab),
+                   VertexPenetration(bvhB, bvhA, tba));
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool Collide(const Geometry& a, const Transform& ta,
+             const Geometry& b, const Transform& tb, double& depth)
+{
+  if (a.type == Shape::PLANE && b.type == Shape::PLANE)
+    THROW_EXCEPTION("Collision of two planes is not supported");
+  if (a.type == Shape::SPHERE) return CollideSphere(a, ta, b, tb, depth);
+  if (b.type == Shape::SPHERE) return CollideSphere(b, tb, a, ta, depth);
+  if (a.type == Shape::PLANE) return CollidePlane(a, ta, b, tb, depth);
+  if (b.type == Shape::PLANE) return CollidePlane(b, tb, a, ta, depth);
+  if (a.type == Shape::MESH && b.type == Shape::MESH)
+    return CollideMeshes(a, ta, b, tb, depth);
+  if (a.type == Shape::MESH) return CollideMeshConvex(a, ta, b, tb, depth);
+  if (b.type == Shape::MESH) return CollideMeshConvex(b, tb, a, ta, depth);
+  return CollideConvex(a, ta, b, tb, depth);
+}
+
+}  // namespace oracle
+}  // namespace collision_benchmark
+
+/////////////////////////////////////////////////////////////////////////////
+CollisionOracle::GeometryConstPtr
+CollisionOracle::CreateGeometry(const Shape::Ptr& shape, const Pose3& pose)
+{
+  std::shared_ptr<oracle::Geometry> g(new oracle::Geometry());
+  g->type = shape->GetType();
+  g->pose = pose;
+
+  PrimitiveShape::Ptr prim = std::dynamic_pointer_cast<PrimitiveShape>(shape);
+  SimpleTriMeshShape::Ptr mesh =
+    std::dynamic_pointer_cast<SimpleTriMeshShape>(shape);
+  if (prim)
+  {
+    PrimitiveShapeParameters::Ptr params = prim->GetParams();
+    switch (g->type)
+    {
+      case Shape::BOX:
+        g->halfSize.Set(params->Get(PrimitiveShapeParameters::DIMX) / 2,
+                        params->Get(PrimitiveShapeParameters::DIMY) / 2,
+                        params->Get(PrimitiveShapeParameters::DIMZ) / 2);
+        break;
+      case Shape::SPHERE:
+        g->radius = params->Get(PrimitiveShapeParameters::RADIUS);
+        break;
+      case Shape::CYLINDER:
+        g->radius = params->Get(PrimitiveShapeParameters::RADIUS);
+        g->halfLength = params->Get(PrimitiveShapeParameters::LENGTH) / 2;
+        break;
+      case Shape::PLANE:
+      {
+        oracle::Vector3 n(params->Get(PrimitiveShapeParameters::VALX),
+                          params->Get(PrimitiveShapeParameters::VALY),
+                          params->Get(PrimitiveShapeParameters::VALZ));
+        double len = n.Length();
+        if (len <= 0)
+        {
+          LOG_ERROR("shape", "CollisionOracle: Plane has no valid normal");
+          return GeometryConstPtr();
+        }
+        g->normal = n / len;
+        g->offset = params->Get(PrimitiveShapeParameters::LENGTH) / len;
+        break;
+      }
+      default:
+        LOG_ERROR("shape", "CollisionOracle: Unknown primitive type "
+                           << g->type);
+        return GeometryConstPtr();
+    }
+  }
+  else if (mesh && mesh->GetMeshData() &&
+           !mesh->GetMeshData()->GetFaces().empty())
+  {
+    g->bvh.reset(new TriangleBVH(*mesh->GetMeshData()));
+  }
+  else
+  {
+    LOG_ERROR("shape", "CollisionOracle: Shape of type " << g->type
+                       << " is not supported");
+    return GeometryConstPtr();
+  }
+  return g;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool CollisionOracle::AddShape(const std::string& id, const Shape::Ptr& shape)
+{
+  if (!shape) return false;
+  std::vector<GeometryConstPtr> parts;
+  std::vector<Shape::Ptr> collParts = shape->GetCollisionParts();
+  if (collParts.empty())
+  {
+    GeometryConstPtr g = CreateGeometry(shape, Pose3());
+    if (!g) return false;
+    parts.push_back(g);
+  }
+  for (std::vector<Shape::Ptr>::const_iterator it = collParts.begin();
+       it != collParts.end(); ++it)
+  {
+    GeometryConstPtr g = CreateGeometry(*it, (*it)->GetPose());
+    if (!g) return false;
+    parts.push_back(g);
+  }
+  shapes[id] = parts;
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool CollisionOracle::RemoveShape(const std::string& id)
+{
+  return shapes.erase(id) > 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool CollisionOracle::HasShape(const std::string& id) const
+{
+  return shapes.find(id) != shapes.end();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool CollisionOracle::Collide(const std::string& id1, const Pose3& pose1,
+                              const std::string& id2, const Pose3& pose2,
+                              double& depth) const
+{
+  std::map<std::string, std::vector<GeometryConstPtr> >::const_iterator
+    it1 = shapes.find(id1);
+  std::map<std::string, std::vector<GeometryConstPtr> >::const_iterator
+    it2 = shapes.find(id2);
+  if (it1 == shapes.end()) THROW_EXCEPTION("No shape with id " << id1);
+  if (it2 == shapes.end()) THROW_EXCEPTION("No shape with id " << id2);
+
+  const oracle::Transform t1(pose1);
+  const oracle::Transform t2(pose2);
+  bool collide = false;
+  depth = 0;
+  for (std::vector<GeometryConstPtr>::const_iterator g1 = it1->second.begin();
+       g1 != it1->second.end(); ++g1)
+  {
+    oracle::Transform tg1 = t1 * oracle::Transform((*g1)->pose);
+    for (std::vector<GeometryConstPtr>::const_iterator
+         g2 = it2->second.begin(); g2 != it2->second.end(); ++g2)
+    {
+      oracle::Transform tg2 = t2 * oracle::Transform((*g2)->pose);
+      double partDepth;
+      if (oracle::Collide(**g1, tg1, **g2, tg2, partDepth))
+      {
+        collide = true;
+        depth = std::max(depth, partDepth);
+      }
+    }
+  }
+  return collide;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_COLLISIONORACLE_H
+#define COLLISION_BENCHMARK_COLLISIONORACLE_H
+
+#include <collision_benchmark/Shape.hh>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace collision_benchmark
+{
+namespace oracle
+{
+// Geometry of one collision part, prepared for the queries of
+// CollisionOracle. Defined in the implementation file.
+struct Geometry;
+}
+
+/**
+ * \brief Reference collision checker which is independent of any physics
+ * engine, to be used as ground truth when evaluating engines.
+ *
+ * Shapes are added once with AddShape(), which prepares them for
+ * the queries (e.g. builds a TriangleBVH for meshes), and can then be tested
+ * for collision at any pair of poses with Collide().
+ *
+ * Supported are PrimitiveShape and SimpleTriMeshShape instances, and any
+ * shape which consists of collision parts of these types
+ * (see Shape::GetCollisionParts()). Planes are treated as half-spaces:
+ * everything below the plane is inside, and the plane bounds are ignored.
+ * Meshes are expected to be closed, as their inside is determined with
+ * ray parity tests.
+ *
+ * The boolean collision result is exact up to floating point precision
+ * for all supported pairs. The penetration depth is exact for all pairs
+ * including a sphere or a plane, and for pairs of boxes. For pairs of a box
+ * and a cylinder or of two cylinders, it is computed with GjkEpa() to within
+ * a relative tolerance of about 1e-06. For pairs including
+ * a mesh (other than with a sphere or a plane), it is the maximum distance
+ * by which a vertex of one shape lies inside the other, which is a
+ * lower bound of the penetration depth.
+ */
+class CollisionOracle
+{
+  public: typedef std::shared_ptr<CollisionOracle> Ptr;
+  public: typedef std::shared_ptr<const CollisionOracle> ConstPtr;
+
+  public: typedef Shape::Pose3 Pose3;
+
+  public: CollisionOracle() {}
+  public: virtual ~CollisionOracle() {}
+
+  // Prepares \e shape for queries and stores it under \e id, replacing
+  // any shape which was previously added with this id. The pose of
+  // \e shape is not considered, the poses are given in Collide().
+  // \return false if the shape type is not supported.
+  public: bool AddShape(const std::string& id, const Shape::Ptr& shape);
+
+  // Removes the shape with the given \e id.
+  // \retval false there was no shape with this id
+  public: bool RemoveShape(const std::string& id);
+
+  // Returns true if there is a shape with the given \e id
+  public: bool HasShape(const std::string& id) const;
+
+  // Tests whether the shapes \e id1 and \e id2 intersect when placed at
+  // \e pose1 and \e pose2. Touching shapes are considered intersecting.
+  // Throws a collision_benchmark::Exception if there are no shapes with
+  // the given ids, or if both shapes are planes.
+  // \param[out] depth the penetration depth if the shapes intersect,
+  //    or 0 if they don't.
+  // \return true if the shapes intersect
+  public: bool Collide(const std::string& id1, const Pose3& pose1,
+                       const std::string& id2, const Pose3& pose2,
+                       double& depth) const;
+
+  private: typedef std::shared_ptr<const oracle::Geometry> GeometryConstPtr;
+
+  // Creates the geometry for \e shape, or NULL if it is not supported.
+  // \param pose the pose of the geometry relative to the model
+  private: static GeometryConstPtr CreateGeometry(const Shape::Ptr& shape,
+                                                  const Pose3& pose);
+
+  // all shapes by their id, each consisting of one or several parts
+  private: std::map<std::string, std::vector<GeometryConstPtr> > shapes;
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_COLLISIONORACLE_H
@@ -5,6 +5,7 @@
 #include <memory>
 #include <iostream>
 #include <limits>
+#include <string>
 
 namespace collision_benchmark
 {
@@ -188,6 +189,148 @@ class ContactInfo
 
 };
 
+/**
+ * \brief Counts of inconsistencies in the contact points which a physics
+ * engine computed, with a few examples of each.
+ *
+ * The counts are relative to the number of contacts and contact points
+ * which have been looked at, so that rates can be compared between engines.
+ *
+ * Template parameters:
+ * - ModelIdImpl ID type used to identify models in the world
+ */
+template<typename ModelIdImpl>
+class ContactAnomalies
+{
+  public: typedef ModelIdImpl ModelID;
+
+  public: enum Type
+  {
+    // a contact between two bodies was reported without any contact points
+    EMPTY_CONTACT = 0,
+    // a contact point had a negative depth beyond the tolerance
+    NEGATIVE_DEPTH,
+    // all contact points of a contact between two bodies were invalid
+    ALL_POINTS_SKIPPED,
+    NUM_TYPES
+  };
+
+  // One occurrence of an anomaly
+  public: struct Example
+  {
+    Type type;
+    ModelID model1;
+    ModelID model2;
+    // depth of the contact point, or 0 if not applicable
+    double depth;
+  };
+
+  // \param maxExamples_ maximum number of examples kept for each type
+  public: explicit ContactAnomalies(const unsigned int maxExamples_ = 5):
+        numContacts(0),
+        numPoints(0),
+        maxExamples(maxExamples_)
+  {
+    for (int i = 0; i < NUM_TYPES; ++i) counts[i] = 0;
+  }
+
+  // Counts one occurrence of the anomaly \e type, and keeps it as example
+  // if there are less than maxExamples examples of this type yet.
+  public: void Add(const Type type, const ModelID& model1,
+                   const ModelID& model2, const double depth = 0)
+  {
+    if (counts[type]++ >= maxExamples) return;
+    Example e;
+    e.type = type;
+    e.model1 = model1;
+    e.model2 = model2;
+    e.depth = depth;
+    examples.push_back(e);
+  }
+
+  // Counts \e n occurrences of the anomaly \e type without keeping
+  // examples of them.
+  public: void AddCount(const Type type, const unsigned long n)
+  {
+    counts[type] += n;
+  }
+
+  // Adds all counts and examples of \e other to this one
+  public: void Merge(const ContactAnomalies& other)
+  {
+    numContacts += other.numContacts;
+    numPoints += other.numPoints;
+    for (int i = 0; i < NUM_TYPES; ++i)
+    {
+      unsigned int numExamples = counts[i] < maxExamples ?
+                                 maxExamples - counts[i] : 0;
+      for (typename std::vector<Example>::const_iterator
+           it = other.examples.begin(); it != other.examples.end() &&
+           numExamples > 0; ++it)
+      {
+        if (it->type != i) continue;
+        examples.push_back(*it);
+        --numExamples;
+      }
+      counts[i] += other.counts[i];
+    }
+  }
+
+  public: void Clear()
+  {
+    *this = ContactAnomalies(maxExamples);
+  }
+
+  // \return the number of occurrences of anomaly \e type
+  public: unsigned long GetCount(const Type type) const
+  {
+    return counts[type];
+  }
+
+  // \return the number of occurrences of anomaly \e type relative
+  // to the number of contact points (for NEGATIVE_DEPTH) or to
+  // the number of contacts (for all other types), or 0 if there were none.
+  public: double GetRate(const Type type) const
+  {
+    const unsigned long total =
+      (type == NEGATIVE_DEPTH) ? numPoints : numContacts;
+    if (total == 0) return 0;
+    return counts[type] / static_cast<double>(total);
+  }
+
+  public: static std::string GetTypeName(const Type type)
+  {
+    switch (type)
+    {
+      case EMPTY_CONTACT: return "empty_contact";
+      case NEGATIVE_DEPTH: return "negative_depth";
+      case ALL_POINTS_SKIPPED: return "all_points_skipped";
+      default: return "unknown";
+    }
+  }
+
+  public: friend std::ostream& operator<<(std::ostream& o,
+                                          const ContactAnomalies& a)
+  {
+    o << "(Contacts: " << a.numContacts << ", points: " << a.numPoints;
+    for (int i = 0; i < NUM_TYPES; ++i)
+      o << "; " << GetTypeName(static_cast<Type>(i)) << ": " << a.counts[i];
+    o << ")";
+    return o;
+  }
+
+  // number of contacts between two bodies which have been looked at
+  public: unsigned long numContacts;
+  // number of contact points which have been looked at
+  public: unsigned long numPoints;
+  // examples of the anomalies, at most maxExamples per type, in the
+  // order in which they occurred
+  public: std::vector<Example> examples;
+
+  private: unsigned long counts[NUM_TYPES];
+  private: unsigned int maxExamples;
+};
+
 }  // namespace
 
 #endif  // COLLISION_BENCHMARK_CONTACTINFO
@@ -0,0 +1,672 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_CONVEXDECOMPOSITION_INL_H
+#define COLLISION_BENCHMARK_CONVEXDECOMPOSITION_INL_H
+
+#include <collision_benchmark/Logger.hh>
+
+#include <ignition/math/Vector3.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace collision_benchmark
+{
+namespace convex
+{
+
+typedef ignition::math::Vector3d Vec3;
+
+// A triangle of a triangle soup
+struct Triangle
+{
+  Triangle(const Vec3& a, const Vec3& b, const Vec3& c)
+  { p[0] = a; p[1] = b; p[2] = c; }
+  Vec3 p[3];
+};
+
+// Convex hull as indexed triangle mesh, with outward pointing unit
+// normals and plane offsets (n.x + d = 0) for each face.
+struct Hull
+{
+  std::vector<Vec3> verts;
+  std::vector<std::size_t> tris;
+  std::vector<Vec3> normals;
+  std::vector<double> offsets;
+
+  // Distance from \e p, which must be inside the hull, to the hull boundary
+  // along the ray in direction \e dir.
+  double RayDistance(const Vec3& p, const Vec3& dir) const
+  {
+    double minDist = std::numeric_limits<double>::max();
+    for (std::size_t i = 0; i < normals.size(); ++i)
+    {
+      const double denom = normals[i].Dot(dir);
+      if (denom < 1e-12) continue;
+      const double t = -(normals[i].Dot(p) + offsets[i]) / denom;
+      minDist = std::min(minDist, std::max(t, 0.0));
+    }
+    return minDist == std::numeric_limits<double>::max() ? 0 : minDist;
+  }
+
+};
+
+// Quickhull working data
+class QuickHull
+{
+  public: explicit QuickHull(const std::vector<Vec3>& points):
+          pts(points) {}
+
+  // Computes the hull. Returns false if the points are co-planar.
+  public: bool Compute(Hull& hull)
+  {
+    hull = Hull();
+    if (pts.size() < 4) return false;
+
+    Vec3 minP = pts[0], maxP = pts[0];
+    for (std::size_t i = 1; i < pts.size(); ++i)
+    {
+      minP.Set(std::min(minP.X(), pts[i].X()), std::min(minP.Y(), pts[i].Y()),
+               std::min(minP.Z(), pts[i].Z()));
+      maxP.Set(std::max(maxP.X(), pts[i].X()), std::max(maxP.Y(), pts[i].Y()),
+               std::max(maxP.Z(), pts[i].Z()));
+    }
+    eps = 1e-09 * std::max(1.0, (maxP - minP).Length());
+
+    std::size_t init[4];
+    if (!InitialSimplex(init)) return false;
+
+    // build the tetrahedron, oriented outwards
+    const Vec3 center = (pts[init[0]] + pts[init[1]] +
+                         pts[init[2]] + pts[init[3]]) * 0.25;
+    const std::size_t tetra[4][3] = {{0, 1, 2}, {0, 3, 1},
+                                     {0, 2, 3}, {1, 3, 2}};
+    for (int i = 0; i < 4; ++i)
+    {
+      std::size_t a = init[tetra[i][0]], b = init[tetra[i][1]],
+                  c = init[tetra[i][2]];
+      const Vec3 n = (pts[b] - pts[a]).Cross(pts[c] - pts[a]);
+      if (n.Dot(center - pts[a]) > 0) std::swap(b, c);
+      AddFace(a, b, c);
+    }
+
+    // assign all points to the faces they are outside of
+    std::vector<std::size_t> all;
+    for (std::size_t i = 0; i < pts.size(); ++i)
+    {
+      if (i != init[0] && i != init[1] && i != init[2] && i != init[3])
+        all.push_back(i);
+    }
+    std::vector<std::size_t> newFaces;
+    for (std::size_t i = 0; i < faces.size(); ++i) newFaces.push_back(i);
+    AssignPoints(all, newFaces);
+
+    // Points are only ever assigned to newly created faces, which are
+    // appended at the end, so one pass over all faces is sufficient.
+    for (std::size_t f = 0; f < faces.size(); ++f)
+    {
+      if (faces[f].alive && !faces[f].outside.empty()) AddPoint(f);
+    }
+
+    // collect the result
+    std::map<std::size_t, std::size_t> idx;
+    for (std::size_t i = 0; i < faces.size(); ++i)
+    {
+      const Face& face = faces[i];
+      if (!face.alive) continue;
+      for (int k = 0; k < 3; ++k)
+      {
+        std::map<std::size_t, std::size_t>::iterator it = idx.find(face.v[k]);
+        if (it == idx.end())
+        {
+          it = idx.insert(std::make_pair(face.v[k], hull.verts.size())).first;
+          hull.verts.push_back(pts[face.v[k]]);
+        }
+        hull.tris.push_back(it->second);
+      }
+      hull.normals.push_back(face.n);
+      hull.offsets.push_back(face.d);
+    }
+    return true;
+  }
+
+  private: struct Face
+  {
+    std::size_t v[3];
+    Vec3 n;
+    double d;
+    bool alive;
+    std::vector<std::size_t> outside;
+  };
+
+  private: bool InitialSimplex(std::size_t init[4]) const
+  {
+    // the two points furthest apart of the extreme points along the axes
+    std::size_t ext[6] = {0, 0, 0, 0, 0, 0};
+    for (std::size_t i = 0; i < pts.size(); ++i)
+    {
+      for (int a = 0; a < 3; ++a)
+      {
+        if (pts[i][a] < pts[ext[2 * a]][a]) ext[2 * a] = i;
+        if (pts[i][a] > pts[ext[2 * a + 1]][a]) ext[2 * a + 1] = i;
+      }
+    }
+    double best = -1;
+    for (int i = 0; i < 6; ++i)
+    {
+      for (int j = i + 1; j < 6; ++j)
+      {
+        const double dist = pts[ext[i]].Distance(pts[ext[j]]);
+        if (dist > best)
+        {
+          best = dist;
+          init[0] = ext[i];
+          init[1] = ext[j];
+        }
+      }
+    }
+    if (best < eps) return false;
+
+    // point furthest from the line
+    const Vec3 dir = (pts[init[1]] - pts[init[0]]).Normalized();
+    best = -1;
+    for (std::size_t i = 0; i < pts.size(); ++i)
+    {
+      const double dist = (pts[i] - pts[init[0]]).Cross(dir).Length();
+      if (dist > best)
+      {
+        best = dist;
+        init[2] = i;
+      }
+    }
+    if (best < eps) return false;
+
+    // point furthest from the plane
+    const Vec3 n = (pts[init[1]] - pts[init[0]]).Cross(
+                    pts[init[2]] - pts[init[0]]).Normalized();
+    best = -1;
+    for (std::size_t i = 0; i < pts.size(); ++i)
+    {
+      const double dist = std::fabs(n.Dot(pts[i] - pts[init[0]]));
+      if (dist > best)
+      {
+        best = dist;
+        init[3] = i;
+      }
+    }
+    return best >= eps;
+  }
+
+  private: void AddFace(const std::size_t a, const std::size_t b,
+                        const std::size_t c)
+  {
+    Face f;
+    f.v[0] = a; f.v[1] = b; f.v[2] = c;
+    f.n = (pts[b] - pts[a]).Cross(pts[c] - pts[a]);
+    f.n.Normalize();
+    f.d = -f.n.Dot(pts[a]);
+    f.alive = true;
+    for (int k = 0; k < 3; ++k)
+      edgeFaces[std::make_pair(f.v[k], f.v[(k + 1) % 3])] = faces.size();
+    faces.push_back(f);
+  }
+
+  // assigns each of the points to the first face in \e candidates it is
+  // outside of. Points which are inside all of them are dropped.
+  private: void AssignPoints(const std::vector<std::size_t>& points,
+                             const std::vector<std::size_t>& candidates)
+  {
+    for (std::vector<std::size_t>::const_iterator it = points.begin();
+         it != points.end(); ++it)
+    {
+      for (std::vector<std::size_t>::const_iterator
+           fit = candidates.begin(); fit != candidates.end(); ++fit)
+      {
+        Face& f = faces[*fit];
+        if (f.n.Dot(pts[*it]) + f.d > eps)
+        {
+          f.outside.push_back(*it);
+          break;
+        }
+      }
+    }
+  }
+
+  // adds the furthest outside point of face \e f to the hull
+  private: void AddPoint(const std::size_t f)
+  {
+    std::size_t eye = faces[f].outside.front();
+    double best = -1;
+    for (std::vector<std::size_t>::const_iterator
+         it = faces[f].outside.begin(); it != faces[f].outside.end(); ++it)
+    {
+      const double dist = faces[f].n.Dot(pts[*it]) + faces[f].d;
+      if (dist > best)
+      {
+        best = dist;
+        eye = *it;
+      }
+    }
+
+    // all faces visible from the eye point, found by a breadth-first search
+    // from face f, so that the visible region is always connected.
+    std::vector<std::size_t> visible(1, f);
+    std::set<std::size_t> visited;
+    visited.insert(f);
+    // horizon edges, each with the face on the other side
+    std::vector<std::pair<std::size_t, std::size_t> > horizon;
+    for (std::size_t i = 0; i < visible.size(); ++i)
+    {
+      const Face& face = faces[visible[i]];
+      for (int k = 0; k < 3; ++k)
+      {
+        const std::size_t a = face.v[k];
+        const std::size_t b = face.v[(k + 1) % 3];
+        const std::size_t other = edgeFaces[std::make_pair(b, a)];
+        if (visited.count(other))
+        {
+          continue;
+        }
+        if (faces[other].n.Dot(pts[eye]) + faces[other].d > eps)
+        {
+          visited.insert(other);
+          visible.push_back(other);
+        }
+        else
+        {
+          horizon.push_back(std::make_pair(a, b));
+        }
+      }
+    }
+
+    // Edges to a neighbour which turned out visible later in the search
+    // are not on the horizon.
+    std::vector<std::pair<std::size_t, std::size_t> > realHorizon;
+    for (std::vector<std::pair<std::size_t, std::size_t> >::const_iterator
+         it = horizon.begin(); it != horizon.end(); ++it)
+    {
+      const std::size_t other =
+        edgeFaces[std::make_pair(it->second, it->first)];
+      if (!visited.count(other)) realHorizon.push_back(*it);
+    }
+
+    std::vector<std::size_t> orphans;
+    for (std::vector<std::size_t>::const_iterator it = visible.begin();
+         it != visible.end(); ++it)
+    {
+      Face& face = faces[*it];
+      face.alive = false;
+      for (int k = 0; k < 3; ++k)
+        edgeFaces.erase(std::make_pair(face.v[k], face.v[(k + 1) % 3]));
+      for (std::vector<std::size_t>::const_iterator
+           pit = face.outside.begin(); pit != face.outside.end(); ++pit)
+        if (*pit != eye) orphans.push_back(*pit);
+      face.outside.clear();
+    }
+
+    std::vector<std::size_t> newFaces;
+    for (std::vector<std::pair<std::size_t, std::size_t> >::const_iterator
+         it = realHorizon.begin(); it != realHorizon.end(); ++it)
+    {
+      newFaces.push_back(faces.size());
+      AddFace(it->first, it->second, eye);
+    }
+    AssignPoints(orphans, newFaces);
+  }
+
+  private: const std::vector<Vec3>& pts;
+  private: std::vector<Face> faces;
+  // maps each directed edge of the alive faces to its face
+  private: std::map<std::pair<std::size_t, std::size_t>, std::size_t>
+            edgeFaces;
+  private: double eps;
+};
+
+// Splits the triangles in \e tris by the plane with normal along \e axis
+// at \e value into the triangles below and above the plane.
+inline void Split(const std::vector<Triangle>& tris,
+                  const int axis, const double value,
+                  std::vector<Triangle>& below,
+                  std::vector<Triangle>& above)
+{
+  below.clear();
+  above.clear();
+  for (std::vector<Triangle>::const_iterator it = tris.begin();
+       it != tris.end(); ++it)
+  {
+    // Triangles within the plane belong to the side of the solid, which is
+    // opposite to the direction of their normal.
+    if (it->p[0][axis] == value && it->p[1][axis] == value &&
+        it->p[2][axis] == value)
+    {
+      const Vec3 n = (it->p[1] - it->p[0]).Cross(it->p[2] - it->p[0]);
+      if (n[axis] > 0) below.push_back(*it);
+      else above.push_back(*it);
+      continue;
+    }
+
+    // clip the triangle on both sides (Sutherland-Hodgman)
+    std::vector<Vec3> polyBelow, polyAbove;
+    for (int k = 0; k < 3; ++k)
+    {
+      const Vec3& p = it->p[k];
+      const Vec3& q = it->p[(k + 1) % 3];
+      const double dp = p[axis] - value;
+      const double dq = q[axis] - value;
+      if (dp <= 0) polyBelow.push_back(p);
+      if (dp >= 0) polyAbove.push_back(p);
+      if ((dp < 0 && dq > 0) || (dp > 0 && dq < 0))
+      {
+        const Vec3 x = p + (q - p) * (dp / (dp - dq));
+        polyBelow.push_back(x);
+        polyAbove.push_back(x);
+      }
+    }
+    for (std::size_t k = 1; k + 1 < polyBelow.size(); ++k)
+      below.push_back(Triangle(polyBelow[0], polyBelow[k], polyBelow[k+1]));
+    for (std::size_t k = 1; k + 1 < polyAbove.size(); ++k)
+      above.push_back(Triangle(polyAbove[0], polyAbove[k], polyAbove[k+1]));
+  }
+}
+
+// Point in mesh test for a closed triangle mesh, by counting the
+// intersections of a ray with the mesh.
+class InsideTest
+{
+  public: explicit InsideTest(const std::vector<Triangle>& tris_):
+          tris(tris_) {}
+
+  public: bool Inside(const Vec3& p)
+  {
+    const std::vector<double> key = {p.X(), p.Y(), p.Z()};
+    std::map<std::vector<double>, bool>::const_iterator it = cache.find(key);
+    if (it != cache.end()) return it->second;
+
+    // odd direction, so that edges and vertices are unlikely to be hit
+    static const Vec3 dir = Vec3(0.5773, 0.5774, 0.5771).Normalized();
+    int crossings = 0;
+    for (std::vector<Triangle>::const_iterator t = tris.begin();
+         t != tris.end(); ++t)
+    {
+      // Moeller-Trumbore ray-triangle intersection
+      const Vec3 e1 = t->p[1] - t->p[0];
+      const Vec3 e2 = t->p[2] - t->p[0];
+      const Vec3 h = dir.Cross(e2);
+      const double det = e1.Dot(h);
+      if (std::fabs(det) < 1e-15) continue;
+      const Vec3 s = p - t->p[0];
+      const double u = s.Dot(h) / det;
+      if (u < 0 || u > 1) continue;
+      const Vec3 q = s.Cross(e1);
+      const double v = dir.Dot(q) / det;
+      if (v < 0 || u + v > 1) continue;
+      if (e2.Dot(q) / det > 0) ++crossings;
+    }
+    const bool inside = (crossings % 2) == 1;
+    cache[key] = inside;
+    return inside;
+  }
+
+  private: const std::vector<Triangle>& tris;
+  private: std::map<std::vector<double>, bool> cache;
+};
+
+// A part of the decomposition, which is the intersection of the mesh
+// with an axis aligned box.
+struct Part
+{
+  // the mesh surface triangles clipped to the box
+  std::vector<Triangle> tris;
+  double min[3], max[3];
+  Hull hull;
+  double concavity;
+  // the sample point at which the concavity was measured
+  Vec3 deepest;
+
+  // computes the hull and the concavity. Returns false if there is no
+  // hull for this part (e.g. it is flat).
+  bool Update(InsideTest& insideTest)
+  {
+    // The hull of the intersection of the mesh with the box is the hull of
+    // the clipped surface together with the box corners inside the mesh.
+    // The points where box edges cross the surface are vertices of the
+    // clipped triangles already.
+    std::vector<Vec3> points;
+    points.reserve(3 * tris.size() + 8);
+    for (std::vector<Triangle>::const_iterator it = tris.begin();
+         it != tris.end(); ++it)
+      points.insert(points.end(), it->p, it->p + 3);
+    for (int c = 0; c < 8; ++c)
+    {
+      const Vec3 corner((c & 1) ? max[0] : min[0], (c & 2) ? max[1] : min[1],
+                        (c & 4) ? max[2] : min[2]);
+      if (insideTest.Inside(corner)) points.push_back(corner);
+    }
+    QuickHull qh(points);
+    concavity = 0;
+    if (!qh.Compute(hull)) return false;
+
+    // Sample the vertices and triangle centers: the concavity at each point
+    // is the distance to the hull boundary along the surface normal.
+    for (std::vector<Triangle>::const_iterator it = tris.begin();
+         it != tris.end(); ++it)
+    {
+      Vec3 n = (it->p[1] - it->p[0]).Cross(it->p[2] - it->p[0]);
+      if (n.Length() < 1e-20) continue;
+      n.Normalize();
+      const Vec3 samples[4] = {it->p[0], it->p[1], it->p[2],
+                               (it->p[0] + it->p[1] + it->p[2]) / 3.0};
+      for (int k = 0; k < 4; ++k)
+      {
+        const double dist = hull.RayDistance(samples[k], n);
+        if (dist > concavity)
+        {
+          concavity = dist;
+          deepest = samples[k];
+        }
+      }
+    }
+    return true;
+  }
+};
+
+template<typename VP>
+typename MeshData<VP, 3>::Ptr ToMeshData(const Hull& hull)
+{
+  typedef MeshData<VP, 3> MeshDataT;
+  typename MeshDataT::Ptr ret(new MeshDataT());
+  std::vector<typename MeshDataT::Vertex>& verts = ret->GetVertices();
+  std::vector<typename MeshDataT::Face>& faces = ret->GetFaces();
+  verts.reserve(hull.verts.size());
+  for (std::vector<Vec3>::const_iterator it = hull.verts.begin();
+       it != hull.verts.end(); ++it)
+    verts.push_back(typename MeshDataT::Vertex(it->X(), it->Y(), it->Z()));
+  faces.reserve(hull.tris.size() / 3);
+  for (std::size_t i = 0; i + 2 < hull.tris.size(); i += 3)
+  {
+    faces.push_back(typename MeshDataT::Face(hull.tris[i], hull.tris[i + 1],
+                                             hull.tris[i + 2]));
+  }
+  return ret;
+}
+
+}  // namespace convex
+
+template<typename VP>
+typename MeshData<VP, 3>::Ptr
+ConvexHull(const MeshData<VP, 3>& mesh)
+{
+  typedef typename MeshData<VP, 3>::Vertex Vertex;
+  const std::vector<Vertex>& inVerts = mesh.GetVertices();
+  std::vector<convex::Vec3> points;
+  points.reserve(inVerts.size());
+  for (typename std::vector<Vertex>::const_iterator it = inVerts.begin();
+       it != inVerts.end(); ++it)
+    points.push_back(convex::Vec3(it->X(), it->Y(), it->Z()));
+
+  convex::Hull hull;
+  convex::QuickHull qh(points);
+  if (!qh.Compute(hull))
+  {
+    LOG_ERROR("shape", "Cannot compute convex hull of flat mesh");
+    return typename MeshData<VP, 3>::Ptr();
+  }
+  return convex::ToMeshData<VP>(hull);
+}
+
+template<typename VP>
+std::vector<typename MeshData<VP, 3>::Ptr>
+ConvexDecomposition(const MeshData<VP, 3>& mesh,
+                    const double maxConcavity,
+                    const unsigned int maxParts)
+{
+  typedef typename MeshData<VP, 3>::Vertex Vertex;
+  typedef typename MeshData<VP, 3>::Face Face;
+  // number of candidate split positions per axis
+  static const int numSplits = 7;
+
+  std::vector<typename MeshData<VP, 3>::Ptr> ret;
+
+  const std::vector<Vertex>& verts = mesh.GetVertices();
+  const std::vector<Face>& faces = mesh.GetFaces();
+  std::vector<convex::Triangle> tris;
+  tris.reserve(faces.size());
+  for (typename std::vector<Face>::const_iterator it = faces.begin();
+       it != faces.end(); ++it)
+  {
+    const Vertex& a = verts[it->val[0]];
+    const Vertex& b = verts[it->val[1]];
+    const Vertex& c = verts[it->val[2]];
+    tris.push_back(convex::Triangle(
+      convex::Vec3(a.X(), a.Y(), a.Z()), convex::Vec3(b.X(), b.Y(), b.Z()),
+      convex::Vec3(c.X(), c.Y(), c.Z())));
+  }
+  convex::InsideTest insideTest(tris);
+
+  // the first part is the whole mesh, in a box slightly larger than the
+  // bounding box so that the corners are outside.
+  std::vector<convex::Part> parts(1);
+  parts[0].tris = tris;
+  for (int a = 0; a < 3; ++a)
+  {
+    parts[0].min[a] = std::numeric_limits<double>::max();
+    parts[0].max[a] = -std::numeric_limits<double>::max();
+  }
+  for (typename std::vector<Vertex>::const_iterator it = verts.begin();
+       it != verts.end(); ++it)
+  {
+    for (int a = 0; a < 3; ++a)
+    {
+      const double val = (*it)[a];
+      parts[0].min[a] = std::min(parts[0].min[a], val);
+      parts[0].max[a] = std::max(parts[0].max[a], val);
+    }
+  }
+  for (int a = 0; a < 3; ++a)
+  {
+    const double margin = 1e-03 * (parts[0].max[a] - parts[0].min[a]) + 1e-06;
+    parts[0].min[a] -= margin;
+    parts[0].max[a] += margin;
+  }
+
+  if (!parts[0].Update(insideTest))
+  {
+    LOG_ERROR("shape", "Cannot compute convex decomposition of flat mesh");
+    return ret;
+  }
+
+  while (parts.size() < maxParts)
+  {
+    // the most concave part
+    std::size_t worst = 0;
+    for (std::size_t i = 1; i < parts.size(); ++i)
+      if (parts[i].concavity > parts[worst].concavity) worst = i;
+    if (parts[worst].concavity <= maxConcavity) break;
+
+    // Candidate planes are within the bounds of the hull, which may be
+    // smaller than the box of the part.
+    const convex::Hull& hull = parts[worst].hull;
+    double minP[3], maxP[3];
+    for (int a = 0; a < 3; ++a)
+    {
+      minP[a] = std::numeric_limits<double>::max();
+      maxP[a] = -std::numeric_limits<double>::max();
+      for (std::size_t i = 0; i < hull.verts.size(); ++i)
+      {
+        minP[a] = std::min(minP[a], hull.verts[i][a]);
+        maxP[a] = std::max(maxP[a], hull.verts[i][a]);
+      }
+    }
+
+    // find the candidate plane which minimizes the larger concavity of the
+    // two resulting parts.
+    bool found = false;
+    double bestConcavity = std::numeric_limits<double>::max();
+    convex::Part bestBelow, bestAbove;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      // regularly spaced planes, and the plane through the deepest point
+      std::vector<double> values;
+      for (int s = 1; s <= numSplits; ++s)
+        values.push_back(minP[axis] +
+                         (maxP[axis] - minP[axis]) * s / (numSplits + 1));
+      const double deepest = parts[worst].deepest[axis];
+      if (deepest > minP[axis] && deepest < maxP[axis])
+        values.push_back(deepest);
+
+      for (std::vector<double>::const_iterator vit = values.begin();
+           vit != values.end(); ++vit)
+      {
+        const double value = *vit;
+        convex::Part below, above;
+        std::copy(parts[worst].min, parts[worst].min + 3, below.min);
+        std::copy(parts[worst].max, parts[worst].max + 3, below.max);
+        std::copy(parts[worst].min, parts[worst].min + 3, above.min);
+        std::copy(parts[worst].max, parts[worst].max + 3, above.max);
+        below.max[axis] = value;
+        above.min[axis] = value;
+        convex::Split(parts[worst].tris, axis, value, below.tris, above.tris);
+        if (!below.Update(insideTest) || !above.Update(insideTest)) continue;
+        const double conc = std::max(below.concavity, above.concavity);
+        if (conc < bestConcavity)
+        {
+          bestConcavity = conc;
+          bestBelow = below;
+          bestAbove = above;
+          found = true;
+        }
+      }
+    }
+    if (!found) break;
+
+    parts[worst] = bestBelow;
+    parts.push_back(bestAbove);
+  }
+
+  for (std::vector<convex::Part>::const_iterator it = parts.begin();
+       it != parts.end(); ++it)
+    ret.push_back(convex::ToMeshData<VP>(it->hull));
+  return ret;
+}
+
+}  // namespace
+#endif  // COLLISION_BENCHMARK_CONVEXDECOMPOSITION_INL_H
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_CONVEXDECOMPOSITION_H
+#define COLLISION_BENCHMARK_CONVEXDECOMPOSITION_H
+
+#include <collision_benchmark/MeshData.hh>
+
+#include <vector>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Computes the convex hull of the vertices of \e mesh with the
+ * quickhull algorithm.
+ *
+ * All faces of the resulting triangle mesh are oriented counter-clockwise
+ * when seen from the outside. Only vertices which are on the hull are
+ * contained in the result.
+ *
+ * \return the convex hull, or NULL if the points are all co-planar,
+ *    in which case there is no volume which can be enclosed.
+ */
+template<typename VP>
+typename MeshData<VP, 3>::Ptr
+ConvexHull(const MeshData<VP, 3>& mesh);
+
+/**
+ * \brief Computes an approximate convex decomposition of \e mesh.
+ *
+ * The mesh is recursively split by axis-aligned planes into parts, until
+ * the concavity of each part is at most \e maxConcavity, or until there
+ * are \e maxParts parts. The concavity of a part is the largest distance
+ * from a point on the mesh surface within the part, along the surface normal,
+ * to the boundary of the part's convex hull. At each step, the part with the
+ * largest concavity is split by the candidate plane which minimizes the
+ * larger concavity of the two resulting parts. Candidates are regularly
+ * spaced planes and the planes through the point of largest concavity.
+ *
+ * \param mesh the mesh to decompose. It should be closed.
+ * \param maxConcavity the maximum concavity accepted for each part, in
+ *    the units of the mesh vertices.
+ * \param maxParts the maximum number of convex parts.
+ * \return the convex hulls of all parts. There is at least one part if the
+ *    mesh is not flat.
+ */
+template<typename VP>
+std::vector<typename MeshData<VP, 3>::Ptr>
+ConvexDecomposition(const MeshData<VP, 3>& mesh,
+                    const double maxConcavity,
+                    const unsigned int maxParts = 16);
+
+}  // namespace
+
+#include <collision_benchmark/ConvexDecomposition-inl.hh>
+
+#endif  // COLLISION_BENCHMARK_CONVEXDECOMPOSITION_H
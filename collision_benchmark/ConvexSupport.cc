@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/ConvexSupport.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+#include <collision_benchmark/SimpleTriMeshShape.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <cmath>
+#include <limits>
+
+using collision_benchmark::ConvexSupport;
+using collision_benchmark::PrimitiveShape;
+using collision_benchmark::PrimitiveShapeParameters;
+using collision_benchmark::SimpleTriMeshShape;
+
+/////////////////////////////////////////////////////////////////////////////
+ConvexSupport::ConvexSupport():
+  type(Shape::SPHERE),
+  radius(0),
+  halfLength(0),
+  rot(ignition::math::Matrix3d::Identity),
+  rotT(ignition::math::Matrix3d::Identity)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+ConvexSupport::Ptr ConvexSupport::Create(const Shape::Ptr& shape)
+{
+  PrimitiveShape::Ptr prim = std::dynamic_pointer_cast<PrimitiveShape>(shape);
+  SimpleTriMeshShape::Ptr mesh =
+    std::dynamic_pointer_cast<SimpleTriMeshShape>(shape);
+  Ptr s;
+  if (prim)
+  {
+    s.reset(new ConvexSupport());
+    s->type = prim->GetType();
+    PrimitiveShapeParameters::Ptr params = prim->GetParams();
+    switch (s->type)
+    {
+      case Shape::BOX:
+        s->halfSize.Set(params->Get(PrimitiveShapeParameters::DIMX) / 2,
+                        params->Get(PrimitiveShapeParameters::DIMY) / 2,
+                        params->Get(PrimitiveShapeParameters::DIMZ) / 2);
+        break;
+      case Shape::SPHERE:
+        s->radius = params->Get(PrimitiveShapeParameters::RADIUS);
+        break;
+      case Shape::CYLINDER:
+        s->radius = params->Get(PrimitiveShapeParameters::RADIUS);
+        s->halfLength = params->Get(PrimitiveShapeParameters::LENGTH) / 2;
+        break;
+      default:
+        LOG_ERROR("shape", "ConvexSupport: Primitive type " << s->type
+                           << " is not supported");
+        return Ptr();
+    }
+  }
+  else if (mesh && mesh->GetMeshData())
+  {
+    s = Create(*mesh->GetMeshData());
+  }
+  if (!s)
+  {
+    LOG_ERROR("shape", "ConvexSupport: Shape of type " << shape->GetType()
+                       << " is not supported");
+    return Ptr();
+  }
+  s->SetPose(shape->GetPose());
+  return s;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void ConvexSupport::SetPose(const Pose3& pose_)
+{
+  pose = pose_;
+  rot = ignition::math::Matrix3d(pose.Rot());
+  rotT = rot.Transposed();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+ConvexSupport::Vector3 ConvexSupport::operator()(const Vector3& dir) const
+{
+  const Vector3 d = rotT * dir;
+  Vector3 s;
+  switch (type)
+  {
+    case Shape::SPHERE:
+    {
+      const double len = d.Length();
+      if (len > 0) s = d * (radius / len);
+      else s.Set(radius, 0, 0);
+      break;
+    }
+    case Shape::BOX:
+      s.Set(d.X() >= 0 ? halfSize.X() : -halfSize.X(),
+            d.Y() >= 0 ? halfSize.Y() : -halfSize.Y(),
+            d.Z() >= 0 ? halfSize.Z() : -halfSize.Z());
+      break;
+    case Shape::CYLINDER:
+    {
+      const double rho = std::sqrt(d.X() * d.X() + d.Y() * d.Y());
+      const double z = d.Z() >= 0 ? halfLength : -halfLength;
+      if (rho > 0) s.Set(radius * d.X() / rho, radius * d.Y() / rho, z);
+      else s.Set(0, 0, z);
+      break;
+    }
+    default:
+    {
+      double best = -std::numeric_limits<double>::max();
+      for (std::vector<Vector3>::const_iterator it = vertices.begin();
+           it != vertices.end(); ++it)
+      {
+        const double proj = it->Dot(d);
+        if (proj > best)
+        {
+          best = proj;
+          s = *it;
+        }
+      }
+    }
+  }
+  return rot * s + pose.Pos();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+ConvexSupport::Vector3 ConvexSupport::Center() const
+{
+  return rot * centroid + pose.Pos();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool collision_benchmark::ConvexSignedDistance(const ConvexSupport& a,
+                                               const ConvexSupport& b,
+                                               SignedDistanceResult& result)
+{
+  return GjkEpa(a, b, result);
+}
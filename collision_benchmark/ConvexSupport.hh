@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_CONVEXSUPPORT_H
+#define COLLISION_BENCHMARK_CONVEXSUPPORT_H
+
+#include <collision_benchmark/Shape.hh>
+#include <collision_benchmark/MeshData.hh>
+#include <collision_benchmark/GjkEpa.hh>
+
+#include <ignition/math/Matrix3.hh>
+
+#include <memory>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Support function of a convex shape placed at a pose, to be used
+ * as exact reference for distance and penetration queries with GjkEpa()
+ * and ConvexSignedDistance().
+ *
+ * Supported are spheres, boxes and cylinders (PrimitiveShape), and
+ * meshes, of which only the vertices are used: for a mesh which is not
+ * convex, the support function is the one of its convex hull.
+ */
+class ConvexSupport
+{
+  public: typedef std::shared_ptr<ConvexSupport> Ptr;
+  public: typedef std::shared_ptr<const ConvexSupport> ConstPtr;
+
+  public: typedef Shape::Pose3 Pose3;
+  public: typedef Shape::Vector3 Vector3;
+
+  // Creates the support function of \e shape, placed at the pose of the
+  // shape (Shape::GetPose()).
+  // \return NULL if \e shape is not a sphere, box, cylinder or mesh.
+  public: static Ptr Create(const Shape::Ptr& shape);
+
+  // Creates the support function of the convex hull of the vertices
+  // of \e mesh, placed at the identity pose.
+  // \return NULL if the mesh has no vertices.
+  public: template<typename VP>
+          static Ptr Create(const MeshData<VP, 3>& mesh);
+
+  public: virtual ~ConvexSupport() {}
+
+  // Places the shape at \e pose
+  public: void SetPose(const Pose3& pose);
+
+  public: const Pose3& GetPose() const { return pose; }
+
+  // Returns the point of the placed shape which is furthest in
+  // direction \e dir
+  public: Vector3 operator()(const Vector3& dir) const;
+
+  // Returns a point within the placed shape
+  public: Vector3 Center() const;
+
+  private: ConvexSupport();
+
+  private: Shape::Type type;
+  // radius of spheres and cylinders
+  private: double radius;
+  // half of the length of cylinders, which are aligned with the z axis
+  private: double halfLength;
+  // half of the size of boxes
+  private: Vector3 halfSize;
+  // vertices of meshes and their centroid
+  private: std::vector<Vector3> vertices;
+  private: Vector3 centroid;
+  // pose of the shape, and its rotation as matrix and transposed matrix
+  private: Pose3 pose;
+  private: ignition::math::Matrix3d rot;
+  private: ignition::math::Matrix3d rotT;
+};
+
+/**
+ * \brief Computes the signed distance between the convex shapes \e a and
+ * \e b at their current poses with GjkEpa().
+ *
+ * \param[out] result the signed distance, which is the negative
+ *    penetration depth if the shapes intersect, with the normal pointing
+ *    from \e a to \e b and the witness points.
+ * \return false if the algorithm did not converge, see GjkEpa().
+ */
+bool ConvexSignedDistance(const ConvexSupport& a, const ConvexSupport& b,
+                          SignedDistanceResult& result);
+
+/////////////////////////////////////////////////////////////////////////////
+template<typename VP>
+ConvexSupport::Ptr ConvexSupport::Create(const MeshData<VP, 3>& mesh)
+{
+  typedef MeshData<VP, 3> MeshDataT;
+  const std::vector<typename MeshDataT::Vertex>& verts = mesh.GetVertices();
+  if (verts.empty()) return Ptr();
+  Ptr s(new ConvexSupport());
+  s->type = Shape::MESH;
+  s->vertices.reserve(verts.size());
+  for (typename std::vector<typename MeshDataT::Vertex>::const_iterator
+       it = verts.begin(); it != verts.end(); ++it)
+  {
+    s->vertices.push_back(Vector3(it->X(), it->Y(), it->Z()));
+    s->centroid += s->vertices.back();
+  }
+  s->centroid /= s->vertices.size();
+  return s;
+}
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_CONVEXSUPPORT_H
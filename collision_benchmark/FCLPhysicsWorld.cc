@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/FCLPhysicsWorld.hh>
+#include <collision_benchmark/GazeboWorldState.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+#include <collision_benchmark/SimpleTriMeshShape.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <fcl/collision.h>
+#include <fcl/shape/geometric_shapes.h>
+#include <fcl/BVH/BVH_model.h>
+#include <fcl/BV/OBBRSS.h>
+
+#include <limits>
+#include <map>
+
+using collision_benchmark::FCLPhysicsWorld;
+using collision_benchmark::PrimitiveShape;
+using collision_benchmark::PrimitiveShapeParameters;
+using collision_benchmark::SimpleTriMeshShape;
+using collision_benchmark::ShapeModelState;
+
+// maximum number of contact points between two parts, the same as the
+// default of max_contacts in Gazebo
+static const std::size_t MaxContacts = 20;
+
+/////////////////////////////////////////////////////////////////////////////
+static fcl::Vec3f ToFCL(const ignition::math::Vector3d& v)
+{
+  return fcl::Vec3f(v.X(), v.Y(), v.Z());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+static fcl::Transform3f ToFCL(const ignition::math::Pose3d& p)
+{
+  return fcl::Transform3f(fcl::Quaternion3f(p.Rot().W(), p.Rot().X(),
+                                            p.Rot().Y(), p.Rot().Z()),
+                          ToFCL(p.Pos()));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+static ignition::math::Vector3d ToIgn(const fcl::Vec3f& v)
+{
+  return ignition::math::Vector3d(v[0], v[1], v[2]);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+FCLPhysicsWorld::FCLPhysicsWorld(const std::string& name_,
+                                 const double stepSize_):
+  ParentClass(name_, stepSize_)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+FCLPhysicsWorld::WorldState FCLPhysicsWorld::GetWorldState() const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  std::map<ModelID, ShapeModelState> modelStates;
+  for (ModelMap::const_iterator it = models.begin(); it != models.end(); ++it)
+  {
+    ShapeModelState& modelState = modelStates[it->first];
+    modelState.pose = it->second.pose;
+    modelState.scale = it->second.scale;
+  }
+  WorldState state;
+  if (!MakeShapeWorldState(name, simTime, iterations, modelStates,
+                           PartID(), state))
+  {
+    LOG_ERROR("physics", "World " << GetName()
+                         << ": Could not build the world state");
+  }
+  return state;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+FCLPhysicsWorld::WorldState
+FCLPhysicsWorld::GetWorldStateDiff(const WorldState& other) const
+{
+  return other - GetWorldState();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::OpResult
+FCLPhysicsWorld::SetWorldState(const WorldState& state, bool isDiff)
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  OpResult ret = SUCCESS;
+  for (std::vector<std::string>::const_iterator
+       it = state.Deletions().begin(); it != state.Deletions().end(); ++it)
+  {
+    RemoveModel(*it);
+  }
+  if (!state.Insertions().empty())
+  {
+    LOG_ERROR("physics", "World " << GetName() << ": Models can't be "
+                         << "inserted with the world state");
+    ret = NOT_SUPPORTED;
+  }
+
+  const gazebo::physics::ModelState_M& modelStates = state.GetModelStates();
+  for (gazebo::physics::ModelState_M::const_iterator
+       it = modelStates.begin(); it != modelStates.end(); ++it)
+  {
+    if (!SetModelPose(it->first, it->second.Pose(), it->second.Scale()))
+      ret = NOT_SUPPORTED;
+  }
+  simTime = state.GetSimTime().Double();
+  iterations = state.GetIterations();
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool FCLPhysicsWorld::GetAABB(const ModelID& id,
+                              Vector3& min, Vector3& max) const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  ModelMap::const_iterator m = models.find(id);
+  if (m == models.end()) return false;
+  const double inf = std::numeric_limits<double>::max();
+  min.Set(inf, inf, inf);
+  max.Set(-inf, -inf, -inf);
+  for (std::vector<Part>::const_iterator it = m->second.parts.begin();
+       it != m->second.parts.end(); ++it)
+  {
+    const fcl::AABB& aabb = it->object->getAABB();
+    min.Min(ToIgn(aabb.min_));
+    max.Max(ToIgn(aabb.max_));
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<FCLPhysicsWorld::ContactInfoPtr>
+FCLPhysicsWorld::GetContactInfo() const
+{
+  ContactAnomalies anomalies;
+  std::vector<ContactInfoPtr> ret;
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (ModelMap::const_iterator it1 = models.begin();
+         it1 != models.end(); ++it1)
+    {
+      ModelMap::const_iterator it2 = it1;
+      for (++it2; it2 != models.end(); ++it2)
+      {
+        Collide(it1, it2, ret, anomalies);
+      }
+    }
+  }
+  AddContactAnomalies(anomalies);
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<FCLPhysicsWorld::ContactInfoPtr>
+FCLPhysicsWorld::GetContactInfo(const ModelID& m1, const ModelID& m2) const
+{
+  ContactAnomalies anomalies;
+  std::vector<ContactInfoPtr> ret;
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    ModelMap::const_iterator it1 = models.find(m1);
+    ModelMap::const_iterator it2 = models.find(m2);
+    if ((it1 == models.end()) || (it2 == models.end()) || (it1 == it2))
+      return ret;
+    Collide(it1, it2, ret, anomalies);
+  }
+  AddContactAnomalies(anomalies);
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::OpResult
+FCLPhysicsWorld::CreateModel(const ModelID& id, ModelEntry& model)
+{
+  if (!CreateParts(model.GetCollisionShape(), model.scale, model.parts))
+    return NOT_SUPPORTED;
+  PlaceParts(model);
+  return SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool FCLPhysicsWorld::UpdateModel(const ModelID& id, ModelEntry& model,
+                                  const Vector3& oldScale)
+{
+  if (model.scale != oldScale)
+  {
+    // FCL geometries can't be scaled, so they are created again
+    std::vector<Part> parts;
+    if (!CreateParts(model.GetCollisionShape(), model.scale, parts))
+      return false;
+    model.parts = parts;
+  }
+  PlaceParts(model);
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool FCLPhysicsWorld::CreateParts(const Shape::Ptr& shape,
+                                  const Vector3& scale,
+                                  std::vector<Part>& parts)
+{
+  std::vector<Shape::Ptr> collParts;
+  std::vector<Pose3> poses;
+  GetCollisionParts(shape, collParts, poses);
+
+  for (unsigned int i = 0; i < collParts.size(); ++i)
+  {
+    boost::shared_ptr<fcl::CollisionGeometry> geometry =
+      CreateGeometry(collParts[i], scale);
+    if (!geometry) return false;
+    Part part;
+    part.pose = poses[i];
+    part.object.reset(new fcl::CollisionObject(geometry));
+    parts.push_back(part);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+boost::shared_ptr<fcl::CollisionGeometry>
+FCLPhysicsWorld::CreateGeometry(const Shape::Ptr& shape, const Vector3& scale)
+{
+  typedef boost::shared_ptr<fcl::CollisionGeometry> GeometryPtr;
+  PrimitiveShape::Ptr prim = std::dynamic_pointer_cast<PrimitiveShape>(shape);
+  SimpleTriMeshShape::Ptr mesh =
+    std::dynamic_pointer_cast<SimpleTriMeshShape>(shape);
+  if (prim)
+  {
+    PrimitiveShapeParameters::Ptr params = prim->GetParams();
+    switch (prim->GetType())
+    {
+      case Shape::BOX:
+        return GeometryPtr(new fcl::Box(
+          params->Get(PrimitiveShapeParameters::DIMX) * scale.X(),
+          params->Get(PrimitiveShapeParameters::DIMY) * scale.Y(),
+          params->Get(PrimitiveShapeParameters::DIMZ) * scale.Z()));
+      case Shape::SPHERE:
+        return GeometryPtr(new fcl::Sphere(
+          params->Get(PrimitiveShapeParameters::RADIUS) * scale.X()));
+      case Shape::CYLINDER:
+        return GeometryPtr(new fcl::Cylinder(
+          params->Get(PrimitiveShapeParameters::RADIUS) * scale.X(),
+          params->Get(PrimitiveShapeParameters::LENGTH) * scale.Z()));
+      case Shape::PLANE:
+      {
+        Vector3 n(params->Get(PrimitiveShapeParameters::VALX),
+                  params->Get(PrimitiveShapeParameters::VALY),
+                  params->Get(PrimitiveShapeParameters::VALZ));
+        const double len = n.Length();
+        if (len <= 0)
+        {
+          LOG_ERROR("physics", "Plane has no valid normal");
+          return GeometryPtr();
+        }
+        return GeometryPtr(new fcl::Halfspace(ToFCL(n / len),
+                           params->Get(PrimitiveShapeParameters::LENGTH) / len));
+      }
+      default:
+        LOG_ERROR("physics", "Unknown primitive type " << prim->GetType());
+        return GeometryPtr();
+    }
+  }
+
+  if (!mesh || !mesh->GetMeshData() ||
+      mesh->GetMeshData()->GetFaces().empty())
+  {
+    LOG_ERROR("physics", "FCLPhysicsWorld does not support shapes of "
+                         << "type " << shape->GetType());
+    return GeometryPtr();
+  }
+
+  typedef SimpleTriMeshShape::MeshDataT MeshDataT;
+  const MeshDataT& data = *mesh->GetMeshData();
+  std::vector<fcl::Vec3f> vertices;
+  vertices.reserve(data.GetVertices().size());
+  for (std::vector<MeshDataT::Vertex>::const_iterator
+       it = data.GetVertices().begin(); it != data.GetVertices().end(); ++it)
+  {
+    vertices.push_back(fcl::Vec3f(it->X() * scale.X(), it->Y() * scale.Y(),
+                                  it->Z() * scale.Z()));
+  }
+  std::vector<fcl::Triangle> triangles;
+  triangles.reserve(data.GetFaces().size());
+  for (std::vector<MeshDataT::Face>::const_iterator
+       it = data.GetFaces().begin(); it != data.GetFaces().end(); ++it)
+  {
+    triangles.push_back(fcl::Triangle((*it)[0], (*it)[1], (*it)[2]));
+  }
+  boost::shared_ptr<fcl::BVHModel<fcl::OBBRSS> >
+    model(new fcl::BVHModel<fcl::OBBRSS>());
+  model->beginModel(triangles.size(), vertices.size());
+  model->addSubModel(vertices, triangles);
+  model->endModel();
+  return model;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void FCLPhysicsWorld::PlaceParts(ModelEntry& model)
+{
+  for (std::vector<Part>::iterator it = model.parts.begin();
+       it != model.parts.end(); ++it)
+  {
+    const Pose3 partPose(it->pose.Pos() * model.scale, it->pose.Rot());
+    it->object->setTransform(ToFCL(partPose + model.pose));
+    it->object->computeAABB();
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void FCLPhysicsWorld::Collide(const ModelMap::const_iterator& m1,
+                              const ModelMap::const_iterator& m2,
+                              std::vector<ContactInfoPtr>& contacts,
+                              ContactAnomalies& anomalies) const
+{
+  const bool enableContact = true;
+  const fcl::CollisionRequest request(MaxContacts, enableContact);
+  ContactInfoPtr cInfo;
+  // FCL contact normals point from the first to the second object,
+  // the normals of the contact info from model1 to model2.
+  double normalSign = 1;
+  for (std::vector<Part>::const_iterator p1 = m1->second.parts.begin();
+       p1 != m1->second.parts.end(); ++p1)
+  {
+    for (std::vector<Part>::const_iterator p2 = m2->second.parts.begin();
+         p2 != m2->second.parts.end(); ++p2)
+    {
+      if (!p1->object->getAABB().overlap(p2->object->getAABB())) continue;
+      fcl::CollisionResult result;
+      if (fcl::collide(p1->object.get(), p2->object.get(),
+                       request, result) == 0) continue;
+      if (!cInfo)
+      {
+        cInfo.reset(new ContactInfo(m1->first, PartID(), m2->first, PartID()));
+        normalSign = (cInfo->model1 == m1->first) ? 1 : -1;
+      }
+      anomalies.numPoints += result.numContacts();
+      for (std::size_t i = 0; i < result.numContacts(); ++i)
+      {
+        const fcl::Contact& contact = result.getContact(i);
+        const double depth = contact.penetration_depth;
+        static const double tol = 1e-03;
+        if (depth < -tol)
+        {
+          anomalies.Add(ContactAnomalies::NEGATIVE_DEPTH,
+                        m1->first, m2->first, depth);
+          LOG_DEBUG("physics", "Negative contact depth found in world "
+                               << GetName() << ", depth = " << depth
+                               << ". Skipping contact.");
+          continue;
+        }
+        cInfo->contacts.push_back(
+          Contact(ToIgn(contact.pos), ToIgn(contact.normal) * normalSign,
+                  gazebo::physics::JointWrench(), depth));
+      }
+    }
+  }
+  if (!cInfo) return;
+
+  ++anomalies.numContacts;
+  if (cInfo->contacts.empty())
+  {
+    anomalies.Add(ContactAnomalies::ALL_POINTS_SKIPPED, m1->first, m2->first);
+    LOG_DEBUG("physics", "All contact points gotten from models "
+                         << m1->first << ", " << m2->first << " world "
+                         << GetName() << " skipped.");
+    return;
+  }
+  contacts.push_back(cInfo);
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_FCLPHYSICSWORLD_H
+#define COLLISION_BENCHMARK_FCLPHYSICSWORLD_H
+
+#include <collision_benchmark/GazeboPhysicsWorld.hh>
+#include <collision_benchmark/ShapePhysicsWorld.hh>
+
+#include <fcl/collision_object.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief FCL objects of a model in an FCLPhysicsWorld, in addition to the
+ * shape, pose and scale kept by ShapePhysicsWorld.
+ */
+struct FCLModelData
+{
+  // One collision part of a model
+  struct Part
+  {
+    // pose relative to the model, not scaled
+    Shape::Pose3 pose;
+    std::shared_ptr<fcl::CollisionObject> object;
+  };
+
+  std::vector<Part> parts;
+};
+
+/**
+ * \brief Collision-only PhysicsWorld which uses FCL for narrowphase
+ * queries, without Gazebo and without dynamics.
+ *
+ * It uses the same types as GazeboPhysicsWorld (GazeboPhysicsWorldTypes),
+ * so that it can be added to the same WorldManager and take part in the
+ * agreement tests of the Gazebo engines.
+ *
+ * Models can only be added with AddModelFromShape(). Supported are
+ * PrimitiveShape and SimpleTriMeshShape instances and shapes consisting of
+ * collision parts of these types (see Shape::GetCollisionParts()).
+ * Planes are half spaces, meshes are BVH models (OBBRSS).
+ *
+ * Contacts are computed when they are requested, so GetContactInfo() between
+ * two models is one FCL query per pair of parts, after checking their
+ * bounding boxes. Update() only advances the simulation time.
+ *
+ * World states are gazebo::physics::WorldState instances, built from the
+ * SDF of the state (see MakeShapeWorldState()). SetWorldState() applies
+ * model poses and deletions, but can't insert models.
+ *
+ * This is written against the API of FCL 0.5.
+ */
+class FCLPhysicsWorld:
+  public ShapePhysicsWorld<PhysicsWorld<GazeboPhysicsWorldTypes::WorldState,
+                                        GazeboPhysicsWorldTypes::ModelID,
+                                        GazeboPhysicsWorldTypes::ModelPartID,
+                                        GazeboPhysicsWorldTypes::Vector3,
+                                        GazeboPhysicsWorldTypes::Wrench>,
+                           FCLModelData>
+{
+  private: typedef ShapePhysicsWorld<
+             PhysicsWorld<GazeboPhysicsWorldTypes::WorldState,
+                          GazeboPhysicsWorldTypes::ModelID,
+                          GazeboPhysicsWorldTypes::ModelPartID,
+                          GazeboPhysicsWorldTypes::Vector3,
+                          GazeboPhysicsWorldTypes::Wrench>,
+             FCLModelData> ParentClass;
+
+  public: typedef std::shared_ptr<FCLPhysicsWorld> Ptr;
+  public: typedef std::shared_ptr<const FCLPhysicsWorld> ConstPtr;
+
+  public: typedef ParentClass::ModelID ModelID;
+  public: typedef ParentClass::WorldState WorldState;
+  public: typedef ParentClass::Vector3 Vector3;
+  public: typedef ParentClass::Contact Contact;
+  public: typedef ParentClass::ContactInfo ContactInfo;
+  public: typedef ParentClass::ContactInfoPtr ContactInfoPtr;
+  public: typedef ParentClass::ContactAnomalies ContactAnomalies;
+  public: typedef ParentClass::Shape Shape;
+  public: typedef ParentClass::ModelLoadResult ModelLoadResult;
+  public: typedef Shape::Pose3 Pose3;
+
+  // \param name the name of the world
+  // \param stepSize the time (seconds) which passes in one step of Update()
+  public: FCLPhysicsWorld(const std::string& name = "fcl_world",
+                          const double stepSize = 0.001);
+  public: virtual ~FCLPhysicsWorld() {}
+
+  public: virtual WorldState GetWorldState() const;
+
+  public: virtual WorldState GetWorldStateDiff(const WorldState& other) const;
+
+  // \retval NOT_SUPPORTED \e state contains insertions or models
+  //    which are not in the world. All other changes are still applied.
+  public: virtual OpResult SetWorldState(const WorldState& state,
+                                         bool isDiff = false);
+
+  // The bounding box of models containing a plane is unbounded.
+  public: virtual bool GetAABB(const ModelID& id,
+                               Vector3& min, Vector3& max) const;
+
+  public: virtual std::vector<ContactInfoPtr> GetContactInfo() const;
+
+  public: virtual std::vector<ContactInfoPtr>
+                  GetContactInfo(const ModelID& m1, const ModelID& m2) const;
+
+  // \retval NOT_SUPPORTED a collision part is of an unsupported type
+  protected: virtual OpResult CreateModel(const ModelID& id,
+                                          ModelEntry& model);
+
+  // The scale is applied to the geometries and to the positions of the
+  // collision parts. Spheres are scaled by x, cylinders by x (radius)
+  // and z (length), planes are not scaled.
+  protected: virtual bool UpdateModel(const ModelID& id, ModelEntry& model,
+                                      const Vector3& oldScale);
+
+  private: typedef FCLModelData::Part Part;
+
+  // Creates the parts of \e shape scaled by \e scale, without placing them.
+  // \return false if a collision part is not supported
+  private: static bool CreateParts(const Shape::Ptr& shape,
+                                   const Vector3& scale,
+                                   std::vector<Part>& parts);
+
+  // Creates the FCL geometry of a shape which has no collision parts,
+  // scaled by \e scale.
+  // \return the geometry, or NULL if it is not supported
+  private: static boost::shared_ptr<fcl::CollisionGeometry>
+                  CreateGeometry(const Shape::Ptr& shape, const Vector3& scale);
+
+  // Places all parts of \e model at the model pose
+  private: static void PlaceParts(ModelEntry& model);
+
+  // Computes the contacts between all parts of \e m1 and \e m2 and
+  // adds them to \e contacts, if there are any.
+  private: void Collide(const ModelMap::const_iterator& m1,
+                        const ModelMap::const_iterator& m2,
+                        std::vector<ContactInfoPtr>& contacts,
+                        ContactAnomalies& anomalies) const;
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_FCLPHYSICSWORLD_H
@@ -21,6 +21,7 @@
 #include <collision_benchmark/GazeboControlServer.hh>
 #include <collision_benchmark/Exception.hh>
 #include <collision_benchmark/BasicTypes.hh>
+#include <collision_benchmark/Logger.hh>
 
 #include <gazebo/transport/TransportIface.hh>
 
@@ -65,61 +66,61 @@ BasicState GetModelChangeState(const gazebo::msgs::Model &_msg)
   // model itself
   if (_msg.link_size() > 0)
   {
-    std::cout<<"WARNING: GazeboControlServer is ignoring model "
-      <<"message link field. Not supported."<<std::endl;
+    LOG_WARN("control", "GazeboControlServer is ignoring model "
+                        <<"message link field. Not supported.");
   }
 
   // cannot support nested models at this point, only changes for
   // model itself
   if (_msg.model_size() > 0)
   {
-    std::cout<<"WARNING: GazeboControlServer is ignoring model "
-      <<"message model field. Not supported."<<std::endl;
+    LOG_WARN("control", "GazeboControlServer is ignoring model "
+                        <<"message model field. Not supported.");
   }
 
   // cannot support is_static as it's not part of ModelState
   if (_msg.has_is_static())
   {
-    std::cout<<"WARNING: GazeboControlServer is ignoring model "
-      <<"message is_static field. Not supported."<<std::endl;
+    LOG_WARN("control", "GazeboControlServer is ignoring model "
+                        <<"message is_static field. Not supported.");
   }
 
   // cannot support enable_wind as it's not part of ModelState
   if (_msg.has_enable_wind())
   {
-    std::cout<<"WARNING: GazeboControlServer is ignoring model "
-      <<"message enable_wind field. Not supported."<<std::endl;
+    LOG_WARN("control", "GazeboControlServer is ignoring model "
+                        <<"message enable_wind field. Not supported.");
   }
 
   // cannot support joint as it's not part of ModelState
   if (_msg.joint_size() > 0)
   {
-    std::cout<<"WARNING: GazeboControlServer is ignoring model "
-      <<"message joint field. Not supported."<<std::endl;
+    LOG_WARN("control", "GazeboControlServer is ignoring model "
+                        <<"message joint field. Not supported.");
   }
   // cannot support deleted as it's not part of ModelState
   if (_msg.has_deleted())
   {
-    std::cout<<"WARNING: GazeboControlServer is ignoring model "
-      <<"message deleted field. Not supported."<<std::endl;
+    LOG_WARN("control", "GazeboControlServer is ignoring model "
+                        <<"message deleted field. Not supported.");
   }
   // cannot support visual as it's not part of ModelState
   if (_msg.visual_size() > 0)
   {
-    std::cout<<"WARNING: GazeboControlServer is ignoring model "
-      <<"message visual field. Not supported."<<std::endl;
+    LOG_WARN("control", "GazeboControlServer is ignoring model "
+                        <<"message visual field. Not supported.");
   }
   // cannot support self_collide as it's not part of ModelState
   if (_msg.has_self_collide())
   {
-    std::cout<<"WARNING: GazeboControlServer is ignoring model "
-      <<"message self_collide field. Not supported."<<std::endl;
+    LOG_WARN("control", "GazeboControlServer is ignoring model "
+                        <<"message self_collide field. Not supported.");
   }
   // cannot support plugin as it's not part of ModelState
   if (_msg.plugin_size() > 0)
   {
-    std::cout<<"WARNING: GazeboControlServer is ignoring model "
-      <<"message plugin field. Not supported."<<std::endl;
+    LOG_WARN("control", "GazeboControlServer is ignoring model "
+                        <<"message plugin field. Not supported.");
   }
   return state;
 }
@@ -227,8 +228,8 @@ void GazeboControlServer::OnUserCmd
 
       if (_msg->light_size() > 0)
       {
-        std::cout<<"WARNING: GazeboControlServer is ignoring light "
-          <<"modification field in user command. Not supported."<<std::endl;
+        LOG_WARN("control", "GazeboControlServer is ignoring light "
+                 << "modification field in user command. Not supported.");
       }
       break;
     }
@@ -290,9 +291,9 @@ void GazeboControlServer::OnPhysics
   if (!_msg->has_enable_physics() &&
       !_msg->has_gravity())
   {
-    std::cout << "Only 'enable_physics' and 'gravity' fields "
-              << "of msgs::Physics messages can be forwarded, "
-              << "but none of those fields are set." <<std::endl;
+    LOG_INFO("control", "Only 'enable_physics' and 'gravity' fields "
+                        << "of msgs::Physics messages can be forwarded, "
+                        << "but none of those fields are set.");
     return;
   }
   if (_msg->has_enable_physics())
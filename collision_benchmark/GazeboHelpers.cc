@@ -175,11 +175,41 @@ int collision_benchmark::isProperSDFString(const std::string& string,
 }
 
 
+/////////////////////////////////////////////////
+bool collision_benchmark::hasOuterSDFTag(const std::string& str)
+{
+  std::string::size_type pos = 0;
+  while (true)
+  {
+    pos = str.find_first_not_of(" \t\r\n", pos);
+    if ((pos == std::string::npos) || (str[pos] != '<')) return false;
+
+    std::string::size_type end;
+    if (str.compare(pos, 2, "<?") == 0)
+      end = str.find("?>", pos);
+    else if (str.compare(pos, 4, "<!--") == 0)
+      end = str.find("-->", pos);
+    else if (str.compare(pos, 2, "<!") == 0)
+      end = str.find(">", pos);
+    else
+      break;
+
+    if (end == std::string::npos) return false;
+    pos = str.find('>', end) + 1;
+  }
+
+  // the tag name has to end after "sdf"
+  static const std::string sdfTag = "<sdf";
+  if (str.compare(pos, sdfTag.size(), sdfTag) != 0) return false;
+  pos += sdfTag.size();
+  return (pos < str.size()) &&
+         (std::string(" \t\r\n/>").find(str[pos]) != std::string::npos);
+}
+
 void collision_benchmark::wrapSDF(std::string& sdf)
 {
-  std::stringstream mod;
-  mod << "<sdf version='1.6'>" << sdf << "</sdf>";
-  sdf = std::string(mod.str());
+  sdf.insert(0, "<sdf version='1.6'>");
+  sdf.append("</sdf>");
 }
 
 void collision_benchmark::wrapSDF(std::vector<std::string>& sdfs)
@@ -89,6 +89,15 @@ int isProperSDFFile(const std::string& filename, std::string* version=NULL);
  */
 int isProperSDFString(const std::string& str, std::string* version=NULL);
 
+/**
+ * Checks whether the first element in the XML string \e str is an outer
+ * ``<sdf>`` tag. Unlike isProperSDFString(), this does not parse the string,
+ * it only skips leading whitespace, the XML declaration and comments.
+ * It is meant to be used before the string is parsed by sdformat,
+ * which requires an outer ``<sdf>`` tag and checks its version.
+ */
+bool hasOuterSDFTag(const std::string& str);
+
 /**
  * Helper function which fixes the SDF format in the string, aimed at being part
  * of the WorldState's <insertions> or <deletions>.
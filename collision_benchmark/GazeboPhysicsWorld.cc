@@ -26,6 +26,8 @@
 #include <collision_benchmark/GazeboHelpers.hh>
 #include <collision_benchmark/GazeboWorldLoader.hh>
 #include <collision_benchmark/Helpers.hh>
+#include <collision_benchmark/Logger.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
 #include <collision_benchmark/boost_std_conversion.hh>
 
 #include <gazebo/physics/physics.hh>
@@ -33,14 +35,74 @@
 
 #include <boost/filesystem.hpp>
 #include <algorithm>
+#include <map>
+#include <mutex>
+#include <sstream>
 
 using collision_benchmark::GazeboPhysicsWorld;
 using collision_benchmark::Contact;
 using collision_benchmark::ContactInfo;
+using collision_benchmark::PrimitiveShape;
+
+// Returns \e modelname if it is not empty, otherwise the name of the
+// model \e sdf, or an empty string if it has no name.
+static std::string GetSDFModelName(const sdf::ElementPtr& sdf,
+                                   const std::string& modelname)
+{
+  if (!modelname.empty() || !sdf) return modelname;
+  sdf::ParamPtr name = sdf->GetAttribute("name");
+  return name ? name->GetAsString() : "";
+}
+
+// Process-wide cache of the model SDF built for primitive shapes in
+// GazeboPhysicsWorld::GetShapeModelSDF(), keyed by the signature of the
+// primitive. The models only differ in name and pose, so a copy of
+// the cached model with these two values replaced is used.
+class ShapeSDFTemplateCache
+{
+  public: static ShapeSDFTemplateCache& Instance()
+  {
+    static ShapeSDFTemplateCache cache;
+    return cache;
+  }
+
+  // Returns a copy of the template for \e signature, or NULL if there is
+  // none yet.
+  public: sdf::ElementPtr Get(const std::string& signature)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::map<std::string, sdf::ElementPtr>::const_iterator it =
+      this->templates.find(signature);
+    if (it == this->templates.end()) return sdf::ElementPtr();
+    return it->second->Clone();
+  }
+
+  // Adds a copy of \e model as template for \e signature, unless the
+  // maximum number of templates has been reached.
+  public: void Add(const std::string& signature,
+                   const sdf::ElementPtr& model)
+  {
+    // shapes with random dimensions would otherwise fill up the memory
+    const unsigned int maxTemplates = 1000;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->templates.size() >= maxTemplates) return;
+    if (this->templates.count(signature) == 0)
+      this->templates[signature] = model->Clone();
+  }
+
+  private: ShapeSDFTemplateCache() {}
+
+  private: std::map<std::string, sdf::ElementPtr> templates;
+  private: std::mutex mutex;
+};
 
 GazeboPhysicsWorld::GazeboPhysicsWorld(bool _enforceContactComputation)
   : enforceContactComputation(_enforceContactComputation),
-    paused(false)
+    paused(false),
+    updateSection(Profiler::MAX_SECTIONS),
+    setStateSection(Profiler::MAX_SECTIONS),
+    contactsSection(Profiler::MAX_SECTIONS),
+    recycleModels(false)
 {
 }
 
@@ -54,18 +116,19 @@ bool GazeboPhysicsWorld::SupportsSDF() const
 }
 
 bool GazeboPhysicsWorld::WaitForNamespace
-      (const gazebo::physics::WorldPtr& gzworld, float maxWait, float waitSleep)
+      (const gazebo::physics::WorldPtr& gzworld, float maxWait,
+       float waitSleep)
 {
   std::string worldNamespace = gzworld->Name();
 
   // wait for namespace to be loaded, to make sure the order of
   // namespaces maintained in the transport system eventually will correspond
   // to the same order of the worlds
-  if (!collision_benchmark::WaitForNamespace(worldNamespace,
-                                             maxWait, waitSleep))
+  if (!collision_benchmark::WaitForNamespace(worldNamespace, maxWait,
+                                             waitSleep))
   {
-    std::cerr << "Namespace of world '" << worldNamespace
-              << "' was not loaded" << std::endl;
+    LOG_ERROR("physics", "Namespace of world '" << worldNamespace
+                         << "' was not loaded");
     return false;
   }
   return true;
@@ -151,8 +214,8 @@ bool CopyAllResourcesHelper(const sdf::ElementPtr& elem,
         if (!uriElem->GetValue() ||
             (uriElem->GetValue()->GetTypeName() != "string"))
         {
-          std::cerr << "URI has no value or is not of expected string type"
-                    << std::endl;
+          LOG_ERROR("physics",
+                    "URI has no value or is not of expected string type");
           continue;
         }
 
@@ -171,16 +234,16 @@ bool CopyAllResourcesHelper(const sdf::ElementPtr& elem,
         if (!collision_benchmark::makeDirectoryIfNeeded
                                                  (fullDestinationDir.native()))
         {
-          std::cerr << "Could not create directory "
-                    << fullDestinationDir << std::endl;
+          LOG_ERROR("physics", "Could not create directory "
+                               << fullDestinationDir);
           return false;
         }
         // find the file in the existing GAZEBO_RESOURCE_PATH
         boost::filesystem::path filename = gazebo::common::find_file(uri);
         if (filename.empty())
         {
-          std::cerr << "Could not find file " << uri << " in gazebo paths. "
-                    << std::endl;
+          LOG_ERROR("physics", "Could not find file " << uri
+                               << " in gazebo paths.");
           return false;
         }
         // full filename path in destination:
@@ -190,26 +253,27 @@ bool CopyAllResourcesHelper(const sdf::ElementPtr& elem,
         // We could use boost::filesystem::copy_option::overwrite_if_exists
         // instead to force overwriting, maybe add this as a parameter later
         // on. For now, we're conservative and keep existing files.
-        std::cout << "Copy file from " << filename.string()
-                  << " to " << fullDestinationFile << std::endl;
+        LOG_INFO("physics", "Copy file from " << filename.string()
+                            << " to " << fullDestinationFile);
         boost::system::error_code err;
         boost::filesystem::copy_file(filename, fullDestinationFile,
                         boost::filesystem::copy_option::fail_if_exists, err);
         if (err.value() != boost::system::errc::success)
         {
           bool exists = err.value() == boost::system::errc::file_exists;
-          if (exists) std::cerr << "WARNING: ";
-          else std::cerr << "ERROR: ";
-          std::cerr << "Could not copy file from " << filename.string()
-                    << " to " << fullDestinationFile;
           if (exists)
           {
-            std::cerr << " because file exists. Keeping existing file. "
-                      << std::endl;
+            LOG_WARN("physics", "Could not copy file from "
+                                << filename.string() << " to "
+                                << fullDestinationFile << " because file "
+                                << "exists. Keeping existing file.");
           }
           else
           { // fatal error
-            std::cerr << ". Error: " << err.message() << std::endl;
+            LOG_ERROR("physics", "Could not copy file from "
+                                 << filename.string() << " to "
+                                 << fullDestinationFile << ". Error: "
+                                 << err.message());
             return false;
           }
         }
@@ -247,9 +311,8 @@ bool GazeboPhysicsWorld::CopyAllModelResources(const sdf::ElementPtr& elem,
     if (!CopyAllResourcesHelper(modelElem, parentElemNames,
                                 destinationBase, destinationSubdir))
     {
-      std::cerr << "Could not replace URI resource in model "
-                << modelElem->GetAttribute("name")->GetAsString()
-                << std::endl;
+      LOG_ERROR("physics", "Could not replace URI resource in model "
+                           << modelElem->GetAttribute("name")->GetAsString());
       return false;
     }
     // recurse into nested models
@@ -257,9 +320,8 @@ bool GazeboPhysicsWorld::CopyAllModelResources(const sdf::ElementPtr& elem,
         !CopyAllModelResources(modelElem, parentElemNames,
                                destinationBase, destinationSubdir))
     {
-      std::cerr << "Could not replace URI resource in nested model "
-                << modelElem->GetAttribute("name")->GetAsString()
-                << std::endl;
+      LOG_ERROR("physics", "Could not replace URI resource in nested model "
+                           << modelElem->GetAttribute("name")->GetAsString());
       return false;
     }
   }
@@ -283,13 +345,13 @@ bool GazeboPhysicsWorld::SaveToFile(const std::string& filename,
     fpath = fpath.parent_path();
     if (!collision_benchmark::makeDirectoryIfNeeded(fpath.string()))
     {
-      std::cerr << "Unable to make directory for " << filename << std::endl;
+      LOG_ERROR("physics", "Unable to make directory for " << filename);
       return false;
     }
     out.open(filename.c_str(), std::ios::out);
     if (!out.is_open())
     {
-      std::cerr << "Unable to write file " << filename << std::endl;
+      LOG_ERROR("physics", "Unable to write file " << filename);
       return false;
     }
   }
@@ -297,13 +359,13 @@ bool GazeboPhysicsWorld::SaveToFile(const std::string& filename,
   sdf::ElementPtr sdf = world->GetSDF();
   if (!sdf)
   {
-    std::cerr << "Could not get SDF of world" << std::endl;
+    LOG_ERROR("physics", "Could not get SDF of world");
     return false;
   }
 
   if (!sdf->HasElement("world"))
   {
-    std::cerr << "Missing SDF 'world' element" << std::endl;
+    LOG_ERROR("physics", "Missing SDF 'world' element");
     return false;
   }
   if (!resourceDir.empty())
@@ -334,7 +396,7 @@ GazeboPhysicsWorld::AddModelFromFile(const std::string& filename,
   ret.opResult=FAILED;
   if (!sdfRoot)
   {
-    std::cerr<< " Could not get SDF for model in "<<filename<<std::endl;
+    LOG_ERROR("physics", "Could not get SDF for model in " << filename);
     return ret;
   }
 
@@ -349,27 +411,21 @@ GazeboPhysicsWorld::AddModelFromString(const std::string& str,
   ModelLoadResult ret;
   ret.opResult=FAILED;
 
-  std::string useStr=str;
-  int checkSDF=collision_benchmark::isProperSDFString(useStr);
-  if (checkSDF<0)
+  // The string is parsed only once, by sdformat, which also checks the
+  // version in the outer <sdf> tag. Beforehand, only the presence of the
+  // tag is checked so that it is only copied if the tag has to be added.
+  std::string wrapped;
+  if (!collision_benchmark::hasOuterSDFTag(str))
   {
-    if (checkSDF==-2)
-    {
-      collision_benchmark::wrapSDF(useStr);
-    }
-    else
-    {
-      std::cerr<<"SDF is not proper so cannot load model from the string. "
-               <<"Value: "<<checkSDF<<std::endl;
-      return ret;
-    }
+    wrapped = str;
+    collision_benchmark::wrapSDF(wrapped);
   }
 
-  sdf::ElementPtr sdfRoot =
-    collision_benchmark::GetSDFElementFromString(useStr, "model", modelname);
+  sdf::ElementPtr sdfRoot = collision_benchmark::GetSDFElementFromString
+    (wrapped.empty() ? str : wrapped, "model", modelname);
   if (!sdfRoot)
   {
-    std::cerr<< " Could not get SDF for model."<<std::endl;
+    LOG_ERROR("physics", "Could not get SDF for model.");
     return ret;
   }
 
@@ -382,6 +438,8 @@ GazeboPhysicsWorld::ModelLoadResult
 GazeboPhysicsWorld::AddModelFromSDF(const sdf::ElementPtr& sdf,
                                     const std::string& modelname)
 {
+  if (!recycledModels.empty())
+    DropRecycledModel(GetSDFModelName(sdf, modelname));
   gazebo::physics::ModelPtr model =
     collision_benchmark::LoadModelFromSDF(sdf, world, modelname);
   ModelLoadResult ret;
@@ -412,6 +470,26 @@ GazeboPhysicsWorld::GetMeshOutputPath(std::string& outputSubdir) const
 }
 
 
+std::vector<GazeboPhysicsWorld::ModelLoadResult>
+GazeboPhysicsWorld::AddModelsFromSDF(const std::vector<sdf::ElementPtr>& sdfs,
+                                     const std::vector<std::string>& modelnames)
+{
+  for (unsigned int i = 0; !recycledModels.empty() && (i < sdfs.size()); ++i)
+  {
+    DropRecycledModel(GetSDFModelName(sdfs[i], modelnames.empty() ?
+                                               "" : modelnames[i]));
+  }
+  std::vector<gazebo::physics::ModelPtr> models =
+    collision_benchmark::LoadModelsFromSDF(sdfs, world, modelnames);
+  std::vector<ModelLoadResult> ret(models.size());
+  for (unsigned int i = 0; i < models.size(); ++i)
+  {
+    ret[i].opResult = models[i] ? SUCCESS : FAILED;
+    if (models[i]) ret[i].modelID = models[i]->GetName();
+  }
+  return ret;
+}
+
 GazeboPhysicsWorld::ModelLoadResult
 GazeboPhysicsWorld::AddModelFromShape(const std::string& modelname,
                                       const Shape::Ptr& shape,
@@ -420,12 +498,123 @@ GazeboPhysicsWorld::AddModelFromShape(const std::string& modelname,
   ModelLoadResult ret;
   ret.opResult=FAILED;
 
+  const std::string signature =
+    recycleModels ? GetPrimitiveSignature(shape, collShape) : "";
+  if (!signature.empty())
+  {
+    gazebo::physics::ModelPtr m =
+      ReuseModel(modelname, signature, shape->GetPose());
+    if (m)
+    {
+      ret.opResult=SUCCESS;
+      ret.modelID=m->GetName();
+      return ret;
+    }
+  }
+
+  sdf::ElementPtr root = GetShapeModelSDF(modelname, shape, collShape);
+  if (!root) return ret;
+  ret = AddModelFromSDF(root);
+  if (!signature.empty() && (ret.opResult == SUCCESS))
+    modelSignatures[ret.modelID] = signature;
+  return ret;
+}
+
+std::vector<GazeboPhysicsWorld::ModelLoadResult>
+GazeboPhysicsWorld::AddModelsFromShape(const std::vector<ShapeModel>& models)
+{
+  std::vector<ModelLoadResult> ret(models.size());
+  for (unsigned int i = 0; i < ret.size(); ++i) ret[i].opResult = FAILED;
+
+  // re-use recycled models and build the SDF of all other models,
+  // then add the ones which could be built
+  std::vector<std::string> signatures(models.size());
+  std::vector<sdf::ElementPtr> sdfs;
+  std::vector<unsigned int> sdfIdx;
+  for (unsigned int i = 0; i < models.size(); ++i)
+  {
+    if (recycleModels)
+    {
+      signatures[i] = GetPrimitiveSignature(models[i].shape,
+                                            models[i].collShape);
+    }
+    if (!signatures[i].empty())
+    {
+      gazebo::physics::ModelPtr m = ReuseModel(models[i].modelname,
+                                               signatures[i],
+                                               models[i].shape->GetPose());
+      if (m)
+      {
+        ret[i].opResult = SUCCESS;
+        ret[i].modelID = m->GetName();
+        continue;
+      }
+    }
+    sdf::ElementPtr root = GetShapeModelSDF(models[i].modelname,
+                                            models[i].shape,
+                                            models[i].collShape);
+    if (!root) continue;
+    sdfs.push_back(root);
+    sdfIdx.push_back(i);
+  }
+
+  std::vector<ModelLoadResult> sdfRet = AddModelsFromSDF(sdfs);
+  for (unsigned int i = 0; i < sdfRet.size(); ++i)
+  {
+    const unsigned int idx = sdfIdx[i];
+    ret[idx] = sdfRet[i];
+    if (!signatures[idx].empty() && (sdfRet[i].opResult == SUCCESS))
+      modelSignatures[sdfRet[i].modelID] = signatures[idx];
+  }
+  return ret;
+}
+
+std::string
+GazeboPhysicsWorld::GetPrimitiveSignature(const Shape::Ptr& shape,
+                                          const Shape::Ptr& collShape)
+{
+  PrimitiveShape::Ptr primitive =
+    std::dynamic_pointer_cast<PrimitiveShape>(shape);
+  if (!primitive || (collShape && (collShape != shape))) return "";
+  return primitive->GetSignature();
+}
+
+sdf::ElementPtr
+GazeboPhysicsWorld::GetShapeModelSDF(const std::string& modelname,
+                                     const Shape::Ptr& shape,
+                                     const Shape::Ptr& collShape) const
+{
   if (modelname.empty())
   {
-    std::cerr << "World " << GetName() << ": Must specify model name"
-              << std::endl;
-    return ret;
+    LOG_ERROR("physics", "World " << GetName() << ": Must specify model name");
+    return sdf::ElementPtr();
+  }
+
+  // Primitives which are also used as collision shape are built only once
+  // for each signature. If a separate collision shape is given, the
+  // model is always built.
+  const std::string signature = GetPrimitiveSignature(shape, collShape);
+  if (signature.empty())
+    return BuildShapeModelSDF(modelname, shape, collShape);
+
+  sdf::ElementPtr root = ShapeSDFTemplateCache::Instance().Get(signature);
+  if (!root)
+  {
+    root = BuildShapeModelSDF(modelname, shape, collShape);
+    if (root) ShapeSDFTemplateCache::Instance().Add(signature, root);
+    return root;
   }
+  root->GetAttribute("name")->SetFromString(modelname);
+  root->GetElement("pose")->Set(shape->GetPose());
+  return root;
+}
+
+sdf::ElementPtr
+GazeboPhysicsWorld::BuildShapeModelSDF(const std::string& modelname,
+                                       const Shape::Ptr& shape,
+                                       const Shape::Ptr& collShape) const
+{
+  sdf::ElementPtr ret;
 
   // Build the SDF
   sdf::ElementPtr root(new sdf::Element());
@@ -451,8 +640,7 @@ GazeboPhysicsWorld::AddModelFromShape(const std::string& modelname,
   if (std::find(gzSysPaths.begin(), gzSysPaths.end(), outputPath)
         == gzSysPaths.end())
   {
-    std::cout << "Adding path " << outputPath << " to Gazebo paths"
-              << std::endl;
+    LOG_INFO("physics", "Adding path " << outputPath << " to Gazebo paths");
     gazebo::common::SystemPaths::Instance()->AddGazeboPaths(outputPath);
   }
 
@@ -463,6 +651,35 @@ GazeboPhysicsWorld::AddModelFromShape(const std::string& modelname,
   visual->InsertElement(shapeGeom);
   link->InsertElement(visual);
 
+  // shapes consisting of several collision geometries, e.g. a convex
+  // decomposition, get one collision element per part
+  std::vector<Shape::Ptr> collParts =
+    collShape ? collShape->GetCollisionParts() : shape->GetCollisionParts();
+  if (!collParts.empty())
+  {
+    for (unsigned int i = 0; i < collParts.size(); ++i)
+    {
+      sdf::ElementPtr partColl =
+        collParts[i]->GetShapeSDF(true, outputPath, outputSubdir);
+      if (!partColl)
+      {
+        LOG_ERROR("physics", "Could not construct SDF for collision part "
+                             << i);
+        return ret;
+      }
+      std::stringstream collName;
+      collName << "collision_" << i;
+      sdf::ElementPtr collision(new sdf::Element());
+      collision->SetName("collision");
+      collision->AddAttribute("name", "string", collName.str(),
+                              true, "collision name");
+      collision->InsertElement(collParts[i]->GetPoseSDF());
+      collision->InsertElement(partColl);
+      link->InsertElement(collision);
+    }
+    return root;
+  }
+
   sdf::ElementPtr shapeColl;
   if (collShape)
   {
@@ -479,7 +696,7 @@ GazeboPhysicsWorld::AddModelFromShape(const std::string& modelname,
 
   if (!shapeColl)
   {
-    std::cerr << "Could not construct collision shape SDF" << std::endl;
+    LOG_ERROR("physics", "Could not construct collision shape SDF");
     return ret;
   }
 
@@ -490,7 +707,7 @@ GazeboPhysicsWorld::AddModelFromShape(const std::string& modelname,
   collision->InsertElement(shapeColl);
   link->InsertElement(collision);
 
-  return AddModelFromSDF(root);
+  return root;
 }
 
 std::vector<GazeboPhysicsWorld::ModelID>
@@ -501,6 +718,7 @@ GazeboPhysicsWorld::GetAllModelIDs() const
   for (int i=0; i<numModels; ++i)
   {
     gazebo::physics::ModelPtr m=world->ModelByIndex(i);
+    if (recycledModels.count(m->GetName())) continue;
     names.push_back(m->GetName());
   }
   return names;
@@ -508,27 +726,144 @@ GazeboPhysicsWorld::GetAllModelIDs() const
 
 int GazeboPhysicsWorld::GetIntegerModelID(const ModelID& id) const
 {
-  gazebo::physics::ModelPtr m=world->ModelByName(id);
+  gazebo::physics::ModelPtr m=GetGzModel(id);
   if (!m) return -1;
   return m->GetId();
 }
 
 bool GazeboPhysicsWorld::RemoveModel(const ModelID& id)
 {
-  gazebo::physics::ModelPtr m=world->ModelByName(id);
+  gazebo::physics::ModelPtr m=GetGzModel(id);
   if (!m) return false;
-  world->RemoveModel(m);
+  RecycleOrRemoveModel(m);
   return true;
 }
 
 void GazeboPhysicsWorld::Clear()
 {
-  collision_benchmark::ClearModels(world);
+  if (!recycleModels)
+  {
+    collision_benchmark::ClearModels(world);
+    modelSignatures.clear();
+    recycledModels.clear();
+    return;
+  }
+
+  bool pauseState = world->IsPaused();
+  world->SetPaused(true);
+  gazebo::physics::Model_V models = world->Models();
+  for (gazebo::physics::Model_V::iterator it = models.begin();
+       it != models.end(); ++it)
+  {
+    if (recycledModels.count((*it)->GetName())) continue;
+    RecycleOrRemoveModel(*it);
+  }
+  // as in ClearModels(), stop the physics engine from
+  // publishing old contact points
+  gazebo::physics::PhysicsEnginePtr physics = world->Physics();
+  if (physics) physics->GetContactManager()->Clear();
+  world->SetPaused(pauseState);
+}
+
+void GazeboPhysicsWorld::SetRecycleModels(const bool flag)
+{
+  recycleModels = flag;
+  if (recycleModels) return;
+  for (std::map<std::string, std::pair<std::string,
+                gazebo::physics::ModelPtr> >::iterator
+       it = recycledModels.begin(); it != recycledModels.end(); ++it)
+  {
+    world->RemoveModel(it->second.second);
+  }
+  recycledModels.clear();
+  modelSignatures.clear();
+}
+
+gazebo::physics::ModelPtr
+GazeboPhysicsWorld::GetGzModel(const ModelID& id) const
+{
+  if (recycledModels.count(id)) return gazebo::physics::ModelPtr();
+  return world->ModelByName(id);
+}
+
+void GazeboPhysicsWorld::RecycleOrRemoveModel
+                          (const gazebo::physics::ModelPtr& m)
+{
+  std::map<std::string, std::string>::iterator it =
+    modelSignatures.find(m->GetName());
+  if (it == modelSignatures.end())
+  {
+    world->RemoveModel(m);
+    return;
+  }
+  // without collisions and disabled, the model does not
+  // affect any other models
+  m->SetCollideMode("none");
+  m->ResetPhysicsStates();
+  m->SetEnabled(false);
+  recycledModels[it->first] = std::make_pair(it->second, m);
+  modelSignatures.erase(it);
+}
+
+gazebo::physics::ModelPtr
+GazeboPhysicsWorld::ReuseModel(const std::string& modelname,
+                               const std::string& signature,
+                               const Shape::Pose3& pose)
+{
+  std::map<std::string, std::pair<std::string,
+           gazebo::physics::ModelPtr> >::iterator it =
+    recycledModels.find(modelname);
+  if (it == recycledModels.end()) return gazebo::physics::ModelPtr();
+
+  gazebo::physics::ModelPtr m = it->second.second;
+  if (it->second.first != signature)
+  {
+    // a different shape is to be added with this name
+    world->RemoveModel(m);
+    recycledModels.erase(it);
+    return gazebo::physics::ModelPtr();
+  }
+  recycledModels.erase(it);
+
+  bool pauseState = world->IsPaused();
+  world->SetPaused(true);
+  m->SetWorldPose(pose);
+  m->ResetPhysicsStates();
+  m->SetEnabled(true);
+  m->SetCollideMode("all");
+  world->SetPaused(pauseState);
+
+  modelSignatures[modelname] = signature;
+  return m;
+}
+
+void GazeboPhysicsWorld::DropRecycledModel(const std::string& modelname)
+{
+  std::map<std::string, std::pair<std::string,
+           gazebo::physics::ModelPtr> >::iterator it =
+    recycledModels.find(modelname);
+  if (it == recycledModels.end()) return;
+  world->RemoveModel(it->second.second);
+  recycledModels.erase(it);
+}
+
+void GazeboPhysicsWorld::RemoveRecycledModels(WorldState& state) const
+{
+  if (recycledModels.empty()) return;
+  gazebo::physics::ModelState_M modelStates = state.GetModelStates();
+  for (std::map<std::string, std::pair<std::string,
+                gazebo::physics::ModelPtr> >::const_iterator
+       it = recycledModels.begin(); it != recycledModels.end(); ++it)
+  {
+    modelStates.erase(it->first);
+  }
+  state.SetModelStates(modelStates);
 }
 
 GazeboPhysicsWorld::WorldState GazeboPhysicsWorld::GetWorldState() const
 {
   gazebo::physics::WorldState s(world);
+  RemoveRecycledModels(s);
   return s;
 }
 
@@ -543,16 +878,47 @@ GazeboPhysicsWorld::GetWorldStateDiff(const WorldState& other) const
 collision_benchmark::OpResult
 GazeboPhysicsWorld::SetWorldState(const WorldState& state, bool isDiff)
 {
-  collision_benchmark::SetWorldState(world, state);
+  COLLISION_BENCHMARK_PROFILE_SCOPE(setStateSection);
+  if (recycledModels.empty())
+  {
+    collision_benchmark::SetWorldState(world, state);
+  }
+  else
+  {
+    // Recycled models are not in the states of this class. Keep them as
+    // they are, so that they are not deleted as models missing in the
+    // target state. Recycled models with the name of a model in the
+    // target state are dropped, so that the model can be inserted.
+    WorldState target = state;
+    gazebo::physics::ModelState_M modelStates = target.GetModelStates();
+    std::vector<std::string> drop;
+    for (std::map<std::string, std::pair<std::string,
+                  gazebo::physics::ModelPtr> >::const_iterator
+         it = recycledModels.begin(); it != recycledModels.end(); ++it)
+    {
+      if (modelStates.count(it->first))
+        drop.push_back(it->first);
+      else
+        modelStates[it->first] =
+          gazebo::physics::ModelState(it->second.second);
+    }
+    for (std::vector<std::string>::const_iterator it = drop.begin();
+         it != drop.end(); ++it)
+    {
+      DropRecycledModel(*it);
+    }
+    target.SetModelStates(modelStates);
+    collision_benchmark::SetWorldState(world, target);
+  }
 
 #ifdef DEBUG
-  gazebo::physics::WorldState _currentState(world);
+  gazebo::physics::WorldState _currentState = GetWorldState();
   GazeboStateCompare::Tolerances t =
     GazeboStateCompare::Tolerances::CreateDefault(1e-03);
   if (!world->PhysicsEnabled()) t.CheckDynamics=false;
   if (!GazeboStateCompare::Equal(_currentState, state, t))
   {
-    std::cerr<<"Target state was not set as supposed to!!"<<std::endl;
+    LOG_ERROR("physics", "Target state was not set as supposed to!!");
   }
 #endif
 
@@ -563,11 +929,11 @@ GazeboPhysicsWorld::SetWorldState(const WorldState& state, bool isDiff)
 bool GazeboPhysicsWorld::SetBasicModelState(const ModelID  &_id,
                                             const BasicState &_state)
 {
-  gazebo::physics::ModelPtr m=world->ModelByName(_id);
+  gazebo::physics::ModelPtr m=GetGzModel(_id);
   if (!m)
   {
-    std::cerr << "World "<<GetName()<<": Model " << _id
-              << " could not be found" << std::endl;
+    LOG_ERROR("physics", "World "<<GetName()<<": Model " << _id
+                         << " could not be found");
     return false;
   }
   ignition::math::Pose3d pose = m->WorldPose();
@@ -596,11 +962,11 @@ bool GazeboPhysicsWorld::SetBasicModelState(const ModelID  &_id,
 bool GazeboPhysicsWorld::GetBasicModelState(const ModelID  &_id,
                                             BasicState &_state)
 {
-  gazebo::physics::ModelPtr m=world->ModelByName(_id);
+  gazebo::physics::ModelPtr m=GetGzModel(_id);
   if (!m)
   {
-    std::cerr << "World " << GetName() << ": Model " << _id
-              << " could not be found" << std::endl;
+    LOG_ERROR("physics", "World " << GetName() << ": Model " << _id
+                         << " could not be found");
     return false;
   }
   ignition::math::Pose3d pose = m->WorldPose();
@@ -637,6 +1003,7 @@ void GazeboPhysicsWorld::Update(int steps, bool force)
   //          <<world->Physics()->GetType()<<std::endl;
 #ifdef NEW_WORLDRUN_SOLUTION
   if (!force && IsPaused()) return;
+  COLLISION_BENCHMARK_PROFILE_SCOPE(updateSection);
 
   // if the world is not paused, it is updating itself already
   // automatically (started in PostWorldLoaded().
@@ -647,11 +1014,11 @@ void GazeboPhysicsWorld::Update(int steps, bool force)
     static bool printOnce=true;
     if (printOnce)
     {
-      std::cout<<"DEBUG WARNING: The Gazebo world is not paused. "
-        <<"In GazeboPhysicsWorld::Update(), we operate it in "
-        <<"paused mode and rely on manually doint the updates "
-        <<"instead of letting the gazebo world update "
-        <<"itself continuously."<<std::endl;
+      LOG_WARN("physics", "The Gazebo world is not paused. "
+               << "In GazeboPhysicsWorld::Update(), we operate it in "
+               << "paused mode and rely on manually doint the updates "
+               << "instead of letting the gazebo world update "
+               << "itself continuously.");
       printOnce=false;
     }
     world->SetPaused(true);
@@ -661,6 +1028,7 @@ void GazeboPhysicsWorld::Update(int steps, bool force)
   // It advances the state despite the paused state.
   world->Step(steps);
 #else
+  COLLISION_BENCHMARK_PROFILE_SCOPE(updateSection);
   // This method calls world->RunBlocking();
   gazebo::runWorld(world, steps);
   // iterations is always 1 if it has been set with steps!=0
@@ -700,8 +1068,10 @@ bool GazeboPhysicsWorld::SupportsContacts() const
 // helper function which can be used to get contact info of either
 // all models (m1 and m2 set to NULL), or for one model
 // (m1=NULL and m2=NULL) or for two models (m1!=NULL and m2!=NULL).
+// Inconsistent contacts which are skipped are counted in \e anomalies.
 std::vector<GazeboPhysicsWorld::ContactInfoPtr>
 GetContactInfoHelper(const gazebo::physics::WorldPtr& world,
+                     GazeboPhysicsWorld::ContactAnomalies& anomalies,
                      const GazeboPhysicsWorld::ModelID * m1=NULL,
                      const GazeboPhysicsWorld::ModelID * m2=NULL)
 {
@@ -741,8 +1111,11 @@ GetContactInfoHelper(const gazebo::physics::WorldPtr& world,
       }
     }
 
+    ++anomalies.numContacts;
     if (c->count == 0)
     {
+      anomalies.Add(GazeboPhysicsWorld::ContactAnomalies::EMPTY_CONTACT,
+                    m1Name, m2Name);
       // for BULLET, it can happen quite frequently that a contact is given
       // while there is no actual contact information.
       // See also this issue:
@@ -750,9 +1123,9 @@ GetContactInfoHelper(const gazebo::physics::WorldPtr& world,
       // For now, don't print this warning for bullet.
       if (world->Physics()->GetType() != "bullet")
       {
-        std::cerr << "CONSISTENCY GazeboPhysicsWorld: With no contacts, "
-                  << "there should be no collision!! World: " << world->Name()
-                  << " Models: " << m1Name << ", " << m2Name << std::endl;
+        LOG_DEBUG("physics", "CONSISTENCY GazeboPhysicsWorld: With no "
+                  << "contacts, there should be no collision!! World: "
+                  << world->Name() << " Models: " << m1Name << ", " << m2Name);
       }
       continue;
     }
@@ -761,6 +1134,7 @@ GetContactInfoHelper(const gazebo::physics::WorldPtr& world,
       cInfo(new GazeboPhysicsWorld::ContactInfo
             (m1Name, c->collision1->GetLink()->GetName(),
              m2Name, c->collision2->GetLink()->GetName()));
+    anomalies.numPoints += c->count;
     for (int i=0; i < c->count; ++i)
     {
       if (c->depths[i] < 0)
@@ -770,9 +1144,11 @@ GetContactInfoHelper(const gazebo::physics::WorldPtr& world,
         static double tol = 1e-03;
         if (c->depths[i] < -tol)
         {
-          std::cout << "DEBUG-INFO: Negative contact distance found in world "
-                    << world->Name() <<", depth = " << c->depths[i]
-                    << ". Skipping contact. " << std::endl;
+          anomalies.Add(GazeboPhysicsWorld::ContactAnomalies::NEGATIVE_DEPTH,
+                        m1Name, m2Name, c->depths[i]);
+          LOG_DEBUG("physics", "Negative contact distance found in world "
+                               << world->Name() << ", depth = " << c->depths[i]
+                               << ". Skipping contact.");
           continue;
         }
       }
@@ -783,10 +1159,12 @@ GetContactInfoHelper(const gazebo::physics::WorldPtr& world,
 
     if (cInfo->contacts.empty())
     {
-     std::cout << "WARNING: All contact points gotten from models "
+     anomalies.Add(GazeboPhysicsWorld::ContactAnomalies::ALL_POINTS_SKIPPED,
+                   m1Name, m2Name);
+     LOG_DEBUG("physics", "All contact points gotten from models "
                << m1Name << " / " << c->collision1->GetLink()->GetName() << ", "
                << m2Name << " / " << c->collision2->GetLink()->GetName()
-               << " world " << world->Name() <<" skipped. " << std::endl;
+               << " world " << world->Name() << " skipped.");
     }
     else
     {
@@ -860,13 +1238,37 @@ GetNativeContactsHelper(const gazebo::physics::WorldPtr& world,
 std::vector<GazeboPhysicsWorld::ContactInfoPtr>
 GazeboPhysicsWorld::GetContactInfo() const
 {
-  return GetContactInfoHelper(world);
+  COLLISION_BENCHMARK_PROFILE_SCOPE(contactsSection);
+  ContactAnomalies anomalies;
+  std::vector<ContactInfoPtr> ret = GetContactInfoHelper(world, anomalies);
+  std::lock_guard<std::mutex> lock(contactAnomaliesMutex);
+  contactAnomalies.Merge(anomalies);
+  return ret;
 }
 
 std::vector<GazeboPhysicsWorld::ContactInfoPtr>
 GazeboPhysicsWorld::GetContactInfo(const ModelID& m1, const ModelID& m2) const
 {
-  return GetContactInfoHelper(world, &m1, &m2);
+  COLLISION_BENCHMARK_PROFILE_SCOPE(contactsSection);
+  ContactAnomalies anomalies;
+  std::vector<ContactInfoPtr> ret =
+    GetContactInfoHelper(world, anomalies, &m1, &m2);
+  std::lock_guard<std::mutex> lock(contactAnomaliesMutex);
+  contactAnomalies.Merge(anomalies);
+  return ret;
+}
+
+GazeboPhysicsWorld::ContactAnomalies
+GazeboPhysicsWorld::GetContactAnomalies() const
+{
+  std::lock_guard<std::mutex> lock(contactAnomaliesMutex);
+  return contactAnomalies;
+}
+
+void GazeboPhysicsWorld::ResetContactAnomalies()
+{
+  std::lock_guard<std::mutex> lock(contactAnomaliesMutex);
+  contactAnomalies.Clear();
 }
 
 std::vector<GazeboPhysicsWorld::NativeContactPtr>
@@ -923,6 +1325,13 @@ collision_benchmark::RefResult
 GazeboPhysicsWorld::SetWorld(const WorldPtr& _world)
 {
   world = collision_benchmark::to_boost_ptr<World>(_world);
+  const std::string name = GetName();
+  updateSection =
+    Profiler::GetSection("GazeboPhysicsWorld::Update/" + name, name);
+  setStateSection =
+    Profiler::GetSection("GazeboPhysicsWorld::SetWorldState/" + name, name);
+  contactsSection =
+    Profiler::GetSection("GetContactInfoHelper/" + name, name);
   SetEnforceContactsComputation(enforceContactComputation);
   PostWorldLoaded();
   return collision_benchmark::REFERENCED;
@@ -936,7 +1345,7 @@ GazeboPhysicsWorld::WorldPtr GazeboPhysicsWorld::GetWorld() const
 GazeboPhysicsWorld::ModelPtr
 GazeboPhysicsWorld::GetModel(const ModelID& model) const
 {
-  gazebo::physics::ModelPtr m=world->ModelByName(model);
+  gazebo::physics::ModelPtr m=GetGzModel(model);
   return collision_benchmark::to_std_ptr<gazebo::physics::Model>(m);
 }
 
@@ -944,7 +1353,7 @@ GazeboPhysicsWorld::GetModel(const ModelID& model) const
 bool GazeboPhysicsWorld::GetAABB(const ModelID& id,
                                  Vector3& min, Vector3& max) const
 {
-  gazebo::physics::ModelPtr m=world->ModelByName(id);
+  gazebo::physics::ModelPtr m=GetGzModel(id);
   if (!m) return false;
   ignition::math::Box box = m->BoundingBox();
   min = Vector3(box.Min().X(), box.Min().Y(), box.Min().Z());
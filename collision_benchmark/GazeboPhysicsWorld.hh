@@ -2,6 +2,7 @@
 #define COLLISION_BENCHMARK_GAZEBOPHYSICSWORLD
 
 #include <collision_benchmark/PhysicsWorld.hh>
+#include <collision_benchmark/Profiler.hh>
 #include <gazebo/physics/PhysicsTypes.hh>
 #include <gazebo/physics/World.hh>
 #include <gazebo/physics/Contact.hh>
@@ -11,6 +12,10 @@
 #include <gazebo/transport/TransportTypes.hh>
 #endif
 
+#include <map>
+#include <mutex>
+#include <utility>
+
 namespace collision_benchmark
 {
 
@@ -60,8 +65,10 @@ class GazeboPhysicsWorld:
   public: typedef typename ParentClass::WorldState WorldState;
   public: typedef typename ParentClass::ContactInfo ContactInfo;
   public: typedef typename ParentClass::ContactInfoPtr ContactInfoPtr;
+  public: typedef typename ParentClass::ContactAnomalies ContactAnomalies;
   public: typedef typename ParentClass::Shape Shape;
   public: typedef typename ParentClass::ModelLoadResult ModelLoadResult;
+  public: typedef typename ParentClass::ShapeModel ShapeModel;
 
 
   public: typedef typename ParentClass::Model Model;
@@ -83,7 +90,7 @@ class GazeboPhysicsWorld:
   public: static constexpr float OnLoadMaxWaitForNamespace = 10;
   // if \e OnLoadWaitForNamespace, sleep time in-between checks to wait for
   // whether the namespace has been loaded
-  public: static constexpr float OnLoadWaitForNamespaceSleep = 1;
+  public: static constexpr float OnLoadWaitForNamespaceSleep = 0.005;
 
   // \param enforceContactComputation by default, contacts in Gazebo are only
   //  computed if there is at least one subscriber to the contacts topic.
@@ -119,6 +126,11 @@ class GazeboPhysicsWorld:
                   AddModelFromSDF(const sdf::ElementPtr& sdf,
                                   const std::string& modelname="");
 
+  public: virtual std::vector<ModelLoadResult>
+          AddModelsFromSDF(const std::vector<sdf::ElementPtr>& sdfs,
+                           const std::vector<std::string>& modelnames
+                             = std::vector<std::string>());
+
   public: virtual bool SupportsShapes() const;
 
   // The gazebo implementation needs to write mesh shapes to file. This method
@@ -128,6 +140,9 @@ class GazeboPhysicsWorld:
                                     const Shape::Ptr& shape,
                                     const Shape::Ptr& collShape=Shape::Ptr());
 
+  public: virtual std::vector<ModelLoadResult>
+          AddModelsFromShape(const std::vector<ShapeModel>& models);
+
   public: virtual std::vector<ModelID> GetAllModelIDs() const;
   public: virtual int GetIntegerModelID(const ModelID& id) const;
 
@@ -161,6 +176,10 @@ class GazeboPhysicsWorld:
   public: virtual std::vector<ContactInfoPtr>
                   GetContactInfo(const ModelID& m1, const ModelID& m2) const;
 
+  public: virtual ContactAnomalies GetContactAnomalies() const;
+
+  public: virtual void ResetContactAnomalies();
+
   /// Current warning for Gazebo implementation: Returned shared pointers
   /// are flakey, they will be deleted as soon as
   /// Gazebo ContactManager deletes them. This will be resolved as soon as
@@ -208,6 +227,66 @@ class GazeboPhysicsWorld:
   //    the URI of the resource in the SDF (the SDF won't use absolute paths).
   public: std::string GetMeshOutputPath(std::string& outputSubdir) const;
 
+  // Enables or disables recycling of models. If enabled, models which were
+  // added as primitive with AddModelFromShape() or AddModelsFromShape()
+  // (and without a separate collision shape) are not destroyed by Clear()
+  // and RemoveModel(). Instead, they are disabled and kept, and re-enabled
+  // by the next call of AddModelFromShape() or AddModelsFromShape() with
+  // the same model name and a primitive of the same signature
+  // (see PrimitiveShape::GetSignature()). This is much faster than building
+  // the model again.
+  // Recycled models are not reported by any of the methods of this class,
+  // including the world states, but they are still part of the gazebo world
+  // and may be displayed by the gazebo client. SetWorldState() keeps them,
+  // unless the state contains a model with the same name.
+  // Disabling recycling destroys all recycled models.
+  public: void SetRecycleModels(const bool flag);
+
+  // Returns whether models are recycled, see SetRecycleModels().
+  public: bool GetRecycleModels() const { return recycleModels; }
+
+  // Returns the SDF of a model which consists of \e shape,
+  // see AddModelFromShape(). The SDF of primitive shapes is built only once
+  // and then copied with name and pose replaced.
+  // \return the SDF of the model, or NULL if it could not be built.
+  private: sdf::ElementPtr GetShapeModelSDF(const std::string& modelname,
+                                            const Shape::Ptr& shape,
+                                            const Shape::Ptr& collShape) const;
+
+  // Builds the SDF returned by GetShapeModelSDF().
+  private: sdf::ElementPtr BuildShapeModelSDF(const std::string& modelname,
+                                              const Shape::Ptr& shape,
+                                              const Shape::Ptr& collShape)
+                                              const;
+
+  // Returns the signature of \e shape if it is a primitive which is also
+  // used as collision shape, or an empty string otherwise.
+  private: static std::string GetPrimitiveSignature(const Shape::Ptr& shape,
+                                                    const Shape::Ptr& collShape);
+
+  // Returns the gazebo model with the name \e id, or NULL if there is no
+  // such model or it is recycled.
+  private: gazebo::physics::ModelPtr GetGzModel(const ModelID& id) const;
+
+  // Disables and keeps model \e m if recycling is enabled and it was added
+  // as primitive, and removes it from the world otherwise.
+  private: void RecycleOrRemoveModel(const gazebo::physics::ModelPtr& m);
+
+  // Re-enables the recycled model with the name \e modelname if it has
+  // \e signature and places it at \e pose. A recycled model with another
+  // signature is removed from the world.
+  // \return the re-enabled model, or NULL if there was no matching model.
+  private: gazebo::physics::ModelPtr ReuseModel(const std::string& modelname,
+                                                const std::string& signature,
+                                                const Shape::Pose3& pose);
+
+  // Removes the states of all recycled models from \e state
+  private: void RemoveRecycledModels(WorldState& state) const;
+
+  // Removes the recycled model with the name \e modelname (if any) from
+  // the world, so that a new model with this name can be added.
+  private: void DropRecycledModel(const std::string& modelname);
+
   /// wait for the namespace of this world
   private: bool WaitForNamespace(const gazebo::physics::WorldPtr& gzworld,
                                  float maxWait, float waitSleep);
@@ -252,6 +331,28 @@ class GazeboPhysicsWorld:
   // separately.
   private: bool paused;
 
+  // Profiler sections of this world for Update(), SetWorldState()
+  // and GetContactInfo(). They are registered in SetWorld() once the
+  // name of the world is known.
+  private: Profiler::SectionID updateSection;
+  private: Profiler::SectionID setStateSection;
+  private: Profiler::SectionID contactsSection;
+
+  // inconsistencies found in the contacts in GetContactInfo(),
+  // which is a const method, hence mutable.
+  private: mutable ContactAnomalies contactAnomalies;
+  private: mutable std::mutex contactAnomaliesMutex;
+
+  // whether models are recycled, see SetRecycleModels()
+  private: bool recycleModels;
+  // signatures of the primitives of all models which are recycled
+  // when they are removed, by model name.
+  private: std::map<std::string, std::string> modelSignatures;
+  // models which have been recycled by name, together with the signature
+  // of their primitive.
+  private: std::map<std::string, std::pair<std::string,
+                                 gazebo::physics::ModelPtr> > recycledModels;
+
 };  // class GazeboPhysicsWorld
 
 /// \def GazeboPhysicsWorldPtr
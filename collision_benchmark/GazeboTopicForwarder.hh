@@ -24,6 +24,9 @@
 #include <collision_benchmark/MirrorWorld.hh>
 #include <collision_benchmark/TypeHelper.hh>
 #include <collision_benchmark/Exception.hh>
+#include <collision_benchmark/Metrics.hh>
+#include <collision_benchmark/Logger.hh>
+#include <collision_benchmark/Profiler.hh>
 
 #include <gazebo/gazebo.hh>
 #include <gazebo/physics/World.hh>
@@ -153,12 +156,11 @@ class GazeboTopicForwarder
 
             if (this->verbose)
             {
-              std::cout << "Forwarding messages (verbose: "
-                        << (verbose ? "true" : "false")<<") of type "
-                        << GetTypeName<Msg>()<<" from topic "
-                        << _from<<" to topic ";
-              if (this->pub) std::cout<<this->pub->GetTopic()<<std::endl;
-              else std::cout<<"<none>"<<std::endl;
+              LOG_INFO("mirror", "Forwarding messages (verbose: "
+                       << (verbose ? "true" : "false")<<") of type "
+                       << GetTypeName<Msg>()<<" from topic "
+                       << _from<<" to topic "
+                       << (this->pub ? this->pub->GetTopic() : "<none>"));
             }
           }
 
@@ -186,6 +188,15 @@ class GazeboTopicForwarder
                std::lock_guard<std::mutex> lock(transportMutex);
                this->pub =
                  _node->Advertise<Msg>(_to, _pubQueueLimit, _pubHzRate);
+               Metrics::Labels labels;
+               labels["topic"] = _to;
+               this->forwardedMsgs = Metrics::GetCounter
+                 ("collision_benchmark_forwarded_messages_total",
+                  "Number of messages forwarded to the topic", labels);
+               this->outgoingMsgs = Metrics::GetGauge
+                 ("collision_benchmark_forwarder_outgoing_messages",
+                  "Number of messages waiting to be published to the topic",
+                  labels);
              } catch (gazebo::common::Exception &e)
              {
                THROW_EXCEPTION("Could not create forwarder to "
@@ -197,9 +208,8 @@ class GazeboTopicForwarder
   private: void OnMsg(const boost::shared_ptr<Msg const> &_msg)
   {
     assert(_msg);
-
-    if (this->verbose)
-      std::cout<<"Debug: Got message of type "<<GetTypeName<Msg>()<<std::endl;
+    COLLISION_BENCHMARK_PROFILE_NAMED_SCOPE("GazeboTopicForwarder::OnMsg<"
+                                            + GetTypeName<Msg>() + ">");
 
     std::lock_guard<std::mutex> lock(transportMutex);
     if (!this->sub) THROW_EXCEPTION("Inconsistency: Subscriber is NULL, "
@@ -207,10 +217,10 @@ class GazeboTopicForwarder
 
     if (this->verbose)
     {
-      std::cout<<" - on topic "<<this->sub->GetTopic();
-      if (this->pub) std::cout<<" forwarded to topic "<<this->pub->GetTopic();
-      else std::cout<<" <null>";
-      std::cout<<std::endl;
+      LOG_INFO("mirror", "Got message of type " << GetTypeName<Msg>()
+               << " on topic " << this->sub->GetTopic()
+               << (this->pub ? " forwarded to topic " + this->pub->GetTopic()
+                             : std::string(" <null>")));
     }
 
     if (!this->pub)
@@ -225,13 +235,14 @@ class GazeboTopicForwarder
     if (!msgToFwd)
     {
       if (this->verbose)
-        std::cout<<"Debug: Rejected message of type "
-          <<GetTypeName<Msg>()<<std::endl;
+        LOG_INFO("mirror", "Rejected message of type " << GetTypeName<Msg>());
       return;
     }
 
     // this->pub->WaitForConnection();
     this->pub->Publish(*msgToFwd);
+    this->forwardedMsgs.Increment();
+    this->outgoingMsgs.Set(this->pub->GetOutgoingCount());
   }
 
   /// \brief Publisher for forwarding messages.
@@ -248,6 +259,10 @@ class GazeboTopicForwarder
 
   /// \brief for debugging
   private: bool verbose;
+
+  /// \brief number of forwarded messages and publisher queue size
+  private: Metrics::Counter forwardedMsgs;
+  private: Metrics::Gauge outgoingMsgs;
 };
 
 
@@ -345,6 +360,11 @@ class GazeboServiceForwarder
               _node->Subscribe(_requestSourceTopic,
                                &GazeboServiceForwarder::OnRequest,
                                this, latching);
+            Metrics::Labels labels;
+            labels["topic"] = _requestSourceTopic;
+            this->numBufferedRequests = Metrics::GetGauge
+              ("collision_benchmark_service_forwarder_buffered_requests",
+               "Number of requests buffered until forwarding starts", labels);
           }
 
 
@@ -426,8 +446,9 @@ class GazeboServiceForwarder
 
                if (this->verbose)
                {
-                 std::cout<<"Forwarding request: "<<msg->DebugString()
-                          <<" to "<<_requestDestTopic<<std::endl;
+                 LOG_INFO("mirror", "Forwarding request: "
+                          << msg->DebugString() << " to "
+                          << _requestDestTopic);
                }
 
                RequestConstPtr msgToFwd(nullptr);
@@ -436,13 +457,14 @@ class GazeboServiceForwarder
                if (!msgToFwd)
                {
                  if (this->verbose)
-                   std::cout<<"Debug: Filtered out request"<<std::endl;
+                   LOG_INFO("mirror", "Filtered out request");
                  continue;
                }
 
                // pubTmp->WaitForConnection();
                pubTmp->Publish(*msgToFwd);
              }
+             this->numBufferedRequests.Set(0);
            }
 
   private: void UnsubscribeBufferRequests()
@@ -462,6 +484,7 @@ class GazeboServiceForwarder
              //           << _request->DebugString()<<std::endl;
              std::lock_guard<std::mutex> lock(bufferedRequestsMutex);
              this->bufferedRequests.push_back(_request);
+             this->numBufferedRequests.Set(this->bufferedRequests.size());
            }
 
 
@@ -493,6 +516,8 @@ class GazeboServiceForwarder
   private: gazebo::transport::SubscriberPtr bufferedRequestsSub;
   /// \brief Mutex for bufferedRequests and bufferedRequestsSub
   private: std::mutex bufferedRequestsMutex;
+  /// \brief size of bufferedRequests, exported as metric
+  private: Metrics::Gauge numBufferedRequests;
 
   /// \brief for debugging
   private: bool verbose;
@@ -567,10 +592,10 @@ class GazeboTopicBlockPrinter:
     assert(_msg);
     if (!msgFilter || msgFilter->Filter(_msg))
     {
-      std::cout<<printPrefix<<": Blocked message of type "<<GetTypeName<Msg>();
-      if (this->sub) std::cout<<" on topic "<<this->sub->GetTopic();
-      else std::cout<<" <null>";
-      std::cout<<std::endl;
+      LOG_INFO("mirror", printPrefix << ": Blocked message of type "
+               << GetTypeName<Msg>()
+               << (this->sub ? " on topic " + this->sub->GetTopic()
+                             : std::string(" <null>")));
     }
   }
 
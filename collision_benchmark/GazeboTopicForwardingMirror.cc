@@ -24,7 +24,9 @@
 #include <collision_benchmark/GazeboPhysicsWorld.hh>
 #include <collision_benchmark/GazeboStateCompare.hh>
 #include <collision_benchmark/GazeboWorldState.hh>
+#include <collision_benchmark/GazeboWorldLoader.hh>
 #include <collision_benchmark/GazeboHelpers.hh>
+#include <collision_benchmark/Logger.hh>
 
 #include <gazebo/physics/PhysicsIface.hh>
 #include <gazebo/physics/PhysicsEngine.hh>
@@ -108,14 +110,14 @@ class WorldStatMsgFilter:
             if (!mirrorPtr)
             {
               // mirror world has been deleted so filter out message
-              std::cout<<"DEBUG ERROR: No mirror world set!";
+              LOG_DEBUG("mirror", "No mirror world set!");
               return nullptr;
             }
             if (!mirrorPtr->GetOriginalWorld())
             {
-              std::cout<<"DEBUG: Mirror world must have original world, ";
-              std::cout<<"this could happen when messages arrive during ";
-              std::cout<<"initializaion process."<<std::endl;
+              LOG_DEBUG("mirror", "Mirror world must have original world, "
+                        << "this could happen when messages arrive during "
+                        << "initializaion process.");
               return nullptr;
             }
             WorldStatisticsPtr msgCopy(new WorldStatistics(*_msg));
@@ -153,8 +155,8 @@ GazeboTopicForwardingMirror::GazeboTopicForwardingMirror
 void GazeboTopicForwardingMirror::RegisterNamespace
       (const std::string& wldName) const
 {
-  std::cout << "Registering gazebo namespace "
-            << wldName << " for mirror world."<<std::endl;
+  LOG_INFO("mirror", "Registering gazebo namespace "
+                     << wldName << " for mirror world.");
 
   std::list<std::string> topicNames;
   gazebo::transport::TopicManager::Instance()->GetTopicNamespaces(topicNames);
@@ -165,23 +167,16 @@ void GazeboTopicForwardingMirror::RegisterNamespace
     str<<"means gzclient is not going to connect with mirror world!"<<std::endl;
     gzwarn<<str.str();
   }
-  std::cout<<"Registering mirror world name "
-           <<wldName<<" as topic"<<std::endl;
+  LOG_INFO("mirror", "Registering mirror world name "
+                     <<wldName<<" as topic");
   gazebo::transport::TopicManager::Instance()->RegisterTopicNamespace(wldName);
 
   // Wait for namespaces to make sure the mirror world name has arrived.
-  gazebo::common::Time waitTime(1, 0);
-  int waitCount = 0;
-  int maxWaitCount = 10;
-  while (!gazebo::transport::waitForNamespaces(waitTime) &&
-      (waitCount++) < maxWaitCount)
+  const float maxWaitTime = 10;
+  if (!collision_benchmark::WaitForNamespace(wldName, maxWaitTime))
   {
-    gzwarn << "Waited " << waitTime.Double() << "seconds for namespaces.\n";
-  }
-  if (waitCount >= maxWaitCount)
-  {
-    THROW_EXCEPTION("Waited " << (waitTime * waitCount).Double()
-      << " seconds for namespaces. Giving up.");
+    THROW_EXCEPTION("Waited " << maxWaitTime
+      << " seconds for namespace " << wldName << ". Giving up.");
   }
 
   // Make sure the mirror world was in fact the first to arrive
@@ -209,7 +204,7 @@ GazeboTopicForwardingMirror::~GazeboTopicForwardingMirror()
 
 void GazeboTopicForwardingMirror::Init()
 {
-  std::cout<<"Initializing GazeboTopicForwardingMirror."<<std::endl;
+  LOG_INFO("mirror", "Initializing GazeboTopicForwardingMirror.");
 
   // initialize topic block printers (for user information printing)
   ////////////////////////////////////////////////
@@ -345,7 +340,7 @@ void GazeboTopicForwardingMirror::Init()
   ////////////////////////////////////////////////
   this->requestPub = this->node->Advertise<gazebo::msgs::Request>("~/request");
   this->modelPub = this->node->Advertise<gazebo::msgs::Model>("~/model/info");
-  std::cout<<"GazeboTopicForwardingMirror initialized."<<std::endl;
+  LOG_INFO("mirror", "GazeboTopicForwardingMirror initialized.");
   this->initialized = true;
 }
 
@@ -355,7 +350,7 @@ void GazeboTopicForwardingMirror::ConnectOriginalWorld
 {
   if (!this->initialized) Init();
 
-  std::cout<<"Mirror is connecting to world '"<<origWorldName<<"'"<<std::endl;
+  LOG_INFO("mirror", "Mirror is connecting to world '"<<origWorldName<<"'");
 
   // connect services
   assert(this->origServiceFwd);
@@ -496,7 +491,7 @@ void GazeboTopicForwardingMirror::NotifyOriginalWorldChange
     }
   }
 
-  std::cout<<"Connecting the new world "<<_newWorld->GetName()<<std::endl;
+  LOG_INFO("mirror", "Connecting the new world "<<_newWorld->GetName());
   ConnectOriginalWorld(_newWorld->GetName());
 }
 
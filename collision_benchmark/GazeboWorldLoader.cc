@@ -20,12 +20,23 @@
 #include <collision_benchmark/GazeboWorldState.hh>
 #include <collision_benchmark/GazeboHelpers.hh>
 #include <collision_benchmark/Exception.hh>
+#include <collision_benchmark/Logger.hh>
 #include <collision_benchmark/boost_std_conversion.hh>
 
 #include <gazebo/gazebo.hh>
 #include <gazebo/physics/physics.hh>
 
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
 #include <sstream>
+#include <thread>
 
 using collision_benchmark::PhysicsWorldBaseInterface;
 using collision_benchmark::GazeboWorldLoader;
@@ -41,21 +52,44 @@ std::string generateWorldName(const std::string& baseName,
   return worldname;
 }
 
+// Helper function which replaces the ``<physics>`` element of the world
+// \e sdfRoot by \e overridePhysics, or adds it if there is none.
+static void OverridePhysics(const sdf::ElementPtr& sdfRoot,
+                            const sdf::ElementPtr& overridePhysics)
+{
+  LOG_DEBUG("loader", "Overriding the physics of world "
+                      << sdfRoot->Get<std::string>("name") << " with: "
+                      << std::endl << overridePhysics->ToString(""));
+  if (!sdfRoot->HasElement("physics"))
+  {
+    sdf::ElementPtr physics = overridePhysics->Clone();
+    physics->SetParent(sdfRoot);
+    sdfRoot->InsertElement(physics);
+  }
+  else
+  {
+    sdfRoot->GetElement("physics")->Copy(overridePhysics);
+  }
+}
+
 GazeboWorldLoader::GazeboWorldLoader(const std::string& _engine,
-                                     const bool _alwaysCalcContacts):
+                                     const bool _alwaysCalcContacts,
+                                     const std::string& _physicsSettings):
           WorldLoader(_engine),
           alwaysCalcContacts(_alwaysCalcContacts)
 {
-  std::string physicsSDF =
-    collision_benchmark::getPhysicsSettingsSdfFor(_engine);
+  std::string physicsSDF = _physicsSettings;
   if (physicsSDF.empty())
   {
-    THROW_EXCEPTION("Physics engine " << _engine << " not supported");
+    physicsSDF = collision_benchmark::getPhysicsSettingsSdfFor(_engine);
+    if (physicsSDF.empty())
+    {
+      THROW_EXCEPTION("Physics engine " << _engine << " not supported");
+    }
   }
-  std::cout << "Loading physics from " << physicsSDF << std::endl;
   // Get the physics SDF element from the file.
   // This will only succeed if it is in the GAZEBO_RESOURCE_PATH
-  physics = collision_benchmark::GetPhysicsFromSDF(physicsSDF);
+  physics = collision_benchmark::GetPhysicsSettings(_engine, physicsSDF);
   if (!physics)
   {
     THROW_EXCEPTION("Could not get phyiscs engine from " << physicsSDF);
@@ -73,43 +107,53 @@ PhysicsWorldBaseInterface::Ptr
 GazeboWorldLoader::LoadFromSDF(const sdf::ElementPtr& sdf,
                                const std::string& worldname) const
 {
-  THROW_EXCEPTION("TODO: Implement GazeboWorldLoader::LoadFromSDF");
-/*  std::cout << "Loading world from SDF with physics engine '"
-            << EngineName() << "' (named as '"
-            << worldname << "')." << std::endl;
-  // std::cout<<"Loading world from "<<worldfile<<std::endl;
-  // XXX TODO this function yet has to be written, using an SDF instead
-  // of a string and a physics engine to override
+  LOG_INFO("loader", "Loading world from SDF with physics engine '"
+                     << EngineName() << "' (named as '"
+                     << worldname << "').");
+  if (!sdf)
+  {
+    LOG_ERROR("loader", "No SDF given to load the world from.");
+    return PhysicsWorldBaseInterface::Ptr();
+  }
+  // Work on a copy: \e sdf may be a template shared by several loaders.
+  // Copying the element tree is much cheaper than parsing the file again,
+  // which also has to resolve all included models.
+  sdf::ElementPtr sdfRoot = sdf->Clone();
+  if (physics) OverridePhysics(sdfRoot, physics);
   gazebo::physics::WorldPtr gzworld =
-    collision_benchmark::LoadWorldFromSDF(sdf, worldname, physics);
+    collision_benchmark::LoadWorldFromSDF(sdfRoot, worldname);
   if (!gzworld)
   {
-    std::cout<<"Error loading world from SDF." << std::endl;
+    LOG_ERROR("loader", "Error loading world from SDF.");
     return PhysicsWorldBaseInterface::Ptr();
   }
   // Create the GazeboPhysicsWorld object
-  // std::cout<<"Creating GazeboPhysicsWorld. "<<std::endl;
   GazeboPhysicsWorld::Ptr
     gzPhysicsWorld(new GazeboPhysicsWorld(alwaysCalcContacts));
   gzPhysicsWorld->SetWorld
     (collision_benchmark::to_std_ptr<gazebo::physics::World>(gzworld));
   return gzPhysicsWorld;
-  */
+}
+
+sdf::ElementPtr
+GazeboWorldLoader::ReadWorldFile(const std::string& filename) const
+{
+  return collision_benchmark::GetSDFElementFromFile(filename, "world");
 }
 
 PhysicsWorldBaseInterface::Ptr
 GazeboWorldLoader::LoadFromFile(const std::string& worldfile,
                                 const std::string& worldname) const
 {
-  std::cout << "Loading world " << worldfile << " with physics engine '"
-            << EngineName() << "' (named as '"
-            << worldname << "')." << std::endl;
+  LOG_INFO("loader", "Loading world " << worldfile << " with physics engine '"
+                     << EngineName() << "' (named as '"
+                     << worldname << "').");
   // std::cout<<"Loading world from "<<worldfile<<std::endl;
   gazebo::physics::WorldPtr gzworld =
     collision_benchmark::LoadWorldFromFile(worldfile, worldname, physics);
   if (!gzworld)
   {
-    std::cout<<"Error loading world "<<worldfile<<std::endl;
+    LOG_ERROR("loader", "Error loading world "<<worldfile);
     return PhysicsWorldBaseInterface::Ptr();
   }
   // Create the GazeboPhysicsWorld object
@@ -126,15 +170,15 @@ PhysicsWorldBaseInterface::Ptr
 GazeboWorldLoader::LoadFromString(const std::string& str,
                                   const std::string& worldname) const
 {
-  std::cout << "Loading world form string, with physics engine '"
-            << EngineName() << "' (named as '"
-            << worldname << "')." << std::endl;
+  LOG_INFO("loader", "Loading world form string, with physics engine '"
+                     << EngineName() << "' (named as '"
+                     << worldname << "').");
   // std::cout<<"Loading world from "<<worldfile<<std::endl;
   gazebo::physics::WorldPtr gzworld =
     collision_benchmark::LoadWorldFromSDFString(str, worldname, physics);
   if (!gzworld)
   {
-    std::cout<<"Error loading world from string." << std::endl;
+    LOG_ERROR("loader", "Error loading world from string.");
     return PhysicsWorldBaseInterface::Ptr();
   }
   // Create the GazeboPhysicsWorld object
@@ -152,7 +196,7 @@ const std::string collision_benchmark::GetFirstNamespace()
     gazebo::transport::TopicManager::Instance();
   if (!topicManager)
   {
-    std::cerr << "No topic manager instance" << std::endl;
+    LOG_ERROR("loader", "No topic manager instance");
     return "";
   }
   std::list<std::string> namespaces;
@@ -161,62 +205,133 @@ const std::string collision_benchmark::GetFirstNamespace()
   return namespaces.front();
 }
 
-bool collision_benchmark::WaitForNamespace(std::string worldNamespace,
-                                           float maxWaitTime,
-                                           float sleepTime)
+// Watches the namespaces of the gazebo topic manager while there are
+// threads waiting in WaitForNamespace(), and wakes them up as soon as
+// the namespaces change. The topic manager has no notification for new
+// namespaces, so they are checked by one thread at the shortest interval
+// requested by the waiting threads, instead of by each waiting thread.
+class NamespaceWatcher
 {
-  gazebo::transport::TopicManager * topicManager =
-    gazebo::transport::TopicManager::Instance();
-  if (!topicManager)
+  public: static NamespaceWatcher& Instance()
   {
-    std::cerr << "No topic manager instance" << std::endl;
-    return false;
+    static NamespaceWatcher watcher;
+    return watcher;
   }
 
-  gazebo::common::Timer timer;
-  timer.Start();
+  // Waits until \e worldNamespace is in the list of namespaces, or for
+  // at most \e maxWaitTime seconds.
+  // \param checkInterval the namespaces are checked at least this often
+  //    (seconds) while this thread is waiting
+  // \return true if the namespace has arrived
+  public: bool Wait(const std::string& worldNamespace, const float maxWaitTime,
+                    const float checkInterval)
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (this->numWaiting == 0 || checkInterval < this->checkInterval)
+    {
+      // wake the watching thread so it doesn't sleep the longer interval
+      this->checkInterval = checkInterval;
+      this->runCond.notify_all();
+    }
+    if (this->numWaiting++ == 0)
+    {
+      this->thread = std::thread(&NamespaceWatcher::Run, this,
+                                 this->generation);
+    }
+    bool found = this->cond.wait_for(lock,
+      std::chrono::duration<float>(maxWaitTime),
+      [this, &worldNamespace]()
+      {
+        return this->namespaces.count(worldNamespace) > 0;
+      });
+    if (--this->numWaiting == 0)
+    {
+      // the last waiting thread stops the watching thread, so that
+      // it doesn't access the topic manager after it has been shut down.
+      // The namespaces are forgotten as well, so that namespaces of a
+      // server which has been shut down don't satisfy later waits.
+      ++this->generation;
+      this->namespaces.clear();
+      this->runCond.notify_all();
+      std::thread watchingThread;
+      watchingThread.swap(this->thread);
+      lock.unlock();
+      watchingThread.join();
+    }
+    return found;
+  }
 
-  std::cout << "Waiting for namespace '" << worldNamespace
-            << " 'to be loaded." << std::endl;
+  private: NamespaceWatcher(): numWaiting(0), generation(0), checkInterval(0)
+  {}
 
-  bool found = false;
-  while (!found && (timer.GetElapsed().Float() < maxWaitTime))
+  // checks the namespaces until \e generation changes
+  private: void Run(const unsigned int runGeneration)
   {
-    // found at most 1 second for namespaces to appear.
-    if (gazebo::transport::waitForNamespaces(gazebo::common::Time(sleepTime,
-                                                                  0)))
+    std::list<std::string> current;
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (runGeneration == this->generation)
     {
-      std::list<std::string> namespaces;
-      topicManager->GetTopicNamespaces(namespaces);
-
-      /*std::cout<<"Namespaces:"<<std::endl;
-      for (std::list<std::string>::iterator it=namespaces.begin();
-           it!=namespaces.end(); ++it)
-        std::cout<<*it<<std::endl;*/
-
-      std::list<std::string>::iterator ns =
-        std::find(namespaces.begin(), namespaces.end(), worldNamespace);
-      bool loaded = (ns != namespaces.end()) && (*ns == worldNamespace);
-      if (loaded)
+      lock.unlock();
+      current.clear();
+      gazebo::transport::TopicManager::Instance()
+        ->GetTopicNamespaces(current);
+      std::set<std::string> currentSet(current.begin(), current.end());
+      lock.lock();
+      // don't fill the namespaces again after the thread has been stopped
+      if (runGeneration != this->generation) break;
+      if (currentSet != this->namespaces)
       {
-        std::cout << "Namespace '" << worldNamespace
-                  << "' received." << std::endl;
-        found = true;
+        this->namespaces.swap(currentSet);
+        this->cond.notify_all();
       }
-      /*else
-      {
-        std::cout << "Namespace '" << worldNamespace
-                  << "' not received yet." << std::endl;
-      }*/
+      const float interval = this->checkInterval;
+      this->runCond.wait_for(lock, std::chrono::duration<float>(interval),
+        [this, runGeneration, interval]()
+        {
+          return runGeneration != this->generation ||
+                 this->checkInterval < interval;
+        });
     }
-    /*else
-    {
-      std::cout << "No namespaces received yet.\n";
-    }*/
   }
-  if (!found)
-    std::cerr << "Unsuccessful wait for namespace "
-              << worldNamespace<<"."<<std::endl;
+
+  private: std::mutex mutex;
+  // signalled when the namespaces change
+  private: std::condition_variable cond;
+  // signalled when the watching thread has to stop
+  private: std::condition_variable runCond;
+  // namespaces at the last check
+  private: std::set<std::string> namespaces;
+  // number of threads waiting in Wait()
+  private: int numWaiting;
+  // incremented each time the watching thread is stopped
+  private: unsigned int generation;
+  // interval (seconds) at which the namespaces are checked
+  private: float checkInterval;
+  private: std::thread thread;
+};
+
+bool collision_benchmark::WaitForNamespace(std::string worldNamespace,
+                                           float maxWaitTime,
+                                           float sleepTime)
+{
+  gazebo::transport::TopicManager * topicManager =
+    gazebo::transport::TopicManager::Instance();
+  if (!topicManager)
+  {
+    LOG_ERROR("loader", "No topic manager instance");
+    return false;
+  }
+
+  LOG_INFO("loader", "Waiting for namespace '" << worldNamespace
+                     << " 'to be loaded.");
+
+  bool found = NamespaceWatcher::Instance().Wait(worldNamespace, maxWaitTime,
+                                                 sleepTime);
+  if (found)
+    LOG_INFO("loader", "Namespace '" << worldNamespace << "' received.");
+  else
+    LOG_ERROR("loader", "Unsuccessful wait for namespace "
+                        << worldNamespace<<".");
 
   return found;
 }
@@ -232,7 +347,7 @@ collision_benchmark::GetSDFElementFromFile(const std::string& filename,
   sdf::SDFPtr sdf(new sdf::SDF);
   if (!sdf::init(sdf))
   {
-    std::cerr << "Unable to initialize sdf\n";
+    LOG_ERROR("loader", "Unable to initialize sdf");
     return sdfRoot;
   }
 
@@ -244,31 +359,31 @@ collision_benchmark::GetSDFElementFromFile(const std::string& filename,
   }
   catch (gazebo::common::Exception& e)
   {
-    std::cerr << "File "<<filename<<" not found. "
-              << e.GetErrorStr() << std::endl;
+    LOG_ERROR("loader", "File "<<filename<<" not found. "
+                        << e.GetErrorStr());
     return sdf::ElementPtr();
   }
 
 
   if (fullFile.empty())
   {
-    std::cerr << "Unable to find file[" << filename << "]\n";
+    LOG_ERROR("loader", "Unable to find file[" << filename << "]");
     return sdfRoot;
   }
 
-  std::cout << "File "<<fullFile<<" (from "<<filename<<") found. " << std::endl;
+  LOG_INFO("loader", "File "<<fullFile<<" (from "<<filename<<") found. ");
 
   try
   {
     if (!sdf::readFile(fullFile, sdf))
     {
-      std::cerr << "Unable to read sdf file[" << filename << "]\n";
+      LOG_ERROR("loader", "Unable to read sdf file[" << filename << "]");
       return sdfRoot;
     }
   }
   catch (...)
   {
-    std::cerr << "Unable to read sdf file[" << filename << "]\n";
+    LOG_ERROR("loader", "Unable to read sdf file[" << filename << "]");
     return sdfRoot;
   }
 
@@ -296,14 +411,14 @@ collision_benchmark::GetSDFElementFromString(const std::string& xmlString,
   sdf::SDFPtr sdf(new sdf::SDF);
   if (!sdf::init(sdf))
   {
-    std::cerr << "Unable to initialize sdf\n";
+    LOG_ERROR("loader", "Unable to initialize sdf");
     return sdfRoot;
   }
 
   if (!sdf::readString(xmlString, sdf))
   {
-    std::cerr << "Unable to read sdf string: "
-              << std::endl << xmlString << std::endl;
+    LOG_ERROR("loader", "Unable to read sdf string: "
+                        << std::endl << xmlString);
     return sdfRoot;
   }
 
@@ -312,8 +427,8 @@ collision_benchmark::GetSDFElementFromString(const std::string& xmlString,
   if (!name.empty())
   {
     sdf::ParamPtr sdfElemName = sdfRoot->GetAttribute("name");
-    std::cout << "Replacing world name: '" << sdfElemName->GetAsString()
-              << "' with '" << name << "'" << std::endl;
+    LOG_INFO("loader", "Replacing world name: '" << sdfElemName->GetAsString()
+                       << "' with '" << name << "'");
     sdfElemName->SetFromString(name);
   }
 
@@ -329,7 +444,7 @@ collision_benchmark::GetPhysicsFromSDF(const std::string& filename)
   sdf::SDFPtr sdf(new sdf::SDF);
   if (!sdf::init(sdf))
   {
-    std::cerr << "Unable to initialize sdf\n";
+    LOG_ERROR("loader", "Unable to initialize sdf");
     return sdfRoot;
   }
 
@@ -338,31 +453,147 @@ collision_benchmark::GetPhysicsFromSDF(const std::string& filename)
 
   if (fullFile.empty())
   {
-    std::cerr << "Unable to find file[" << filename << "]\n";
+    LOG_ERROR("loader", "Unable to find file[" << filename << "]");
     return sdfRoot;
   }
 
   if (!sdf::readFile(fullFile, sdf))
   {
-    std::cerr << "Unable to read sdf file[" << filename << "]\n";
+    LOG_ERROR("loader", "Unable to read sdf file[" << filename << "]");
     return sdfRoot;
   }
 
   sdfRoot = sdf->Root()->GetElement("world");
   if (!sdfRoot)
   {
-      std::cerr<<"No <world> tag exits in SDF "<<filename<<std::endl;
+      LOG_ERROR("loader", "No <world> tag exits in SDF "<<filename);
       return sdfRoot;
   }
 
   sdfRoot = sdfRoot->GetElement("physics");
 
   if (!sdfRoot)
-    std::cerr<<"No <physics> tag under <world>"<<std::endl;
+    LOG_ERROR("loader", "No <physics> tag under <world>");
 
   return sdfRoot;
 }
 
+// Process-wide cache of the ``<physics>`` elements used by
+// GetPhysicsSettings(), keyed by engine and settings file (or name of
+// the registered settings).
+class PhysicsSettingsCache
+{
+  public: static PhysicsSettingsCache& Instance()
+  {
+    static PhysicsSettingsCache cache;
+    return cache;
+  }
+
+  public: sdf::ElementPtr Get(const std::string& engine,
+                              const std::string& settings)
+  {
+    const Key key(engine, settings);
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::map<Key, sdf::ElementPtr>::const_iterator regIt =
+      this->registered.find(key);
+    if (regIt != this->registered.end()) return regIt->second;
+
+    std::string fullFile;
+    try
+    {
+      fullFile = gazebo::common::find_file(settings);
+    }
+    catch (gazebo::common::Exception& e)
+    {
+      LOG_ERROR("loader", "File " << settings << " not found. "
+                          << e.GetErrorStr());
+      return sdf::ElementPtr();
+    }
+    if (fullFile.empty())
+    {
+      LOG_ERROR("loader", "Unable to find file[" << settings << "]");
+      return sdf::ElementPtr();
+    }
+    std::time_t modified = 0;
+    try
+    {
+      modified = boost::filesystem::last_write_time(fullFile);
+    }
+    catch (const boost::filesystem::filesystem_error& e)
+    {
+      LOG_ERROR("loader", "Cannot access file " << fullFile << ": "
+                          << e.what());
+      return sdf::ElementPtr();
+    }
+
+    Entry& entry = this->files[key];
+    if (entry.physics && (entry.fullFile == fullFile) &&
+        (entry.modified == modified))
+      return entry.physics;
+
+    LOG_INFO("loader", "Loading physics from " << fullFile);
+    entry.physics = collision_benchmark::GetPhysicsFromSDF(settings);
+    entry.fullFile = fullFile;
+    entry.modified = modified;
+    if (entry.physics)
+    {
+      std::string type = entry.physics->Get<std::string>("type");
+      if (type != engine)
+        LOG_WARN("loader", "Physics settings " << settings << " are for "
+                           << "engine " << type << ", not " << engine);
+    }
+    return entry.physics;
+  }
+
+  public: void Register(const std::string& engine, const std::string& name,
+                        const sdf::ElementPtr& physics)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->registered[Key(engine, name)] = physics;
+  }
+
+  private: PhysicsSettingsCache() {}
+
+  private: typedef std::pair<std::string, std::string> Key;
+
+  private: struct Entry
+  {
+    Entry(): modified(0) {}
+    sdf::ElementPtr physics;
+    // the file which was read, as found in the resource paths
+    std::string fullFile;
+    // time at which the file was last modified when it was read
+    std::time_t modified;
+  };
+
+  private: std::mutex mutex;
+  private: std::map<Key, Entry> files;
+  private: std::map<Key, sdf::ElementPtr> registered;
+};
+
+sdf::ElementPtr
+collision_benchmark::GetPhysicsSettings(const std::string& engine,
+                                        const std::string& settings)
+{
+  std::string useSettings = settings;
+  if (useSettings.empty())
+  {
+    useSettings = collision_benchmark::getPhysicsSettingsSdfFor(engine);
+    if (useSettings.empty()) return sdf::ElementPtr();
+  }
+  return PhysicsSettingsCache::Instance().Get(engine, useSettings);
+}
+
+void
+collision_benchmark::RegisterPhysicsSettings(const std::string& engine,
+                                             const std::string& name,
+                                             const sdf::ElementPtr& physics)
+{
+  GZ_ASSERT(physics && physics->GetName() == "physics",
+            "Physics settings must be a <physics> element");
+  PhysicsSettingsCache::Instance().Register(engine, name, physics);
+}
+
 gazebo::physics::WorldPtr
 collision_benchmark::LoadWorldFromSDF(const sdf::ElementPtr& sdfRoot,
                                       const std::string& name,
@@ -370,8 +601,8 @@ collision_benchmark::LoadWorldFromSDF(const sdf::ElementPtr& sdfRoot,
 {
   if (sdfRoot->GetName() != "world")
   {
-    std::cerr<<"SDF must be a 'world' element"<<std::endl;
-    std::cerr<<sdfRoot->ToString("")<<std::endl;
+    LOG_ERROR("loader", "SDF must be a 'world' element" << std::endl
+                        << sdfRoot->ToString(""));
     return gazebo::physics::WorldPtr();
   }
 
@@ -381,9 +612,9 @@ collision_benchmark::LoadWorldFromSDF(const sdf::ElementPtr& sdfRoot,
   {
     if (sdfWorldName->GetAsString() != name)
     {
-      std::cout << "INFO: Need to replace world name in SDF: '"
-                << sdfWorldName->GetAsString() << "' with '"
-                << name << "'" << std::endl;
+      LOG_INFO("loader", "Need to replace world name in SDF: '"
+                         << sdfWorldName->GetAsString() << "' with '"
+                         << name << "'");
       sdfWorldName->SetFromString(name);
     }
   }
@@ -393,26 +624,32 @@ collision_benchmark::LoadWorldFromSDF(const sdf::ElementPtr& sdfRoot,
   }
 
 
-  if (gazebo::physics::has_world(useName))
-  {
-    std::cerr<<"World with name "<<useName<<" already exists."<<std::endl;
-    return nullptr;
-  }
-
   gazebo::physics::WorldPtr world;
   try
   {
-    // XXX this just creates a new world object, all worlds objects are
-    // kept in a static list and can be retrieved. No Physics engine
-    // is created yet - this is done in World::Load (line 257), called
-    // from load_world: The physics engine specified **in the SDF** is
-    // loaded.
-    world = gazebo::physics::create_world(useName);
+    {
+      // Gazebo keeps all worlds in a static list which is not protected
+      // against concurrent access, so worlds which are loaded in
+      // parallel have to be created one after another.
+      static std::mutex createWorldMutex;
+      std::lock_guard<std::mutex> lock(createWorldMutex);
+      if (gazebo::physics::has_world(useName))
+      {
+        LOG_ERROR("loader", "World with name "<<useName<<" already exists.");
+        return nullptr;
+      }
+      // XXX this just creates a new world object, all worlds objects are
+      // kept in a static list and can be retrieved. No Physics engine
+      // is created yet - this is done in World::Load (line 257), called
+      // from load_world: The physics engine specified **in the SDF** is
+      // loaded.
+      world = gazebo::physics::create_world(useName);
+    }
 
-    std::cout<<"Loading world..."<<std::endl;
+    LOG_INFO("loader", "Loading world...");
     if (world) gazebo::physics::load_world(world, sdfRoot);
 
-    std::cout<<"Initializing world..."<<std::endl;
+    LOG_INFO("loader", "Initializing world...");
     // call to world->init
     if (world) gazebo::physics::init_world(world);
 
@@ -426,79 +663,180 @@ collision_benchmark::LoadWorldFromSDF(const sdf::ElementPtr& sdfRoot,
   }
   catch (gazebo::common::Exception& e)
   {
-    std::cerr << " Exception ocurred when loading world. "
-              << e.GetErrorStr() << std::endl;
+    LOG_ERROR("loader", " Exception ocurred when loading world. "
+                        << e.GetErrorStr());
     return gazebo::physics::WorldPtr();
   }
   assert(world);
-  std::cout<<"World loaded."<<std::endl;
+  LOG_INFO("loader", "World loaded.");
 
   return world;
 }
 
-gazebo::physics::ModelPtr
-collision_benchmark::LoadModelFromSDF(const sdf::ElementPtr& sdfRoot,
-                                      const gazebo::physics::WorldPtr& world,
-                                      const std::string& name)
+// Tag to access the private gazebo::physics::World::LoadModel(), which is
+// the only way to add a model from an already parsed SDF element to a
+// world. Access checking does not apply to the template arguments of
+// explicit instantiations, which is used to obtain the member pointer.
+struct WorldLoadModelTag
 {
-  GZ_ASSERT(world, "Can't load a model without a world");
+  typedef gazebo::physics::ModelPtr (gazebo::physics::World::*type)
+    (sdf::ElementPtr, gazebo::physics::BasePtr);
+  friend type GetMember(WorldLoadModelTag);
+};
+
+template<typename Tag, typename Tag::type Member>
+struct PrivateMemberAccess
+{
+  friend typename Tag::type GetMember(Tag) { return Member; }
+};
+
+template struct PrivateMemberAccess<WorldLoadModelTag,
+                                    &gazebo::physics::World::LoadModel>;
+
+// Helper function which adds the model \e sdfModel to \e world in the same
+// way as gazebo::physics::World::SetState() does for insertions, but
+// without serializing the SDF and parsing it again.
+// The model gets its own copy of \e sdfModel.
+// \return the model or NULL if it could not be inserted.
+static gazebo::physics::ModelPtr
+InsertModel(const gazebo::physics::WorldPtr& world,
+            const sdf::ElementPtr& sdfModel)
+{
+  // the root element of the world is the parent of all models, and
+  // it has the name of the world.
+  gazebo::physics::BasePtr root = world->BaseByName(world->Name());
+  if (!root) return gazebo::physics::ModelPtr();
+
+  gazebo::physics::ModelPtr model =
+    ((*world).*GetMember(WorldLoadModelTag()))(sdfModel->Clone(), root);
+  if (!model) return model;
+  model->Init();
+  model->LoadPlugins();
+  return model;
+}
+
+// Helper function which adds the models \e sdfModels to \e world via the
+// insertions of a world state, which is the only way to do it with the
+// public interface of gazebo::physics::World.
+static void
+InsertModelsViaState(const gazebo::physics::WorldPtr& world,
+                     const std::vector<sdf::ElementPtr>& sdfModels)
+{
+  gazebo::physics::WorldState tempState;
+  tempState.SetSimTime(world->SimTime());
+  tempState.SetRealTime(world->RealTime());
+  tempState.SetWallTime(gazebo::common::Time::GetWallTime());
+  tempState.SetIterations(world->Iterations());
+
+  std::vector<std::string> insertions;
+  insertions.reserve(sdfModels.size());
+  for (std::vector<sdf::ElementPtr>::const_iterator it = sdfModels.begin();
+       it != sdfModels.end(); ++it)
+  {
+    insertions.push_back((*it)->ToString(""));
+  }
+  // the SDF has to be fixed up, otherwise gazebo::physics::World::SetState
+  // is not successful
+  collision_benchmark::wrapSDF(insertions);
+  tempState.SetInsertions(insertions);
 
-  if (sdfRoot->GetName() != "model")
+  world->SetState(tempState);
+}
+
+// Helper function which checks that \e sdfRoot is a model and replaces
+// its name by \e name, unless \e name is empty.
+// \return the name of the model, or empty string if \e sdfRoot
+//    is not a model.
+static std::string PrepareModelSDF(const sdf::ElementPtr& sdfRoot,
+                                   const std::string& name)
+{
+  if (!sdfRoot || (sdfRoot->GetName() != "model"))
   {
-    std::cerr<<"SDF must be a 'model' element"<<std::endl;
-    std::cerr<<sdfRoot->ToString("")<<std::endl;
-    return gazebo::physics::ModelPtr();
+    LOG_ERROR("loader", "SDF must be a 'model' element" << std::endl
+                        << (sdfRoot ? sdfRoot->ToString("") : "NULL"));
+    return "";
   }
 
   sdf::ParamPtr sdfModelName = sdfRoot->GetAttribute("name");
   std::string modelName = sdfModelName->GetAsString();
 
-  // first, fix up the name in the SDF
-  if (!name.empty())
+  if (!name.empty() && (modelName != name))
   {
-    if (modelName != name)
-    {
-      std::cout << "INFO: Replacing name in SDF: '"
-                << sdfModelName->GetAsString() << "' with '" << name
-                << "'" << std::endl;
-      sdfModelName->SetFromString(name);
-      modelName = name;
-    }
+    LOG_DEBUG("loader", "Replacing name in SDF: '"
+                        << sdfModelName->GetAsString() << "' with '" << name
+                        << "'");
+    sdfModelName->SetFromString(name);
+    modelName = name;
   }
+  return modelName;
+}
 
-  // load the model
-  bool pausedState=world->IsPaused();
-  world->SetPaused(true);
+gazebo::physics::ModelPtr
+collision_benchmark::LoadModelFromSDF(const sdf::ElementPtr& sdfRoot,
+                                      const gazebo::physics::WorldPtr& world,
+                                      const std::string& name)
+{
+  return LoadModelsFromSDF(std::vector<sdf::ElementPtr>(1, sdfRoot), world,
+                           std::vector<std::string>(1, name)).front();
+}
 
-  // The current interface of the world only allows addition of models
-  // via SetState() in the insertions.
-  gazebo::physics::WorldState wstate(world);
-  gazebo::physics::WorldState tempState;
-  tempState.SetSimTime(wstate.GetSimTime());
-  tempState.SetRealTime(wstate.GetRealTime());
-  tempState.SetWallTime(wstate.GetWallTime());
-  tempState.SetIterations(wstate.GetIterations());
+std::vector<gazebo::physics::ModelPtr>
+collision_benchmark::LoadModelsFromSDF(const std::vector<sdf::ElementPtr>& sdfs,
+                                       const gazebo::physics::WorldPtr& world,
+                                       const std::vector<std::string>& names)
+{
+  GZ_ASSERT(world, "Can't load a model without a world");
+  GZ_ASSERT(names.empty() || (names.size() == sdfs.size()),
+            "Need one name for each model");
 
-  std::string ins=sdfRoot->ToString("");
-  // the SDF has to be fixed up, otherwise gazebo::physics::World::SetState
-  // is not successful
-  collision_benchmark::wrapSDF(ins);
+  std::vector<gazebo::physics::ModelPtr> models(sdfs.size());
+  std::vector<std::string> modelNames(sdfs.size());
 
-  std::vector<std::string> insertions;
-  insertions.push_back(ins);
-  tempState.SetInsertions(insertions);
+  // load the models
+  bool pausedState=world->IsPaused();
+  world->SetPaused(true);
 
-  world->SetState(tempState);
+  // indices of the models which could not be inserted directly
+  std::vector<unsigned int> viaState;
+  for (unsigned int i = 0; i < sdfs.size(); ++i)
+  {
+    modelNames[i] = PrepareModelSDF(sdfs[i], names.empty() ? "" : names[i]);
+    if (modelNames[i].empty()) continue;
+    models[i] = InsertModel(world, sdfs[i]);
+    if (!models[i]) viaState.push_back(i);
+  }
+
+  // all remaining models are inserted with one state application
+  if (!viaState.empty())
+  {
+    LOG_DEBUG("loader", "Could not insert " << viaState.size()
+                        << " models directly, inserting them via the "
+                        << "world state");
+    std::vector<sdf::ElementPtr> remaining;
+    for (std::vector<unsigned int>::const_iterator it = viaState.begin();
+         it != viaState.end(); ++it)
+    {
+      remaining.push_back(sdfs[*it]);
+    }
+    InsertModelsViaState(world, remaining);
+    for (std::vector<unsigned int>::const_iterator it = viaState.begin();
+         it != viaState.end(); ++it)
+    {
+      models[*it] = world->ModelByName(modelNames[*it]);
+    }
+  }
 
-  gazebo::physics::ModelPtr m = world->ModelByName(modelName);
-  if (!m)
+  for (unsigned int i = 0; i < models.size(); ++i)
   {
-    std::cerr<<"Could not load model "<<modelName<<std::endl;
+    if (!models[i] && !modelNames[i].empty())
+    {
+      LOG_ERROR("loader", "Could not load model "<<modelNames[i]);
+    }
   }
 
   world->SetPaused(pausedState);
 
-  return m;
+  return models;
 }
 
 gazebo::physics::ModelPtr
@@ -512,7 +850,7 @@ collision_benchmark::LoadModelFromSDFString(const std::string& sdfString,
     = collision_benchmark::GetSDFElementFromString(sdfString, "model", name);
   if (!sdfRoot)
   {
-    std::cerr<<"SDF has no tag named 'model' in the root"<<std::endl;
+    LOG_ERROR("loader", "SDF has no tag named 'model' in the root");
   }
   return LoadModelFromSDF(sdfRoot, w, name);
 }
@@ -538,37 +876,16 @@ LoadWorld_helper(const std::string &str,
   }
   catch (gazebo::common::Exception& e)
   {
-    std::cerr << " Exception ocurred when loading world. "
-              << e.GetErrorStr() << std::endl;
+    LOG_ERROR("loader", " Exception ocurred when loading world. "
+                        << e.GetErrorStr());
     return gazebo::physics::WorldPtr();
   }
   if (!sdfRoot)
   {
-    std::cerr << "Could not load world" << std::endl;
+    LOG_ERROR("loader", "Could not load world");
     return world;
   }
-  if (overridePhysics)
-  {
-    if (!sdfRoot->HasElement("physics"))
-    {
-#ifdef DEBUG
-      std::cout << "World in did not have physics, so adding the "
-                << "override physics: " << std::endl
-                << overridePhysics->ToString("")<<std::endl;
-#endif
-      sdf::ElementPtr physics = overridePhysics->Clone();
-      physics->SetParent(sdfRoot);
-      sdfRoot->InsertElement(physics);
-    }
-    else
-    {
-      sdf::ElementPtr sdfPhysics = sdfRoot->GetElement("physics");
-      // std::cout << "World in "<<worldfile<<" has physics: "<<std::endl
-      //           << sdfPhysics->ToString("")<<"overriding with: "
-      //           << std::endl<<overridePhysics->ToString("")<<std::endl;
-      sdfPhysics->Copy(overridePhysics);
-    }
-  }
+  if (overridePhysics) OverridePhysics(sdfRoot, overridePhysics);
   return collision_benchmark::LoadWorldFromSDF(sdfRoot, name);
 }
 
@@ -577,9 +894,8 @@ collision_benchmark::LoadWorldFromFile(const std::string &worldfile,
                                        const std::string& name,
                                        const sdf::ElementPtr& overridePhysics)
 {
-  std::cout << "Loading world from file " << worldfile;
-  if (!name.empty()) std::cout << " (to be named '" << name << "')";
-  std::cout << std::endl;
+  LOG_INFO("loader", "Loading world from file " << worldfile
+                     << (name.empty() ? "" : " (to be named '" + name + "')"));
   return LoadWorld_helper(worldfile, true, name, overridePhysics);
 }
 
@@ -588,9 +904,8 @@ collision_benchmark::LoadWorldFromSDFString(const std::string &xmlStr,
                                             const std::string& name,
                                             const sdf::ElementPtr& overridePhys)
 {
-  std::cout << "Loading world XML string. ";
-  if (!name.empty()) std::cout << " (to be named '" << name << "')";
-  std::cout << std::endl;
+  LOG_INFO("loader", "Loading world XML string. "
+                     << (name.empty() ? "" : " (to be named '" + name + "')"));
   return LoadWorld_helper(xmlStr, false, name, overridePhys);
 }
 
@@ -604,7 +919,7 @@ collision_benchmark::LoadWorld(const std::string& worldfile,
     = LoadWorldFromFile(worldfile, name, overridePhysics);
   if (!world)
   {
-    std::cerr << "Could not load world." << std::endl;
+    LOG_ERROR("loader", "Could not load world.");
     return gazebo::physics::WorldPtr();
   }
 
@@ -615,8 +930,8 @@ collision_benchmark::LoadWorld(const std::string& worldfile,
   // same order of the worlds
   if (!WaitForNamespace(worldNamespace))
   {
-    std::cerr << "Namespace of world '" << worldNamespace
-              << "' was not loaded" << std::endl;
+    LOG_ERROR("loader", "Namespace of world '" << worldNamespace
+                        << "' was not loaded");
     return gazebo::physics::WorldPtr();
   }
   return world;
@@ -631,12 +946,12 @@ collision_benchmark::LoadWorlds(const std::vector<Worldfile>& worldfiles)
   for (std::vector<Worldfile>::const_iterator w = worldfiles.begin();
       w != worldfiles.end(); ++w)
   {
-    std::cout << "Loading world " << w->filename << " (named as '"
-              << w->worldname << "')" << std::endl;
+    LOG_INFO("loader", "Loading world " << w->filename << " (named as '"
+                       << w->worldname << "')");
     gazebo::physics::WorldPtr world = LoadWorld(w->filename, w->worldname);
     if (!world)
     {
-      std::cerr << "Could not load world " << w->filename << std::endl;
+      LOG_ERROR("loader", "Could not load world " << w->filename);
       worlds.clear();
       return worlds;
     }
@@ -37,8 +37,12 @@ class GazeboWorldLoader: public WorldLoader
   // \param _engine the name of the physics engine
   // \param _alwaysCalcContacts constructor parameter for
   //        GazeboPhysicsWorld
+  // \param _physicsSettings the physics settings to use, as file or
+  //        name given to RegisterPhysicsSettings(). If empty, the default
+  //        settings of the engine are used (getPhysicsSettingsSdfFor()).
   public: GazeboWorldLoader(const std::string& _engine,
-                            const bool _alwaysCalcContacts = true);
+                            const bool _alwaysCalcContacts = true,
+                            const std::string& _physicsSettings = "");
 
   // Creates a universal loader that loads up the world specified in
   // the SDF of the world.
@@ -50,6 +54,9 @@ class GazeboWorldLoader: public WorldLoader
           LoadFromSDF(const sdf::ElementPtr& sdf,
                       const std::string& worldname="") const;
 
+  public: virtual sdf::ElementPtr
+          ReadWorldFile(const std::string& filename) const;
+
   public: virtual PhysicsWorldBaseInterface::Ptr
           LoadFromFile(const std::string& filename,
                        const std::string& worldname="") const;
@@ -121,7 +128,9 @@ LoadWorldFromSDFString(const std::string& xmlString,
                        const std::string& name="",
                        const sdf::ElementPtr& overridePhys=sdf::ElementPtr());
 
-/// loads a model from an SDF element
+/// loads a model from an SDF element. The element is passed to the world
+/// directly, without converting it to XML and parsing it again. The model
+/// keeps a copy of \e sdfRoot.
 /// \param name if not empty string, then this name is used to override
 ///       the name in \e sdfRoot, which will change \e sdfRoot itself
 /// \param world the world into which the model is to be loaded
@@ -130,6 +139,18 @@ LoadModelFromSDF(const sdf::ElementPtr& sdfRoot,
                  const gazebo::physics::WorldPtr& world,
                  const std::string& name);
 
+/// loads several models from SDF elements at once, which is faster than
+/// calling LoadModelFromSDF() for each of them.
+/// \param names either empty, or the names to override the names in
+///       \e sdfs (see LoadModelFromSDF()), one for each model.
+/// \param world the world into which the models are to be loaded
+/// \return the loaded models, NULL for those which could not be loaded.
+std::vector<gazebo::physics::ModelPtr>
+LoadModelsFromSDF(const std::vector<sdf::ElementPtr>& sdfs,
+                  const gazebo::physics::WorldPtr& world,
+                  const std::vector<std::string>& names
+                    = std::vector<std::string>());
+
 /// loads a model from an SDF XML string
 /// \param name if not empty string, then this name is used to override the
 ///       name in \e sdfRoot, which will change \e sdfRoot itself
@@ -150,6 +171,28 @@ LoadWorld(const std::string& worldfile,
 /// Must be under the root's ``<world>`` tag.
 sdf::ElementPtr GetPhysicsFromSDF(const std::string& filename);
 
+/// Gets the ``<physics>`` element for \e engine from a process-wide cache,
+/// so that the settings are only parsed once. Files are read again if they
+/// have been modified since they were cached.
+/// The returned element is shared by all callers and must not be changed:
+/// clone it to make changes.
+/// \param settings the file with the physics settings (as for
+///   GetPhysicsFromSDF()), or the name under which settings have been
+///   registered with RegisterPhysicsSettings(). If empty, the default file
+///   returned by getPhysicsSettingsSdfFor() is used.
+/// \return the ``<physics>`` element, or NULL if it could not be read.
+sdf::ElementPtr GetPhysicsSettings(const std::string& engine,
+                                   const std::string& settings = "");
+
+/// Registers the ``<physics>`` element \e physics for \e engine under
+/// \e name, so that GetPhysicsSettings() and GazeboWorldLoader can use
+/// it like a settings file. Use this to create variants of the
+/// default settings without writing them to files. Registering a \e name
+/// again replaces the settings for worlds loaded afterwards.
+void RegisterPhysicsSettings(const std::string& engine,
+                             const std::string& name,
+                             const sdf::ElementPtr& physics);
+
 class Worldfile
 {
   public: Worldfile(const std::string& filename_,
@@ -186,12 +229,15 @@ LoadWorlds(const std::vector<Worldfile>& worldfiles);
 
 /// Waits for the namespace \e worldNamespace to appear in the Gazebo
 /// list of namespaces.
-/// Repeatedly waits for new incoming namespaces (waiting *maximum*
-/// \e sleepTime seconds at each attempt)
-/// and checks whether the given \e worldNamespace is in the list of namespaces.
+/// Returns as soon as the namespace has arrived: the list of namespaces
+/// is checked by a background thread, which wakes up all threads waiting
+/// for a namespace when the list changes.
 /// \param maxWaitTime waits for this maximum time (seconds)
+/// \param sleepTime the list of namespaces is checked every \e sleepTime
+///   seconds. If several threads are waiting, the shortest of their
+///   intervals is used.
 bool WaitForNamespace(std::string worldNamespace, float maxWaitTime = 10,
-                      float sleepTime = 1);
+                      float sleepTime = 0.005);
 
 
 /// return the first namespace loaded on the gazebo server,
@@ -25,6 +25,10 @@
 #include <gazebo/common/common.hh>
 #include <gazebo/physics/physics.hh>
 
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
 
 /**
  * Returns new entities which were added in \e state2 when compared to _state1
@@ -244,5 +248,66 @@ void collision_benchmark::PrintWorldStates
   std::cout << "#####" << std::endl;
 }
 
+std::string collision_benchmark::WorldStateToString
+        (const gazebo::physics::WorldState& state)
+{
+  std::ostringstream str;
+  str << std::setprecision(std::numeric_limits<double>::max_digits10)
+      << state;
+  return str.str();
+}
 
+bool collision_benchmark::WorldStateFromString
+        (const std::string& str, gazebo::physics::WorldState& state)
+{
+  sdf::ElementPtr sdf(new sdf::Element());
+  if (!sdf::initFile("state.sdf", sdf))
+  {
+    std::cerr << "Could not initialize the state SDF" << std::endl;
+    return false;
+  }
+  std::string wrapped = str;
+  wrapSDF(wrapped);
+  if (!sdf::readString(wrapped, sdf))
+  {
+    std::cerr << "Could not parse world state" << std::endl;
+    return false;
+  }
+  state.Load(sdf);
+  return true;
+}
 
+bool collision_benchmark::MakeShapeWorldState
+        (const std::string& worldName,
+         const double simTime,
+         const unsigned long iterations,
+         const std::map<std::string, ShapeModelState>& models,
+         const std::string& linkName,
+         gazebo::physics::WorldState& state)
+{
+  const gazebo::common::Time time(simTime);
+  std::ostringstream str;
+  str << std::setprecision(std::numeric_limits<double>::max_digits10)
+      << "<state world_name='" << worldName << "'>"
+      << "<sim_time>" << time.sec << " " << time.nsec << "</sim_time>"
+      << "<iterations>" << iterations << "</iterations>";
+  for (std::map<std::string, ShapeModelState>::const_iterator
+       it = models.begin(); it != models.end(); ++it)
+  {
+    const ignition::math::Pose3d& pose = it->second.pose;
+    const ignition::math::Vector3d euler = pose.Rot().Euler();
+    std::ostringstream poseStr;
+    poseStr << std::setprecision(std::numeric_limits<double>::max_digits10)
+            << "<pose>" << pose.Pos().X() << " " << pose.Pos().Y() << " "
+            << pose.Pos().Z() << " " << euler.X() << " " << euler.Y() << " "
+            << euler.Z() << "</pose>";
+    const ignition::math::Vector3d& scale = it->second.scale;
+    str << "<model name='" << it->first << "'>" << poseStr.str()
+        << "<scale>" << scale.X() << " " << scale.Y() << " " << scale.Z()
+        << "</scale>"
+        << "<link name='" << linkName << "'>" << poseStr.str() << "</link>"
+        << "</model>";
+  }
+  str << "</state>";
+  return WorldStateFromString(str.str(), state);
+}
@@ -20,6 +20,9 @@
 #include <collision_benchmark/PhysicsWorld.hh>
 #include <gazebo/physics/World.hh>
 
+#include <map>
+#include <string>
+
 namespace collision_benchmark
 {
 
@@ -46,6 +49,44 @@ void PrintWorldStates(const std::vector<gazebo::physics::WorldPtr>& worlds);
 void PrintWorldStates(const std::vector<PhysicsWorldStateInterface
                                         <gazebo::physics::WorldState>::Ptr>& w);
 
+/**
+ * Writes the world state \e state to a string in the SDF format, with
+ * the full precision of the values.
+ */
+std::string WorldStateToString(const gazebo::physics::WorldState& state);
+
+/**
+ * Reads a world state written with WorldStateToString() into \e state.
+ * \return false if \e str could not be parsed.
+ */
+bool WorldStateFromString(const std::string& str,
+                          gazebo::physics::WorldState& state);
+
+/**
+ * Pose and scale of a model which was created from a shape, with
+ * one link at the pose of the model (like the models added with
+ * GazeboPhysicsWorld::AddModelFromShape()).
+ */
+struct ShapeModelState
+{
+  ignition::math::Pose3d pose;
+  ignition::math::Vector3d scale;
+};
+
+/**
+ * Builds the world state \e state of a world which only has models
+ * created from shapes, for worlds which don't keep their models in Gazebo.
+ * \param models the state of all models, by model name
+ * \param linkName name of the link of each model
+ * \return false if the state could not be built.
+ */
+bool MakeShapeWorldState(const std::string& worldName,
+                         const double simTime,
+                         const unsigned long iterations,
+                         const std::map<std::string, ShapeModelState>& models,
+                         const std::string& linkName,
+                         gazebo::physics::WorldState& state);
+
 }
 
 #endif   // COLLISION_BENCHMARK_GAZEBOWORLDSTATE_
@@ -0,0 +1,572 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_GJKEPA_INL_H
+#define COLLISION_BENCHMARK_GJKEPA_INL_H
+
+#include <ignition/math/Vector3.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace collision_benchmark
+{
+namespace gjk
+{
+
+typedef ignition::math::Vector3d Vec3;
+
+// squared length below which vectors are considered zero
+const double ZERO_SQ = 1e-20;
+// relative tolerance at which GJK and EPA are considered converged
+const double REL_TOL = 1e-06;
+// absolute tolerance at which EPA is considered converged
+const double ABS_TOL = 1e-10;
+// maximum number of iterations of GJK and EPA
+const int MAX_GJK_ITER = 128;
+const int MAX_EPA_ITER = 256;
+
+// Point of the Minkowski difference A-B, along with the support points
+// on A and B it was computed from.
+struct Vertex
+{
+  Vec3 w;
+  Vec3 a;
+  Vec3 b;
+};
+
+// Simplex of the GJK algorithm with the barycentric coordinates of the
+// point closest to the origin.
+struct Simplex
+{
+  Simplex(): n(0) {}
+  Vertex v[4];
+  double l[4];
+  int n;
+};
+
+// Support point of A-B in direction \e dir
+template<typename SupportA, typename SupportB>
+Vertex MinkowskiSupport(const SupportA& a, const SupportB& b, const Vec3& dir)
+{
+  Vertex v;
+  v.a = a(dir);
+  v.b = b(-dir);
+  v.w = v.a - v.b;
+  return v;
+}
+
+// Reduces \e s to the vertices \e i and \e j (or only \e i if j < 0)
+inline void Reduce(Simplex& s, const int i, const int j = -1)
+{
+  const Vertex vi = s.v[i];
+  if (j >= 0)
+  {
+    s.v[1] = s.v[j];
+    s.n = 2;
+  }
+  else
+  {
+    s.n = 1;
+    s.l[0] = 1;
+  }
+  s.v[0] = vi;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Closest point to the origin on the segment \e s.v[0], \e s.v[1].
+// Reduces \e s to the vertices which are needed to express it.
+inline Vec3 ClosestOnSegment(Simplex& s)
+{
+  const Vec3 a = s.v[0].w;
+  const Vec3 ab = s.v[1].w - a;
+  const double len = ab.SquaredLength();
+  const double t = len > 0 ? -a.Dot(ab) / len : 0;
+  if (t <= 0)
+  {
+    Reduce(s, 0);
+    return a;
+  }
+  if (t >= 1)
+  {
+    Reduce(s, 1);
+    return s.v[0].w;
+  }
+  s.l[0] = 1 - t;
+  s.l[1] = t;
+  return a + ab * t;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Closest point to the origin on the triangle \e s.v[0..2],
+// see Ericson, "Real-Time Collision Detection", 2005, chapter 5.1.5.
+// Reduces \e s to the vertices which are needed to express it.
+inline Vec3 ClosestOnTriangle(Simplex& s)
+{
+  const Vec3 a = s.v[0].w;
+  const Vec3 b = s.v[1].w;
+  const Vec3 c = s.v[2].w;
+  const Vec3 ab = b - a;
+  const Vec3 ac = c - a;
+  const double d1 = -ab.Dot(a);
+  const double d2 = -ac.Dot(a);
+  if (d1 <= 0 && d2 <= 0)
+  {
+    Reduce(s, 0);
+    return a;
+  }
+  const double d3 = -ab.Dot(b);
+  const double d4 = -ac.Dot(b);
+  if (d3 >= 0 && d4 <= d3)
+  {
+    Reduce(s, 1);
+    return b;
+  }
+  const double vc = d1 * d4 - d3 * d2;
+  if (vc <= 0 && d1 >= 0 && d3 <= 0)
+  {
+    const double t = d1 / (d1 - d3);
+    Reduce(s, 0, 1);
+    s.l[0] = 1 - t;
+    s.l[1] = t;
+    return a + ab * t;
+  }
+  const double d5 = -ab.Dot(c);
+  const double d6 = -ac.Dot(c);
+  if (d6 >= 0 && d5 <= d6)
+  {
+    Reduce(s, 2);
+    return c;
+  }
+  const double vb = d5 * d2 - d1 * d6;
+  if (vb <= 0 && d2 >= 0 && d6 <= 0)
+  {
+    const double t = d2 / (d2 - d6);
+    Reduce(s, 0, 2);
+    s.l[0] = 1 - t;
+    s.l[1] = t;
+    return a + ac * t;
+  }
+  const double va = d3 * d6 - d5 * d4;
+  if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+  {
+    const double t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    Reduce(s, 1, 2);
+    s.l[0] = 1 - t;
+    s.l[1] = t;
+    return b + (c - b) * t;
+  }
+  const double denom = va + vb + vc;
+  if (denom <= 0)
+  {
+    // degenerate triangle: use the longest edge
+    const double e0 = (b - a).SquaredLength();
+    const double e1 = (c - b).SquaredLength();
+    const double e2 = (a - c).SquaredLength();
+    if (e1 >= e0 && e1 >= e2) Reduce(s, 1, 2);
+    else if (e2 >= e0) Reduce(s, 0, 2);
+    else Reduce(s, 0, 1);
+    return ClosestOnSegment(s);
+  }
+  s.l[1] = vb / denom;
+  s.l[2] = vc / denom;
+  s.l[0] = 1 - s.l[1] - s.l[2];
+  return a + ab * s.l[1] + ac * s.l[2];
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Closest point to the origin on the tetrahedron \e s.v[0..3].
+// Reduces \e s to the vertices which are needed to express it, or leaves
+// it unchanged and returns the origin if the origin is inside.
+inline Vec3 ClosestOnTetrahedron(Simplex& s)
+{
+  // faces, with the index of the opposite vertex in the last position
+  static const int faces[4][4] = {{0, 1, 2, 3}, {0, 2, 3, 1},
+                                  {0, 3, 1, 2}, {1, 3, 2, 0}};
+  double best = std::numeric_limits<double>::max();
+  Vec3 closest;
+  Simplex bestSimplex;
+  for (int f = 0; f < 4; ++f)
+  {
+    const Vec3& a = s.v[faces[f][0]].w;
+    const Vec3& b = s.v[faces[f][1]].w;
+    const Vec3& c = s.v[faces[f][2]].w;
+    const Vec3& d = s.v[faces[f][3]].w;
+    const Vec3 n = (b - a).Cross(c - a);
+    const double signOrigin = -n.Dot(a);
+    const double signOpposite = n.Dot(d - a);
+    // the face is considered if the origin is on the other side of it
+    // than the opposite vertex, or if the tetrahedron is flat.
+    if (signOrigin * signOpposite >= 0 &&
+        signOpposite * signOpposite > ZERO_SQ * n.SquaredLength())
+      continue;
+    Simplex face;
+    face.n = 3;
+    face.v[0] = s.v[faces[f][0]];
+    face.v[1] = s.v[faces[f][1]];
+    face.v[2] = s.v[faces[f][2]];
+    const Vec3 p = ClosestOnTriangle(face);
+    if (p.SquaredLength() < best)
+    {
+      best = p.SquaredLength();
+      closest = p;
+      bestSimplex = face;
+    }
+  }
+  if (bestSimplex.n == 0) return Vec3(0, 0, 0);
+  s = bestSimplex;
+  return closest;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Closest point to the origin on the simplex \e s, which has between
+// one and four vertices. Reduces \e s to the vertices which are needed
+// to express it.
+inline Vec3 ClosestOnSimplex(Simplex& s)
+{
+  switch (s.n)
+  {
+    case 1:
+      s.l[0] = 1;
+      return s.v[0].w;
+    case 2: return ClosestOnSegment(s);
+    case 3: return ClosestOnTriangle(s);
+    default: return ClosestOnTetrahedron(s);
+  }
+}
+
+// Result of Gjk()
+enum GjkStatus { INTERSECT, SEPARATED, NOT_CONVERGED };
+
+/////////////////////////////////////////////////////////////////////////////
+// Runs GJK on the Minkowski difference A-B. Afterwards, \e v is the point
+// of the simplex \e s closest to the origin.
+// \param earlyExit if true, stops as soon as a separating axis is found,
+//    in which case \e v is not the closest point of A-B.
+template<typename SupportA, typename SupportB>
+GjkStatus Gjk(const SupportA& a, const SupportB& b, const bool earlyExit,
+              Simplex& s, Vec3& v)
+{
+  Vec3 dir = b.Center() - a.Center();
+  if (dir.SquaredLength() <= ZERO_SQ) dir.Set(1, 0, 0);
+  s.v[0] = MinkowskiSupport(a, b, dir);
+  s.l[0] = 1;
+  s.n = 1;
+  v = s.v[0].w;
+  for (int i = 0; i < MAX_GJK_ITER; ++i)
+  {
+    const double vv = v.SquaredLength();
+    if (vv <= ZERO_SQ) return INTERSECT;
+    const Vertex w = MinkowskiSupport(a, b, -v);
+    const double vw = v.Dot(w.w);
+    // -v is a separating axis if the support point of A-B in direction -v
+    // does not reach the origin
+    if (earlyExit && vw > 0) return SEPARATED;
+    // no more progress towards the origin: v is the closest point
+    if (vv - vw <= REL_TOL * vv) return SEPARATED;
+    for (int k = 0; k < s.n; ++k)
+    {
+      if ((s.v[k].w - w.w).SquaredLength() <= ZERO_SQ) return SEPARATED;
+    }
+    s.v[s.n++] = w;
+    v = ClosestOnSimplex(s);
+    // no more progress because of rounding errors
+    if (v.SquaredLength() >= vv) return SEPARATED;
+  }
+  return NOT_CONVERGED;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Extends the simplex \e s, which contains the origin, to a tetrahedron
+// with non-zero volume.
+// \return false if A-B is flat, so that this is not possible
+template<typename SupportA, typename SupportB>
+bool ToTetrahedron(const SupportA& a, const SupportB& b, Simplex& s)
+{
+  static const Vec3 axes[6] = {Vec3(1, 0, 0), Vec3(-1, 0, 0), Vec3(0, 1, 0),
+                               Vec3(0, -1, 0), Vec3(0, 0, 1), Vec3(0, 0, -1)};
+  for (int i = 0; s.n == 1 && i < 6; ++i)
+  {
+    const Vertex w = MinkowskiSupport(a, b, axes[i]);
+    if ((w.w - s.v[0].w).SquaredLength() > ZERO_SQ) s.v[s.n++] = w;
+  }
+  if (s.n == 2)
+  {
+    // search in the directions perpendicular to the segment
+    const Vec3 d = s.v[1].w - s.v[0].w;
+    Vec3 e = d.Cross(std::fabs(d.X()) < std::fabs(d.Y()) ?
+                     Vec3(1, 0, 0) : Vec3(0, 1, 0)).Normalized();
+    Vec3 f = d.Cross(e).Normalized();
+    for (int i = 0; s.n == 2 && i < 6; ++i)
+    {
+      const double angle = i * M_PI / 3;
+      const Vertex w = MinkowskiSupport(a, b, e * cos(angle) +
+                                              f * sin(angle));
+      if ((w.w - s.v[0].w).Cross(d).SquaredLength() >
+          ZERO_SQ * d.SquaredLength())
+        s.v[s.n++] = w;
+    }
+  }
+  if (s.n == 3)
+  {
+    const Vec3 n = (s.v[1].w - s.v[0].w).Cross(s.v[2].w - s.v[0].w);
+    for (int sign = 1; s.n == 3 && sign >= -1; sign -= 2)
+    {
+      const Vertex w = MinkowskiSupport(a, b, n * sign);
+      const double dist = n.Dot(w.w - s.v[0].w);
+      if (dist * dist > ZERO_SQ * n.SquaredLength()) s.v[s.n++] = w;
+    }
+  }
+  return s.n == 4;
+}
+
+// Triangle of the EPA polytope with its outward unit normal and its
+// distance to the origin
+struct Face
+{
+  int v[3];
+  Vec3 n;
+  double d;
+};
+
+// Adds the face \e i, \e j, \e k of the polytope \e verts to \e faces
+inline void AddFace(const std::vector<Vertex>& verts, const int i,
+                    const int j, const int k, std::vector<Face>& faces)
+{
+  Face f;
+  f.v[0] = i;
+  f.v[1] = j;
+  f.v[2] = k;
+  f.n = (verts[j].w - verts[i].w).Cross(verts[k].w - verts[i].w);
+  const double len = f.n.Length();
+  if (len > 0)
+  {
+    f.n /= len;
+    f.d = f.n.Dot(verts[i].w);
+  }
+  else
+  {
+    // degenerate faces are never selected as closest face
+    f.d = std::numeric_limits<double>::max();
+  }
+  faces.push_back(f);
+}
+
+// Returns true if the faces \e a and \e b share an edge
+inline bool SharesEdge(const Face& a, const Face& b)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      if (a.v[i] == b.v[(j + 1) % 3] && a.v[(i + 1) % 3] == b.v[j])
+        return true;
+    }
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Writes the witness points of the point \e p on the face \e f to \e result
+inline void SetWitnessPoints(const std::vector<Vertex>& verts, const Face& f,
+                             const Vec3& p, SignedDistanceResult& result)
+{
+  const Vertex& a = verts[f.v[0]];
+  const Vertex& b = verts[f.v[1]];
+  const Vertex& c = verts[f.v[2]];
+  const Vec3 v0 = b.w - a.w;
+  const Vec3 v1 = c.w - a.w;
+  const Vec3 v2 = p - a.w;
+  const double d00 = v0.Dot(v0);
+  const double d01 = v0.Dot(v1);
+  const double d11 = v1.Dot(v1);
+  const double d20 = v2.Dot(v0);
+  const double d21 = v2.Dot(v1);
+  const double denom = d00 * d11 - d01 * d01;
+  double lb = 0, lc = 0;
+  if (denom > 0)
+  {
+    lb = (d11 * d20 - d01 * d21) / denom;
+    lc = (d00 * d21 - d01 * d20) / denom;
+  }
+  const double la = 1 - lb - lc;
+  result.pointA = a.a * la + b.a * lb + c.a * lc;
+  result.pointB = a.b * la + b.b * lb + c.b * lc;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Expanding Polytope Algorithm, starting from the tetrahedron \e s which
+// contains the origin.
+template<typename SupportA, typename SupportB>
+bool Epa(const SupportA& a, const SupportB& b, const Simplex& s,
+         SignedDistanceResult& result)
+{
+  std::vector<Vertex> verts(s.v, s.v + 4);
+  std::vector<Face> faces;
+  static const int tetFaces[4][3] = {{0, 1, 2}, {0, 3, 1},
+                                     {0, 2, 3}, {1, 3, 2}};
+  const Vec3 center = (verts[0].w + verts[1].w + verts[2].w + verts[3].w) / 4;
+  for (int f = 0; f < 4; ++f)
+  {
+    const int i = tetFaces[f][0];
+    int j = tetFaces[f][1];
+    int k = tetFaces[f][2];
+    const Vec3 n = (verts[j].w - verts[i].w).Cross(verts[k].w - verts[i].w);
+    if (n.Dot(verts[i].w - center) < 0) std::swap(j, k);
+    AddFace(verts, i, j, k, faces);
+  }
+
+  bool converged = false;
+  std::size_t closest = 0;
+  double upper = std::numeric_limits<double>::max();
+  std::vector<std::pair<int, int> > horizon;
+  for (int iter = 0; iter < MAX_EPA_ITER; ++iter)
+  {
+    closest = 0;
+    for (std::size_t i = 1; i < faces.size(); ++i)
+      if (faces[i].d < faces[closest].d) closest = i;
+    const Face f = faces[closest];
+    const Vertex w = MinkowskiSupport(a, b, f.n);
+    // the penetration depth is between the distance of the closest face
+    // and the smallest extent of A-B along any of the face normals
+    upper = std::min(upper, f.n.Dot(w.w));
+    if (upper - f.d <= REL_TOL * std::fabs(upper) + ABS_TOL)
+    {
+      converged = true;
+      break;
+    }
+
+    // remove the faces which can be seen from the new vertex, starting from
+    // the closest face and proceeding to neighbouring faces only, so that
+    // the removed faces form one connected region. Faces which are almost
+    // coplanar with the new vertex are kept to avoid folds in the polytope.
+    std::vector<bool> removed(faces.size(), false);
+    std::vector<std::size_t> front(1, closest);
+    removed[closest] = true;
+    while (!front.empty())
+    {
+      const Face& r = faces[front.back()];
+      front.pop_back();
+      for (std::size_t i = 0; i < faces.size(); ++i)
+      {
+        if (removed[i] || faces[i].d == std::numeric_limits<double>::max() ||
+            !SharesEdge(r, faces[i]) ||
+            faces[i].n.Dot(w.w - verts[faces[i].v[0]].w) <= ABS_TOL)
+          continue;
+        removed[i] = true;
+        front.push_back(i);
+      }
+    }
+
+    // replace the removed faces by faces connecting their boundary (the
+    // horizon) to the new vertex
+    horizon.clear();
+    std::vector<Face> kept;
+    kept.reserve(faces.size());
+    for (std::size_t i = 0; i < faces.size(); ++i)
+    {
+      if (!removed[i])
+      {
+        kept.push_back(faces[i]);
+        continue;
+      }
+      for (int e = 0; e < 3; ++e)
+      {
+        const std::pair<int, int> edge(faces[i].v[e],
+                                       faces[i].v[(e + 1) % 3]);
+        std::vector<std::pair<int, int> >::iterator twin =
+          std::find(horizon.begin(), horizon.end(),
+                    std::make_pair(edge.second, edge.first));
+        if (twin != horizon.end()) horizon.erase(twin);
+        else horizon.push_back(edge);
+      }
+    }
+    const int newVertex = verts.size();
+    verts.push_back(w);
+    faces.swap(kept);
+    for (std::vector<std::pair<int, int> >::const_iterator it =
+         horizon.begin(); it != horizon.end(); ++it)
+      AddFace(verts, it->first, it->second, newVertex, faces);
+  }
+
+  if (!converged)
+  {
+    closest = 0;
+    for (std::size_t i = 1; i < faces.size(); ++i)
+      if (faces[i].d < faces[closest].d) closest = i;
+  }
+  const Face& f = faces[closest];
+  result.distance = -std::max(f.d, 0.0);
+  result.normal = f.n;
+  SetWitnessPoints(verts, f, f.n * f.d, result);
+  return converged;
+}
+
+}  // namespace gjk
+
+/////////////////////////////////////////////////////////////////////////////
+template<typename SupportA, typename SupportB>
+bool GjkIntersect(const SupportA& a, const SupportB& b)
+{
+  gjk::Simplex s;
+  gjk::Vec3 v;
+  return gjk::Gjk(a, b, true, s, v) != gjk::SEPARATED;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+template<typename SupportA, typename SupportB>
+bool GjkEpa(const SupportA& a, const SupportB& b,
+            SignedDistanceResult& result)
+{
+  gjk::Simplex s;
+  gjk::Vec3 v;
+  const gjk::GjkStatus status = gjk::Gjk(a, b, false, s, v);
+  if (status != gjk::INTERSECT)
+  {
+    // v = pointA - pointB
+    result.pointA.Set(0, 0, 0);
+    result.pointB.Set(0, 0, 0);
+    for (int i = 0; i < s.n; ++i)
+    {
+      result.pointA += s.v[i].a * s.l[i];
+      result.pointB += s.v[i].b * s.l[i];
+    }
+    result.distance = v.Length();
+    result.normal = -v / result.distance;
+    return status == gjk::SEPARATED;
+  }
+
+  if (!gjk::ToTetrahedron(a, b, s))
+  {
+    // A-B is flat and contains the origin, so the shapes are touching
+    result.distance = 0;
+    result.pointA = s.v[0].a;
+    result.pointB = s.v[0].b;
+    result.normal = b.Center() - a.Center();
+    if (result.normal.SquaredLength() > gjk::ZERO_SQ)
+      result.normal.Normalize();
+    else
+      result.normal.Set(0, 0, 1);
+    return true;
+  }
+  return gjk::Epa(a, b, s, result);
+}
+
+}  // namespace
+#endif  // COLLISION_BENCHMARK_GJKEPA_INL_H
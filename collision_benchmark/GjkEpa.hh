@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_GJKEPA_H
+#define COLLISION_BENCHMARK_GJKEPA_H
+
+#include <ignition/math/Vector3.hh>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Result of a signed distance query between two convex shapes.
+ */
+struct SignedDistanceResult
+{
+  SignedDistanceResult(): distance(0) {}
+
+  // Distance between the shapes if they are separated, or the negative
+  // penetration depth if they intersect.
+  double distance;
+  // Unit vector pointing from the first to the second shape. If the shapes
+  // are separated, this is the direction from \e pointA to \e pointB.
+  // If they intersect, this is the direction in which the second shape
+  // has to be moved by the penetration depth to separate the shapes.
+  ignition::math::Vector3d normal;
+  // Witness point on the first shape: the point closest to the second shape
+  // if they are separated, or the deepest point within the second
+  // shape if they intersect.
+  ignition::math::Vector3d pointA;
+  // Witness point on the second shape, defined like \e pointA.
+  ignition::math::Vector3d pointB;
+};
+
+/**
+ * \brief Boolean intersection test of two convex shapes given by their
+ * support functions, with the GJK algorithm (Gilbert, Johnson and Keerthi,
+ * "A fast procedure for computing the distance between complex objects
+ * in three-dimensional space", 1988).
+ *
+ * The support function types need to provide
+ * ``ignition::math::Vector3d operator()(const ignition::math::Vector3d& dir)``,
+ * which returns the point of the shape furthest in direction \e dir,
+ * and ``ignition::math::Vector3d Center()``, which returns a point
+ * within the shape. Touching shapes are considered intersecting.
+ */
+template<typename SupportA, typename SupportB>
+bool GjkIntersect(const SupportA& a, const SupportB& b);
+
+/**
+ * \brief Computes the signed distance between two convex shapes given by
+ * their support functions (see GjkIntersect()).
+ *
+ * If the shapes are separated, the distance and the closest points are
+ * computed with GJK. If they intersect, the penetration depth and direction
+ * are computed with the Expanding Polytope Algorithm (van den Bergen,
+ * "Proximity Queries and Penetration Depth Computation on 3D Game Objects",
+ * 2001). For shapes with curved surfaces, both converge to within a
+ * relative tolerance of about 1e-06 of the exact values.
+ *
+ * \param[out] result the signed distance, normal and witness points
+ * \return false if the algorithm did not converge within the maximum
+ *    number of iterations. \e result then contains the best estimate: if
+ *    the shapes intersect, the penetration depth is not overestimated.
+ */
+template<typename SupportA, typename SupportB>
+bool GjkEpa(const SupportA& a, const SupportB& b,
+            SignedDistanceResult& result);
+
+}  // namespace
+
+#include <collision_benchmark/GjkEpa-inl.hh>
+
+#endif  // COLLISION_BENCHMARK_GJKEPA_H
@@ -0,0 +1,363 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/Logger.hh>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using collision_benchmark::Logger;
+using collision_benchmark::LogSite;
+
+namespace
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// Parses \e str as level name. Returns false if it is not a level.
+bool ParseLevel(const std::string& str, Logger::Level& level)
+{
+  if (str == "error") level = Logger::LEVEL_ERROR;
+  else if (str == "warning" || str == "warn") level = Logger::LEVEL_WARNING;
+  else if (str == "info") level = Logger::LEVEL_INFO;
+  else if (str == "debug") level = Logger::LEVEL_DEBUG;
+  else return false;
+  return true;
+}
+
+// All subsystems and their levels
+struct Registry
+{
+  // reads the levels from the environment variable
+  Registry():
+    defaultLevel(Logger::LEVEL_INFO)
+  {
+    const char * env = getenv("COLLISION_BENCHMARK_LOG");
+    if (!env) return;
+    std::stringstream str(env);
+    std::string item;
+    while (std::getline(str, item, ','))
+    {
+      Logger::Level level;
+      size_t eq = item.find('=');
+      if ((eq == std::string::npos) && ParseLevel(item, level))
+        defaultLevel = level;
+      else if ((eq != std::string::npos) &&
+               ParseLevel(item.substr(eq + 1), level))
+        levels[item.substr(0, eq)] = level;
+      else
+        std::cerr << "Invalid item in COLLISION_BENCHMARK_LOG: "
+                  << item << std::endl;
+    }
+  }
+
+  std::mutex mutex;
+  Logger::Level defaultLevel;
+  // levels given for specific subsystems
+  std::map<std::string, Logger::Level> levels;
+  // all subsystems. They are never deleted, as the log sites keep
+  // pointers to them.
+  std::map<std::string, Logger::Subsystem*> subsystems;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+Registry& GetRegistry()
+{
+  static Registry registry;
+  return registry;
+}
+
+// A message to be written
+struct Message
+{
+  Message(): subsystem(NULL), level(Logger::LEVEL_INFO) {}
+  const Logger::Subsystem * subsystem;
+  Logger::Level level;
+  std::string msg;
+};
+
+// An element of the queue
+struct Entry
+{
+  Message message;
+  std::atomic<Entry*> next;
+};
+
+/**
+ * Queue of messages with multiple producers and one consumer, which is
+ * a background thread writing the messages. Adding a message is lock-free:
+ * producers only swap the head of a linked list. The writing thread sleeps
+ * while the queue is empty, and producers only lock to wake it up.
+ */
+class Writer
+{
+  public: Writer():
+    stub(new Entry()),
+    head(stub),
+    tail(stub),
+    stop(false),
+    sleeping(false),
+    queued(0),
+    written(0),
+    out(NULL)
+  {
+    stub->next = NULL;
+  }
+
+  public: ~Writer()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    wakeCond.notify_all();
+    if (thread.joinable()) thread.join();
+    Message m;
+    while (Pop(m)) Write(m);
+    delete tail;
+  }
+
+  // adds \e e to the queue, and starts the writing thread if needed
+  public: void Push(Entry * e)
+  {
+    std::call_once(started, [this]()
+      { this->thread = std::thread(&Writer::Run, this); });
+    e->next.store(NULL, std::memory_order_relaxed);
+    queued.fetch_add(1, std::memory_order_relaxed);
+    Entry * prev = head.exchange(e, std::memory_order_acq_rel);
+    // Sequentially consistent, like the accesses to sleeping in Run():
+    // either the writing thread sees the new entry before it sleeps,
+    // or this thread sees that it sleeps.
+    prev->next.store(e, std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_seq_cst))
+    {
+      // the writing thread holds the lock until it waits, so the
+      // notification can't get lost
+      std::lock_guard<std::mutex> lock(mutex);
+      wakeCond.notify_one();
+    }
+  }
+
+  // waits until all entries queued before have been written
+  public: void Flush()
+  {
+    const uint64_t target = queued.load();
+    std::unique_lock<std::mutex> lock(mutex);
+    writtenCond.wait(lock, [this, target]()
+                     { return this->written.load() >= target; });
+  }
+
+  public: void SetOutput(std::ostream * _out)
+  {
+    Flush();
+    out = _out;
+  }
+
+  // Removes the oldest message and moves it to \e m.
+  // Must only be called by one thread at a time.
+  // \retval false the queue is empty
+  private: bool Pop(Message& m)
+  {
+    Entry * next = tail->next.load(std::memory_order_acquire);
+    if (!next) return false;
+    // the old tail is the stub or an entry which was already taken,
+    // next becomes the new stub.
+    m.subsystem = next->message.subsystem;
+    m.level = next->message.level;
+    m.msg.swap(next->message.msg);
+    delete tail;
+    tail = next;
+    return true;
+  }
+
+  private: void Write(const Message& m)
+  {
+    std::ostream * o = out.load();
+    if (!o) o = (m.level <= Logger::LEVEL_WARNING) ? &std::cerr : &std::cout;
+    *o << "[" << Logger::GetLevelName(m.level) << "] ["
+       << m.subsystem->name << "] " << m.msg << std::endl;
+  }
+
+  // writes the entries until stop is set
+  private: void Run()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stop)
+    {
+      lock.unlock();
+      Message m;
+      while (Pop(m))
+      {
+        Write(m);
+        written.fetch_add(1);
+      }
+      lock.lock();
+      writtenCond.notify_all();
+      sleeping.store(true, std::memory_order_seq_cst);
+      wakeCond.wait(lock, [this]()
+        {
+          return this->stop ||
+                 this->tail->next.load(std::memory_order_seq_cst);
+        });
+      sleeping.store(false, std::memory_order_relaxed);
+    }
+  }
+
+  // the stub the list starts with
+  private: Entry * stub;
+  // newest entry, where producers add
+  private: std::atomic<Entry*> head;
+  // entry before the oldest entry, only accessed by the writing thread
+  private: Entry * tail;
+
+  private: std::thread thread;
+  private: std::once_flag started;
+  private: std::atomic<bool> stop;
+  // whether the writing thread waits for new entries
+  private: std::atomic<bool> sleeping;
+  // protects the waits of the writing thread and of Flush()
+  private: std::mutex mutex;
+  // signalled when entries were added while the writing thread sleeps
+  private: std::condition_variable wakeCond;
+  // signalled when the writing thread has written all entries
+  private: std::condition_variable writtenCond;
+  // number of queued and written entries
+  private: std::atomic<uint64_t> queued, written;
+  // output to use for all messages, or NULL
+  private: std::atomic<std::ostream*> out;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+Writer& GetWriter()
+{
+  static Writer writer;
+  return writer;
+}
+
+}  // anonymous namespace
+
+/////////////////////////////////////////////////////////////////////////////
+Logger::Subsystem * Logger::GetSubsystem(const std::string& name)
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::map<std::string, Subsystem*>::iterator it =
+    registry.subsystems.find(name);
+  if (it != registry.subsystems.end()) return it->second;
+  Level level = registry.defaultLevel;
+  std::map<std::string, Level>::iterator lIt = registry.levels.find(name);
+  if (lIt != registry.levels.end()) level = lIt->second;
+  Subsystem * subsystem = new Subsystem(name, level);
+  registry.subsystems[name] = subsystem;
+  return subsystem;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Logger::SetLevel(const std::string& name, const Level level)
+{
+  Subsystem * subsystem = GetSubsystem(name);
+  subsystem->level = level;
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.levels[name] = level;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Logger::SetLevel(const Level level)
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.defaultLevel = level;
+  registry.levels.clear();
+  for (std::map<std::string, Subsystem*>::iterator
+       it = registry.subsystems.begin(); it != registry.subsystems.end(); ++it)
+    it->second->level = level;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Logger::SetOutput(std::ostream * out)
+{
+  GetWriter().SetOutput(out);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Logger::Log(const Subsystem& subsystem, const Level level,
+                 const std::string& msg)
+{
+  Entry * e = new Entry();
+  e->message.subsystem = &subsystem;
+  e->message.level = level;
+  e->message.msg = msg;
+  Writer& writer = GetWriter();
+  writer.Push(e);
+  // errors are written before returning, so that they are not lost if
+  // the program crashes, and appear in order with other output
+  if (level == LEVEL_ERROR) writer.Flush();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Logger::Flush()
+{
+  GetWriter().Flush();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+const char * Logger::GetLevelName(const Level level)
+{
+  switch (level)
+  {
+    case LEVEL_ERROR: return "ERROR";
+    case LEVEL_WARNING: return "WARNING";
+    case LEVEL_INFO: return "INFO";
+    case LEVEL_DEBUG: return "DEBUG";
+  }
+  return "";
+}
+
+const unsigned int LogSite::MAX_PER_SECOND;
+
+/////////////////////////////////////////////////////////////////////////////
+LogSite::LogSite(const std::string& subsystemName):
+  subsystem(Logger::GetSubsystem(subsystemName)),
+  windowStart(0),
+  windowCount(0),
+  suppressed(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool LogSite::AllowRate()
+{
+  const int64_t now = std::chrono::duration_cast<std::chrono::seconds>
+    (std::chrono::steady_clock::now().time_since_epoch()).count();
+  int64_t start = windowStart.load(std::memory_order_relaxed);
+  if ((now != start) &&
+      windowStart.compare_exchange_strong(start, now,
+                                          std::memory_order_relaxed))
+  {
+    // this thread started the new window
+    windowCount.store(0, std::memory_order_relaxed);
+  }
+  if (windowCount.fetch_add(1, std::memory_order_relaxed) < MAX_PER_SECOND)
+    return true;
+  suppressed.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_LOGGER_H
+#define COLLISION_BENCHMARK_LOGGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Leveled, asynchronous and rate-limited logging for the library.
+ *
+ * Each message belongs to a subsystem (e.g. "physics", "mirror"), and each
+ * subsystem has its own verbosity level. The levels can be set with
+ * SetLevel(), or with the environment variable COLLISION_BENCHMARK_LOG,
+ * which is a comma-separated list of either a level for all subsystems,
+ * or \<subsystem\>=\<level\> pairs, e.g. "warning,physics=debug".
+ * The default level is INFO.
+ *
+ * Messages are written with the macros LOG_ERROR(), LOG_WARN(), LOG_INFO()
+ * and LOG_DEBUG(), which only build the message if it is going to be
+ * written. Each place in the code which logs is limited to
+ * LogSite::MAX_PER_SECOND messages per second. The number of suppressed
+ * messages is appended to the next message which is written.
+ *
+ * Messages are put into a lock-free queue and written by a background
+ * thread, so logging threads don't wait for the output streams. Only
+ * errors are written before Log() returns, so that they are not lost if the
+ * program crashes afterwards. Errors and warnings are written to std::cerr,
+ * all other messages to std::cout, unless SetOutput() is used. Call Flush()
+ * to wait until all messages have been written.
+ */
+class Logger
+{
+  // the levels, prefixed because DEBUG is defined as a macro in debug builds
+  public: enum Level
+  {
+    LEVEL_ERROR = 0,
+    LEVEL_WARNING = 1,
+    LEVEL_INFO = 2,
+    LEVEL_DEBUG = 3
+  };
+
+  // Verbosity of one subsystem
+  public: struct Subsystem
+  {
+    explicit Subsystem(const std::string& _name, const Level _level):
+      name(_name), level(_level) {}
+    const std::string name;
+    std::atomic<int> level;
+  };
+
+  // Returns the subsystem \e name, which is created with the level given in
+  // the environment variable, or the default level, if it does not exist.
+  // The returned object is valid until the end of the program.
+  public: static Subsystem * GetSubsystem(const std::string& name);
+
+  // Sets the level of subsystem \e name. Messages with a higher level
+  // than \e level are not written.
+  public: static void SetLevel(const std::string& name, const Level level);
+
+  // Sets the level of all subsystems, including those which are created
+  // later.
+  public: static void SetLevel(const Level level);
+
+  // Writes all messages to \e out instead of std::cout and std::cerr.
+  // Set to NULL to use std::cout and std::cerr again. \e out must remain
+  // valid until it is replaced, or until after the last Flush().
+  public: static void SetOutput(std::ostream * out);
+
+  // Queues \e msg for writing, and waits until it is written if \e level
+  // is LEVEL_ERROR. Use the LOG_*() macros instead of calling this directly.
+  public: static void Log(const Subsystem& subsystem, const Level level,
+                          const std::string& msg);
+
+  // Waits until all messages which were queued before have been written.
+  public: static void Flush();
+
+  // Returns the name of \e level
+  public: static const char * GetLevelName(const Level level);
+};
+
+/**
+ * \brief State of one place in the code which logs messages,
+ * to determine whether a message is written.
+ */
+class LogSite
+{
+  // maximum number of messages written per second from one site
+  public: static const unsigned int MAX_PER_SECOND = 10;
+
+  public: explicit LogSite(const std::string& subsystemName);
+
+  // Returns true if a message with \e level is to be written. Counts the
+  // message as suppressed if it exceeds the rate limit.
+  public: bool Allow(const Logger::Level level)
+          {
+            if (level > subsystem->level.load(std::memory_order_relaxed))
+              return false;
+            return AllowRate();
+          }
+
+  // Returns the subsystem of this site
+  public: const Logger::Subsystem& GetSubsystem() const { return *subsystem; }
+
+  // Returns the number of messages which were suppressed since the last
+  // call of this function.
+  public: unsigned int TakeSuppressed()
+          {
+            return suppressed.exchange(0, std::memory_order_relaxed);
+          }
+
+  // Returns true if the rate limit is not exceeded
+  private: bool AllowRate();
+
+  private: const Logger::Subsystem * subsystem;
+  // start of the current one-second window, in seconds of the steady clock
+  private: std::atomic<int64_t> windowStart;
+  // number of messages written in the current window
+  private: std::atomic<unsigned int> windowCount;
+  // number of messages suppressed because of the rate limit
+  private: std::atomic<unsigned int> suppressed;
+};
+
+}  // namespace
+
+// Logs the message \e msg, which may be a stream expression
+// (e.g. "value: " << value), for the subsystem with the given name
+#define COLLISION_BENCHMARK_LOG(subsystemName, level, msg) \
+  do { \
+    static collision_benchmark::LogSite logSite_(subsystemName); \
+    if (logSite_.Allow(level)) \
+    { \
+      std::ostringstream logStr_; \
+      logStr_ << msg; \
+      const unsigned int logSuppressed_ = logSite_.TakeSuppressed(); \
+      if (logSuppressed_ > 0) \
+        logStr_ << " (" << logSuppressed_ << " similar messages suppressed)"; \
+      collision_benchmark::Logger::Log(logSite_.GetSubsystem(), level, \
+                                       logStr_.str()); \
+    } \
+  } while (0)
+
+#define LOG_ERROR(subsystemName, msg) \
+  COLLISION_BENCHMARK_LOG(subsystemName, \
+                          collision_benchmark::Logger::LEVEL_ERROR, msg)
+#define LOG_WARN(subsystemName, msg) \
+  COLLISION_BENCHMARK_LOG(subsystemName, \
+                          collision_benchmark::Logger::LEVEL_WARNING, msg)
+#define LOG_INFO(subsystemName, msg) \
+  COLLISION_BENCHMARK_LOG(subsystemName, \
+                          collision_benchmark::Logger::LEVEL_INFO, msg)
+#define LOG_DEBUG(subsystemName, msg) \
+  COLLISION_BENCHMARK_LOG(subsystemName, \
+                          collision_benchmark::Logger::LEVEL_DEBUG, msg)
+
+#endif  // COLLISION_BENCHMARK_LOGGER_H
@@ -0,0 +1,438 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_MESHDECIMATION_INL_H
+#define COLLISION_BENCHMARK_MESHDECIMATION_INL_H
+
+#include <ignition/math/Vector3.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace collision_benchmark
+{
+namespace decimation
+{
+
+typedef ignition::math::Vector3d Vec3;
+
+// Symmetric 4x4 quadric matrix, stored as the upper triangle:
+// [a b c d; b e f g; c f h i; d g i j]
+struct Quadric
+{
+  Quadric() { std::fill(m, m + 10, 0.0); }
+
+  // quadric for the plane with unit normal \e n and offset \e d
+  // (n.x + d = 0), scaled by \e w
+  Quadric(const Vec3& n, const double d, const double w)
+  {
+    const double a = n.X(), b = n.Y(), c = n.Z();
+    m[0] = w*a*a; m[1] = w*a*b; m[2] = w*a*c; m[3] = w*a*d;
+    m[4] = w*b*b; m[5] = w*b*c; m[6] = w*b*d;
+    m[7] = w*c*c; m[8] = w*c*d;
+    m[9] = w*d*d;
+  }
+
+  Quadric& operator+=(const Quadric& o)
+  {
+    for (int i = 0; i < 10; ++i) m[i] += o.m[i];
+    return *this;
+  }
+
+  Quadric operator+(const Quadric& o) const
+  {
+    Quadric r(*this);
+    r += o;
+    return r;
+  }
+
+  double Error(const Vec3& v) const
+  {
+    const double x = v.X(), y = v.Y(), z = v.Z();
+    return m[0]*x*x + 2*m[1]*x*y + 2*m[2]*x*z + 2*m[3]*x
+         + m[4]*y*y + 2*m[5]*y*z + 2*m[6]*y
+         + m[7]*z*z + 2*m[8]*z
+         + m[9];
+  }
+
+  // Computes the position minimizing the error. Returns false if the
+  // system is (close to) singular.
+  bool Optimum(Vec3& v) const
+  {
+    const double det = m[0] * (m[4]*m[7] - m[5]*m[5])
+                     - m[1] * (m[1]*m[7] - m[5]*m[2])
+                     + m[2] * (m[1]*m[5] - m[4]*m[2]);
+    if (std::fabs(det) < 1e-12) return false;
+    const double inv = 1.0 / det;
+    // Cramer's rule for A v = -b
+    const double bx = -m[3], by = -m[6], bz = -m[8];
+    v.Set(inv * (bx * (m[4]*m[7] - m[5]*m[5])
+               - m[1] * (by*m[7] - m[5]*bz)
+               + m[2] * (by*m[5] - m[4]*bz)),
+          inv * (m[0] * (by*m[7] - bz*m[5])
+               - bx * (m[1]*m[7] - m[5]*m[2])
+               + m[2] * (m[1]*bz - by*m[2])),
+          inv * (m[0] * (m[4]*bz - m[5]*by)
+               - m[1] * (m[1]*bz - by*m[2])
+               + bx * (m[1]*m[5] - m[4]*m[2])));
+    return true;
+  }
+
+  double m[10];
+};
+
+// candidate for an edge collapse in the priority queue
+struct Collapse
+{
+  double cost;
+  std::size_t v1, v2;
+  // versions of v1 and v2 at the time the candidate was computed
+  unsigned int ver1, ver2;
+  Vec3 pos;
+
+  bool operator<(const Collapse& o) const
+  {
+    // lowest cost has highest priority
+    return cost > o.cost;
+  }
+};
+
+// Working data for the decimation
+class Decimator
+{
+  public: Decimator(const std::vector<Vec3>& verts,
+                    const std::vector<std::size_t>& triIndices):
+            pos(verts),
+            quadrics(verts.size()),
+            vertFaces(verts.size()),
+            vertAlive(verts.size(), true),
+            version(verts.size(), 0),
+            numAlive(triIndices.size() / 3)
+  {
+    faces.resize(numAlive);
+    faceAlive.resize(numAlive, true);
+    for (std::size_t i = 0; i < numAlive; ++i)
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        faces[i].v[k] = triIndices[3 * i + k];
+        vertFaces[faces[i].v[k]].push_back(i);
+      }
+    }
+  }
+
+  // Decimates until \e target faces are reached
+  public: void Run(const std::size_t target)
+  {
+    InitQuadrics();
+    InitQueue();
+    while (numAlive > target && !queue.empty())
+    {
+      Collapse c = queue.top();
+      queue.pop();
+      if (!vertAlive[c.v1] || !vertAlive[c.v2] ||
+          version[c.v1] != c.ver1 || version[c.v2] != c.ver2)
+        continue;  // outdated candidate
+      if (!CanCollapse(c.v1, c.v2, c.pos)) continue;
+      DoCollapse(c.v1, c.v2, c.pos);
+    }
+  }
+
+  // Retrieves the resulting mesh, with unreferenced vertices removed.
+  public: void Result(std::vector<Vec3>& outVerts,
+                      std::vector<std::size_t>& outTris) const
+  {
+    std::vector<std::size_t> newIdx(pos.size(),
+                                    std::numeric_limits<std::size_t>::max());
+    outVerts.clear();
+    outTris.clear();
+    for (std::size_t f = 0; f < faces.size(); ++f)
+    {
+      if (!faceAlive[f]) continue;
+      for (int k = 0; k < 3; ++k)
+      {
+        const std::size_t v = faces[f].v[k];
+        if (newIdx[v] == std::numeric_limits<std::size_t>::max())
+        {
+          newIdx[v] = outVerts.size();
+          outVerts.push_back(pos[v]);
+        }
+        outTris.push_back(newIdx[v]);
+      }
+    }
+  }
+
+  private: struct Face
+  {
+    std::size_t v[3];
+    bool Has(const std::size_t i) const
+    { return v[0] == i || v[1] == i || v[2] == i; }
+  };
+
+  // unnormalized face normal (length is twice the area)
+  private: Vec3 FaceNormal(const std::size_t f) const
+  {
+    const Face& face = faces[f];
+    return (pos[face.v[1]] - pos[face.v[0]]).Cross(
+            pos[face.v[2]] - pos[face.v[0]]);
+  }
+
+  private: void InitQuadrics()
+  {
+    // all directed edges, to detect borders
+    std::set<std::pair<std::size_t, std::size_t> > directed;
+    for (std::size_t f = 0; f < faces.size(); ++f)
+    {
+      Vec3 n = FaceNormal(f);
+      const double area2 = n.Length();
+      if (area2 < 1e-20) continue;
+      n = n / area2;
+      const Quadric q(n, -n.Dot(pos[faces[f].v[0]]), area2 / 2.0);
+      for (int k = 0; k < 3; ++k)
+      {
+        quadrics[faces[f].v[k]] += q;
+        directed.insert(std::make_pair(faces[f].v[k], faces[f].v[(k+1)%3]));
+      }
+    }
+
+    // Border edges (no opposite directed edge) get a penalty quadric
+    // for the plane through the edge, perpendicular to the face.
+    static const double borderWeight = 1000;
+    for (std::size_t f = 0; f < faces.size(); ++f)
+    {
+      Vec3 n = FaceNormal(f);
+      if (n.Length() < 1e-20) continue;
+      n.Normalize();
+      for (int k = 0; k < 3; ++k)
+      {
+        const std::size_t a = faces[f].v[k];
+        const std::size_t b = faces[f].v[(k + 1) % 3];
+        if (directed.count(std::make_pair(b, a))) continue;
+        const Vec3 e = pos[b] - pos[a];
+        Vec3 bn = e.Cross(n);
+        if (bn.Length() < 1e-20) continue;
+        bn.Normalize();
+        const Quadric q(bn, -bn.Dot(pos[a]),
+                        borderWeight * e.SquaredLength());
+        quadrics[a] += q;
+        quadrics[b] += q;
+      }
+    }
+  }
+
+  private: void InitQueue()
+  {
+    std::set<std::pair<std::size_t, std::size_t> > edges;
+    for (std::size_t f = 0; f < faces.size(); ++f)
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        const std::size_t a = faces[f].v[k];
+        const std::size_t b = faces[f].v[(k + 1) % 3];
+        edges.insert(std::make_pair(std::min(a, b), std::max(a, b)));
+      }
+    }
+    for (std::set<std::pair<std::size_t, std::size_t> >::const_iterator
+         it = edges.begin(); it != edges.end(); ++it)
+      PushCandidate(it->first, it->second);
+  }
+
+  private: void PushCandidate(const std::size_t a, const std::size_t b)
+  {
+    const Quadric q = quadrics[a] + quadrics[b];
+    Collapse c;
+    c.v1 = a;
+    c.v2 = b;
+    c.ver1 = version[a];
+    c.ver2 = version[b];
+    Vec3 mid = (pos[a] + pos[b]) * 0.5;
+    if (!q.Optimum(c.pos) ||
+        c.pos.Distance(mid) > 2.0 * pos[a].Distance(pos[b]))
+    {
+      // pick the best of the end points and the midpoint
+      c.pos = mid;
+      double best = q.Error(mid);
+      if (q.Error(pos[a]) < best) { best = q.Error(pos[a]); c.pos = pos[a]; }
+      if (q.Error(pos[b]) < best) { c.pos = pos[b]; }
+    }
+    c.cost = q.Error(c.pos);
+    queue.push(c);
+  }
+
+  // collects the vertices adjacent to \e v
+  private: void Neighbours(const std::size_t v,
+                           std::set<std::size_t>& n) const
+  {
+    for (std::vector<std::size_t>::const_iterator it = vertFaces[v].begin();
+         it != vertFaces[v].end(); ++it)
+    {
+      if (!faceAlive[*it]) continue;
+      for (int k = 0; k < 3; ++k)
+        if (faces[*it].v[k] != v) n.insert(faces[*it].v[k]);
+    }
+  }
+
+  private: bool CanCollapse(const std::size_t a, const std::size_t b,
+                            const Vec3& p) const
+  {
+    // link condition: the only common neighbours of a and b may be the
+    // opposite vertices of the faces shared by the edge.
+    std::set<std::size_t> na, nb;
+    Neighbours(a, na);
+    Neighbours(b, nb);
+    if (!na.count(b)) return false;
+    std::size_t common = 0;
+    for (std::set<std::size_t>::const_iterator it = na.begin();
+         it != na.end(); ++it)
+      if (nb.count(*it)) ++common;
+    std::size_t shared = 0;
+    for (std::vector<std::size_t>::const_iterator it = vertFaces[a].begin();
+         it != vertFaces[a].end(); ++it)
+      if (faceAlive[*it] && faces[*it].Has(b)) ++shared;
+    if (common != shared) return false;
+
+    // no remaining face may flip or degenerate
+    const std::size_t ends[2] = {a, b};
+    for (int e = 0; e < 2; ++e)
+    {
+      const std::size_t v = ends[e];
+      for (std::vector<std::size_t>::const_iterator it = vertFaces[v].begin();
+           it != vertFaces[v].end(); ++it)
+      {
+        const std::size_t f = *it;
+        if (!faceAlive[f] || (faces[f].Has(a) && faces[f].Has(b))) continue;
+        const Vec3 before = FaceNormal(f);
+        Vec3 corners[3];
+        for (int k = 0; k < 3; ++k)
+          corners[k] = (faces[f].v[k] == v) ? p : pos[faces[f].v[k]];
+        const Vec3 after = (corners[1] - corners[0]).Cross(
+                            corners[2] - corners[0]);
+        const double lb = before.Length();
+        const double la = after.Length();
+        if (la < 1e-12 * std::max(1.0, lb)) return false;
+        if (lb > 1e-20 && before.Dot(after) < 0.2 * lb * la) return false;
+      }
+    }
+    return true;
+  }
+
+  private: void DoCollapse(const std::size_t a, const std::size_t b,
+                           const Vec3& p)
+  {
+    for (std::vector<std::size_t>::const_iterator it = vertFaces[b].begin();
+         it != vertFaces[b].end(); ++it)
+    {
+      const std::size_t f = *it;
+      if (!faceAlive[f]) continue;
+      if (faces[f].Has(a))
+      {
+        faceAlive[f] = false;
+        --numAlive;
+        continue;
+      }
+      for (int k = 0; k < 3; ++k)
+        if (faces[f].v[k] == b) faces[f].v[k] = a;
+      vertFaces[a].push_back(f);
+    }
+    vertFaces[b].clear();
+    vertAlive[b] = false;
+    ++version[b];
+
+    // drop dead faces from a's list
+    std::vector<std::size_t> alive;
+    alive.reserve(vertFaces[a].size());
+    for (std::vector<std::size_t>::const_iterator it = vertFaces[a].begin();
+         it != vertFaces[a].end(); ++it)
+      if (faceAlive[*it]) alive.push_back(*it);
+    vertFaces[a].swap(alive);
+
+    pos[a] = p;
+    quadrics[a] += quadrics[b];
+    ++version[a];
+
+    std::set<std::size_t> n;
+    Neighbours(a, n);
+    for (std::set<std::size_t>::const_iterator it = n.begin();
+         it != n.end(); ++it)
+    {
+      // all edges of a's neighbours have changed cost as well, but for
+      // efficiency only the edges of a are updated, as is common practice.
+      PushCandidate(a, *it);
+    }
+  }
+
+  private: std::vector<Vec3> pos;
+  private: std::vector<Quadric> quadrics;
+  private: std::vector<std::vector<std::size_t> > vertFaces;
+  private: std::vector<bool> vertAlive;
+  private: std::vector<unsigned int> version;
+  private: std::vector<Face> faces;
+  private: std::vector<bool> faceAlive;
+  private: std::size_t numAlive;
+  private: std::priority_queue<Collapse> queue;
+};
+
+}  // namespace decimation
+
+template<typename VP>
+typename MeshData<VP, 3>::Ptr
+DecimateMesh(const MeshData<VP, 3>& mesh, const unsigned int targetFaces)
+{
+  typedef MeshData<VP, 3> MeshDataT;
+  typedef typename MeshDataT::Vertex Vertex;
+  typedef typename MeshDataT::Face Face;
+
+  const std::vector<Vertex>& inVerts = mesh.GetVertices();
+  const std::vector<Face>& inFaces = mesh.GetFaces();
+  if (inFaces.size() <= targetFaces)
+    return typename MeshDataT::Ptr(new MeshDataT(mesh));
+
+  std::vector<decimation::Vec3> verts;
+  verts.reserve(inVerts.size());
+  for (typename std::vector<Vertex>::const_iterator it = inVerts.begin();
+       it != inVerts.end(); ++it)
+    verts.push_back(decimation::Vec3(it->X(), it->Y(), it->Z()));
+
+  std::vector<std::size_t> tris;
+  tris.reserve(3 * inFaces.size());
+  for (typename std::vector<Face>::const_iterator it = inFaces.begin();
+       it != inFaces.end(); ++it)
+    tris.insert(tris.end(), it->val, it->val + 3);
+
+  decimation::Decimator decimator(verts, tris);
+  decimator.Run(targetFaces);
+  decimator.Result(verts, tris);
+
+  typename MeshDataT::Ptr ret(new MeshDataT());
+  std::vector<Vertex>& outVerts = ret->GetVertices();
+  std::vector<Face>& outFaces = ret->GetFaces();
+  outVerts.reserve(verts.size());
+  for (std::vector<decimation::Vec3>::const_iterator it = verts.begin();
+       it != verts.end(); ++it)
+    outVerts.push_back(Vertex(it->X(), it->Y(), it->Z()));
+  outFaces.reserve(tris.size() / 3);
+  for (std::size_t i = 0; i + 2 < tris.size(); i += 3)
+    outFaces.push_back(Face(tris[i], tris[i + 1], tris[i + 2]));
+  return ret;
+}
+
+}  // namespace
+#endif  // COLLISION_BENCHMARK_MESHDECIMATION_INL_H
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_MESHDECIMATION_H
+#define COLLISION_BENCHMARK_MESHDECIMATION_H
+
+#include <collision_benchmark/MeshData.hh>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Simplifies a triangle mesh by quadric error edge collapses
+ * (Garland and Heckbert, "Surface Simplification Using Quadric Error
+ * Metrics", 1997).
+ *
+ * Edges are collapsed in order of increasing quadric error until the number
+ * of triangles is at most \e targetFaces, or until no more edges can be
+ * collapsed without changing the topology or flipping a triangle.
+ * Open borders of the mesh are preserved by additional penalty quadrics.
+ * Unreferenced vertices are removed from the result.
+ *
+ * \param mesh the mesh to simplify
+ * \param targetFaces the maximum number of triangles the result should have.
+ * \return the simplified mesh. If \e mesh already has at most
+ *    \e targetFaces triangles, a copy of \e mesh is returned.
+ */
+template<typename VP>
+typename MeshData<VP, 3>::Ptr
+DecimateMesh(const MeshData<VP, 3>& mesh, const unsigned int targetFaces);
+
+}  // namespace
+
+#include <collision_benchmark/MeshDecimation-inl.hh>
+
+#endif  // COLLISION_BENCHMARK_MESHDECIMATION_H
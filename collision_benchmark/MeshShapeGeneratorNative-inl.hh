@@ -0,0 +1,387 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_MESHSHAPEGENERATORNATIVE_INL_H
+#define COLLISION_BENCHMARK_MESHSHAPEGENERATORNATIVE_INL_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+template<typename VP>
+typename MeshShapeGeneratorNative<VP>::TriMeshDataPtr
+MeshShapeGeneratorNative<VP>::MakeUVEllipsoid(const double xRad,
+                                              const double yRad,
+                                              const double zRad,
+                                              const unsigned int numLong,
+                                              const unsigned int numLatBands,
+                                              const bool alternate) const
+{
+  typedef typename TriMeshData::Vertex Vertex;
+  typedef typename TriMeshData::Face Face;
+  const unsigned int nLong = std::max(numLong, 3u);
+  const unsigned int nBands = std::max(numLatBands, 2u);
+  const unsigned int nRings = nBands - 1;
+
+  TriMeshDataPtr ret(new TriMeshData());
+  std::vector<Vertex>& verts = ret->GetVertices();
+  std::vector<Face>& faces = ret->GetFaces();
+  verts.reserve(nRings * nLong + 2);
+  faces.reserve(2 * nLong * nBands - 2 * nLong);
+
+  // north pole is vertex 0, then all rings from north to south,
+  // and the south pole is the last vertex.
+  verts.push_back(Vertex(0, 0, zRad));
+  for (unsigned int i = 1; i <= nRings; ++i)
+  {
+    const double v = M_PI * i / nBands;
+    const double sv = sin(v);
+    const double cv = cos(v);
+    for (unsigned int j = 0; j < nLong; ++j)
+    {
+      const double u = 2 * M_PI * j / nLong;
+      verts.push_back(Vertex(xRad * sv * cos(u), yRad * sv * sin(u),
+                             zRad * cv));
+    }
+  }
+  verts.push_back(Vertex(0, 0, -zRad));
+  const std::size_t southIdx = verts.size() - 1;
+
+  for (unsigned int j = 0; j < nLong; ++j)
+  {
+    const unsigned int jn = (j + 1) % nLong;
+    faces.push_back(Face(0, 1 + j, 1 + jn));
+    faces.push_back(Face(southIdx, 1 + (nRings - 1) * nLong + jn,
+                         1 + (nRings - 1) * nLong + j));
+  }
+
+  for (unsigned int i = 0; i + 1 < nRings; ++i)
+  {
+    const std::size_t upper = 1 + i * nLong;
+    const std::size_t lower = upper + nLong;
+    for (unsigned int j = 0; j < nLong; ++j)
+    {
+      const unsigned int jn = (j + 1) % nLong;
+      if (alternate && ((i + j) % 2 == 1))
+      {
+        faces.push_back(Face(upper + j, lower + j, upper + jn));
+        faces.push_back(Face(upper + jn, lower + j, lower + jn));
+      }
+      else
+      {
+        faces.push_back(Face(upper + j, lower + j, lower + jn));
+        faces.push_back(Face(upper + j, lower + jn, upper + jn));
+      }
+    }
+  }
+  return ret;
+}
+
+template<typename VP>
+typename MeshShapeGeneratorNative<VP>::TriMeshDataPtr
+MeshShapeGeneratorNative<VP>::MakeSphere(const double radius,
+                                         const unsigned int theta,
+                                         const unsigned int phi,
+                                         const bool latLongTessel) const
+{
+  // \e phi is the number of points from pole to pole (including the poles)
+  return MakeUVEllipsoid(radius, radius, radius, theta,
+                         phi > 0 ? phi - 1 : 0, !latLongTessel);
+}
+
+template<typename VP>
+typename MeshShapeGeneratorNative<VP>::TriMeshDataPtr
+MeshShapeGeneratorNative<VP>::MakeCylinder(const double radius,
+                                           const double height,
+                                           const unsigned int resolution,
+                                           const bool capping) const
+{
+  typedef typename TriMeshData::Vertex Vertex;
+  typedef typename TriMeshData::Face Face;
+  const unsigned int res = std::max(resolution, 3u);
+  const double halfHeight = height / 2.0;
+
+  TriMeshDataPtr ret(new TriMeshData());
+  std::vector<Vertex>& verts = ret->GetVertices();
+  std::vector<Face>& faces = ret->GetFaces();
+  verts.reserve(2 * res + 2);
+  faces.reserve(4 * res);
+
+  // bottom ring (at -y) is [0..res-1], top ring (at +y) is [res..2*res-1]
+  for (unsigned int j = 0; j < res; ++j)
+  {
+    const double a = 2 * M_PI * j / res;
+    verts.push_back(Vertex(radius * cos(a), -halfHeight, -radius * sin(a)));
+  }
+  for (unsigned int j = 0; j < res; ++j)
+  {
+    const double a = 2 * M_PI * j / res;
+    verts.push_back(Vertex(radius * cos(a), halfHeight, -radius * sin(a)));
+  }
+
+  for (unsigned int j = 0; j < res; ++j)
+  {
+    const unsigned int jn = (j + 1) % res;
+    faces.push_back(Face(j, jn, res + j));
+    faces.push_back(Face(jn, res + jn, res + j));
+  }
+
+  if (capping)
+  {
+    const std::size_t bottomCenter = verts.size();
+    verts.push_back(Vertex(0, -halfHeight, 0));
+    const std::size_t topCenter = verts.size();
+    verts.push_back(Vertex(0, halfHeight, 0));
+    for (unsigned int j = 0; j < res; ++j)
+    {
+      const unsigned int jn = (j + 1) % res;
+      faces.push_back(Face(bottomCenter, jn, j));
+      faces.push_back(Face(topCenter, res + j, res + jn));
+    }
+  }
+  return ret;
+}
+
+template<typename VP>
+typename MeshShapeGeneratorNative<VP>::TriMeshDataPtr
+MeshShapeGeneratorNative<VP>::MakeBox(const double x,
+                                      const double y,
+                                      const double z) const
+{
+  return MakeBox(-x / 2.0, x / 2.0, -y / 2.0, y / 2.0, -z / 2.0, z / 2.0);
+}
+
+template<typename VP>
+typename MeshShapeGeneratorNative<VP>::TriMeshDataPtr
+MeshShapeGeneratorNative<VP>::MakeBox(const double xMin, const double xMax,
+                                      const double yMin, const double yMax,
+                                      const double zMin,
+                                      const double zMax) const
+{
+  typedef typename TriMeshData::Vertex Vertex;
+  typedef typename TriMeshData::Face Face;
+
+  TriMeshDataPtr ret(new TriMeshData());
+  std::vector<Vertex>& verts = ret->GetVertices();
+  std::vector<Face>& faces = ret->GetFaces();
+  verts.reserve(8);
+  faces.reserve(12);
+
+  // vertex index bits: 1 = x, 2 = y, 4 = z (bit set means max coordinate)
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    verts.push_back(Vertex((i & 1) ? xMax : xMin,
+                           (i & 2) ? yMax : yMin,
+                           (i & 4) ? zMax : zMin));
+  }
+
+  // -x and +x
+  faces.push_back(Face(0, 4, 6)); faces.push_back(Face(0, 6, 2));
+  faces.push_back(Face(1, 3, 7)); faces.push_back(Face(1, 7, 5));
+  // -y and +y
+  faces.push_back(Face(0, 1, 5)); faces.push_back(Face(0, 5, 4));
+  faces.push_back(Face(2, 6, 7)); faces.push_back(Face(2, 7, 3));
+  // -z and +z
+  faces.push_back(Face(0, 2, 3)); faces.push_back(Face(0, 3, 1));
+  faces.push_back(Face(4, 5, 7)); faces.push_back(Face(4, 7, 6));
+  return ret;
+}
+
+template<typename VP>
+typename MeshShapeGeneratorNative<VP>::TriMeshDataPtr
+MeshShapeGeneratorNative<VP>::MakeCone(const double radius,
+                                       const double height,
+                                       const unsigned int resolution,
+                                       const double angle_deg,
+                                       const bool capping,
+                                       const double dir_x,
+                                       const double dir_y,
+                                       const double dir_z) const
+{
+  typedef typename TriMeshData::Vertex Vertex;
+  typedef typename TriMeshData::Face Face;
+  typedef ignition::math::Vector3d Vec3;
+  const unsigned int res = std::max(resolution, 3u);
+
+  double baseRadius = radius;
+  if (angle_deg > 0) baseRadius = height * tan(angle_deg * M_PI / 180.0);
+
+  Vec3 axis(dir_x, dir_y, dir_z);
+  if (axis.Length() < 1e-09) axis.Set(1, 0, 0);
+  axis.Normalize();
+
+  // two vectors which, together with the axis, form a right-handed
+  // orthonormal basis.
+  Vec3 helper = (fabs(axis.X()) < 0.9) ? Vec3(1, 0, 0) : Vec3(0, 1, 0);
+  Vec3 e1 = helper.Cross(axis);
+  e1.Normalize();
+  Vec3 e2 = axis.Cross(e1);
+
+  const Vec3 apex = axis * (height / 2.0);
+  const Vec3 baseCenter = axis * (-height / 2.0);
+
+  TriMeshDataPtr ret(new TriMeshData());
+  std::vector<Vertex>& verts = ret->GetVertices();
+  std::vector<Face>& faces = ret->GetFaces();
+  verts.reserve(res + 2);
+  faces.reserve(2 * res);
+
+  // base ring is [0..res-1], the apex is at index res
+  for (unsigned int j = 0; j < res; ++j)
+  {
+    const double a = 2 * M_PI * j / res;
+    const Vec3 p = baseCenter + (e1 * cos(a) + e2 * sin(a)) * baseRadius;
+    verts.push_back(Vertex(p.X(), p.Y(), p.Z()));
+  }
+  verts.push_back(Vertex(apex.X(), apex.Y(), apex.Z()));
+
+  for (unsigned int j = 0; j < res; ++j)
+    faces.push_back(Face(res, j, (j + 1) % res));
+
+  if (capping)
+  {
+    const std::size_t centerIdx = verts.size();
+    verts.push_back(Vertex(baseCenter.X(), baseCenter.Y(), baseCenter.Z()));
+    for (unsigned int j = 0; j < res; ++j)
+      faces.push_back(Face(centerIdx, (j + 1) % res, j));
+  }
+  return ret;
+}
+
+template<typename VP>
+typename MeshShapeGeneratorNative<VP>::TriMeshDataPtr
+MeshShapeGeneratorNative<VP>::MakeDisk(const double innerRadius,
+                                       const double outerRadius,
+                                       const unsigned int radialRes,
+                                       const unsigned int circumRes) const
+{
+  typedef typename TriMeshData::Vertex Vertex;
+  typedef typename TriMeshData::Face Face;
+  const unsigned int rRes = std::max(radialRes, 1u);
+  const unsigned int cRes = std::max(circumRes, 3u);
+  const bool hasCenter = innerRadius <= 0;
+
+  TriMeshDataPtr ret(new TriMeshData());
+  std::vector<Vertex>& verts = ret->GetVertices();
+  std::vector<Face>& faces = ret->GetFaces();
+  verts.reserve((rRes + 1) * cRes + 1);
+  faces.reserve(2 * rRes * cRes);
+
+  // rings from inside to outside. If there is no hole, the innermost
+  // ring degenerates to the center vertex at index 0.
+  unsigned int firstRing = 0;
+  if (hasCenter)
+  {
+    verts.push_back(Vertex(0, 0, 0));
+    firstRing = 1;
+  }
+  const double inner = hasCenter ? 0 : innerRadius;
+  for (unsigned int k = firstRing; k <= rRes; ++k)
+  {
+    const double r = inner + (outerRadius - inner) * k / rRes;
+    for (unsigned int j = 0; j < cRes; ++j)
+    {
+      const double a = 2 * M_PI * j / cRes;
+      verts.push_back(Vertex(r * cos(a), r * sin(a), 0));
+    }
+  }
+
+  // index of the first vertex of the ring k (only valid for ring k
+  // which is not the degenerated center)
+  const std::size_t ringOffset = hasCenter ? 1 : 0;
+  for (unsigned int k = 0; k < rRes; ++k)
+  {
+    const std::size_t outer = ringOffset + (k + 1 - firstRing) * cRes;
+    for (unsigned int j = 0; j < cRes; ++j)
+    {
+      const unsigned int jn = (j + 1) % cRes;
+      if (k < firstRing)
+      {
+        faces.push_back(Face(0, outer + j, outer + jn));
+        continue;
+      }
+      const std::size_t in = outer - cRes;
+      faces.push_back(Face(in + j, outer + j, outer + jn));
+      faces.push_back(Face(in + j, outer + jn, in + jn));
+    }
+  }
+  return ret;
+}
+
+template<typename VP>
+typename MeshShapeGeneratorNative<VP>::TriMeshDataPtr
+MeshShapeGeneratorNative<VP>::MakeEllipsoid(const double xRad,
+                                            const double yRad,
+                                            const double zRad,
+                                            const unsigned int uRes,
+                                            const unsigned int vRes) const
+{
+  // The parametric VTK surfaces sample the closed u and v range including
+  // both ends, so there are uRes-1 distinct sections in u and vRes-1 in v.
+  return MakeUVEllipsoid(xRad, yRad, zRad,
+                         uRes > 0 ? uRes - 1 : 0,
+                         vRes > 0 ? vRes - 1 : 0, false);
+}
+
+template<typename VP>
+typename MeshShapeGeneratorNative<VP>::TriMeshDataPtr
+MeshShapeGeneratorNative<VP>::MakeTorus(const double ringRadius,
+                                        const double crossRadius,
+                                        const unsigned int uRes,
+                                        const unsigned int vRes) const
+{
+  typedef typename TriMeshData::Vertex Vertex;
+  typedef typename TriMeshData::Face Face;
+  // see comment in MakeEllipsoid() about the number of sections
+  const unsigned int nU = std::max(uRes > 0 ? uRes - 1 : 0, 3u);
+  const unsigned int nV = std::max(vRes > 0 ? vRes - 1 : 0, 3u);
+
+  TriMeshDataPtr ret(new TriMeshData());
+  std::vector<Vertex>& verts = ret->GetVertices();
+  std::vector<Face>& faces = ret->GetFaces();
+  verts.reserve(nU * nV);
+  faces.reserve(2 * nU * nV);
+
+  for (unsigned int i = 0; i < nU; ++i)
+  {
+    const double u = 2 * M_PI * i / nU;
+    for (unsigned int j = 0; j < nV; ++j)
+    {
+      const double v = 2 * M_PI * j / nV;
+      const double d = ringRadius + crossRadius * cos(v);
+      verts.push_back(Vertex(d * cos(u), d * sin(u), crossRadius * sin(v)));
+    }
+  }
+
+  for (unsigned int i = 0; i < nU; ++i)
+  {
+    const std::size_t ring = i * nV;
+    const std::size_t nextRing = ((i + 1) % nU) * nV;
+    for (unsigned int j = 0; j < nV; ++j)
+    {
+      const unsigned int jn = (j + 1) % nV;
+      faces.push_back(Face(ring + j, nextRing + j, nextRing + jn));
+      faces.push_back(Face(ring + j, nextRing + jn, ring + jn));
+    }
+  }
+  return ret;
+}
+
+}  // namespace
+#endif  // COLLISION_BENCHMARK_MESHSHAPEGENERATORNATIVE_INL_H
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_MESHSHAPEGENERATORNATIVE_H
+#define COLLISION_BENCHMARK_MESHSHAPEGENERATORNATIVE_H
+
+#include <collision_benchmark/MeshShapeGenerator.hh>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Generates triangle mesh representations of shapes in closed form,
+ * without any dependency on third party libraries.
+ *
+ * The indexed MeshData is emitted directly, and each point on the surface
+ * is represented by exactly one vertex (there are no duplicate vertices, e.g.
+ * at the poles of a sphere or the seams of parametric shapes).
+ * All faces are oriented counter-clockwise when seen from the outside.
+ *
+ * The shapes are oriented in the same way as with MeshShapeGeneratorVtk,
+ * so both implementations can be used interchangeably. Resolutions which
+ * are too low to produce a valid shape are raised to the minimum.
+ */
+template<typename VertexPrecision_=float>
+class MeshShapeGeneratorNative:
+  public MeshShapeGenerator<VertexPrecision_>
+{
+  public: typedef VertexPrecision_ VertexPrecision;
+  private: typedef MeshShapeGeneratorNative<VertexPrecision> Self;
+  private: typedef MeshShapeGenerator<VertexPrecision> Super;
+  public: typedef std::shared_ptr<Self> Ptr;
+  public: typedef std::shared_ptr<const Self> ConstPtr;
+
+  public: typedef typename Super::TriMeshData TriMeshData;
+  public: typedef typename Super::TriMeshDataPtr TriMeshDataPtr;
+
+  public: virtual TriMeshDataPtr MakeSphere(const double radius,
+                                            const unsigned int theta,
+                                            const unsigned int phi,
+                                            const bool latLongTessel) const;
+
+  public: virtual TriMeshDataPtr MakeCylinder(const double radius,
+                                              const double height,
+                                              const unsigned int resolution,
+                                              const bool capping) const;
+
+  public: virtual TriMeshDataPtr MakeBox(const double x,
+                                         const double y,
+                                         const double z) const;
+
+  public: virtual TriMeshDataPtr MakeBox(const double xMin, const double xMax,
+                                         const double yMin, const double yMax,
+                                         const double zMin,
+                                         const double zMax) const;
+
+  // As in the VTK implementation, the cone is centered at the origin with the
+  // apex at ``height/2 * dir``. If \e angle_deg is positive, the base radius
+  // is ``height * tan(angle_deg)`` and \e radius is ignored.
+  public: virtual TriMeshDataPtr MakeCone(const double radius,
+                                          const double height,
+                                          const unsigned int resolution,
+                                          const double angle_deg,
+                                          const bool capping,
+                                          const double dir_x=0,
+                                          const double dir_y=0,
+                                          const double dir_z=1) const;
+
+  // The disk lies in the x/y plane and faces point towards +z. If
+  // \e innerRadius is zero, the center is one single vertex.
+  public: virtual TriMeshDataPtr MakeDisk(const double innerRadius,
+                                          const double outerRadius,
+                                          const unsigned int radialRes,
+                                          const unsigned int circumRes) const;
+
+  public: virtual TriMeshDataPtr MakeEllipsoid(const double xRad,
+                                               const double yRad,
+                                               const double zRad,
+                                               const unsigned int uRes,
+                                               const unsigned int vRes) const;
+
+  public: virtual TriMeshDataPtr MakeTorus(const double ringRadius,
+                                           const double crossRadius,
+                                           const unsigned int uRes,
+                                           const unsigned int vRes) const;
+
+  // Helper which creates an ellipsoid around the z axis with one vertex at
+  // each pole, \e numLong vertices on each ring of latitude and
+  // \e numLatBands bands between the poles.
+  // \param alternate if true, the diagonals used to split the quads between
+  //    two latitude rings alternate, otherwise they all point the same way.
+  private: TriMeshDataPtr MakeUVEllipsoid(const double xRad,
+                                          const double yRad,
+                                          const double zRad,
+                                          const unsigned int numLong,
+                                          const unsigned int numLatBands,
+                                          const bool alternate) const;
+};  // class
+}  // namespace
+
+#include <collision_benchmark/MeshShapeGeneratorNative-inl.hh>
+
+#endif  // COLLISION_BENCHMARK_MESHSHAPEGENERATORNATIVE_H
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/Metrics.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+using collision_benchmark::Metrics;
+
+namespace
+{
+
+// All series of one metric
+struct Family
+{
+  bool isCounter;
+  std::string help;
+  // values by their label string (see LabelString())
+  std::map<std::string, std::shared_ptr<std::atomic<uint64_t> > > counters;
+  std::map<std::string, std::shared_ptr<std::atomic<double> > > gauges;
+};
+
+// All metrics, by name
+struct Registry
+{
+  std::mutex mutex;
+  std::map<std::string, Family> families;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+Registry& GetRegistry()
+{
+  static Registry registry;
+  return registry;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Escapes \e str as required in help texts (\e inLabel = false)
+// or label values (\e inLabel = true)
+std::string Escape(const std::string& str, const bool inLabel)
+{
+  std::stringstream ret;
+  for (std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+  {
+    if (*it == '\\') ret << "\\\\";
+    else if (*it == '\n') ret << "\\n";
+    else if (inLabel && (*it == '"')) ret << "\\\"";
+    else ret << *it;
+  }
+  return ret.str();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Returns the labels as written after the metric name, e.g.
+// {world="a",engine="ode"}, or an empty string if there are no labels.
+std::string LabelString(const Metrics::Labels& labels)
+{
+  if (labels.empty()) return "";
+  std::stringstream ret;
+  ret << "{";
+  for (Metrics::Labels::const_iterator it = labels.begin();
+       it != labels.end(); ++it)
+  {
+    if (it != labels.begin()) ret << ",";
+    ret << it->first << "=\"" << Escape(it->second, true) << "\"";
+  }
+  ret << "}";
+  return ret.str();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Returns the family \e name, which is created if it does not exist.
+// The mutex of \e registry must be locked.
+// \return NULL if the family exists with the other type
+Family * GetFamily(Registry& registry, const std::string& name,
+                   const std::string& help, const bool isCounter)
+{
+  std::map<std::string, Family>::iterator it = registry.families.find(name);
+  if (it == registry.families.end())
+  {
+    Family& family = registry.families[name];
+    family.isCounter = isCounter;
+    family.help = help;
+    return &family;
+  }
+  if (it->second.isCounter != isCounter)
+  {
+    LOG_ERROR("metrics", "Metric " << name << " was registered as "
+                         << (isCounter ? "gauge" : "counter") << " before");
+    return NULL;
+  }
+  return &(it->second);
+}
+
+}  // anonymous namespace
+
+/////////////////////////////////////////////////////////////////////////////
+Metrics::Counter Metrics::GetCounter(const std::string& name,
+                                     const std::string& help,
+                                     const Labels& labels)
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  Family * family = GetFamily(registry, name, help, true);
+  if (!family) return Counter();
+  std::shared_ptr<std::atomic<uint64_t> >& value =
+    family->counters[LabelString(labels)];
+  if (!value) value.reset(new std::atomic<uint64_t>(0));
+  return Counter(value);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+Metrics::Gauge Metrics::GetGauge(const std::string& name,
+                                 const std::string& help,
+                                 const Labels& labels)
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  Family * family = GetFamily(registry, name, help, false);
+  if (!family) return Gauge();
+  std::shared_ptr<std::atomic<double> >& value =
+    family->gauges[LabelString(labels)];
+  if (!value) value.reset(new std::atomic<double>(0));
+  return Gauge(value);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Metrics::Write(std::ostream& out)
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (std::map<std::string, Family>::const_iterator
+       it = registry.families.begin(); it != registry.families.end(); ++it)
+  {
+    const Family& family = it->second;
+    out << "# HELP " << it->first << " " << Escape(family.help, false)
+        << std::endl;
+    out << "# TYPE " << it->first << " "
+        << (family.isCounter ? "counter" : "gauge") << std::endl;
+    for (std::map<std::string, std::shared_ptr<std::atomic<uint64_t> > >::
+         const_iterator c = family.counters.begin();
+         c != family.counters.end(); ++c)
+    {
+      out << it->first << c->first << " " << c->second->load() << std::endl;
+    }
+    for (std::map<std::string, std::shared_ptr<std::atomic<double> > >::
+         const_iterator g = family.gauges.begin();
+         g != family.gauges.end(); ++g)
+    {
+      out << it->first << g->first << " " << g->second->load() << std::endl;
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool Metrics::WriteFile(const std::string& filename)
+{
+  const std::string tmpFilename = filename + ".tmp";
+  {
+    std::ofstream file(tmpFilename.c_str());
+    if (!file.is_open())
+    {
+      LOG_ERROR("metrics", "Could not open file " << tmpFilename);
+      return false;
+    }
+    Write(file);
+    if (!file.good())
+    {
+      LOG_ERROR("metrics", "Could not write file " << tmpFilename);
+      return false;
+    }
+  }
+  if (std::rename(tmpFilename.c_str(), filename.c_str()) != 0)
+  {
+    LOG_ERROR("metrics", "Could not rename " << tmpFilename << " to "
+                         << filename);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_METRICS_H
+#define COLLISION_BENCHMARK_METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Process-wide counters and gauges for monitoring long-running
+ * servers, which can be exported in the Prometheus text format.
+ *
+ * A counter or gauge is identified by its metric name and its labels.
+ * It is looked up once with GetCounter() or GetGauge(), which locks, and
+ * the returned handle can then be updated without locking.
+ *
+ * WriteFile() writes all metrics such that the file is replaced atomically,
+ * as expected by the textfile collector of the Prometheus node exporter.
+ */
+class Metrics
+{
+  // labels of a metric, by label name
+  public: typedef std::map<std::string, std::string> Labels;
+
+  // \brief Handle to a counter, which only increases.
+  // A default constructed counter is not registered and ignores all updates.
+  public: class Counter
+  {
+    public: Counter() {}
+    public: explicit Counter(const std::shared_ptr<std::atomic<uint64_t> >& v):
+            value(v) {}
+
+    // Adds \e n to the counter.
+    public: void Increment(const uint64_t n = 1)
+            {
+              if (value) value->fetch_add(n, std::memory_order_relaxed);
+            }
+
+    // Returns the value of the counter
+    public: uint64_t Get() const { return value ? value->load() : 0; }
+
+    private: std::shared_ptr<std::atomic<uint64_t> > value;
+  };
+
+  // \brief Handle to a gauge, which may go up and down.
+  // A default constructed gauge is not registered and ignores all updates.
+  public: class Gauge
+  {
+    public: Gauge() {}
+    public: explicit Gauge(const std::shared_ptr<std::atomic<double> >& v):
+            value(v) {}
+
+    // Sets the gauge to \e v
+    public: void Set(const double v)
+            {
+              if (value) value->store(v, std::memory_order_relaxed);
+            }
+
+    // Returns the value of the gauge
+    public: double Get() const { return value ? value->load() : 0; }
+
+    private: std::shared_ptr<std::atomic<double> > value;
+  };
+
+  // Returns the counter \e name with the given \e labels, which is
+  // created with value 0 if it does not exist yet.
+  // \param help the description of the metric, used if it is not set yet.
+  // \return a counter which ignores all updates if \e name was already
+  //    registered as a gauge.
+  public: static Counter GetCounter(const std::string& name,
+                                    const std::string& help,
+                                    const Labels& labels = Labels());
+
+  // Returns the gauge \e name with the given \e labels, which is
+  // created with value 0 if it does not exist yet.
+  // \param help the description of the metric, used if it is not set yet.
+  // \return a gauge which ignores all updates if \e name was already
+  //    registered as a counter.
+  public: static Gauge GetGauge(const std::string& name,
+                                const std::string& help,
+                                const Labels& labels = Labels());
+
+  // Writes all metrics in the Prometheus text format to \e out.
+  public: static void Write(std::ostream& out);
+
+  // Writes all metrics in the Prometheus text format to \e filename,
+  // by first writing to a temporary file which is then renamed.
+  // \retval false the file could not be written
+  public: static bool WriteFile(const std::string& filename);
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_METRICS_H
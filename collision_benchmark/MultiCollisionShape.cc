@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/MultiCollisionShape.hh>
+#include <collision_benchmark/ConvexDecomposition.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <sstream>
+
+using collision_benchmark::MultiCollisionShape;
+using collision_benchmark::Shape;
+using collision_benchmark::SimpleTriMeshShape;
+
+////////////////////////////////////////////////////////////////
+MultiCollisionShape *
+MultiCollisionShape::CreateConvexHull(const SimpleTriMeshShape::MeshDataPtr&
+                                        mesh,
+                                      const std::string& name)
+{
+  if (!mesh)
+  {
+    LOG_ERROR("shape", "Need mesh data to create convex hull.");
+    return NULL;
+  }
+  SimpleTriMeshShape::MeshDataPtr hull =
+    collision_benchmark::ConvexHull(*mesh);
+  if (!hull)
+  {
+    LOG_ERROR("shape", "Could not create convex hull of " << name);
+    return NULL;
+  }
+  Shape::Ptr visual(new SimpleTriMeshShape(mesh, name));
+  std::vector<Shape::Ptr> parts;
+  parts.push_back(Shape::Ptr(new SimpleTriMeshShape(hull, name + "_hull")));
+  return new MultiCollisionShape(visual, parts);
+}
+
+////////////////////////////////////////////////////////////////
+MultiCollisionShape *
+MultiCollisionShape::CreateConvexDecomposition
+    (const SimpleTriMeshShape::MeshDataPtr& mesh,
+     const std::string& name,
+     const double maxConcavity,
+     const unsigned int maxParts)
+{
+  if (!mesh)
+  {
+    LOG_ERROR("shape", "Need mesh data to create convex decomposition.");
+    return NULL;
+  }
+  std::vector<SimpleTriMeshShape::MeshDataPtr> hulls =
+    collision_benchmark::ConvexDecomposition(*mesh, maxConcavity, maxParts);
+  if (hulls.empty())
+  {
+    LOG_ERROR("shape", "Could not create convex decomposition of "
+                       << name);
+    return NULL;
+  }
+  Shape::Ptr visual(new SimpleTriMeshShape(mesh, name));
+  std::vector<Shape::Ptr> parts;
+  for (unsigned int i = 0; i < hulls.size(); ++i)
+  {
+    std::stringstream partName;
+    partName << name << "_part" << i;
+    parts.push_back(Shape::Ptr(new SimpleTriMeshShape(hulls[i],
+                                                      partName.str())));
+  }
+  return new MultiCollisionShape(visual, parts);
+}
+
+////////////////////////////////////////////////////////////////
+sdf::ElementPtr
+MultiCollisionShape::GetShapeSDF(bool detailed,
+                                 const std::string& resourceDir,
+                                 const std::string& resourceSubDir,
+                                 const bool useFullPath) const
+{
+  return visual->GetShapeSDF(detailed, resourceDir,
+                             resourceSubDir, useFullPath);
+}
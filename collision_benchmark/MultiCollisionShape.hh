@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_MULTICOLLISIONSHAPE
+#define COLLISION_BENCHMARK_MULTICOLLISIONSHAPE
+
+#include <collision_benchmark/Shape.hh>
+#include <collision_benchmark/SimpleTriMeshShape.hh>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief A shape which is displayed as one shape, but which is made up of
+ * several parts when used as collision geometry.
+ *
+ * The typical use is a mesh which is approximated by one or several convex
+ * parts for collision detection. Use the static factory methods to create
+ * the convex hull or an approximate convex decomposition of a triangle mesh.
+ */
+class MultiCollisionShape: public Shape
+{
+  public: typedef std::shared_ptr<MultiCollisionShape> Ptr;
+  public: typedef std::shared_ptr<const MultiCollisionShape> ConstPtr;
+
+  /**
+   * \param visual_ the shape to use as visual, and which is returned
+   *    by GetShapeSDF().
+   * \param parts_ the shapes to use as collision geometries. Their poses
+   *    are relative to the pose of this shape.
+   */
+  public: MultiCollisionShape(const Shape::Ptr& visual_,
+                              const std::vector<Shape::Ptr>& parts_):
+            Shape(visual_->GetType()),
+            visual(visual_),
+            parts(parts_) {}
+
+  public: MultiCollisionShape(const MultiCollisionShape& o):
+            Shape(o),
+            visual(o.visual),
+            parts(o.parts) {}
+
+  public: virtual ~MultiCollisionShape(){}
+
+  // Creates a shape which displays \e mesh and uses the convex hull of
+  // \e mesh as collision geometry. Returns NULL if the hull can't be built.
+  // \param name unique name for the mesh. The hull is named \e name + "_hull".
+  public: static MultiCollisionShape *
+            CreateConvexHull(const SimpleTriMeshShape::MeshDataPtr& mesh,
+                             const std::string& name);
+
+  // Creates a shape which displays \e mesh and uses an approximate convex
+  // decomposition of \e mesh as collision geometries.
+  // See also ConvexDecomposition(). Returns NULL if no part could be built.
+  // \param name unique name for the mesh. The parts are named
+  //    \e name + "_part<i>".
+  public: static MultiCollisionShape *
+            CreateConvexDecomposition(const SimpleTriMeshShape::MeshDataPtr&
+                                        mesh,
+                                      const std::string& name,
+                                      const double maxConcavity,
+                                      const unsigned int maxParts = 16);
+
+  // Documentation inherited from parent class.
+  // Returns the SDF of the visual shape.
+  public: virtual sdf::ElementPtr
+                  GetShapeSDF(bool detailed=true,
+                              const std::string& resourceDir = "/tmp/",
+                              const std::string& resourceSubDir = "",
+                              const bool useFullPath = false) const;
+
+  // Documentation inherited from parent class
+  public: virtual bool SupportLowRes() const
+          { return visual->SupportLowRes(); }
+
+  // Documentation inherited from parent class
+  public: virtual std::vector<Shape::Ptr> GetCollisionParts() const
+          { return parts; }
+
+  // Returns the visual shape
+  public: Shape::Ptr GetVisual() const { return visual; }
+
+  private: Shape::Ptr visual;
+
+  private: std::vector<Shape::Ptr> parts;
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_MULTICOLLISIONSHAPE
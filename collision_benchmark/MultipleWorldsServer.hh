@@ -23,8 +23,13 @@
 #include <collision_benchmark/WorldManager.hh>
 #include <collision_benchmark/WorldLoader.hh>
 #include <collision_benchmark/ControlServer.hh>
+#include <collision_benchmark/Logger.hh>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <memory>
+#include <thread>
 
 namespace collision_benchmark
 {
@@ -73,7 +78,8 @@ class MultipleWorldsServer
                                const WorldLoader::ConstPtr& _universalLoader =
                                      nullptr):
           worldLoaders(_worldLoaders),
-          universalLoader(_universalLoader) {}
+          universalLoader(_universalLoader),
+          maxLoadThreads(1) {}
   public: virtual ~MultipleWorldsServer() {}
 
   // Start the server. Starting of the server may accept
@@ -105,6 +111,10 @@ class MultipleWorldsServer
   // \param namePrefix The name of the world will be generated
   //  using this prefix to the name. This is required because multiple
   //  worlds loaded from the same world file cannot have the same name.
+  // The file is parsed only once, and each engine loads a copy of it.
+  // The worlds are loaded in up to GetMaxLoadThreads() threads (one
+  // by default), and are added to the WorldManager in the order of
+  // \e engines once all of them are loaded.
   // \return number of engines which were successfully loaded
   public: int Load(const std::string& worldfile,
                    const std::vector<std::string>& engines,
@@ -113,18 +123,76 @@ class MultipleWorldsServer
     assert(worldManager);
     assert(!namePrefix.empty());
 
+    std::vector<std::string> worldnames;
     int i = 1;
     for (std::vector<std::string>::const_iterator
          it = engines.begin(); it != engines.end(); ++it, ++i)
     {
-      std::string engine = *it;
       std::stringstream _worldname;
-      _worldname << namePrefix << "_engine_" << i << "_" << engine;
-      std::string worldname=_worldname.str();
-      if (Load(worldfile, engine, worldname) < 0)
+      _worldname << namePrefix << "_engine_" << i << "_" << *it;
+      worldnames.push_back(_worldname.str());
+    }
+
+    // parse the file with the loader of the first engine which has one
+    sdf::ElementPtr worldTemplate;
+    for (std::vector<std::string>::const_iterator
+         it = engines.begin(); it != engines.end() && !worldTemplate; ++it)
+    {
+      WorldLoader_M::const_iterator wlIt = worldLoaders.find(*it);
+      if (wlIt != worldLoaders.end())
+        worldTemplate = wlIt->second->ReadWorldFile(worldfile);
+    }
+    if (!worldTemplate)
+    {
+      LOG_ERROR("loader", "Could not read world " << worldfile);
+      return worldManager->GetNumWorlds();
+    }
+
+    // each thread takes the next world to load until all are loaded
+    std::vector<PhysicsWorldBaseInterface::Ptr> worlds(engines.size());
+    std::atomic<unsigned int> next(0);
+    auto loadNext = [&]()
+    {
+      for (unsigned int w = next++; w < engines.size(); w = next++)
       {
-        std::cerr << "Could not load world " << worldfile << " with engine "
-                  << engine << ", skipping it." << std::endl;
+        WorldLoader_M::const_iterator wlIt = worldLoaders.find(engines[w]);
+        if (wlIt == worldLoaders.end()) continue;
+        LOG_INFO("loader", "Loading with physics engine " << engines[w]
+                           << " (named as '" << worldnames[w] << "')");
+        // an exception must not leave the loading thread
+        try
+        {
+          worlds[w] = wlIt->second->LoadFromSDF(worldTemplate, worldnames[w]);
+        }
+        catch (const std::exception& e)
+        {
+          LOG_ERROR("loader", "Exception while loading world "
+                              << worldnames[w] << ": " << e.what());
+        }
+        catch (...)
+        {
+          LOG_ERROR("loader", "Unknown exception while loading world "
+                              << worldnames[w]);
+        }
+      }
+    };
+    const unsigned int numThreads =
+      std::min(static_cast<unsigned int>(engines.size()), maxLoadThreads);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < numThreads; ++t)
+      threads.push_back(std::thread(loadNext));
+    loadNext();
+    for (std::vector<std::thread>::iterator it = threads.begin();
+         it != threads.end(); ++it)
+      it->join();
+
+    for (unsigned int w = 0; w < engines.size(); ++w)
+    {
+      if (!worlds[w] || (worldManager->AddPhysicsWorld(worlds[w]) < 0))
+      {
+        LOG_ERROR("loader", "Could not load world " << worldfile
+                            << " with engine " << engines[w]
+                            << ", skipping it.");
         continue;
       }
     }
@@ -148,19 +216,13 @@ class MultipleWorldsServer
                    const std::string& worldname = "")
   {
     assert(worldManager);
-    WorldLoader_M::iterator wlIt = worldLoaders.find(engine);
-    if (wlIt == worldLoaders.end())
+    if (worldLoaders.find(engine) == worldLoaders.end())
     {
       return -1;
     }
-    WorldLoader::ConstPtr loader = wlIt->second;
-    assert(loader);
-
-    std::cout << "Loading with physics engine " << engine
-              << " (named as '" << worldname << "')" << std::endl;
 
     PhysicsWorldBaseInterface::Ptr world =
-      loader->LoadFromFile(worldfile, worldname);
+      LoadWorld(worldfile, engine, worldname);
 
     if (!world) return -2;
 
@@ -186,8 +248,8 @@ class MultipleWorldsServer
   {
     assert(worldManager);
     if (!universalLoader) return -1;
-    std::cout << "Auto-loading world (named as '"
-              << worldname << "')" << std::endl;
+    LOG_INFO("loader", "Auto-loading world (named as '"
+                       << worldname << "')");
 
     PhysicsWorldBaseInterface::Ptr world =
       universalLoader->LoadFromFile(worldfile, worldname);
@@ -201,6 +263,46 @@ class MultipleWorldsServer
 
   WorldManagerPtr GetWorldManager() { return worldManager; }
 
+  // Sets the maximum number of threads used to load the worlds of
+  // the different engines in Load(). Defaults to 1, which loads them one
+  // after another. With more threads, the worlds register their Gazebo
+  // topic namespaces in the order in which they finish loading instead
+  // of the order of the engines, so without a mirror world, gzclient may
+  // connect to any of them.
+  public: void SetMaxLoadThreads(const unsigned int n)
+  {
+    maxLoadThreads = std::max(1u, n);
+  }
+
+  public: unsigned int GetMaxLoadThreads() const
+  {
+    return maxLoadThreads;
+  }
+
+  // Loads the world file with the loader for \e engine without adding
+  // it to the WorldManager. This may be called concurrently from several
+  // threads, as the world loaders are const.
+  // \return the loaded world or NULL if it could not be loaded or no
+  //    loader exists for this engine.
+  private: PhysicsWorldBaseInterface::Ptr
+           LoadWorld(const std::string& worldfile,
+                     const std::string& engine,
+                     const std::string& worldname) const
+  {
+    WorldLoader_M::const_iterator wlIt = worldLoaders.find(engine);
+    if (wlIt == worldLoaders.end())
+    {
+      return PhysicsWorldBaseInterface::Ptr();
+    }
+    WorldLoader::ConstPtr loader = wlIt->second;
+    assert(loader);
+
+    LOG_INFO("loader", "Loading with physics engine " << engine
+                       << " (named as '" << worldname << "')");
+
+    return loader->LoadFromFile(worldfile, worldname);
+  }
+
   // creates the world manager.
   // \param mirror_name the name of the mirror world, or empty to disable
   //        creating a mirror world.
@@ -219,6 +321,9 @@ class MultipleWorldsServer
   protected: WorldLoader::ConstPtr universalLoader;
 
   protected: WorldManagerPtr worldManager;
+
+  // maximum number of threads to load worlds with in Load()
+  private: unsigned int maxLoadThreads;
 };  // class MultpleWorldsServer
 
 }  // namespace
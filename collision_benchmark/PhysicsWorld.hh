@@ -23,6 +23,8 @@
 #include <sdf/sdf.hh>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace collision_benchmark
 {
@@ -310,6 +312,58 @@ class PhysicsWorldModelInterface
                                     const Shape::Ptr& collShape
                                       = Shape::Ptr()) = 0;
 
+  /// Description of a model to be added with AddModelsFromShape()
+  public: typedef struct _ShapeModel
+      {
+        /// name to give to the model
+        std::string modelname;
+        /// the shape, see AddModelFromShape()
+        Shape::Ptr shape;
+        /// optional collision shape, see AddModelFromShape()
+        Shape::Ptr collShape;
+      } ShapeModel;
+
+  /// Loads several models from SDF and adds them to the world.
+  /// The result is the same as calling AddModelFromSDF() for each model,
+  /// but implementations may add all models in one go, which is
+  /// considerably faster for large numbers of models.
+  /// \param modelnames either empty, or of the same size as \e sdfs:
+  ///   each non-empty string overrides the name of the model in the SDF.
+  /// \return the result for each model in \e sdfs
+  public: virtual std::vector<ModelLoadResult>
+          AddModelsFromSDF(const std::vector<sdf::ElementPtr>& sdfs,
+                           const std::vector<std::string>& modelnames
+                             = std::vector<std::string>())
+  {
+    std::vector<ModelLoadResult> ret;
+    ret.reserve(sdfs.size());
+    for (unsigned int i = 0; i < sdfs.size(); ++i)
+    {
+      ret.push_back(AddModelFromSDF(sdfs[i], modelnames.empty() ?
+                                             "" : modelnames[i]));
+    }
+    return ret;
+  }
+
+  /// Adds several shapes to the world. The result is the same as calling
+  /// AddModelFromShape() for each model, but implementations may add all
+  /// models in one go, which is considerably faster for large numbers
+  /// of models.
+  /// \return the result for each model in \e models
+  public: virtual std::vector<ModelLoadResult>
+          AddModelsFromShape(const std::vector<ShapeModel>& models)
+  {
+    std::vector<ModelLoadResult> ret;
+    ret.reserve(models.size());
+    for (typename std::vector<ShapeModel>::const_iterator
+         it = models.begin(); it != models.end(); ++it)
+    {
+      ret.push_back(AddModelFromShape(it->modelname, it->shape,
+                                      it->collShape));
+    }
+    return ret;
+  }
+
   public: virtual std::vector<ModelID> GetAllModelIDs() const = 0;
 
   // If the underlying implementation offers integer IDs for models
@@ -374,6 +428,9 @@ class PhysicsWorldContactInterface
                                                    ModelPartID> ContactInfo;
   public: typedef typename ContactInfo::Ptr ContactInfoPtr;
 
+  public: typedef collision_benchmark::ContactAnomalies<ModelID>
+                  ContactAnomalies;
+
   public: PhysicsWorldContactInterface(){}
   public: virtual ~PhysicsWorldContactInterface(){}
 
@@ -393,6 +450,16 @@ class PhysicsWorldContactInterface
   public: virtual std::vector<ContactInfoPtr>
                   GetContactInfo(const ModelID& m1,
                                  const ModelID& m2) const = 0;
+
+  /// Returns the inconsistencies found in the contact points of the
+  /// underlying implementation in all calls of GetContactInfo() since
+  /// the world was created or ResetContactAnomalies() was called.
+  /// Contact points which are inconsistent are not returned by
+  /// GetContactInfo(), so this is how they can be accounted for.
+  public: virtual ContactAnomalies GetContactAnomalies() const = 0;
+
+  /// Resets the counts returned by GetContactAnomalies()
+  public: virtual void ResetContactAnomalies() = 0;
 };
 
 /**
@@ -548,6 +615,8 @@ class PhysicsWorld:
 
   public: typedef typename PhysicsWorldContactParent::ContactInfo ContactInfo;
   public: typedef typename ContactInfo::Ptr ContactInfoPtr;
+  public: typedef typename PhysicsWorldContactParent::ContactAnomalies
+                  ContactAnomalies;
 };
 
 
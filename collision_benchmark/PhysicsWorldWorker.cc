@@ -0,0 +1,425 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/PhysicsWorldWorker.hh>
+#include <collision_benchmark/GazeboWorldState.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+
+using collision_benchmark::PhysicsWorldWorker;
+
+// Appends the components of \e v to \e fields
+static void
+AppendVector(const PhysicsWorldWorker::PhysicsWorldT::Vector3& v,
+             std::vector<std::string>& fields)
+{
+  fields.push_back(PhysicsWorldWorker::ToField(v.X()));
+  fields.push_back(PhysicsWorldWorker::ToField(v.Y()));
+  fields.push_back(PhysicsWorldWorker::ToField(v.Z()));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+PhysicsWorldWorker::PhysicsWorldWorker(const std::string& _channel,
+                                       const WorldLoader::ConstPtr& _loader):
+  channel(_channel),
+  loader(_loader)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::string
+PhysicsWorldWorker::GetCommandBufferName(const std::string& channel)
+{
+  return channel + "_cmd";
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::string PhysicsWorldWorker::GetReplyBufferName(const std::string& channel)
+{
+  return channel + "_reply";
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::string
+PhysicsWorldWorker::EncodeMessage(const std::vector<std::string>& fields)
+{
+  std::string msg;
+  for (std::vector<std::string>::const_iterator it = fields.begin();
+       it != fields.end(); ++it)
+  {
+    std::ostringstream len;
+    len << it->size() << ":";
+    msg += len.str();
+    msg += *it;
+  }
+  return msg;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool PhysicsWorldWorker::DecodeMessage(const std::string& msg,
+                                       std::vector<std::string>& fields)
+{
+  fields.clear();
+  size_t pos = 0;
+  while (pos < msg.size())
+  {
+    const size_t sep = msg.find(':', pos);
+    if ((sep == std::string::npos) || (sep == pos)) return false;
+    char * end = NULL;
+    const unsigned long len = strtoul(msg.c_str() + pos, &end, 10);
+    if ((end != msg.c_str() + sep) || (len > msg.size() - sep - 1))
+      return false;
+    fields.push_back(msg.substr(sep + 1, len));
+    pos = sep + 1 + len;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::string PhysicsWorldWorker::ToField(const double n)
+{
+  std::ostringstream str;
+  str << std::setprecision(std::numeric_limits<double>::max_digits10) << n;
+  return str.str();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+double PhysicsWorldWorker::ToNumber(const std::string& field)
+{
+  return strtod(field.c_str(), NULL);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool PhysicsWorldWorker::Run()
+{
+  SharedMemoryRingBuffer::Ptr commands =
+    SharedMemoryRingBuffer::Open(GetCommandBufferName(channel));
+  SharedMemoryRingBuffer::Ptr replies =
+    SharedMemoryRingBuffer::Open(GetReplyBufferName(channel));
+  if (!commands || !replies)
+  {
+    LOG_ERROR("control", "Could not open the buffers of channel " << channel);
+    return false;
+  }
+
+  // when the controlling process exits, this process is re-parented
+  const pid_t parent = getppid();
+  const double pollSecs = 1;
+  while (true)
+  {
+    std::string msg;
+    if (!commands->Pop(msg, pollSecs))
+    {
+      if (getppid() != parent)
+      {
+        LOG_ERROR("control", "Controlling process of channel " << channel
+                             << " has exited, stopping the worker.");
+        return true;
+      }
+      continue;
+    }
+
+    std::vector<std::string> cmd, reply;
+    if (!DecodeMessage(msg, cmd) || cmd.empty())
+    {
+      reply.push_back("ERR");
+      reply.push_back("Invalid message");
+    }
+    else
+    {
+      Execute(cmd, reply);
+    }
+
+    msg = EncodeMessage(reply);
+    if (msg.size() + sizeof(uint32_t) > replies->GetCapacity())
+    {
+      reply.clear();
+      reply.push_back("ERR");
+      reply.push_back("Reply to " + cmd[0] + " is too large for the buffer");
+      msg = EncodeMessage(reply);
+    }
+    while (!replies->Push(msg, pollSecs))
+    {
+      if (getppid() != parent) return true;
+    }
+
+    if (!cmd.empty() && (cmd.front() == "SHUTDOWN")) return true;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void PhysicsWorldWorker::Load(const std::string& source, const bool fromFile,
+                              const std::string& worldname,
+                              std::vector<std::string>& reply)
+{
+  PhysicsWorldBaseInterface::Ptr w = fromFile ?
+    loader->LoadFromFile(source, worldname) :
+    loader->LoadFromString(source, worldname);
+  PhysicsWorldPtr newWorld = std::dynamic_pointer_cast<PhysicsWorldT>(w);
+  if (!newWorld)
+  {
+    reply.push_back("ERR");
+    reply.push_back("Could not load the world");
+    return;
+  }
+  world = newWorld;
+  reply.push_back("OK");
+  reply.push_back(world->GetName());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void PhysicsWorldWorker::Execute(const std::vector<std::string>& cmd,
+                                 std::vector<std::string>& reply)
+{
+  typedef PhysicsWorldT::ModelID ModelID;
+  typedef PhysicsWorldT::Vector3 Vector3;
+  typedef PhysicsWorldT::ContactInfoPtr ContactInfoPtr;
+  typedef PhysicsWorldT::ContactAnomalies ContactAnomalies;
+
+  const std::string& name = cmd[0];
+  // number of arguments each command expects
+  static std::map<std::string, unsigned int> numArgs;
+  if (numArgs.empty())
+  {
+    numArgs["SHUTDOWN"] = 0;
+    numArgs["LOAD_FILE"] = 2;
+    numArgs["LOAD_STRING"] = 2;
+    numArgs["SAVE_FILE"] = 3;
+    numArgs["CLEAR"] = 0;
+    numArgs["UPDATE"] = 2;
+    numArgs["SET_PAUSED"] = 1;
+    numArgs["IS_PAUSED"] = 0;
+    numArgs["SET_DYNAMICS"] = 1;
+    numArgs["GET_STATE"] = 0;
+    numArgs["SET_STATE"] = 2;
+    numArgs["ADD_MODEL_FILE"] = 2;
+    numArgs["ADD_MODEL_STRING"] = 2;
+    numArgs["GET_MODELS"] = 0;
+    numArgs["GET_INT_ID"] = 1;
+    numArgs["REMOVE_MODEL"] = 1;
+    numArgs["SET_MODEL_STATE"] = 14;
+    numArgs["GET_MODEL_STATE"] = 1;
+    numArgs["GET_AABB"] = 1;
+    numArgs["SUPPORTS_CONTACTS"] = 0;
+    numArgs["GET_CONTACTS"] = 2;
+    numArgs["GET_ANOMALIES"] = 0;
+    numArgs["RESET_ANOMALIES"] = 0;
+  }
+
+  std::map<std::string, unsigned int>::const_iterator argsIt =
+    numArgs.find(name);
+  if (argsIt == numArgs.end())
+  {
+    reply.push_back("ERR");
+    reply.push_back("Unknown command " + name);
+    return;
+  }
+  if (cmd.size() != argsIt->second + 1)
+  {
+    reply.push_back("ERR");
+    reply.push_back("Wrong number of arguments for " + name);
+    return;
+  }
+
+  if (name == "SHUTDOWN")
+  {
+    reply.push_back("OK");
+    return;
+  }
+  if ((name == "LOAD_FILE") || (name == "LOAD_STRING"))
+  {
+    Load(cmd[1], name == "LOAD_FILE", cmd[2], reply);
+    return;
+  }
+  if (!world)
+  {
+    reply.push_back("ERR");
+    reply.push_back("No world loaded");
+    return;
+  }
+
+  reply.push_back("OK");
+  if (name == "SAVE_FILE")
+  {
+    reply.push_back(world->SaveToFile(cmd[1], cmd[2], cmd[3]) ? "1" : "0");
+  }
+  else if (name == "CLEAR")
+  {
+    world->Clear();
+  }
+  else if (name == "UPDATE")
+  {
+    world->Update(ToNumber(cmd[1]), cmd[2] == "1");
+  }
+  else if (name == "SET_PAUSED")
+  {
+    world->SetPaused(cmd[1] == "1");
+  }
+  else if (name == "IS_PAUSED")
+  {
+    reply.push_back(world->IsPaused() ? "1" : "0");
+  }
+  else if (name == "SET_DYNAMICS")
+  {
+    world->SetDynamicsEnabled(cmd[1] == "1");
+  }
+  else if (name == "GET_STATE")
+  {
+    reply.push_back(WorldStateToString(world->GetWorldState()));
+  }
+  else if (name == "SET_STATE")
+  {
+    PhysicsWorldT::WorldState state;
+    if (!WorldStateFromString(cmd[1], state))
+    {
+      reply.front() = "ERR";
+      reply.push_back("Could not read the world state");
+      return;
+    }
+    reply.push_back(ToField(world->SetWorldState(state, cmd[2] == "1")));
+  }
+  else if ((name == "ADD_MODEL_FILE") || (name == "ADD_MODEL_STRING"))
+  {
+    PhysicsWorldT::ModelLoadResult res = (name == "ADD_MODEL_FILE") ?
+      world->AddModelFromFile(cmd[1], cmd[2]) :
+      world->AddModelFromString(cmd[1], cmd[2]);
+    reply.push_back(ToField(res.opResult));
+    reply.push_back(res.modelID);
+  }
+  else if (name == "GET_MODELS")
+  {
+    std::vector<ModelID> ids = world->GetAllModelIDs();
+    reply.insert(reply.end(), ids.begin(), ids.end());
+  }
+  else if (name == "GET_INT_ID")
+  {
+    reply.push_back(ToField(world->GetIntegerModelID(cmd[1])));
+  }
+  else if (name == "REMOVE_MODEL")
+  {
+    reply.push_back(world->RemoveModel(cmd[1]) ? "1" : "0");
+  }
+  else if (name == "SET_MODEL_STATE")
+  {
+    // fields: enabled flags of position, rotation and scale,
+    // followed by position, rotation and scale
+    double v[10];
+    for (int i = 0; i < 10; ++i) v[i] = ToNumber(cmd[5 + i]);
+    BasicState state;
+    if (cmd[2] == "1") state.SetPosition(v[0], v[1], v[2]);
+    if (cmd[3] == "1") state.SetRotation(v[3], v[4], v[5], v[6]);
+    if (cmd[4] == "1") state.SetScale(v[7], v[8], v[9]);
+    reply.push_back(world->SetBasicModelState(cmd[1], state) ? "1" : "0");
+  }
+  else if (name == "GET_MODEL_STATE")
+  {
+    BasicState state;
+    if (!world->GetBasicModelState(cmd[1], state))
+    {
+      reply.push_back("0");
+      return;
+    }
+    reply.push_back("1");
+    reply.push_back(state.PosEnabled() ? "1" : "0");
+    reply.push_back(state.RotEnabled() ? "1" : "0");
+    reply.push_back(state.ScaleEnabled() ? "1" : "0");
+    reply.push_back(ToField(state.position.x));
+    reply.push_back(ToField(state.position.y));
+    reply.push_back(ToField(state.position.z));
+    reply.push_back(ToField(state.rotation.x));
+    reply.push_back(ToField(state.rotation.y));
+    reply.push_back(ToField(state.rotation.z));
+    reply.push_back(ToField(state.rotation.w));
+    reply.push_back(ToField(state.scale.x));
+    reply.push_back(ToField(state.scale.y));
+    reply.push_back(ToField(state.scale.z));
+  }
+  else if (name == "GET_AABB")
+  {
+    Vector3 min, max;
+    if (!world->GetAABB(cmd[1], min, max))
+    {
+      reply.push_back("0");
+      return;
+    }
+    reply.push_back("1");
+    AppendVector(min, reply);
+    AppendVector(max, reply);
+  }
+  else if (name == "SUPPORTS_CONTACTS")
+  {
+    reply.push_back(world->SupportsContacts() ? "1" : "0");
+  }
+  else if (name == "GET_CONTACTS")
+  {
+    // an empty pair of models means all contacts
+    std::vector<ContactInfoPtr> contacts =
+      (cmd[1].empty() && cmd[2].empty()) ? world->GetContactInfo() :
+      world->GetContactInfo(cmd[1], cmd[2]);
+    for (std::vector<ContactInfoPtr>::const_iterator it = contacts.begin();
+         it != contacts.end(); ++it)
+    {
+      const PhysicsWorldT::ContactInfo& info = **it;
+      reply.push_back(info.model1);
+      reply.push_back(info.modelPart1);
+      reply.push_back(info.model2);
+      reply.push_back(info.modelPart2);
+      reply.push_back(ToField(info.contacts.size()));
+      for (std::vector<PhysicsWorldT::Contact>::const_iterator
+           cIt = info.contacts.begin(); cIt != info.contacts.end(); ++cIt)
+      {
+        AppendVector(cIt->position, reply);
+        AppendVector(cIt->normal, reply);
+        AppendVector(cIt->wrench.body1Force, reply);
+        AppendVector(cIt->wrench.body2Force, reply);
+        AppendVector(cIt->wrench.body1Torque, reply);
+        AppendVector(cIt->wrench.body2Torque, reply);
+        reply.push_back(ToField(cIt->depth));
+      }
+    }
+  }
+  else if (name == "GET_ANOMALIES")
+  {
+    ContactAnomalies anomalies = world->GetContactAnomalies();
+    reply.push_back(ToField(anomalies.numContacts));
+    reply.push_back(ToField(anomalies.numPoints));
+    for (int i = 0; i < ContactAnomalies::NUM_TYPES; ++i)
+    {
+      reply.push_back(ToField(anomalies.GetCount
+                                (static_cast<ContactAnomalies::Type>(i))));
+    }
+    for (std::vector<ContactAnomalies::Example>::const_iterator
+         it = anomalies.examples.begin(); it != anomalies.examples.end(); ++it)
+    {
+      reply.push_back(ToField(it->type));
+      reply.push_back(it->model1);
+      reply.push_back(it->model2);
+      reply.push_back(ToField(it->depth));
+    }
+  }
+  else if (name == "RESET_ANOMALIES")
+  {
+    world->ResetContactAnomalies();
+  }
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_PHYSICSWORLDWORKER_H
+#define COLLISION_BENCHMARK_PHYSICSWORLDWORKER_H
+
+#include <collision_benchmark/GazeboPhysicsWorld.hh>
+#include <collision_benchmark/SharedMemoryRingBuffer.hh>
+#include <collision_benchmark/WorldLoader.hh>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Serves one physics world in a separate worker process.
+ *
+ * The world is loaded with the given WorldLoader and then controlled by
+ * the process which started the worker (see RemotePhysicsWorld), which sends
+ * commands through a SharedMemoryRingBuffer and receives the replies through
+ * a second one. Both buffers are created by the controlling process and
+ * named after the channel, see GetCommandBufferName() and
+ * GetReplyBufferName().
+ *
+ * Each message is a list of fields (see EncodeMessage()). The first field
+ * of a command is its name and the others are its arguments. The first
+ * field of a reply is "OK", followed by the results, or "ERR", followed
+ * by an error message. Every command is replied to, in the order the
+ * commands were received.
+ */
+class PhysicsWorldWorker
+{
+  public: typedef std::shared_ptr<PhysicsWorldWorker> Ptr;
+
+  public: typedef PhysicsWorld<GazeboPhysicsWorldTypes::WorldState,
+                               GazeboPhysicsWorldTypes::ModelID,
+                               GazeboPhysicsWorldTypes::ModelPartID,
+                               GazeboPhysicsWorldTypes::Vector3,
+                               GazeboPhysicsWorldTypes::Wrench> PhysicsWorldT;
+  public: typedef PhysicsWorldT::Ptr PhysicsWorldPtr;
+
+  // \param _channel name of the channel to the controlling process
+  // \param _loader loader for the worlds loaded by the commands
+  public: PhysicsWorldWorker(const std::string& _channel,
+                             const WorldLoader::ConstPtr& _loader);
+
+  // Opens the buffers of the channel and serves commands until the
+  // command SHUTDOWN is received or the process which started this one
+  // has exited.
+  // \return false if the buffers could not be opened
+  public: bool Run();
+
+  // Name of the buffer which takes the commands for channel \e channel
+  public: static std::string GetCommandBufferName(const std::string& channel);
+
+  // Name of the buffer which takes the replies for channel \e channel
+  public: static std::string GetReplyBufferName(const std::string& channel);
+
+  // Encodes \e fields into one message. Each field is preceded by its
+  // length, so fields may contain any characters.
+  public: static std::string EncodeMessage
+                              (const std::vector<std::string>& fields);
+
+  // Decodes a message created with EncodeMessage() into \e fields.
+  // \return false if \e msg is not a valid message
+  public: static bool DecodeMessage(const std::string& msg,
+                                    std::vector<std::string>& fields);
+
+  // Converts \e n to a message field, without loss of precision
+  public: static std::string ToField(const double n);
+
+  // Converts the message field \e field to a number, or 0 if it is
+  // not a number
+  public: static double ToNumber(const std::string& field);
+
+  // Executes the command in \e cmd and writes the reply to \e reply.
+  private: void Execute(const std::vector<std::string>& cmd,
+                        std::vector<std::string>& reply);
+
+  // Loads the world with \e loader from a file if \e fromFile is true,
+  // or from a string otherwise, and replaces the current world with it.
+  private: void Load(const std::string& source, const bool fromFile,
+                     const std::string& worldname,
+                     std::vector<std::string>& reply);
+
+  // name of the channel
+  private: std::string channel;
+  private: WorldLoader::ConstPtr loader;
+  // the world which is served, NULL until one was loaded
+  private: PhysicsWorldPtr world;
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_PHYSICSWORLDWORKER_H
@@ -16,6 +16,9 @@
 */
 #include <collision_benchmark/PrimitiveShape.hh>
 
+#include <limits>
+#include <sstream>
+
 using collision_benchmark::PrimitiveShape;
 
 PrimitiveShape * PrimitiveShape::CreateBox(double width,
@@ -144,3 +147,39 @@ PrimitiveShape::GetShapeSDF(bool detailed,
   }
   return geometry;
 }
+
+std::string PrimitiveShape::GetSignature() const
+{
+  std::stringstream sig;
+  // the values have to be exact, so that only identical shapes
+  // get the same signature
+  sig.precision(std::numeric_limits<double>::max_digits10);
+  switch(GetType())
+  {
+    case BOX:
+      sig << "box " << params->Get(PrimitiveShapeParameters::DIMX) << " "
+          << params->Get(PrimitiveShapeParameters::DIMY) << " "
+          << params->Get(PrimitiveShapeParameters::DIMZ);
+      break;
+    case SPHERE:
+      sig << "sphere " << params->Get(PrimitiveShapeParameters::RADIUS);
+      break;
+    case CYLINDER:
+      sig << "cylinder " << params->Get(PrimitiveShapeParameters::RADIUS)
+          << " " << params->Get(PrimitiveShapeParameters::LENGTH);
+      break;
+    case PLANE:
+      sig << "plane " << params->Get(PrimitiveShapeParameters::VALX) << " "
+          << params->Get(PrimitiveShapeParameters::VALY) << " "
+          << params->Get(PrimitiveShapeParameters::VALZ) << " "
+          << params->Get(PrimitiveShapeParameters::DIMX) << " "
+          << params->Get(PrimitiveShapeParameters::DIMY);
+      break;
+    default:
+    {
+      THROW_EXCEPTION("Unsupported primitive type in "
+                      << "collision_benchmark::PrimitiveShape");
+    }
+  }
+  return sig.str();
+}
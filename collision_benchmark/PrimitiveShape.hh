@@ -22,6 +22,7 @@
 #include <collision_benchmark/PrimitiveShapeParameters.hh>
 
 #include <memory>
+#include <string>
 
 namespace collision_benchmark
 {
@@ -88,6 +89,14 @@ class PrimitiveShape: public Shape
                               const std::string& resourceSubDir = "",
                               const bool useFullPath = false) const;
 
+  // Returns the parameters of the primitive
+  public: PrimitiveShapeParameters::Ptr GetParams() const { return params; }
+
+  // Returns a string which identifies the type and the parameters of the
+  // primitive, so that primitives with the same signature have the same
+  // geometry. The pose is not part of the signature.
+  public: std::string GetSignature() const;
+
   private: PrimitiveShapeParameters::Ptr params;
 };
 
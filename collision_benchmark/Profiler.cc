@@ -0,0 +1,470 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/Profiler.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+using collision_benchmark::Profiler;
+
+namespace
+{
+
+// Histogram of one section in one thread. Only the owning thread
+// writes to it, other threads only read (except in Profiler::Reset()).
+struct Histogram
+{
+  Histogram():
+    count(0), totalNs(0), maxNs(0)
+  {
+    for (unsigned int i = 0; i < Profiler::NUM_BUCKETS; ++i) buckets[i] = 0;
+  }
+  std::atomic<uint64_t> count;
+  std::atomic<uint64_t> totalNs;
+  std::atomic<uint64_t> maxNs;
+  std::atomic<uint64_t> buckets[Profiler::NUM_BUCKETS];
+};
+
+// A span or marker in the trace
+struct TraceEvent
+{
+  // section of a span, or MAX_SECTIONS for a marker
+  Profiler::SectionID section;
+  // name and track of a marker
+  std::string name, track;
+  // start relative to the start of the trace, and duration
+  uint64_t startNs, durNs;
+};
+
+// The histograms of one thread, by section ID. A histogram is allocated
+// the first time a duration is recorded for the section.
+// The thread also keeps its own trace events.
+struct ThreadData
+{
+  explicit ThreadData(const unsigned int _index):
+    index(_index),
+    droppedEvents(0)
+  {
+    for (unsigned int i = 0; i < Profiler::MAX_SECTIONS; ++i)
+      histograms[i] = NULL;
+  }
+  ~ThreadData()
+  {
+    for (unsigned int i = 0; i < Profiler::MAX_SECTIONS; ++i)
+      delete histograms[i].load();
+  }
+  std::atomic<Histogram*> histograms[Profiler::MAX_SECTIONS];
+
+  // index of the thread in the order the threads started recording
+  const unsigned int index;
+  // guards the events and droppedEvents
+  std::mutex eventsMutex;
+  std::vector<TraceEvent> events;
+  // number of events which exceeded the maximum
+  size_t droppedEvents;
+};
+
+// Sections and threads known to the profiler
+struct Registry
+{
+  std::mutex mutex;
+  Registry():
+    tracing(false),
+    maxEvents(0) {}
+
+  // names and tracks of all sections, index is the section ID
+  std::vector<std::string> names;
+  std::vector<std::string> tracks;
+  // section IDs by name
+  std::map<std::string, Profiler::SectionID> ids;
+  // data of all threads which ever recorded a duration. It is kept
+  // after the threads have finished, so that its durations still count.
+  std::vector<std::shared_ptr<ThreadData> > threads;
+
+  // whether events are added to the trace. Atomic because it is read
+  // without locking the mutex.
+  std::atomic<bool> tracing;
+  // maximum number of events per thread, and start time of the trace.
+  // They only change while tracing is false.
+  size_t maxEvents;
+  Profiler::Clock::time_point traceStart;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+Registry& GetRegistry()
+{
+  static Registry registry;
+  return registry;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+ThreadData * GetThreadData()
+{
+  static thread_local ThreadData * data = NULL;
+  if (!data)
+  {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::shared_ptr<ThreadData> newData(
+      new ThreadData(registry.threads.size()));
+    registry.threads.push_back(newData);
+    data = newData.get();
+  }
+  return data;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+unsigned int GetBucket(const uint64_t ns)
+{
+  if (ns == 0) return 0;
+  // position of the highest bit which is set, starting at 1
+  const unsigned int bucket = 64 - __builtin_clzll(ns);
+  return std::min(bucket, Profiler::NUM_BUCKETS - 1);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Adds \e value to \e counter, which must only be written by one thread.
+inline void Increment(std::atomic<uint64_t>& counter, const uint64_t value)
+{
+  counter.store(counter.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Adds \e event to the trace of the calling thread if tracing is on
+void AddTraceEvent(TraceEvent& event, const Profiler::Clock::time_point& start)
+{
+  Registry& registry = GetRegistry();
+  if (!registry.tracing.load(std::memory_order_acquire)) return;
+  // discard spans which started before the trace
+  if (start < registry.traceStart) return;
+  event.startNs = std::chrono::duration_cast<std::chrono::nanoseconds>
+                    (start - registry.traceStart).count();
+  ThreadData * data = GetThreadData();
+  std::lock_guard<std::mutex> lock(data->eventsMutex);
+  if (data->events.size() >= registry.maxEvents)
+  {
+    ++data->droppedEvents;
+    return;
+  }
+  data->events.push_back(event);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Returns \e str with all characters escaped which are special in JSON
+std::string EscapeJSON(const std::string& str)
+{
+  std::stringstream ret;
+  for (std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+  {
+    if ((*it == '"') || (*it == '\\')) ret << '\\' << *it;
+    else if (static_cast<unsigned char>(*it) < 0x20) ret << ' ';
+    else ret << *it;
+  }
+  return ret.str();
+}
+
+}  // anonymous namespace
+
+/////////////////////////////////////////////////////////////////////////////
+double Profiler::SectionStats::GetPercentile(const double p) const
+{
+  if (count == 0) return 0;
+  const double target = std::min(std::max(p, 0.0), 100.0) / 100 * count;
+  uint64_t cumulative = 0;
+  for (unsigned int i = 0; i < buckets.size(); ++i)
+  {
+    cumulative += buckets[i];
+    if ((cumulative > 0) && (cumulative >= target))
+    {
+      if (i == 0) return 0;
+      if (i + 1 == buckets.size()) return maxNs;
+      return std::min(static_cast<double>(1ull << i),
+                      static_cast<double>(maxNs));
+    }
+  }
+  return maxNs;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+Profiler::SectionID Profiler::GetSection(const std::string& name,
+                                         const std::string& track)
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::map<std::string, SectionID>::iterator it = registry.ids.find(name);
+  if (it != registry.ids.end()) return it->second;
+  SectionID id = registry.names.size();
+  if (id >= MAX_SECTIONS) return MAX_SECTIONS;
+  registry.names.push_back(name);
+  registry.tracks.push_back(track);
+  registry.ids[name] = id;
+  return id;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Profiler::Record(const SectionID section, const uint64_t ns)
+{
+  if (section >= MAX_SECTIONS) return;
+  ThreadData * data = GetThreadData();
+  // only this thread allocates the histograms in data
+  Histogram * h = data->histograms[section].load(std::memory_order_relaxed);
+  if (!h)
+  {
+    h = new Histogram();
+    data->histograms[section].store(h, std::memory_order_release);
+  }
+  // as there is only one writer, plain loads and stores suffice and are
+  // cheaper than read-modify-write operations
+  Increment(h->count, 1);
+  Increment(h->totalNs, ns);
+  Increment(h->buckets[GetBucket(ns)], 1);
+  if (ns > h->maxNs.load(std::memory_order_relaxed))
+    h->maxNs.store(ns, std::memory_order_relaxed);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Profiler::Record(const SectionID section,
+                      const Clock::time_point& start,
+                      const Clock::time_point& end)
+{
+  if (section >= MAX_SECTIONS) return;
+  const uint64_t ns =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  Record(section, ns);
+  if (!IsTracing()) return;
+  TraceEvent event;
+  event.section = section;
+  event.durNs = ns;
+  AddTraceEvent(event, start);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Profiler::Mark(const std::string& name, const std::string& track)
+{
+  if (!IsTracing()) return;
+  TraceEvent event;
+  event.section = MAX_SECTIONS;
+  event.name = name;
+  event.track = track;
+  event.durNs = 0;
+  AddTraceEvent(event, Clock::now());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<Profiler::SectionStats> Profiler::GetStats()
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::vector<SectionStats> ret;
+  for (SectionID s = 0; s < registry.names.size(); ++s)
+  {
+    SectionStats stats;
+    stats.name = registry.names[s];
+    for (std::vector<std::shared_ptr<ThreadData> >::iterator
+         it = registry.threads.begin(); it != registry.threads.end(); ++it)
+    {
+      const Histogram * h =
+        (*it)->histograms[s].load(std::memory_order_acquire);
+      if (!h) continue;
+      stats.count += h->count.load(std::memory_order_relaxed);
+      stats.totalNs += h->totalNs.load(std::memory_order_relaxed);
+      stats.maxNs = std::max(stats.maxNs,
+                             h->maxNs.load(std::memory_order_relaxed));
+      for (unsigned int b = 0; b < NUM_BUCKETS; ++b)
+        stats.buckets[b] += h->buckets[b].load(std::memory_order_relaxed);
+    }
+    if (stats.count > 0) ret.push_back(stats);
+  }
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Profiler::Dump(std::ostream& out)
+{
+  std::vector<SectionStats> stats = GetStats();
+  size_t nameWidth = 7;
+  for (std::vector<SectionStats>::iterator it = stats.begin();
+       it != stats.end(); ++it)
+    nameWidth = std::max(nameWidth, it->name.size());
+
+  std::ios::fmtflags flags = out.flags();
+  std::streamsize precision = out.precision();
+  out << std::left << std::setw(nameWidth) << "section" << std::right
+      << std::setw(10) << "count"
+      << std::setw(12) << "total[ms]"
+      << std::setw(12) << "mean[us]"
+      << std::setw(12) << "p50[us]"
+      << std::setw(12) << "p90[us]"
+      << std::setw(12) << "p99[us]"
+      << std::setw(12) << "max[us]" << std::endl;
+  out << std::fixed << std::setprecision(3);
+  for (std::vector<SectionStats>::iterator it = stats.begin();
+       it != stats.end(); ++it)
+  {
+    out << std::left << std::setw(nameWidth) << it->name << std::right
+        << std::setw(10) << it->count
+        << std::setw(12) << it->totalNs * 1e-6
+        << std::setw(12) << it->GetMean() * 1e-3
+        << std::setw(12) << it->GetPercentile(50) * 1e-3
+        << std::setw(12) << it->GetPercentile(90) * 1e-3
+        << std::setw(12) << it->GetPercentile(99) * 1e-3
+        << std::setw(12) << it->maxNs * 1e-3 << std::endl;
+  }
+  out.flags(flags);
+  out.precision(precision);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Profiler::Reset()
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (std::vector<std::shared_ptr<ThreadData> >::iterator
+       it = registry.threads.begin(); it != registry.threads.end(); ++it)
+  {
+    for (SectionID s = 0; s < registry.names.size(); ++s)
+    {
+      Histogram * h = (*it)->histograms[s].load(std::memory_order_acquire);
+      if (!h) continue;
+      h->count = 0;
+      h->totalNs = 0;
+      h->maxNs = 0;
+      for (unsigned int b = 0; b < NUM_BUCKETS; ++b) h->buckets[b] = 0;
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Profiler::StartTrace(const size_t maxEventsPerThread)
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.tracing = false;
+  for (std::vector<std::shared_ptr<ThreadData> >::iterator
+       it = registry.threads.begin(); it != registry.threads.end(); ++it)
+  {
+    std::lock_guard<std::mutex> eventsLock((*it)->eventsMutex);
+    (*it)->events.clear();
+    (*it)->droppedEvents = 0;
+  }
+  registry.maxEvents = maxEventsPerThread;
+  registry.traceStart = Clock::now();
+  registry.tracing.store(true, std::memory_order_release);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Profiler::StopTrace()
+{
+  GetRegistry().tracing = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool Profiler::IsTracing()
+{
+  return GetRegistry().tracing.load(std::memory_order_relaxed);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Profiler::WriteTrace(std::ostream& out)
+{
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  // the trace ID of each pair of track and thread index
+  typedef std::pair<std::string, unsigned int> TrackKey;
+  std::map<TrackKey, unsigned int> trackIDs;
+  std::stringstream events;
+  size_t dropped = 0;
+  events << std::fixed << std::setprecision(3);
+  for (std::vector<std::shared_ptr<ThreadData> >::iterator
+       it = registry.threads.begin(); it != registry.threads.end(); ++it)
+  {
+    std::vector<TraceEvent> threadEvents;
+    {
+      std::lock_guard<std::mutex> eventsLock((*it)->eventsMutex);
+      threadEvents = (*it)->events;
+      dropped += (*it)->droppedEvents;
+    }
+    for (std::vector<TraceEvent>::iterator e = threadEvents.begin();
+         e != threadEvents.end(); ++e)
+    {
+      const bool isSpan = (e->section < registry.names.size());
+      const std::string& name = isSpan ? registry.names[e->section] : e->name;
+      const std::string& track = isSpan ? registry.tracks[e->section] :
+                                          e->track;
+      TrackKey key(track, (*it)->index);
+      if (trackIDs.find(key) == trackIDs.end())
+      {
+        unsigned int trackID = trackIDs.size() + 1;
+        trackIDs[key] = trackID;
+      }
+      if (events.tellp() > 0) events << "," << std::endl;
+      events << "{\"name\": \"" << EscapeJSON(name) << "\", "
+             << "\"ph\": \"" << (isSpan ? "X" : "i") << "\", "
+             << "\"pid\": 1, \"tid\": " << trackIDs[key] << ", "
+             << "\"ts\": " << e->startNs * 1e-3;
+      if (isSpan) events << ", \"dur\": " << e->durNs * 1e-3;
+      else events << ", \"s\": \"t\"";
+      events << "}";
+    }
+  }
+
+  out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [" << std::endl;
+  out << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, "
+      << "\"args\": {\"name\": \"collision_benchmark\"}}";
+  for (std::map<TrackKey, unsigned int>::iterator it = trackIDs.begin();
+       it != trackIDs.end(); ++it)
+  {
+    std::stringstream trackName;
+    if (!it->first.first.empty()) trackName << it->first.first << " / ";
+    trackName << "thread " << it->first.second;
+    out << "," << std::endl
+        << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+        << "\"tid\": " << it->second << ", "
+        << "\"args\": {\"name\": \"" << EscapeJSON(trackName.str())
+        << "\"}}";
+  }
+  if (events.tellp() > 0) out << "," << std::endl << events.str();
+  out << std::endl << "]}" << std::endl;
+
+  if (dropped > 0)
+  {
+    LOG_WARN("profiler", dropped << " events exceeded the maximum number "
+                         << "of events and are missing in the trace");
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool Profiler::WriteTrace(const std::string& filename)
+{
+  std::ofstream file(filename.c_str());
+  if (!file.is_open())
+  {
+    LOG_ERROR("profiler", "Could not open file " << filename);
+    return false;
+  }
+  WriteTrace(file);
+  return true;
+}
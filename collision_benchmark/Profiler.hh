@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_PROFILER_H
+#define COLLISION_BENCHMARK_PROFILER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Collects the durations of named code sections in histograms,
+ * to find out where time is spent in the hot paths of the framework.
+ *
+ * A section is registered once with GetSection(), which is the only
+ * operation which locks. Durations are recorded with Record(), usually via a
+ * ScopedTimer created with the macros COLLISION_BENCHMARK_PROFILE_SCOPE()
+ * and COLLISION_BENCHMARK_PROFILE_NAMED_SCOPE(). Each thread records into its
+ * own histograms, so recording is lock-free and threads don't contend.
+ * GetStats() and Dump() merge the histograms of all threads.
+ *
+ * The histograms have one bucket per power of two nanoseconds, so
+ * percentiles are approximations within a factor of two.
+ *
+ * Between StartTrace() and StopTrace(), each measured span and each
+ * marker added with Mark() is also kept as an event, and all events can be
+ * written with WriteTrace() in the Chrome trace event format, which can be
+ * opened in chrome://tracing or the Perfetto UI. Each thread gets its own
+ * track, and events of sections which were registered for a world
+ * (see GetSection()) are shown in a separate track per world and thread.
+ * Adding events to the trace locks a mutex of the recording thread, which
+ * is only contended while WriteTrace() copies the events.
+ *
+ * The macros only measure if the framework was compiled with
+ * COLLISION_BENCHMARK_PROFILING defined (cmake -DPROFILING=ON), otherwise
+ * they expand to nothing and cause no overhead.
+ */
+class Profiler
+{
+  // identifies a section
+  public: typedef unsigned int SectionID;
+
+  // the clock used for all measurements
+  public: typedef std::chrono::steady_clock Clock;
+
+  // maximum number of sections which can be registered. Durations recorded
+  // for further sections are discarded.
+  public: static const SectionID MAX_SECTIONS = 1024;
+
+  // number of histogram buckets. Bucket \e i counts durations in
+  // [2^(i-1), 2^i) nanoseconds, and bucket 0 counts durations of 0.
+  // The last bucket also counts all longer durations.
+  public: static const unsigned int NUM_BUCKETS = 40;
+
+  // Statistics of one section, merged over all threads.
+  public: struct SectionStats
+  {
+    SectionStats():
+      count(0), totalNs(0), maxNs(0),
+      buckets(NUM_BUCKETS, 0) {}
+
+    std::string name;
+    // number of recorded durations
+    uint64_t count;
+    // sum and maximum of all durations in nanoseconds
+    uint64_t totalNs, maxNs;
+    // the histogram, see also NUM_BUCKETS
+    std::vector<uint64_t> buckets;
+
+    // Returns the mean duration in nanoseconds
+    double GetMean() const { return count > 0 ? totalNs / (double) count : 0; }
+
+    // Returns the approximate \e p-th percentile (\e p in [0, 100]) in
+    // nanoseconds, which is the upper limit of the bucket
+    // containing it, capped at the maximum duration.
+    double GetPercentile(const double p) const;
+  };
+
+  // Registers the section \e name, or returns the ID of the section if it
+  // has been registered before. Sections with equal names share their
+  // histograms, so a name should include the world if the section is to be
+  // measured per world.
+  // \param track the track (usually the world name) the spans of this
+  //    section are shown in by WriteTrace(). If empty, they are shown in the
+  //    track of the thread. Only used when the section is registered first.
+  // \return an ID >= MAX_SECTIONS if there are too many sections.
+  public: static SectionID GetSection(const std::string& name,
+                                      const std::string& track = "");
+
+  // Records a duration of \e ns nanoseconds for \e section.
+  public: static void Record(const SectionID section, const uint64_t ns);
+
+  // Records the span from \e start to \e end for \e section, which is also
+  // added to the trace if tracing is on.
+  public: static void Record(const SectionID section,
+                             const Clock::time_point& start,
+                             const Clock::time_point& end);
+
+  // Adds a marker with the given \e name at the current time to the trace,
+  // if tracing is on.
+  // \param track the track to show the marker in, or empty to use the
+  //    track of the thread.
+  public: static void Mark(const std::string& name,
+                           const std::string& track = "");
+
+  // Returns the statistics of all sections for which durations were
+  // recorded, in the order the sections were registered.
+  public: static std::vector<SectionStats> GetStats();
+
+  // Writes the statistics of all sections as a table to \e out, with
+  // durations in microseconds.
+  public: static void Dump(std::ostream& out);
+
+  // Discards all recorded durations. Durations which are recorded by
+  // other threads at the same time may be lost or partly retained.
+  public: static void Reset();
+
+  // Discards all events of the previous trace and starts adding events
+  // to the trace.
+  // \param maxEventsPerThread events of a thread which exceed this
+  //    number are discarded, to limit the memory used in long runs.
+  public: static void StartTrace(const size_t maxEventsPerThread = 1000000);
+
+  // Stops adding events to the trace. The events are kept until the next
+  // call of StartTrace().
+  public: static void StopTrace();
+
+  // Returns true if events are added to the trace
+  public: static bool IsTracing();
+
+  // Writes all events of the trace in the Chrome trace event format to
+  // \e out. Can be called while tracing.
+  public: static void WriteTrace(std::ostream& out);
+
+  // Writes the trace to the file \e filename.
+  // \retval false the file could not be written
+  public: static bool WriteTrace(const std::string& filename);
+};
+
+/**
+ * \brief Records the time from its construction to its destruction
+ * for a section of the Profiler.
+ */
+class ScopedTimer
+{
+  private: typedef Profiler::Clock Clock;
+
+  public: explicit ScopedTimer(const Profiler::SectionID _section):
+          section(_section),
+          start(Clock::now()) {}
+
+  public: ~ScopedTimer()
+          {
+            Profiler::Record(section, start, Clock::now());
+          }
+
+  private: ScopedTimer(const ScopedTimer&);
+  private: ScopedTimer& operator=(const ScopedTimer&);
+
+  private: const Profiler::SectionID section;
+  private: const Clock::time_point start;
+};
+
+}  // namespace
+
+#define COLLISION_BENCHMARK_PROFILE_CONCAT_(a, b) a##b
+#define COLLISION_BENCHMARK_PROFILE_CONCAT(a, b) \
+  COLLISION_BENCHMARK_PROFILE_CONCAT_(a, b)
+
+#ifdef COLLISION_BENCHMARK_PROFILING
+// Measures the remainder of the enclosing scope for the section with the
+// given Profiler::SectionID.
+#define COLLISION_BENCHMARK_PROFILE_SCOPE(section) \
+  collision_benchmark::ScopedTimer \
+    COLLISION_BENCHMARK_PROFILE_CONCAT(profileTimer_, __LINE__)(section)
+// Measures the remainder of the enclosing scope for the section \e name,
+// which is registered when the scope is entered the first time.
+#define COLLISION_BENCHMARK_PROFILE_NAMED_SCOPE(name) \
+  static const collision_benchmark::Profiler::SectionID \
+    COLLISION_BENCHMARK_PROFILE_CONCAT(profileSection_, __LINE__) = \
+      collision_benchmark::Profiler::GetSection(name); \
+  COLLISION_BENCHMARK_PROFILE_SCOPE( \
+    COLLISION_BENCHMARK_PROFILE_CONCAT(profileSection_, __LINE__))
+// Adds a marker to the trace. \e name is only evaluated if tracing is on.
+#define COLLISION_BENCHMARK_PROFILE_MARK(name) \
+  do { \
+    if (collision_benchmark::Profiler::IsTracing()) \
+      collision_benchmark::Profiler::Mark(name); \
+  } while (0)
+#else
+#define COLLISION_BENCHMARK_PROFILE_SCOPE(section)
+#define COLLISION_BENCHMARK_PROFILE_NAMED_SCOPE(name)
+#define COLLISION_BENCHMARK_PROFILE_MARK(name)
+#endif
+
+#endif  // COLLISION_BENCHMARK_PROFILER_H
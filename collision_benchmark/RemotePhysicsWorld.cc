@@ -0,0 +1,624 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/RemotePhysicsWorld.hh>
+#include <collision_benchmark/PhysicsWorldWorker.hh>
+#include <collision_benchmark/GazeboHelpers.hh>
+#include <collision_benchmark/GazeboWorldState.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+
+extern char **environ;
+
+using collision_benchmark::RemotePhysicsWorld;
+using collision_benchmark::PhysicsWorldWorker;
+
+// time to wait for a message before checking if the worker is alive
+static const double PollSecs = 1;
+
+// Reads a vector from \e fields, starting at index \e i, and
+// advances \e i to the next field
+static ignition::math::Vector3d
+ReadVector(const std::vector<std::string>& fields, unsigned int& i)
+{
+  ignition::math::Vector3d v(PhysicsWorldWorker::ToNumber(fields[i]),
+                             PhysicsWorldWorker::ToNumber(fields[i + 1]),
+                             PhysicsWorldWorker::ToNumber(fields[i + 2]));
+  i += 3;
+  return v;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+RemotePhysicsWorld::RemotePhysicsWorld(const std::string& engine,
+                                       const bool enforceContactComputation,
+                                       const std::string& workerExecutable,
+                                       const uint64_t bufferSize,
+                                       const double _requestTimeout):
+  pid(-1),
+  alive(false),
+  requestTimeout(_requestTimeout),
+  numPending(0),
+  pendingTimeout(0)
+{
+  static std::atomic<unsigned int> numChannels(0);
+  std::stringstream _channel;
+  _channel << "collision_benchmark_" << getpid() << "_" << numChannels++;
+  channel = _channel.str();
+
+  commands = SharedMemoryRingBuffer::Create
+    (PhysicsWorldWorker::GetCommandBufferName(channel), bufferSize);
+  replies = SharedMemoryRingBuffer::Create
+    (PhysicsWorldWorker::GetReplyBufferName(channel), bufferSize);
+  if (!commands || !replies)
+  {
+    THROW_EXCEPTION("Could not create the shared memory for " << channel);
+  }
+
+  // arguments: channel, engine ("" for the engine of the world)
+  // and whether to enforce the contact computation
+  std::vector<std::string> args;
+  args.push_back(workerExecutable);
+  args.push_back(channel);
+  args.push_back(engine);
+  args.push_back(enforceContactComputation ? "1" : "0");
+  std::vector<char*> argv;
+  for (std::vector<std::string>::iterator it = args.begin();
+       it != args.end(); ++it)
+    argv.push_back(&(*it)[0]);
+  argv.push_back(NULL);
+
+  const int err = posix_spawnp(&pid, workerExecutable.c_str(), NULL, NULL,
+                               &argv[0], environ);
+  if (err != 0)
+  {
+    THROW_EXCEPTION("Could not start worker " << workerExecutable
+                    << ": " << strerror(err));
+  }
+  alive = true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+RemotePhysicsWorld::~RemotePhysicsWorld()
+{
+  if (!IsAlive()) return;
+  std::vector<std::string> reply;
+  std::vector<std::string> cmd(1, "SHUTDOWN");
+  if (Request(cmd, reply))
+    waitpid(pid, NULL, 0);
+  else if (alive)
+    Kill("it did not shut down");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void RemotePhysicsWorld::CheckAlive() const
+{
+  if (!alive) return;
+  int status = 0;
+  if (waitpid(pid, &status, WNOHANG) == pid)
+  {
+    LOG_ERROR("control", "Worker of world '" << name << "' (" << channel
+                         << ") has exited with status " << status);
+    alive = false;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void RemotePhysicsWorld::Kill(const std::string& reason) const
+{
+  if (!alive) return;
+  LOG_ERROR("control", "Killing worker of world '" << name << "' ("
+                       << channel << ") because " << reason << ".");
+  kill(pid, SIGKILL);
+  waitpid(pid, NULL, 0);
+  alive = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::IsAlive() const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  CheckAlive();
+  return alive;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::Send(const std::vector<std::string>& cmd) const
+{
+  const std::string msg = PhysicsWorldWorker::EncodeMessage(cmd);
+  if (msg.size() + sizeof(uint32_t) > commands->GetCapacity())
+  {
+    LOG_ERROR("control", "Command " << cmd.front() << " is too large for "
+                         << "the buffer of " << channel);
+    return false;
+  }
+  const std::chrono::steady_clock::time_point until =
+    std::chrono::steady_clock::now() +
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>
+      (std::chrono::duration<double>(requestTimeout));
+  while (alive && !commands->Push(msg, PollSecs))
+  {
+    CheckAlive();
+    if (std::chrono::steady_clock::now() > until)
+      Kill("it did not accept command " + cmd.front() + " in time");
+  }
+  return alive;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::Receive(std::vector<std::string>& reply,
+                                 const double timeoutSecs) const
+{
+  std::string msg;
+  const std::chrono::steady_clock::time_point until =
+    std::chrono::steady_clock::now() +
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>
+      (std::chrono::duration<double>(timeoutSecs));
+  while (alive && !replies->Pop(msg, PollSecs))
+  {
+    CheckAlive();
+    if (std::chrono::steady_clock::now() > until)
+      Kill("it did not reply in time");
+  }
+  if (!alive) return false;
+  if (!PhysicsWorldWorker::DecodeMessage(msg, reply) || reply.empty())
+  {
+    LOG_ERROR("control", "Invalid reply from worker " << channel);
+    return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void RemotePhysicsWorld::ReceivePending() const
+{
+  for (; numPending > 0; --numPending)
+  {
+    std::vector<std::string> reply;
+    if (!Receive(reply, pendingTimeout)) continue;
+    if (reply.front() != "OK")
+    {
+      LOG_ERROR("control", "Worker of world '" << name << "': "
+                           << (reply.size() > 1 ? reply[1] : ""));
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::Request(const std::vector<std::string>& cmd,
+                                 std::vector<std::string>& reply) const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  ReceivePending();
+  reply.clear();
+  if (!Send(cmd) || !Receive(reply, requestTimeout)) return false;
+  if (reply.front() != "OK")
+  {
+    LOG_ERROR("control", "Worker of world '" << name << "' failed to execute "
+                         << cmd.front() << ": "
+                         << (reply.size() > 1 ? reply[1] : ""));
+    return false;
+  }
+  reply.erase(reply.begin());
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void RemotePhysicsWorld::Clear()
+{
+  std::vector<std::string> reply;
+  Request(std::vector<std::string>(1, "CLEAR"), reply);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void RemotePhysicsWorld::Update(int steps, bool force)
+{
+  if (steps <= 0)
+  {
+    LOG_ERROR("control", "Running a remote world forever is not supported");
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  // wait for the previous update, so that there is at most one
+  // command which is not replied to
+  ReceivePending();
+  std::vector<std::string> cmd;
+  cmd.push_back("UPDATE");
+  cmd.push_back(PhysicsWorldWorker::ToField(steps));
+  cmd.push_back(force ? "1" : "0");
+  if (!Send(cmd)) return;
+  ++numPending;
+  // the worker may legitimately take long for many steps, so the
+  // time to wait for the reply grows with the number of steps
+  pendingTimeout = requestTimeout * std::max(steps, 1);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void RemotePhysicsWorld::SetPaused(bool flag)
+{
+  std::vector<std::string> cmd, reply;
+  cmd.push_back("SET_PAUSED");
+  cmd.push_back(flag ? "1" : "0");
+  Request(cmd, reply);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::IsPaused() const
+{
+  std::vector<std::string> reply;
+  return Request(std::vector<std::string>(1, "IS_PAUSED"), reply) &&
+         (reply[0] == "1");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::string RemotePhysicsWorld::GetName() const
+{
+  return name;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::SupportsSDF() const
+{
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::OpResult
+RemotePhysicsWorld::RequestLoad(const std::string& cmdName,
+                                const std::string& source,
+                                const std::string& worldname)
+{
+  std::vector<std::string> cmd, reply;
+  cmd.push_back(cmdName);
+  cmd.push_back(source);
+  cmd.push_back(worldname);
+  if (!Request(cmd, reply)) return collision_benchmark::FAILED;
+  name = reply[0];
+  return collision_benchmark::SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::OpResult
+RemotePhysicsWorld::LoadFromSDF(const sdf::ElementPtr& sdf,
+                                const std::string& worldname)
+{
+  if (!sdf) return collision_benchmark::FAILED;
+  std::string str = sdf->ToString("");
+  wrapSDF(str);
+  return RequestLoad("LOAD_STRING", str, worldname);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::OpResult
+RemotePhysicsWorld::LoadFromFile(const std::string& filename,
+                                 const std::string& worldname)
+{
+  return RequestLoad("LOAD_FILE", filename, worldname);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::OpResult
+RemotePhysicsWorld::LoadFromString(const std::string& str,
+                                   const std::string& worldname)
+{
+  return RequestLoad("LOAD_STRING", str, worldname);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::SaveToFile(const std::string& filename,
+                                    const std::string& resourceDir,
+                                    const std::string& resourceSubdir)
+{
+  std::vector<std::string> cmd, reply;
+  cmd.push_back("SAVE_FILE");
+  cmd.push_back(filename);
+  cmd.push_back(resourceDir);
+  cmd.push_back(resourceSubdir);
+  return Request(cmd, reply) && (reply[0] == "1");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void RemotePhysicsWorld::SetDynamicsEnabled(const bool flag)
+{
+  std::vector<std::string> cmd, reply;
+  cmd.push_back("SET_DYNAMICS");
+  cmd.push_back(flag ? "1" : "0");
+  Request(cmd, reply);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+RemotePhysicsWorld::WorldState RemotePhysicsWorld::GetWorldState() const
+{
+  WorldState state;
+  std::vector<std::string> reply;
+  if (Request(std::vector<std::string>(1, "GET_STATE"), reply))
+    WorldStateFromString(reply[0], state);
+  return state;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+RemotePhysicsWorld::WorldState
+RemotePhysicsWorld::GetWorldStateDiff(const WorldState& other) const
+{
+  return other - GetWorldState();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::OpResult
+RemotePhysicsWorld::SetWorldState(const WorldState& state, bool isDiff)
+{
+  std::vector<std::string> cmd, reply;
+  cmd.push_back("SET_STATE");
+  cmd.push_back(WorldStateToString(state));
+  cmd.push_back(isDiff ? "1" : "0");
+  if (!Request(cmd, reply)) return collision_benchmark::FAILED;
+  return static_cast<OpResult>(PhysicsWorldWorker::ToNumber(reply[0]));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+RemotePhysicsWorld::ModelLoadResult
+RemotePhysicsWorld::RequestAddModel(const std::string& cmdName,
+                                    const std::string& source,
+                                    const std::string& modelname)
+{
+  ModelLoadResult ret;
+  ret.opResult = collision_benchmark::FAILED;
+  std::vector<std::string> cmd, reply;
+  cmd.push_back(cmdName);
+  cmd.push_back(source);
+  cmd.push_back(modelname);
+  if (!Request(cmd, reply)) return ret;
+  ret.opResult = static_cast<OpResult>(PhysicsWorldWorker::ToNumber(reply[0]));
+  ret.modelID = reply[1];
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+RemotePhysicsWorld::ModelLoadResult
+RemotePhysicsWorld::AddModelFromFile(const std::string& filename,
+                                     const std::string& modelname)
+{
+  return RequestAddModel("ADD_MODEL_FILE", filename, modelname);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+RemotePhysicsWorld::ModelLoadResult
+RemotePhysicsWorld::AddModelFromString(const std::string& str,
+                                       const std::string& modelname)
+{
+  return RequestAddModel("ADD_MODEL_STRING", str, modelname);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+RemotePhysicsWorld::ModelLoadResult
+RemotePhysicsWorld::AddModelFromSDF(const sdf::ElementPtr& sdf,
+                                    const std::string& modelname)
+{
+  if (!sdf)
+  {
+    ModelLoadResult ret;
+    ret.opResult = collision_benchmark::FAILED;
+    return ret;
+  }
+  return RequestAddModel("ADD_MODEL_STRING", sdf->ToString(""), modelname);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::SupportsShapes() const
+{
+  return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+RemotePhysicsWorld::ModelLoadResult
+RemotePhysicsWorld::AddModelFromShape(const std::string& modelname,
+                                      const Shape::Ptr& shape,
+                                      const Shape::Ptr& collShape)
+{
+  THROW_EXCEPTION("RemotePhysicsWorld does not support shapes");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<RemotePhysicsWorld::ModelID>
+RemotePhysicsWorld::GetAllModelIDs() const
+{
+  std::vector<std::string> reply;
+  Request(std::vector<std::string>(1, "GET_MODELS"), reply);
+  return reply;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+int RemotePhysicsWorld::GetIntegerModelID(const ModelID& id) const
+{
+  std::vector<std::string> cmd, reply;
+  cmd.push_back("GET_INT_ID");
+  cmd.push_back(id);
+  if (!Request(cmd, reply)) return -1;
+  return PhysicsWorldWorker::ToNumber(reply[0]);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::RemoveModel(const ModelID& id)
+{
+  std::vector<std::string> cmd, reply;
+  cmd.push_back("REMOVE_MODEL");
+  cmd.push_back(id);
+  return Request(cmd, reply) && (reply[0] == "1");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::SetBasicModelState(const ModelID& id,
+                                            const BasicState& state)
+{
+  std::vector<std::string> cmd, reply;
+  cmd.push_back("SET_MODEL_STATE");
+  cmd.push_back(id);
+  cmd.push_back(state.PosEnabled() ? "1" : "0");
+  cmd.push_back(state.RotEnabled() ? "1" : "0");
+  cmd.push_back(state.ScaleEnabled() ? "1" : "0");
+  const double v[10] = {state.position.x, state.position.y, state.position.z,
+                        state.rotation.x, state.rotation.y, state.rotation.z,
+                        state.rotation.w,
+                        state.scale.x, state.scale.y, state.scale.z};
+  for (int i = 0; i < 10; ++i)
+    cmd.push_back(PhysicsWorldWorker::ToField(v[i]));
+  return Request(cmd, reply) && (reply[0] == "1");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::GetBasicModelState(const ModelID& id,
+                                            BasicState& state)
+{
+  std::vector<std::string> cmd, reply;
+  cmd.push_back("GET_MODEL_STATE");
+  cmd.push_back(id);
+  if (!Request(cmd, reply) || (reply[0] != "1")) return false;
+  double v[10];
+  for (int i = 0; i < 10; ++i)
+    v[i] = PhysicsWorldWorker::ToNumber(reply[4 + i]);
+  state = BasicState();
+  if (reply[1] == "1") state.SetPosition(v[0], v[1], v[2]);
+  if (reply[2] == "1") state.SetRotation(v[3], v[4], v[5], v[6]);
+  if (reply[3] == "1") state.SetScale(v[7], v[8], v[9]);
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::GetAABB(const ModelID& id,
+                                 Vector3& min, Vector3& max) const
+{
+  std::vector<std::string> cmd, reply;
+  cmd.push_back("GET_AABB");
+  cmd.push_back(id);
+  if (!Request(cmd, reply) || (reply[0] != "1")) return false;
+  unsigned int i = 1;
+  min = ReadVector(reply, i);
+  max = ReadVector(reply, i);
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool RemotePhysicsWorld::SupportsContacts() const
+{
+  std::vector<std::string> reply;
+  return Request(std::vector<std::string>(1, "SUPPORTS_CONTACTS"), reply) &&
+         (reply[0] == "1");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<RemotePhysicsWorld::ContactInfoPtr>
+RemotePhysicsWorld::RequestContactInfo(const ModelID& m1,
+                                       const ModelID& m2) const
+{
+  std::vector<ContactInfoPtr> ret;
+  std::vector<std::string> cmd, reply;
+  cmd.push_back("GET_CONTACTS");
+  cmd.push_back(m1);
+  cmd.push_back(m2);
+  if (!Request(cmd, reply)) return ret;
+
+  // each contact point takes 19 fields
+  const unsigned int pointFields = 19;
+  unsigned int i = 0;
+  while (i + 5 <= reply.size())
+  {
+    ContactInfoPtr info(new ContactInfo(reply[i], reply[i + 1],
+                                        reply[i + 2], reply[i + 3]));
+    const unsigned int numPoints = PhysicsWorldWorker::ToNumber(reply[i + 4]);
+    i += 5;
+    if (i + numPoints * pointFields > reply.size())
+    {
+      LOG_ERROR("control", "Invalid contacts from worker " << channel);
+      break;
+    }
+    for (unsigned int p = 0; p < numPoints; ++p)
+    {
+      Contact c;
+      c.position = ReadVector(reply, i);
+      c.normal = ReadVector(reply, i);
+      c.wrench.body1Force = ReadVector(reply, i);
+      c.wrench.body2Force = ReadVector(reply, i);
+      c.wrench.body1Torque = ReadVector(reply, i);
+      c.wrench.body2Torque = ReadVector(reply, i);
+      c.depth = PhysicsWorldWorker::ToNumber(reply[i++]);
+      info->contacts.push_back(c);
+    }
+    ret.push_back(info);
+  }
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<RemotePhysicsWorld::ContactInfoPtr>
+RemotePhysicsWorld::GetContactInfo() const
+{
+  return RequestContactInfo("", "");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<RemotePhysicsWorld::ContactInfoPtr>
+RemotePhysicsWorld::GetContactInfo(const ModelID& m1, const ModelID& m2) const
+{
+  return RequestContactInfo(m1, m2);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+RemotePhysicsWorld::ContactAnomalies
+RemotePhysicsWorld::GetContactAnomalies() const
+{
+  ContactAnomalies anomalies;
+  std::vector<std::string> reply;
+  const unsigned int numTypes = ContactAnomalies::NUM_TYPES;
+  if (!Request(std::vector<std::string>(1, "GET_ANOMALIES"), reply) ||
+      (reply.size() < 2 + numTypes))
+    return anomalies;
+
+  // add the examples first, so that they are kept, and then count
+  // the remaining occurrences of each type
+  unsigned long counts[numTypes];
+  for (unsigned int t = 0; t < numTypes; ++t)
+    counts[t] = PhysicsWorldWorker::ToNumber(reply[2 + t]);
+  for (unsigned int i = 2 + numTypes; i + 4 <= reply.size(); i += 4)
+  {
+    const ContactAnomalies::Type type = static_cast<ContactAnomalies::Type>
+      (PhysicsWorldWorker::ToNumber(reply[i]));
+    if ((type < 0) || (type >= numTypes) || (counts[type] == 0)) continue;
+    anomalies.Add(type, reply[i + 1], reply[i + 2],
+                  PhysicsWorldWorker::ToNumber(reply[i + 3]));
+    --counts[type];
+  }
+  for (unsigned int t = 0; t < numTypes; ++t)
+    anomalies.AddCount(static_cast<ContactAnomalies::Type>(t), counts[t]);
+  anomalies.numContacts = PhysicsWorldWorker::ToNumber(reply[0]);
+  anomalies.numPoints = PhysicsWorldWorker::ToNumber(reply[1]);
+  return anomalies;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void RemotePhysicsWorld::ResetContactAnomalies()
+{
+  std::vector<std::string> reply;
+  Request(std::vector<std::string>(1, "RESET_ANOMALIES"), reply);
+}
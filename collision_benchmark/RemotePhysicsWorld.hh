@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_REMOTEPHYSICSWORLD_H
+#define COLLISION_BENCHMARK_REMOTEPHYSICSWORLD_H
+
+#include <collision_benchmark/GazeboPhysicsWorld.hh>
+#include <collision_benchmark/SharedMemoryRingBuffer.hh>
+
+#include <sys/types.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief PhysicsWorld which runs in a separate worker process.
+ *
+ * The constructor starts the executable physics_world_worker, which loads
+ * the gazebo world with a GazeboWorldLoader for the given engine, and all
+ * calls are forwarded to it as commands through shared memory
+ * (see PhysicsWorldWorker). Running each world in its own process means
+ * that worlds don't share the global state and locks of gazebo, and a
+ * crash of a physics engine only affects the world which uses it.
+ * After the worker has exited, all calls fail. A worker which does not
+ * respond within the request timeout is killed.
+ *
+ * Update() only sends the command and returns before the worker has
+ * finished the step, so that WorldManager::Update() steps all worlds
+ * in parallel. The next call waits until the step is finished, so
+ * results are the same as if Update() was blocking.
+ *
+ * Worlds, models and states are transferred as SDF strings, so shapes
+ * (AddModelFromShape()) are not supported, and there is no access to
+ * the underlying gazebo world.
+ */
+class RemotePhysicsWorld:
+  public PhysicsWorld<GazeboPhysicsWorldTypes::WorldState,
+                      GazeboPhysicsWorldTypes::ModelID,
+                      GazeboPhysicsWorldTypes::ModelPartID,
+                      GazeboPhysicsWorldTypes::Vector3,
+                      GazeboPhysicsWorldTypes::Wrench>
+{
+  private: typedef PhysicsWorld<GazeboPhysicsWorldTypes::WorldState,
+                                GazeboPhysicsWorldTypes::ModelID,
+                                GazeboPhysicsWorldTypes::ModelPartID,
+                                GazeboPhysicsWorldTypes::Vector3,
+                                GazeboPhysicsWorldTypes::Wrench> ParentClass;
+
+  public: typedef std::shared_ptr<RemotePhysicsWorld> Ptr;
+  public: typedef std::shared_ptr<const RemotePhysicsWorld> ConstPtr;
+
+  public: typedef ParentClass::ModelID ModelID;
+  public: typedef ParentClass::WorldState WorldState;
+  public: typedef ParentClass::Vector3 Vector3;
+  public: typedef ParentClass::Contact Contact;
+  public: typedef ParentClass::ContactInfo ContactInfo;
+  public: typedef ParentClass::ContactInfoPtr ContactInfoPtr;
+  public: typedef ParentClass::ContactAnomalies ContactAnomalies;
+  public: typedef ParentClass::Shape Shape;
+  public: typedef ParentClass::ModelLoadResult ModelLoadResult;
+
+  // default size of each of the two shared memory buffers, in bytes.
+  // This limits the size of worlds, models and states transferred.
+  public: static constexpr uint64_t DefaultBufferSize = 16 * 1024 * 1024;
+
+  // default maximum time (seconds) to wait for the worker to accept
+  // a command or to reply to it.
+  public: static constexpr double DefaultRequestTimeout = 300;
+
+  // Starts the worker process.
+  // Throws a collision_benchmark::Exception if it could not be started.
+  // \param engine the physics engine to load worlds with. If empty, the
+  //    engine specified in the world is used.
+  // \param enforceContactComputation see GazeboPhysicsWorld constructor
+  // \param workerExecutable the worker executable. If it contains no
+  //    slash, it is searched for in the PATH.
+  // \param bufferSize size of each of the shared memory buffers
+  // \param requestTimeout maximum time (seconds) to wait for the worker
+  //    to accept a command, and for its reply. For Update(), it is the
+  //    maximum time per step. If the worker takes longer, it is considered
+  //    to hang and is killed.
+  public: RemotePhysicsWorld(const std::string& engine,
+                             const bool enforceContactComputation = true,
+                             const std::string& workerExecutable
+                               = "physics_world_worker",
+                             const uint64_t bufferSize = DefaultBufferSize,
+                             const double requestTimeout
+                               = DefaultRequestTimeout);
+
+  // Shuts down the worker process
+  public: virtual ~RemotePhysicsWorld();
+
+  // Returns false if the worker process has exited
+  public: bool IsAlive() const;
+
+  // Returns the process ID of the worker
+  public: pid_t GetWorkerPID() const { return pid; }
+
+  public: virtual void Clear();
+
+  // Does not support \e steps = 0 (running forever), as the
+  // worker would not serve any other commands.
+  public: virtual void Update(int steps=1, bool force=false);
+
+  public: virtual void SetPaused(bool flag);
+
+  public: virtual bool IsPaused() const;
+
+  public: virtual std::string GetName() const;
+
+  public: virtual bool SupportsSDF() const;
+
+  public: virtual OpResult LoadFromSDF(const sdf::ElementPtr& sdf,
+                                       const std::string& worldname="");
+
+  public: virtual OpResult LoadFromFile(const std::string& filename,
+                                        const std::string& worldname="");
+
+  public: virtual OpResult LoadFromString(const std::string& str,
+                                          const std::string& worldname="");
+
+  public: virtual bool SaveToFile(const std::string& filename,
+                                  const std::string& resourceDir = "",
+                                  const std::string& resourceSubdir = "");
+
+  public: virtual void SetDynamicsEnabled(const bool flag);
+
+  public: virtual WorldState GetWorldState() const;
+
+  public: virtual WorldState GetWorldStateDiff(const WorldState& other) const;
+
+  public: virtual OpResult SetWorldState(const WorldState& state,
+                                         bool isDiff=false);
+
+  public: virtual ModelLoadResult
+                  AddModelFromFile(const std::string& filename,
+                                   const std::string& modelname="");
+
+  public: virtual ModelLoadResult
+                  AddModelFromString(const std::string& str,
+                                     const std::string& modelname="");
+
+  public: virtual ModelLoadResult
+                  AddModelFromSDF(const sdf::ElementPtr& sdf,
+                                  const std::string& modelname="");
+
+  public: virtual bool SupportsShapes() const;
+
+  // Not supported, throws an exception.
+  public: virtual ModelLoadResult
+                  AddModelFromShape(const std::string& modelname,
+                                    const Shape::Ptr& shape,
+                                    const Shape::Ptr& collShape=Shape::Ptr());
+
+  public: virtual std::vector<ModelID> GetAllModelIDs() const;
+
+  public: virtual int GetIntegerModelID(const ModelID& id) const;
+
+  public: virtual bool RemoveModel(const ModelID& id);
+
+  public: virtual bool SetBasicModelState(const ModelID& id,
+                                          const BasicState& state);
+
+  public: virtual bool GetBasicModelState(const ModelID& id,
+                                          BasicState& state);
+
+  public: virtual bool GetAABB(const ModelID& id,
+                               Vector3& min, Vector3& max) const;
+
+  public: virtual bool SupportsContacts() const;
+
+  public: virtual std::vector<ContactInfoPtr> GetContactInfo() const;
+
+  public: virtual std::vector<ContactInfoPtr>
+                  GetContactInfo(const ModelID& m1, const ModelID& m2) const;
+
+  public: virtual ContactAnomalies GetContactAnomalies() const;
+
+  public: virtual void ResetContactAnomalies();
+
+  // Sends the command \e cmd to the worker and waits for the reply.
+  // \param[out] reply the fields of the reply after "OK"
+  // \return false if the worker replied with an error or has exited
+  private: bool Request(const std::vector<std::string>& cmd,
+                        std::vector<std::string>& reply) const;
+
+  // Pushes \e cmd into the command buffer.
+  // \return false if the worker has exited or was killed
+  private: bool Send(const std::vector<std::string>& cmd) const;
+
+  // Waits for the next reply of the worker and writes its fields to \e reply.
+  // \param timeoutSecs time after which the worker is killed if it
+  //    has not replied
+  // \return false if the worker has exited or was killed
+  private: bool Receive(std::vector<std::string>& reply,
+                        const double timeoutSecs) const;
+
+  // Receives the replies to all commands which were sent without
+  // waiting for their reply.
+  private: void ReceivePending() const;
+
+  // Checks whether the worker has exited, and if so, sets \e alive to false
+  private: void CheckAlive() const;
+
+  // Kills the worker, waits for it to exit and sets \e alive to false
+  // \param reason the reason which is logged
+  private: void Kill(const std::string& reason) const;
+
+  // Requests the contacts between \e m1 and \e m2, or all contacts
+  // if both are empty.
+  private: std::vector<ContactInfoPtr>
+           RequestContactInfo(const ModelID& m1, const ModelID& m2) const;
+
+  // Requests loading a world from a file (LOAD_FILE)
+  // or string (LOAD_STRING)
+  private: OpResult RequestLoad(const std::string& cmd,
+                                const std::string& source,
+                                const std::string& worldname);
+
+  // Requests adding a model from a file (ADD_MODEL_FILE)
+  // or string (ADD_MODEL_STRING)
+  private: ModelLoadResult RequestAddModel(const std::string& cmd,
+                                           const std::string& source,
+                                           const std::string& modelname);
+
+  // name of the channel to the worker
+  private: std::string channel;
+  // process ID of the worker
+  private: pid_t pid;
+  // false once the worker has exited
+  private: mutable bool alive;
+  // maximum time (seconds) to wait for the worker in Send() and Receive()
+  private: double requestTimeout;
+  // commands to the worker, and its replies
+  private: SharedMemoryRingBuffer::Ptr commands;
+  private: SharedMemoryRingBuffer::Ptr replies;
+  // number of commands sent without waiting for the reply
+  private: mutable unsigned int numPending;
+  // maximum time (seconds) to wait for the reply to the pending commands
+  private: mutable double pendingTimeout;
+  // name of the loaded world
+  private: std::string name;
+  // protects the exchange with the worker
+  private: mutable std::recursive_mutex mutex;
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_REMOTEPHYSICSWORLD_H
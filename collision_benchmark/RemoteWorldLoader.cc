@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/RemoteWorldLoader.hh>
+#include <collision_benchmark/RemotePhysicsWorld.hh>
+#include <collision_benchmark/GazeboWorldLoader.hh>
+#include <collision_benchmark/Logger.hh>
+
+using collision_benchmark::RemoteWorldLoader;
+using collision_benchmark::RemotePhysicsWorld;
+using collision_benchmark::PhysicsWorldBaseInterface;
+
+/////////////////////////////////////////////////////////////////////////////
+RemoteWorldLoader::RemoteWorldLoader(const std::string& _engine,
+                                     const bool _alwaysCalcContacts,
+                                     const std::string& _workerExecutable):
+  WorldLoader(_engine),
+  alwaysCalcContacts(_alwaysCalcContacts),
+  workerExecutable(_workerExecutable)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+template<class LoadFunction>
+PhysicsWorldBaseInterface::Ptr RemoteWorldLoader::Load(LoadFunction load) const
+{
+  RemotePhysicsWorld::Ptr world;
+  try
+  {
+    world.reset(new RemotePhysicsWorld(EngineName(), alwaysCalcContacts,
+                                       workerExecutable));
+  }
+  catch (const collision_benchmark::Exception& e)
+  {
+    LOG_ERROR("loader", "Could not start worker: " << e.what());
+    return PhysicsWorldBaseInterface::Ptr();
+  }
+  if (load(*world) != collision_benchmark::SUCCESS)
+  {
+    LOG_ERROR("loader", "Worker could not load the world.");
+    return PhysicsWorldBaseInterface::Ptr();
+  }
+  return world;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+PhysicsWorldBaseInterface::Ptr
+RemoteWorldLoader::LoadFromSDF(const sdf::ElementPtr& sdf,
+                               const std::string& worldname) const
+{
+  LOG_INFO("loader", "Loading world from SDF in a worker with physics engine '"
+                     << EngineName() << "' (named as '"
+                     << worldname << "').");
+  return Load([&](RemotePhysicsWorld& w)
+              { return w.LoadFromSDF(sdf, worldname); });
+}
+
+/////////////////////////////////////////////////////////////////////////////
+sdf::ElementPtr
+RemoteWorldLoader::ReadWorldFile(const std::string& filename) const
+{
+  return collision_benchmark::GetSDFElementFromFile(filename, "world");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+PhysicsWorldBaseInterface::Ptr
+RemoteWorldLoader::LoadFromFile(const std::string& filename,
+                                const std::string& worldname) const
+{
+  LOG_INFO("loader", "Loading world " << filename << " in a worker with "
+                     << "physics engine '" << EngineName() << "' (named as '"
+                     << worldname << "').");
+  return Load([&](RemotePhysicsWorld& w)
+              { return w.LoadFromFile(filename, worldname); });
+}
+
+/////////////////////////////////////////////////////////////////////////////
+PhysicsWorldBaseInterface::Ptr
+RemoteWorldLoader::LoadFromString(const std::string& str,
+                                  const std::string& worldname) const
+{
+  LOG_INFO("loader", "Loading world from string in a worker with physics "
+                     << "engine '" << EngineName() << "' (named as '"
+                     << worldname << "').");
+  return Load([&](RemotePhysicsWorld& w)
+              { return w.LoadFromString(str, worldname); });
+}
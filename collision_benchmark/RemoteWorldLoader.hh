@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_REMOTEWORLDLOADER_H
+#define COLLISION_BENCHMARK_REMOTEWORLDLOADER_H
+
+#include <collision_benchmark/WorldLoader.hh>
+
+#include <string>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Loads each world into a RemotePhysicsWorld, so that it runs in
+ * its own worker process.
+ */
+class RemoteWorldLoader: public WorldLoader
+{
+  // \param _engine the name of the physics engine. If empty, this is a
+  //        universal loader, see WorldLoader.
+  // \param _alwaysCalcContacts constructor parameter for
+  //        RemotePhysicsWorld
+  // \param _workerExecutable constructor parameter for RemotePhysicsWorld
+  public: RemoteWorldLoader(const std::string& _engine,
+                            const bool _alwaysCalcContacts = true,
+                            const std::string& _workerExecutable
+                              = "physics_world_worker");
+
+  public: virtual PhysicsWorldBaseInterface::Ptr
+          LoadFromSDF(const sdf::ElementPtr& sdf,
+                      const std::string& worldname="") const;
+
+  public: virtual sdf::ElementPtr
+          ReadWorldFile(const std::string& filename) const;
+
+  public: virtual PhysicsWorldBaseInterface::Ptr
+          LoadFromFile(const std::string& filename,
+                       const std::string& worldname="") const;
+
+  public: virtual PhysicsWorldBaseInterface::Ptr
+          LoadFromString(const std::string& str,
+                         const std::string& worldname="") const;
+
+  // Starts a worker and loads a world into it with \e load.
+  // \return the world, or NULL if the worker could not be started
+  //    or could not load the world.
+  private: template<class LoadFunction>
+           PhysicsWorldBaseInterface::Ptr Load(LoadFunction load) const;
+
+  private: bool alwaysCalcContacts;
+  private: std::string workerExecutable;
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_REMOTEWORLDLOADER_H
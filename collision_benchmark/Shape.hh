@@ -21,6 +21,7 @@
 #include <ignition/math/Vector3.hh>
 #include <ignition/math/Vector2.hh>
 #include <memory>
+#include <vector>
 
 namespace collision_benchmark
 {
@@ -96,6 +97,14 @@ class Shape
   /// representation.
   public: virtual bool SupportLowRes() const { return false; }
 
+  /// Returns the shapes which are to be used as separate collision
+  /// geometries when this shape is used as collision shape, e.g. the parts
+  /// of a convex decomposition. The poses of the parts are relative to the
+  /// pose of this shape. If this returns an empty vector (the default),
+  /// this shape itself is the only collision geometry.
+  public: virtual std::vector<Ptr> GetCollisionParts() const
+          { return std::vector<Ptr>(); }
+
   private: Type type;
   private: Pose3 pose;
 };
@@ -0,0 +1,492 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_SHAPEPHYSICSWORLD_H
+#define COLLISION_BENCHMARK_SHAPEPHYSICSWORLD_H
+
+#include <collision_benchmark/PhysicsWorld.hh>
+#include <collision_benchmark/Shape.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Base class of the worlds in which models can only be added from
+ * shapes (see PhysicsWorld::AddModelFromShape()), and which compute the
+ * collisions without Gazebo.
+ *
+ * It keeps the models with their shapes, pose, scale and integer ID, the
+ * simulation time and the contact anomalies, and implements everything
+ * which does not depend on the engine. Subclasses create the engine data
+ * of a model in CreateModel(), apply changes of the pose and scale in
+ * UpdateModel(), and compute the contacts and world states.
+ *
+ * SDF, files and strings are not supported. The methods to load them
+ * return NOT_SUPPORTED instead of throwing, as WorldManager passes SDF
+ * to all of its worlds.
+ *
+ * \param ParentClass the PhysicsWorld or PhysicsEngineWorld to implement
+ * \param ModelData the engine data of each model. Has to be default
+ *    constructible and copyable.
+ */
+template<class ParentClass, class ModelData>
+class ShapePhysicsWorld: public ParentClass
+{
+  public: typedef typename ParentClass::ModelID ModelID;
+  public: typedef typename ParentClass::Vector3 Vector3;
+  public: typedef typename ParentClass::ContactAnomalies ContactAnomalies;
+  public: typedef typename ParentClass::Shape Shape;
+  public: typedef typename ParentClass::ModelLoadResult ModelLoadResult;
+  public: typedef typename Shape::Pose3 Pose3;
+
+  // \param name_ the name of the world
+  // \param stepSize_ the time (seconds) which passes in one step of Update()
+  public: ShapePhysicsWorld(const std::string& name_,
+                            const double stepSize_):
+    name(name_),
+    stepSize(stepSize_),
+    paused(false),
+    simTime(0),
+    iterations(0),
+    nextModelIndex(0) {}
+
+  public: virtual ~ShapePhysicsWorld() {}
+
+  public: virtual void Clear()
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (typename ModelMap::iterator it = models.begin();
+         it != models.end(); ++it)
+    {
+      DestroyModel(it->first, it->second);
+    }
+    models.clear();
+  }
+
+  // Calls Step() \e steps times, each advancing the simulation time
+  // by the step size.
+  public: virtual void Update(int steps = 1, bool force = false)
+  {
+    if (steps <= 0)
+    {
+      LOG_ERROR("physics", "World " << GetName()
+                           << ": Invalid number of steps: " << steps);
+      return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (paused && !force) return;
+    for (int i = 0; i < steps; ++i)
+    {
+      Step();
+      simTime += stepSize;
+      ++iterations;
+    }
+  }
+
+  public: virtual void SetPaused(bool flag)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    paused = flag;
+  }
+
+  public: virtual bool IsPaused() const
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return paused;
+  }
+
+  public: virtual std::string GetName() const
+  {
+    return name;
+  }
+
+  public: virtual bool SupportsSDF() const
+  {
+    return false;
+  }
+
+  // Returns NOT_SUPPORTED
+  public: virtual OpResult LoadFromSDF(const sdf::ElementPtr& sdf,
+                                       const std::string& worldname = "")
+  {
+    LOG_ERROR("physics", "World " << GetName() << " does not support SDF");
+    return NOT_SUPPORTED;
+  }
+
+  // Returns NOT_SUPPORTED
+  public: virtual OpResult LoadFromFile(const std::string& filename,
+                                        const std::string& worldname = "")
+  {
+    LOG_ERROR("physics", "World " << GetName()
+                         << " can't load worlds from files");
+    return NOT_SUPPORTED;
+  }
+
+  // Returns NOT_SUPPORTED
+  public: virtual OpResult LoadFromString(const std::string& str,
+                                          const std::string& worldname = "")
+  {
+    LOG_ERROR("physics", "World " << GetName()
+                         << " can't load worlds from strings");
+    return NOT_SUPPORTED;
+  }
+
+  // Returns false, as there is no file format for these worlds.
+  public: virtual bool SaveToFile(const std::string& filename,
+                                  const std::string& resourceDir = "",
+                                  const std::string& resourceSubdir = "")
+  {
+    LOG_ERROR("physics", "World " << GetName()
+                         << " can't save worlds to files");
+    return false;
+  }
+
+  // Has no effect, unless the subclass has dynamics.
+  public: virtual void SetDynamicsEnabled(const bool flag) {}
+
+  // Returns NOT_SUPPORTED
+  public: virtual ModelLoadResult
+                  AddModelFromFile(const std::string& filename,
+                                   const std::string& modelname = "")
+  {
+    LOG_ERROR("physics", "World " << GetName()
+                         << " can't load models from files");
+    ModelLoadResult ret;
+    ret.opResult = NOT_SUPPORTED;
+    return ret;
+  }
+
+  // Returns NOT_SUPPORTED
+  public: virtual ModelLoadResult
+                  AddModelFromString(const std::string& str,
+                                     const std::string& modelname = "")
+  {
+    LOG_ERROR("physics", "World " << GetName()
+                         << " can't load models from strings");
+    ModelLoadResult ret;
+    ret.opResult = NOT_SUPPORTED;
+    return ret;
+  }
+
+  // Returns NOT_SUPPORTED
+  public: virtual ModelLoadResult
+                  AddModelFromSDF(const sdf::ElementPtr& sdf,
+                                  const std::string& modelname = "")
+  {
+    LOG_ERROR("physics", "World " << GetName() << " does not support SDF");
+    ModelLoadResult ret;
+    ret.opResult = NOT_SUPPORTED;
+    return ret;
+  }
+
+  public: virtual bool SupportsShapes() const
+  {
+    return true;
+  }
+
+  // Adds a model placed at the pose of \e shape. Like GazeboPhysicsWorld,
+  // \e shape is used for collisions if there is no \e collShape.
+  // \retval NOT_SUPPORTED a collision part is not supported by the engine
+  // \retval FAILED a model with this name already exists, or the name
+  //    is empty.
+  public: virtual ModelLoadResult
+                  AddModelFromShape(const std::string& modelname,
+                                    const typename Shape::Ptr& shape,
+                                    const typename Shape::Ptr& collShape
+                                      = typename Shape::Ptr())
+  {
+    ModelLoadResult ret;
+    ret.opResult = FAILED;
+    if (!shape || modelname.empty())
+    {
+      LOG_ERROR("physics", "World " << GetName() << ": A model needs a "
+                           << "shape and a name");
+      return ret;
+    }
+    ret.opResult = AddShapeModel(modelname, shape, collShape,
+                                 shape->GetPose(), Vector3(1, 1, 1));
+    if (ret.opResult == SUCCESS) ret.modelID = modelname;
+    return ret;
+  }
+
+  public: virtual std::vector<ModelID> GetAllModelIDs() const
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<ModelID> ids;
+    ids.reserve(models.size());
+    for (typename ModelMap::const_iterator it = models.begin();
+         it != models.end(); ++it)
+    {
+      ids.push_back(it->first);
+    }
+    return ids;
+  }
+
+  // Returns the index of the model in the order the models were added
+  public: virtual int GetIntegerModelID(const ModelID& id) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    typename ModelMap::const_iterator m = models.find(id);
+    if (m == models.end()) return -1;
+    return m->second.index;
+  }
+
+  public: virtual bool RemoveModel(const ModelID& id)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    typename ModelMap::iterator m = models.find(id);
+    if (m == models.end()) return false;
+    DestroyModel(m->first, m->second);
+    models.erase(m);
+    return true;
+  }
+
+  public: virtual bool SetBasicModelState(const ModelID& id,
+                                          const BasicState& state)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    typename ModelMap::const_iterator m = models.find(id);
+    if (m == models.end())
+    {
+      LOG_ERROR("physics", "World " << GetName() << ": Model " << id
+                           << " could not be found");
+      return false;
+    }
+    Pose3 pose = m->second.pose;
+    Vector3 scale = m->second.scale;
+    if (state.PosEnabled()) pose.Pos().Set(state.position.x,
+                                           state.position.y,
+                                           state.position.z);
+    if (state.RotEnabled()) pose.Rot().Set(state.rotation.w,
+                                           state.rotation.x,
+                                           state.rotation.y,
+                                           state.rotation.z);
+    if (state.ScaleEnabled()) scale.Set(state.scale.x, state.scale.y,
+                                        state.scale.z);
+    return SetModelPose(id, pose, scale);
+  }
+
+  public: virtual bool GetBasicModelState(const ModelID& id,
+                                          BasicState& state)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    typename ModelMap::const_iterator m = models.find(id);
+    if (m == models.end())
+    {
+      LOG_ERROR("physics", "World " << GetName() << ": Model " << id
+                           << " could not be found");
+      return false;
+    }
+    const Pose3& pose = m->second.pose;
+    const Vector3& scale = m->second.scale;
+    state.SetPosition(pose.Pos().X(), pose.Pos().Y(), pose.Pos().Z());
+    state.SetRotation(pose.Rot().X(), pose.Rot().Y(),
+                      pose.Rot().Z(), pose.Rot().W());
+    state.SetScale(scale.X(), scale.Y(), scale.Z());
+    return true;
+  }
+
+  public: virtual bool SupportsContacts() const
+  {
+    return true;
+  }
+
+  public: virtual ContactAnomalies GetContactAnomalies() const
+  {
+    std::lock_guard<std::mutex> lock(contactAnomaliesMutex);
+    return contactAnomalies;
+  }
+
+  public: virtual void ResetContactAnomalies()
+  {
+    std::lock_guard<std::mutex> lock(contactAnomaliesMutex);
+    contactAnomalies.Clear();
+  }
+
+  // A model of the world
+  protected: struct ModelEntry: public ModelData
+  {
+    // Returns the shape used for collisions
+    const typename Shape::Ptr& GetCollisionShape() const
+    {
+      return collShape ? collShape : shape;
+    }
+
+    // the shapes the model was added with
+    typename Shape::Ptr shape;
+    typename Shape::Ptr collShape;
+    Pose3 pose;
+    Vector3 scale;
+    // see GetIntegerModelID()
+    int index;
+  };
+
+  protected: typedef std::map<ModelID, ModelEntry> ModelMap;
+
+  // Creates the engine data of \e model, which has already been added
+  // with all fields of ModelEntry set. Has to be called with the mutex
+  // locked.
+  // \retval NOT_SUPPORTED the shape is not supported. The model is
+  //    removed again.
+  protected: virtual OpResult CreateModel(const ModelID& id,
+                                          ModelEntry& model) = 0;
+
+  // Applies the pose and scale of \e model after they were changed.
+  // Has to be called with the mutex locked.
+  // \param oldScale the scale before the change
+  // \return false if the change can't be applied. The engine data of
+  //    \e model has to be left unchanged in this case, its pose and scale
+  //    are restored.
+  protected: virtual bool UpdateModel(const ModelID& id,
+                                      ModelEntry& model,
+                                      const Vector3& oldScale) = 0;
+
+  // Called before \e model is removed from the world. Has to be called
+  // with the mutex locked.
+  protected: virtual void DestroyModel(const ModelID& id,
+                                       ModelEntry& model) {}
+
+  // Makes one step of Update(), before the simulation time is advanced.
+  // Has to be called with the mutex locked.
+  protected: virtual void Step() {}
+
+  // Adds the model \e id and creates its engine data (see CreateModel()).
+  // Has to be called with the mutex locked.
+  // \retval FAILED a model with this name already exists
+  protected: OpResult AddShapeModel(const ModelID& id,
+                                    const typename Shape::Ptr& shape,
+                                    const typename Shape::Ptr& collShape,
+                                    const Pose3& pose,
+                                    const Vector3& scale)
+  {
+    if (models.find(id) != models.end())
+    {
+      LOG_ERROR("physics", "World " << GetName() << ": Model " << id
+                           << " already exists");
+      return FAILED;
+    }
+    typename ModelMap::iterator m =
+      models.insert(std::make_pair(id, ModelEntry())).first;
+    ModelEntry& model = m->second;
+    model.shape = shape;
+    model.collShape = collShape;
+    model.pose = pose;
+    model.scale = scale;
+    model.index = nextModelIndex;
+    const OpResult res = CreateModel(m->first, model);
+    if (res != SUCCESS)
+    {
+      models.erase(m);
+      return res;
+    }
+    ++nextModelIndex;
+    return SUCCESS;
+  }
+
+  // Sets the pose and scale of the model \e id, see UpdateModel().
+  // Has to be called with the mutex locked.
+  // \retval false the model is not in the world, or the change
+  //    could not be applied.
+  protected: bool SetModelPose(const ModelID& id, const Pose3& pose,
+                               const Vector3& scale)
+  {
+    typename ModelMap::iterator m = models.find(id);
+    if (m == models.end())
+    {
+      LOG_ERROR("physics", "World " << GetName() << ": Model " << id
+                           << " could not be found");
+      return false;
+    }
+    ModelEntry& model = m->second;
+    const Pose3 oldPose = model.pose;
+    const Vector3 oldScale = model.scale;
+    model.pose = pose;
+    model.scale = scale;
+    if (!UpdateModel(m->first, model, oldScale))
+    {
+      LOG_ERROR("physics", "World " << GetName() << ": Could not change "
+                           << "the pose or scale of model " << id);
+      model.pose = oldPose;
+      model.scale = oldScale;
+      return false;
+    }
+    return true;
+  }
+
+  // Adds \e anomalies, counted in a query for contacts, to the ones
+  // returned by GetContactAnomalies(). Can be called without
+  // the mutex locked.
+  protected: void AddContactAnomalies(const ContactAnomalies& anomalies) const
+  {
+    std::lock_guard<std::mutex> lock(contactAnomaliesMutex);
+    contactAnomalies.Merge(anomalies);
+  }
+
+  // Returns the part ID of all contacts, the same as the link name of
+  // shape models in GazeboPhysicsWorld
+  protected: static const std::string& PartID()
+  {
+    static const std::string partID = "link";
+    return partID;
+  }
+
+  // Gets the collision parts of \e shape and their poses relative to the
+  // model. A shape without collision parts is its own only part, at the
+  // pose of the model.
+  protected: static void GetCollisionParts(const typename Shape::Ptr& shape,
+                                           std::vector<typename Shape::Ptr>&
+                                             parts,
+                                           std::vector<Pose3>& poses)
+  {
+    parts = shape->GetCollisionParts();
+    poses.clear();
+    for (typename std::vector<typename Shape::Ptr>::const_iterator
+         it = parts.begin(); it != parts.end(); ++it)
+    {
+      poses.push_back((*it)->GetPose());
+    }
+    if (parts.empty())
+    {
+      parts.push_back(shape);
+      poses.push_back(Pose3());
+    }
+  }
+
+  protected: std::string name;
+  protected: double stepSize;
+  protected: bool paused;
+  protected: double simTime;
+  protected: unsigned long iterations;
+  protected: ModelMap models;
+  // protects all fields above
+  protected: mutable std::recursive_mutex mutex;
+
+  // index given to the next model
+  private: int nextModelIndex;
+
+  private: mutable ContactAnomalies contactAnomalies;
+  private: mutable std::mutex contactAnomaliesMutex;
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_SHAPEPHYSICSWORLD_H
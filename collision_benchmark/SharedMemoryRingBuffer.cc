@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/SharedMemoryRingBuffer.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/sync/interprocess_condition.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+using collision_benchmark::SharedMemoryRingBuffer;
+
+namespace ipc = boost::interprocess;
+
+struct SharedMemoryRingBuffer::Header
+{
+  explicit Header(const uint64_t _capacity):
+    capacity(_capacity), head(0), tail(0) {}
+
+  ipc::interprocess_mutex mutex;
+  // signalled when a message was pushed
+  ipc::interprocess_condition notEmpty;
+  // signalled when a message was popped
+  ipc::interprocess_condition notFull;
+  // size of the ring in bytes
+  const uint64_t capacity;
+  // total number of bytes popped and pushed. The read and write
+  // positions in the ring are these modulo the capacity.
+  uint64_t head;
+  uint64_t tail;
+};
+
+struct SharedMemoryRingBuffer::Mapping
+{
+  ipc::shared_memory_object shm;
+  ipc::mapped_region region;
+};
+
+// Size of the length which precedes each message in the ring
+static const uint64_t LengthSize = sizeof(uint32_t);
+
+// Maximum time (seconds) to wait for the mutex of the buffer. It is only
+// held while messages are copied, so if it can't be locked within this
+// time, the other process has died while holding it. The mutex is not
+// robust, so it would never be unlocked again.
+static const double LockTimeoutSecs = 5;
+
+// Locks \e lock within LockTimeoutSecs.
+// \return false if the mutex of the buffer \e name could not be locked.
+static bool TimedLock(ipc::scoped_lock<ipc::interprocess_mutex>& lock,
+                      const std::string& name)
+{
+  const boost::posix_time::ptime until =
+    boost::posix_time::microsec_clock::universal_time() +
+    boost::posix_time::microseconds(
+      static_cast<int64_t>(LockTimeoutSecs * 1e6));
+  if (!lock.timed_lock(until))
+  {
+    LOG_ERROR("control", "Could not lock shared memory " << name
+                         << ", the other process may have died.");
+    return false;
+  }
+  return true;
+}
+
+// Waits on \e cond until \e done returns true or \e timeoutSecs
+// have passed (forever if it is negative).
+// \return false if the timeout was reached.
+template<class Predicate>
+static bool WaitFor(ipc::interprocess_condition& cond,
+                    ipc::scoped_lock<ipc::interprocess_mutex>& lock,
+                    const double timeoutSecs, Predicate done)
+{
+  if (timeoutSecs < 0)
+  {
+    while (!done()) cond.wait(lock);
+    return true;
+  }
+  const boost::posix_time::ptime until =
+    boost::posix_time::microsec_clock::universal_time() +
+    boost::posix_time::microseconds(static_cast<int64_t>(timeoutSecs * 1e6));
+  while (!done())
+  {
+    if (!cond.timed_wait(lock, until)) return done();
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+SharedMemoryRingBuffer::SharedMemoryRingBuffer(const std::string& _name,
+                                               const bool _owner):
+  name(_name),
+  owner(_owner),
+  mapping(new Mapping()),
+  header(NULL),
+  data(NULL)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+SharedMemoryRingBuffer::~SharedMemoryRingBuffer()
+{
+  if (owner && header) header->~Header();
+  mapping.reset();
+  if (owner) ipc::shared_memory_object::remove(name.c_str());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+SharedMemoryRingBuffer::Ptr
+SharedMemoryRingBuffer::Create(const std::string& name,
+                               const uint64_t capacity)
+{
+  ipc::shared_memory_object::remove(name.c_str());
+  Ptr buffer(new SharedMemoryRingBuffer(name, true));
+  try
+  {
+    ipc::shared_memory_object shm(ipc::create_only, name.c_str(),
+                                  ipc::read_write);
+    shm.truncate(sizeof(Header) + capacity);
+    ipc::mapped_region region(shm, ipc::read_write);
+    buffer->mapping->shm.swap(shm);
+    buffer->mapping->region.swap(region);
+  }
+  catch (const ipc::interprocess_exception& e)
+  {
+    LOG_ERROR("control", "Could not create shared memory " << name << ": "
+                         << e.what());
+    buffer->owner = false;
+    ipc::shared_memory_object::remove(name.c_str());
+    return Ptr();
+  }
+  void * addr = buffer->mapping->region.get_address();
+  buffer->header = new (addr) Header(capacity);
+  buffer->data = static_cast<char*>(addr) + sizeof(Header);
+  return buffer;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+SharedMemoryRingBuffer::Ptr
+SharedMemoryRingBuffer::Open(const std::string& name)
+{
+  Ptr buffer(new SharedMemoryRingBuffer(name, false));
+  try
+  {
+    ipc::shared_memory_object shm(ipc::open_only, name.c_str(),
+                                  ipc::read_write);
+    ipc::mapped_region region(shm, ipc::read_write);
+    buffer->mapping->shm.swap(shm);
+    buffer->mapping->region.swap(region);
+  }
+  catch (const ipc::interprocess_exception& e)
+  {
+    LOG_ERROR("control", "Could not open shared memory " << name << ": "
+                         << e.what());
+    return Ptr();
+  }
+  void * addr = buffer->mapping->region.get_address();
+  buffer->header = static_cast<Header*>(addr);
+  buffer->data = static_cast<char*>(addr) + sizeof(Header);
+  return buffer;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+uint64_t SharedMemoryRingBuffer::GetCapacity() const
+{
+  return header->capacity;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void SharedMemoryRingBuffer::Write(uint64_t pos, const char * src,
+                                   uint64_t len)
+{
+  pos %= header->capacity;
+  const uint64_t first = std::min(len, header->capacity - pos);
+  memcpy(data + pos, src, first);
+  memcpy(data, src + first, len - first);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void SharedMemoryRingBuffer::Read(uint64_t pos, char * dst,
+                                  uint64_t len) const
+{
+  pos %= header->capacity;
+  const uint64_t first = std::min(len, header->capacity - pos);
+  memcpy(dst, data + pos, first);
+  memcpy(dst + first, data, len - first);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool SharedMemoryRingBuffer::Push(const std::string& msg,
+                                  const double timeoutSecs)
+{
+  const uint64_t size = LengthSize + msg.size();
+  if ((size > header->capacity) || (msg.size() > UINT32_MAX))
+  {
+    LOG_ERROR("control", "Message of " << msg.size() << " bytes does not "
+                         << "fit into shared memory " << name);
+    return false;
+  }
+
+  ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex,
+                                                 ipc::defer_lock);
+  if (!TimedLock(lock, name)) return false;
+  Header * h = header;
+  if (!WaitFor(h->notFull, lock, timeoutSecs, [h, size]()
+               { return h->capacity - (h->tail - h->head) >= size; }))
+    return false;
+
+  const uint32_t len = msg.size();
+  Write(h->tail, reinterpret_cast<const char*>(&len), LengthSize);
+  Write(h->tail + LengthSize, msg.data(), len);
+  h->tail += size;
+  h->notEmpty.notify_all();
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool SharedMemoryRingBuffer::Pop(std::string& msg, const double timeoutSecs)
+{
+  ipc::scoped_lock<ipc::interprocess_mutex> lock(header->mutex,
+                                                 ipc::defer_lock);
+  if (!TimedLock(lock, name)) return false;
+  Header * h = header;
+  if (!WaitFor(h->notEmpty, lock, timeoutSecs, [h]()
+               { return h->tail != h->head; }))
+    return false;
+
+  uint32_t len = 0;
+  Read(h->head, reinterpret_cast<char*>(&len), LengthSize);
+  msg.resize(len);
+  if (len > 0) Read(h->head + LengthSize, &msg[0], len);
+  h->head += LengthSize + len;
+  h->notFull.notify_all();
+  return true;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_SHAREDMEMORYRINGBUFFER_H
+#define COLLISION_BENCHMARK_SHAREDMEMORYRINGBUFFER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Queue of messages in shared memory, to exchange data between
+ * two processes.
+ *
+ * The messages are byte strings of any length up to the capacity of the
+ * buffer, and are stored in a ring buffer in a named shared memory segment.
+ * One process creates the buffer with Create(), the other process opens it
+ * with Open(). Each buffer is meant to be used in one direction only,
+ * with one process pushing and the other one popping messages.
+ *
+ * The segment is removed when the object which created it is destroyed.
+ */
+class SharedMemoryRingBuffer
+{
+  public: typedef std::shared_ptr<SharedMemoryRingBuffer> Ptr;
+
+  // Header at the start of the shared memory segment. Defined in the
+  // implementation file.
+  private: struct Header;
+
+  // Creates the shared memory segment \e name with space for \e capacity
+  // bytes of messages, replacing any existing segment with this name.
+  // Each message takes 4 bytes more than its length.
+  // \return the buffer, or NULL if the segment could not be created.
+  public: static Ptr Create(const std::string& name,
+                            const uint64_t capacity);
+
+  // Opens the shared memory segment \e name which was created with Create().
+  // \return the buffer, or NULL if there is no such segment.
+  public: static Ptr Open(const std::string& name);
+
+  public: ~SharedMemoryRingBuffer();
+
+  // Adds \e msg to the buffer. If there is not enough space, waits
+  // until the other process has popped enough messages.
+  // \param timeoutSecs maximum time to wait, negative to wait forever.
+  // \return false if the message is larger than the capacity, if
+  //    the timeout was reached, or if the buffer could not be locked
+  //    because the other process died while holding the lock.
+  public: bool Push(const std::string& msg, const double timeoutSecs = -1);
+
+  // Takes the oldest message out of the buffer and writes it to \e msg.
+  // If there is no message, waits until the other process pushes one.
+  // \param timeoutSecs maximum time to wait, negative to wait forever.
+  // \return false if the timeout was reached, or if the buffer could not
+  //    be locked because the other process died while holding the lock.
+  public: bool Pop(std::string& msg, const double timeoutSecs = -1);
+
+  // Returns the name of the shared memory segment
+  public: std::string GetName() const { return name; }
+
+  // Returns the maximum number of bytes of all messages in the buffer
+  public: uint64_t GetCapacity() const;
+
+  private: SharedMemoryRingBuffer(const std::string& name,
+                                  const bool owner);
+
+  // Copies \e len bytes from \e src to the ring at position \e pos
+  private: void Write(uint64_t pos, const char * src, uint64_t len);
+
+  // Copies \e len bytes from the ring at position \e pos to \e dst
+  private: void Read(uint64_t pos, char * dst, uint64_t len) const;
+
+  // name of the shared memory segment
+  private: std::string name;
+  // whether this object has created the segment and removes it
+  private: bool owner;
+  // the mapping of the segment, defined in the implementation file
+  private: struct Mapping;
+  private: std::unique_ptr<Mapping> mapping;
+  // header in the shared memory
+  private: Header * header;
+  // the ring of message bytes in the shared memory, after the header
+  private: char * data;
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_SHAREDMEMORYRINGBUFFER_H
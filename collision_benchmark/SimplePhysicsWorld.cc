@@ -0,0 +1,521 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/SimplePhysicsWorld.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <ignition/math/Quaternion.hh>
+
+#include <cmath>
+#include <limits>
+
+using collision_benchmark::SimplePhysicsWorld;
+using collision_benchmark::ConvexSupport;
+using collision_benchmark::PrimitiveShape;
+using collision_benchmark::PrimitiveShapeParameters;
+
+/////////////////////////////////////////////////////////////////////////////
+// Returns a copy of the convex primitive \e prim scaled by \e scale. Like
+// in the other engines, spheres are scaled along x, and cylinders along
+// x (radius) and z (length).
+static collision_benchmark::Shape::Ptr
+ScalePrimitive(const PrimitiveShape::Ptr& prim,
+               const ignition::math::Vector3d& scale)
+{
+  PrimitiveShapeParameters::Ptr params = prim->GetParams();
+  switch (prim->GetType())
+  {
+    case collision_benchmark::Shape::BOX:
+      return collision_benchmark::Shape::Ptr(PrimitiveShape::CreateBox(
+        params->Get(PrimitiveShapeParameters::DIMX) * scale.X(),
+        params->Get(PrimitiveShapeParameters::DIMY) * scale.Y(),
+        params->Get(PrimitiveShapeParameters::DIMZ) * scale.Z()));
+    case collision_benchmark::Shape::SPHERE:
+      return collision_benchmark::Shape::Ptr(PrimitiveShape::CreateSphere(
+        params->Get(PrimitiveShapeParameters::RADIUS) * scale.X()));
+    case collision_benchmark::Shape::CYLINDER:
+      return collision_benchmark::Shape::Ptr(PrimitiveShape::CreateCylinder(
+        params->Get(PrimitiveShapeParameters::RADIUS) * scale.X(),
+        params->Get(PrimitiveShapeParameters::LENGTH) * scale.Z()));
+    default:
+      return prim;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+SimplePhysicsWorld::SimplePhysicsWorld(const std::string& name_,
+                                       const double stepSize_):
+  ParentClass(name_, stepSize_),
+  gravity(0, 0, -9.81),
+  dynamicsEnabled(true)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void SimplePhysicsWorld::SetDynamicsEnabled(const bool flag)
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  dynamicsEnabled = flag;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+SimplePhysicsWorld::WorldState SimplePhysicsWorld::GetWorldState() const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  WorldState state;
+  state.simTime = simTime;
+  state.iterations = iterations;
+  for (ModelMap::const_iterator it = models.begin(); it != models.end(); ++it)
+  {
+    const ModelEntry& model = it->second;
+    SimpleWorldState::ModelState& modelState = state.models[it->first];
+    modelState.pose = model.pose;
+    modelState.linearVel = model.linearVel;
+    modelState.angularVel = model.angularVel;
+    modelState.scale = model.scale;
+    modelState.shape = model.shape;
+    modelState.collShape = model.collShape;
+  }
+  return state;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+SimplePhysicsWorld::WorldState
+SimplePhysicsWorld::GetWorldStateDiff(const WorldState& other) const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  WorldState diff;
+  diff.simTime = other.simTime;
+  diff.iterations = other.iterations;
+  diff.models = other.models;
+  for (ModelMap::const_iterator it = models.begin(); it != models.end(); ++it)
+  {
+    if (other.models.find(it->first) == other.models.end())
+      diff.deletions.push_back(it->first);
+  }
+  return diff;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::OpResult
+SimplePhysicsWorld::SetWorldState(const WorldState& state, bool isDiff)
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  if (isDiff)
+  {
+    for (std::vector<std::string>::const_iterator it = state.deletions.begin();
+         it != state.deletions.end(); ++it)
+    {
+      RemoveModel(*it);
+    }
+  }
+  else
+  {
+    std::vector<ModelID> deletions;
+    for (ModelMap::const_iterator it = models.begin(); it != models.end();
+         ++it)
+    {
+      if (state.models.find(it->first) == state.models.end())
+        deletions.push_back(it->first);
+    }
+    for (std::vector<ModelID>::const_iterator it = deletions.begin();
+         it != deletions.end(); ++it)
+    {
+      RemoveModel(*it);
+    }
+  }
+
+  OpResult ret = SUCCESS;
+  for (std::map<std::string, SimpleWorldState::ModelState>::const_iterator
+       it = state.models.begin(); it != state.models.end(); ++it)
+  {
+    ModelMap::iterator m = models.find(it->first);
+    if (m == models.end())
+    {
+      OpResult res = AddModel(it->first, it->second);
+      if (res != SUCCESS) ret = res;
+      continue;
+    }
+    SetModelPose(it->first, it->second.pose, it->second.scale);
+    m->second.linearVel = it->second.linearVel;
+    m->second.angularVel = it->second.angularVel;
+  }
+  simTime = state.simTime;
+  iterations = state.iterations;
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool SimplePhysicsWorld::GetAABB(const ModelID& id,
+                                 Vector3& min, Vector3& max) const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  ModelMap::const_iterator m = models.find(id);
+  if (m == models.end()) return false;
+  const double inf = std::numeric_limits<double>::max();
+  min.Set(inf, inf, inf);
+  max.Set(-inf, -inf, -inf);
+  std::vector<PlacedPart> parts = PlaceParts(m->second);
+  for (std::vector<PlacedPart>::const_iterator it = parts.begin();
+       it != parts.end(); ++it)
+  {
+    min.Set(std::min(min.X(), it->min.X()), std::min(min.Y(), it->min.Y()),
+            std::min(min.Z(), it->min.Z()));
+    max.Set(std::max(max.X(), it->max.X()), std::max(max.Y(), it->max.Y()),
+            std::max(max.Z(), it->max.Z()));
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<SimplePhysicsWorld::ContactInfoPtr>
+SimplePhysicsWorld::GetContactInfo() const
+{
+  return GetContactInfoHelper(NULL, NULL);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<SimplePhysicsWorld::ContactInfoPtr>
+SimplePhysicsWorld::GetContactInfo(const ModelID& m1, const ModelID& m2) const
+{
+  return GetContactInfoHelper(&m1, &m2);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void SimplePhysicsWorld::SetGravity(const Vector3& gravity_)
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  gravity = gravity_;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+SimplePhysicsWorld::Vector3 SimplePhysicsWorld::GetGravity() const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  return gravity;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool SimplePhysicsWorld::SetModelVelocity(const ModelID& id,
+                                          const Vector3& linear,
+                                          const Vector3& angular)
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  ModelMap::iterator m = models.find(id);
+  if (m == models.end())
+  {
+    LOG_ERROR("physics", "World " << GetName() << ": Model " << id
+                         << " could not be found");
+    return false;
+  }
+  m->second.linearVel = linear;
+  m->second.angularVel = angular;
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::OpResult
+SimplePhysicsWorld::CreateModel(const ModelID& id, ModelEntry& model)
+{
+  if (!CreateParts(model.GetCollisionShape(), model.scale, model.parts))
+    return NOT_SUPPORTED;
+  model.isStatic = false;
+  for (std::vector<Part>::const_iterator it = model.parts.begin();
+       it != model.parts.end(); ++it)
+  {
+    if (!it->support) model.isStatic = true;
+  }
+  return SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool SimplePhysicsWorld::UpdateModel(const ModelID& id, ModelEntry& model,
+                                     const Vector3& oldScale)
+{
+  // the parts are placed at the pose of the model when they are needed,
+  // only the support functions depend on the scale
+  if (model.scale == oldScale) return true;
+  std::vector<Part> parts;
+  if (!CreateParts(model.GetCollisionShape(), model.scale, parts))
+    return false;
+  model.parts = parts;
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool SimplePhysicsWorld::CreateParts(const Shape::Ptr& shape,
+                                     const Vector3& scale,
+                                     std::vector<Part>& parts)
+{
+  std::vector<Shape::Ptr> collParts;
+  std::vector<Pose3> poses;
+  GetCollisionParts(shape, collParts, poses);
+
+  for (unsigned int i = 0; i < collParts.size(); ++i)
+  {
+    PrimitiveShape::Ptr prim =
+      std::dynamic_pointer_cast<PrimitiveShape>(collParts[i]);
+    if (!prim)
+    {
+      LOG_ERROR("physics", "SimplePhysicsWorld only supports primitive "
+                           << "shapes, not type " << collParts[i]->GetType());
+      return false;
+    }
+    Part part;
+    part.pose = poses[i];
+    part.offset = 0;
+    if (prim->GetType() == Shape::PLANE)
+    {
+      PrimitiveShapeParameters::Ptr params = prim->GetParams();
+      Vector3 n(params->Get(PrimitiveShapeParameters::VALX),
+                params->Get(PrimitiveShapeParameters::VALY),
+                params->Get(PrimitiveShapeParameters::VALZ));
+      double len = n.Length();
+      if (len <= 0)
+      {
+        LOG_ERROR("physics", "Plane has no valid normal");
+        return false;
+      }
+      part.normal = n / len;
+      part.offset = params->Get(PrimitiveShapeParameters::LENGTH) / len;
+    }
+    else
+    {
+      part.support = ConvexSupport::Create(ScalePrimitive(prim, scale));
+      if (!part.support)
+      {
+        LOG_ERROR("physics", "SimplePhysicsWorld does not support "
+                             << "primitives of type " << prim->GetType());
+        return false;
+      }
+    }
+    parts.push_back(part);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<SimplePhysicsWorld::PlacedPart>
+SimplePhysicsWorld::PlaceParts(const ModelEntry& model)
+{
+  const double inf = std::numeric_limits<double>::max();
+  std::vector<PlacedPart> placed(model.parts.size());
+  for (unsigned int i = 0; i < model.parts.size(); ++i)
+  {
+    const Part& part = model.parts[i];
+    PlacedPart& p = placed[i];
+    // the positions of the parts are scaled with the model
+    const Pose3 pose =
+      Pose3(part.pose.Pos() * model.scale, part.pose.Rot()) + model.pose;
+    p.isPlane = !part.support;
+    if (!p.isPlane)
+    {
+      p.support.reset(new ConvexSupport(*part.support));
+      p.support->SetPose(pose);
+      const ConvexSupport& s = *p.support;
+      p.min.Set(s(Vector3(-1, 0, 0)).X(), s(Vector3(0, -1, 0)).Y(),
+                s(Vector3(0, 0, -1)).Z());
+      p.max.Set(s(Vector3(1, 0, 0)).X(), s(Vector3(0, 1, 0)).Y(),
+                s(Vector3(0, 0, 1)).Z());
+      continue;
+    }
+    p.normal = pose.Rot().RotateVector(part.normal);
+    p.offset = part.offset + p.normal.Dot(pose.Pos());
+    p.min.Set(-inf, -inf, -inf);
+    p.max.Set(inf, inf, inf);
+    // the half-space is bounded along the axis of an axis-aligned normal
+    for (unsigned int a = 0; a < 3; ++a)
+    {
+      if (std::fabs(std::fabs(p.normal[a]) - 1) > 1e-09) continue;
+      Vector3 bound = p.normal * p.offset;
+      if (p.normal[a] > 0)
+        p.max.Set(a == 0 ? bound.X() : inf, a == 1 ? bound.Y() : inf,
+                  a == 2 ? bound.Z() : inf);
+      else
+        p.min.Set(a == 0 ? bound.X() : -inf, a == 1 ? bound.Y() : -inf,
+                  a == 2 ? bound.Z() : -inf);
+    }
+  }
+  return placed;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void SimplePhysicsWorld::Collide(const std::vector<PlacedPart>& parts1,
+                                 const std::vector<PlacedPart>& parts2,
+                                 std::vector<Contact>& contacts)
+{
+  for (std::vector<PlacedPart>::const_iterator p1 = parts1.begin();
+       p1 != parts1.end(); ++p1)
+  {
+    for (std::vector<PlacedPart>::const_iterator p2 = parts2.begin();
+         p2 != parts2.end(); ++p2)
+    {
+      if (p1->isPlane && p2->isPlane) continue;
+      if (p1->max.X() < p2->min.X() || p2->max.X() < p1->min.X() ||
+          p1->max.Y() < p2->min.Y() || p2->max.Y() < p1->min.Y() ||
+          p1->max.Z() < p2->min.Z() || p2->max.Z() < p1->min.Z())
+        continue;
+
+      if (p1->isPlane || p2->isPlane)
+      {
+        // deepest point of the convex part in the half-space
+        const PlacedPart& plane = p1->isPlane ? *p1 : *p2;
+        const ConvexSupport& convex = p1->isPlane ? *p2->support
+                                                  : *p1->support;
+        const Vector3 p = convex(-plane.normal);
+        const double depth = plane.offset - plane.normal.Dot(p);
+        if (depth < 0) continue;
+        // the convex part separates from the plane along the plane normal
+        const Vector3 normal = p1->isPlane ? plane.normal : -plane.normal;
+        contacts.push_back(Contact(p + plane.normal * (depth / 2), normal,
+                                   SimpleWrench(), depth));
+        continue;
+      }
+
+      SignedDistanceResult res;
+      if (!ConvexSignedDistance(*p1->support, *p2->support, res))
+      {
+        LOG_WARN("physics", "Signed distance did not converge, "
+                            << "skipping contact");
+        continue;
+      }
+      if (res.distance > 0) continue;
+      contacts.push_back(Contact((res.pointA + res.pointB) / 2, res.normal,
+                                 SimpleWrench(), -res.distance));
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<SimplePhysicsWorld::ContactInfoPtr>
+SimplePhysicsWorld::ComputeContacts(const ModelID * m1,
+                                    const ModelID * m2) const
+{
+  std::vector<ContactInfoPtr> ret;
+  // models are iterated in order of their names, so model1 of each
+  // contact is the first and the normals point from model1 to model2
+  std::vector<ModelMap::const_iterator> selected;
+  std::vector<std::vector<PlacedPart> > placed;
+  for (ModelMap::const_iterator it = models.begin(); it != models.end(); ++it)
+  {
+    if (m1 && m2 && it->first != *m1 && it->first != *m2) continue;
+    selected.push_back(it);
+    placed.push_back(PlaceParts(it->second));
+  }
+
+  for (unsigned int i = 0; i < selected.size(); ++i)
+  {
+    for (unsigned int j = i + 1; j < selected.size(); ++j)
+    {
+      // static models don't move, so contacts between them are irrelevant
+      if (selected[i]->second.isStatic && selected[j]->second.isStatic)
+        continue;
+      std::vector<Contact> contacts;
+      Collide(placed[i], placed[j], contacts);
+      if (contacts.empty()) continue;
+      ContactInfoPtr info(new ContactInfo(selected[i]->first, PartID(),
+                                          selected[j]->first, PartID()));
+      info->contacts = contacts;
+      ret.push_back(info);
+    }
+  }
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+std::vector<SimplePhysicsWorld::ContactInfoPtr>
+SimplePhysicsWorld::GetContactInfoHelper(const ModelID * m1,
+                                         const ModelID * m2) const
+{
+  std::vector<ContactInfoPtr> ret;
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    ret = ComputeContacts(m1, m2);
+  }
+  ContactAnomalies anomalies;
+  for (std::vector<ContactInfoPtr>::const_iterator it = ret.begin();
+       it != ret.end(); ++it)
+  {
+    ++anomalies.numContacts;
+    anomalies.numPoints += (*it)->contacts.size();
+  }
+  AddContactAnomalies(anomalies);
+  return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void SimplePhysicsWorld::Step()
+{
+  if (!dynamicsEnabled) return;
+
+  for (ModelMap::iterator it = models.begin(); it != models.end(); ++it)
+  {
+    ModelEntry& s = it->second;
+    if (s.isStatic) continue;
+    s.linearVel += gravity * stepSize;
+    s.pose.Pos() += s.linearVel * stepSize;
+    const double angle = s.angularVel.Length() * stepSize;
+    if (angle > 0)
+    {
+      s.pose.Rot() = ignition::math::Quaterniond(s.angularVel.Normalized(),
+                                                 angle) * s.pose.Rot();
+      s.pose.Rot().Normalize();
+    }
+  }
+
+  // push intersecting models apart and remove their approaching velocity
+  const std::vector<ContactInfoPtr> contacts = ComputeContacts();
+  for (std::vector<ContactInfoPtr>::const_iterator it = contacts.begin();
+       it != contacts.end(); ++it)
+  {
+    ModelEntry& a = models[(*it)->model1];
+    ModelEntry& b = models[(*it)->model2];
+    // the share of each model in the correction
+    const double shareA = a.isStatic ? 0 : (b.isStatic ? 1 : 0.5);
+    const double shareB = b.isStatic ? 0 : (a.isStatic ? 1 : 0.5);
+    for (std::vector<Contact>::const_iterator c = (*it)->contacts.begin();
+         c != (*it)->contacts.end(); ++c)
+    {
+      a.pose.Pos() -= c->normal * (c->depth * shareA);
+      b.pose.Pos() += c->normal * (c->depth * shareB);
+      const double approach = (b.linearVel - a.linearVel).Dot(c->normal);
+      if (approach >= 0) continue;
+      a.linearVel += c->normal * (approach * shareA);
+      b.linearVel -= c->normal * (approach * shareB);
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+collision_benchmark::OpResult
+SimplePhysicsWorld::AddModel(const ModelID& modelname,
+                             const SimpleWorldState::ModelState& state)
+{
+  if (!state.shape)
+  {
+    LOG_ERROR("physics", "World " << GetName() << ": Model " << modelname
+                         << " has no shape");
+    return NOT_SUPPORTED;
+  }
+  const OpResult res = AddShapeModel(modelname, state.shape, state.collShape,
+                                     state.pose, state.scale);
+  if (res != SUCCESS) return res;
+  ModelEntry& model = models[modelname];
+  model.linearVel = state.linearVel;
+  model.angularVel = state.angularVel;
+  return SUCCESS;
+}
@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_SIMPLEPHYSICSWORLD_H
+#define COLLISION_BENCHMARK_SIMPLEPHYSICSWORLD_H
+
+#include <collision_benchmark/PhysicsWorld.hh>
+#include <collision_benchmark/ShapePhysicsWorld.hh>
+#include <collision_benchmark/ConvexSupport.hh>
+#include <collision_benchmark/Shape.hh>
+
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Wrench of a contact in the SimplePhysicsWorld. All fields
+ * are zero, as the simple world does not compute contact forces.
+ */
+struct SimpleWrench
+{
+  ignition::math::Vector3d body1Force;
+  ignition::math::Vector3d body2Force;
+  ignition::math::Vector3d body1Torque;
+  ignition::math::Vector3d body2Torque;
+};
+
+/**
+ * \brief State of a SimplePhysicsWorld.
+ *
+ * The state of each model includes the shapes it was made of, so that
+ * SetWorldState() can add models which are not in the world yet, e.g.
+ * when the state is transferred from another SimplePhysicsWorld.
+ */
+struct SimpleWorldState
+{
+  typedef Shape::Pose3 Pose3;
+  typedef Shape::Vector3 Vector3;
+
+  // State of one model
+  struct ModelState
+  {
+    ModelState(): scale(1, 1, 1) {}
+    Pose3 pose;
+    Vector3 linearVel;
+    Vector3 angularVel;
+    Vector3 scale;
+    // the shapes the model was added with, see
+    // SimplePhysicsWorld::AddModelFromShape()
+    Shape::Ptr shape;
+    Shape::Ptr collShape;
+  };
+
+  SimpleWorldState(): simTime(0), iterations(0) {}
+
+  friend std::ostream& operator<<(std::ostream& o, const SimpleWorldState& s)
+  {
+    o << "Time: " << s.simTime << " (" << s.iterations << " iterations)";
+    for (std::map<std::string, ModelState>::const_iterator
+         it = s.models.begin(); it != s.models.end(); ++it)
+    {
+      o << std::endl << "  " << it->first << ": pose " << it->second.pose
+        << ", vel " << it->second.linearVel;
+    }
+    for (std::vector<std::string>::const_iterator it = s.deletions.begin();
+         it != s.deletions.end(); ++it)
+    {
+      o << std::endl << "  deleted: " << *it;
+    }
+    return o;
+  }
+
+  // simulation time (seconds) and number of steps
+  double simTime;
+  unsigned long iterations;
+  // all models by their name
+  std::map<std::string, ModelState> models;
+  // only in differential states (see SimplePhysicsWorld::GetWorldStateDiff()):
+  // the names of the models which are to be removed.
+  std::vector<std::string> deletions;
+};
+
+struct SimplePhysicsWorldTypes
+{
+  /// Describes a state of the world
+  typedef SimpleWorldState WorldState;
+
+  /// ID type used to identify models in the world
+  typedef std::string ModelID;
+
+  /// ID type to identify individual parts of a model
+  typedef std::string ModelPartID;
+
+  /// Math 3D vector implementation
+  typedef ignition::math::Vector3d Vector3;
+
+  /// Math wrench implementation
+  typedef SimpleWrench Wrench;
+};
+
+/**
+ * \brief Data of a model in a SimplePhysicsWorld, in addition to the
+ * shape, pose and scale kept by ShapePhysicsWorld.
+ */
+struct SimpleModelData
+{
+  typedef Shape::Pose3 Pose3;
+  typedef Shape::Vector3 Vector3;
+
+  // One collision part of a model
+  struct Part
+  {
+    // pose relative to the model
+    Pose3 pose;
+    // support function for convex parts, or NULL for planes
+    ConvexSupport::ConstPtr support;
+    // for planes: the unit normal and offset in the frame of the part
+    // (the plane is n * x = offset)
+    Vector3 normal;
+    double offset;
+  };
+
+  SimpleModelData(): isStatic(false) {}
+
+  Vector3 linearVel;
+  Vector3 angularVel;
+  std::vector<Part> parts;
+  // true if the model contains a plane
+  bool isStatic;
+};
+
+/**
+ * \brief Lightweight PhysicsWorld which needs no physics engine.
+ *
+ * Models consist of primitive shapes (PrimitiveShape, or shapes of which all
+ * collision parts are primitives, see Shape::GetCollisionParts()) and can
+ * only be added with AddModelFromShape(). SDF is not supported.
+ *
+ * Contacts are computed analytically: convex pairs with
+ * ConvexSignedDistance(), and pairs with a plane, which is treated as
+ * half-space, from the support point. There is one contact point for each
+ * pair of intersecting collision parts, with the normal pointing from
+ * ContactInfo::model1 to ContactInfo::model2.
+ *
+ * Update() integrates the velocities with semi-implicit Euler under
+ * gravity. Intersecting models are pushed apart along the contact normal
+ * and their approaching velocity is removed; contacts don't affect
+ * rotations, and there is no friction. Models containing a plane are static.
+ * The scale of models is applied to the positions of the collision parts
+ * and to the dimensions of boxes, spheres (x) and cylinders (x for the
+ * radius, z for the length). Planes are not scaled.
+ *
+ * This is meant as zero-engine baseline to measure the cost of the
+ * benchmark harness itself (world management, state transfer, contact
+ * evaluation), and for tests which should run quickly without an engine.
+ */
+class SimplePhysicsWorld:
+  public ShapePhysicsWorld<PhysicsWorld<SimplePhysicsWorldTypes::WorldState,
+                                        SimplePhysicsWorldTypes::ModelID,
+                                        SimplePhysicsWorldTypes::ModelPartID,
+                                        SimplePhysicsWorldTypes::Vector3,
+                                        SimplePhysicsWorldTypes::Wrench>,
+                           SimpleModelData>
+{
+  private: typedef ShapePhysicsWorld<
+             PhysicsWorld<SimplePhysicsWorldTypes::WorldState,
+                          SimplePhysicsWorldTypes::ModelID,
+                          SimplePhysicsWorldTypes::ModelPartID,
+                          SimplePhysicsWorldTypes::Vector3,
+                          SimplePhysicsWorldTypes::Wrench>,
+             SimpleModelData> ParentClass;
+
+  public: typedef std::shared_ptr<SimplePhysicsWorld> Ptr;
+  public: typedef std::shared_ptr<const SimplePhysicsWorld> ConstPtr;
+
+  public: typedef ParentClass::ModelID ModelID;
+  public: typedef ParentClass::WorldState WorldState;
+  public: typedef ParentClass::Vector3 Vector3;
+  public: typedef ParentClass::Contact Contact;
+  public: typedef ParentClass::ContactInfo ContactInfo;
+  public: typedef ParentClass::ContactInfoPtr ContactInfoPtr;
+  public: typedef ParentClass::ContactAnomalies ContactAnomalies;
+  public: typedef ParentClass::Shape Shape;
+  public: typedef ParentClass::ModelLoadResult ModelLoadResult;
+  public: typedef Shape::Pose3 Pose3;
+
+  // \param name the name of the world
+  // \param stepSize the time (seconds) of one step in Update()
+  public: SimplePhysicsWorld(const std::string& name = "simple_world",
+                             const double stepSize = 0.001);
+  public: virtual ~SimplePhysicsWorld() {}
+
+  public: virtual void SetDynamicsEnabled(const bool flag);
+
+  public: virtual WorldState GetWorldState() const;
+
+  // Returns the state of all models in \e other, and the names of the
+  // models in this world which are not in \e other as deletions.
+  public: virtual WorldState GetWorldStateDiff(const WorldState& other) const;
+
+  // Applies the state of all models in \e state, adding the models which
+  // are not in the world. Unless \e isDiff is true, models which are
+  // not in \e state are removed.
+  // \retval NOT_SUPPORTED a model in \e state is not in the world and
+  //    has no shape.
+  public: virtual OpResult SetWorldState(const WorldState& state,
+                                         bool isDiff = false);
+
+  // The bounding box of models containing a plane is unbounded in the
+  // directions along the plane.
+  public: virtual bool GetAABB(const ModelID& id,
+                               Vector3& min, Vector3& max) const;
+
+  public: virtual std::vector<ContactInfoPtr> GetContactInfo() const;
+
+  public: virtual std::vector<ContactInfoPtr>
+                  GetContactInfo(const ModelID& m1, const ModelID& m2) const;
+
+  // Sets the gravity, by default (0, 0, -9.81)
+  public: void SetGravity(const Vector3& gravity);
+
+  public: Vector3 GetGravity() const;
+
+  // Returns the time (seconds) of one step in Update()
+  public: double GetStepSize() const { return stepSize; }
+
+  // Sets the velocity of the model \e id.
+  // \retval false the model was not in the world
+  public: bool SetModelVelocity(const ModelID& id,
+                                const Vector3& linear,
+                                const Vector3& angular = Vector3());
+
+  // \retval NOT_SUPPORTED a collision part is not a primitive
+  protected: virtual OpResult CreateModel(const ModelID& id,
+                                          ModelEntry& model);
+
+  // Creates the parts again if the scale has changed.
+  protected: virtual bool UpdateModel(const ModelID& id, ModelEntry& model,
+                                      const Vector3& oldScale);
+
+  // Makes one step of the dynamics
+  protected: virtual void Step();
+
+  private: typedef SimpleModelData::Part Part;
+
+  // A part placed in the world
+  private: struct PlacedPart
+  {
+    // for convex parts
+    std::shared_ptr<ConvexSupport> support;
+    // for planes: normal and offset in the world frame
+    bool isPlane;
+    Vector3 normal;
+    double offset;
+    // bounding box in the world frame, unbounded along planes
+    Vector3 min, max;
+  };
+
+  // Creates the model parts of \e shape with the dimensions scaled
+  // by \e scale.
+  // \return false if a collision part is not supported
+  private: static bool CreateParts(const Shape::Ptr& shape,
+                                   const Vector3& scale,
+                                   std::vector<Part>& parts);
+
+  // Places all parts of \e model at its current pose
+  private: static std::vector<PlacedPart> PlaceParts(const ModelEntry& model);
+
+  // Computes the contact points between the placed parts of two models
+  // and adds them to \e contacts.
+  private: static void Collide(const std::vector<PlacedPart>& parts1,
+                               const std::vector<PlacedPart>& parts2,
+                               std::vector<Contact>& contacts);
+
+  // Computes the contacts between all pairs of models, or only between
+  // \e m1 and \e m2 if given. Has to be called with the mutex locked.
+  private: std::vector<ContactInfoPtr>
+           ComputeContacts(const ModelID * m1 = NULL,
+                           const ModelID * m2 = NULL) const;
+
+  // Computes the contacts like ComputeContacts() and counts them in the
+  // contact anomalies.
+  private: std::vector<ContactInfoPtr>
+           GetContactInfoHelper(const ModelID * m1, const ModelID * m2) const;
+
+  // Adds the model \e name from its \e state. Has to be called with the
+  // mutex locked.
+  private: OpResult AddModel(const ModelID& name,
+                             const SimpleWorldState::ModelState& state);
+
+  // protected by the mutex
+  private: Vector3 gravity;
+  private: bool dynamicsEnabled;
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_SIMPLEPHYSICSWORLD_H
@@ -16,12 +16,26 @@
 */
 #include <collision_benchmark/SimpleTriMeshShape.hh>
 #include <collision_benchmark/MeshHelper.hh>
+#include <collision_benchmark/MeshDecimation.hh>
 #include <collision_benchmark/Helpers.hh>
+#include <collision_benchmark/Logger.hh>
 
 using collision_benchmark::SimpleTriMeshShape;
 
 const std::string SimpleTriMeshShape::MESH_EXT="stl";
 
+////////////////////////////////////////////////////////////////
+void SimpleTriMeshShape::MakeLowRes(const unsigned int targetFaces)
+{
+  if (!data)
+  {
+    LOG_ERROR("shape", "No mesh data to create low resolution mesh from.");
+    return;
+  }
+  lowResData = collision_benchmark::DecimateMesh(*data, targetFaces);
+}
+
+////////////////////////////////////////////////////////////////
 sdf::ElementPtr
 SimpleTriMeshShape::GetShapeSDF(bool detailed,
                                 const std::string& resourceDir,
@@ -30,8 +44,8 @@ SimpleTriMeshShape::GetShapeSDF(bool detailed,
 {
   if (resourceDir.empty() && resourceSubDir.empty())
   {
-    std::cerr << "Resource directory to write mesh data to is empty, "
-              << "so cannot create SDF for mesh."<<std::endl;
+    LOG_ERROR("shape", "Resource directory to write mesh data to is empty, "
+                       << "so cannot create SDF for mesh.");
     return sdf::ElementPtr();
   }
 
@@ -53,8 +67,7 @@ SimpleTriMeshShape::GetShapeSDF(bool detailed,
 
   if (!collision_benchmark::makeDirectoryIfNeeded(fulldir))
   {
-    std::cerr << "Could not create directory to write mesh data to"
-              << std::endl;
+    LOG_ERROR("shape", "Could not create directory to write mesh data to");
     return sdf::ElementPtr();
   }
 
@@ -69,9 +82,12 @@ SimpleTriMeshShape::GetShapeSDF(bool detailed,
     useURI="file://"+subname;
   }
 
-  if (!collision_benchmark::WriteTrimesh(fullname, MESH_EXT, data))
+  MeshDataPtr writeData = data;
+  if (!detailed && lowResData) writeData = lowResData;
+
+  if (!collision_benchmark::WriteTrimesh(fullname, MESH_EXT, writeData))
   {
-    std::cerr<<"Could not write mesh data!"<<std::endl;
+    LOG_ERROR("shape", "Could not write mesh data!");
     return sdf::ElementPtr();
   }
 
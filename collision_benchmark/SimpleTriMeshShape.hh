@@ -68,7 +68,9 @@ class SimpleTriMeshShape: public Shape
 
   public: SimpleTriMeshShape(const SimpleTriMeshShape& o):
             Shape(o),
-            data(o.data) {}
+            data(o.data),
+            lowResData(o.lowResData),
+            name(o.name) {}
 
   public: virtual ~SimpleTriMeshShape(){}
 
@@ -79,8 +81,27 @@ class SimpleTriMeshShape: public Shape
                               const std::string& resourceSubDir = "",
                               const bool useFullPath = false) const;
 
+  // Returns true if a low resolution mesh has been created
+  // with MakeLowRes().
+  public: virtual bool SupportLowRes() const { return lowResData != nullptr; }
+
+  // Creates the low resolution mesh which is returned by GetShapeSDF() with
+  // \e detailed = false. The mesh is simplified with DecimateMesh() until it
+  // has at most \e targetFaces triangles. The result is cached alongside the
+  // detailed mesh and replaced by subsequent calls of this method.
+  public: void MakeLowRes(const unsigned int targetFaces);
+
+  // Returns the detailed mesh
+  public: MeshDataPtr GetMeshData() const { return data; }
+
+  // Returns the low resolution mesh, or NULL if MakeLowRes() was not called.
+  public: MeshDataPtr GetLowResMeshData() const { return lowResData; }
+
   private: MeshDataT::Ptr data;
 
+  // low resolution version of \e data, created in MakeLowRes()
+  private: MeshDataT::Ptr lowResData;
+
   // unique name for this mesh data. Important for calls of GetShapeSDF().
   private: std::string name;
 };
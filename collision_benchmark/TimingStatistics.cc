@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/TimingStatistics.hh>
+
+#include <algorithm>
+#include <cmath>
+
+using collision_benchmark::TimingStatistics;
+
+/////////////////////////////////////////////////////////////////////////////
+void TimingStatistics::Add(const double value)
+{
+  if (!samples.empty() && (value < samples.back())) sorted = false;
+  samples.push_back(value);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TimingStatistics::Clear()
+{
+  samples.clear();
+  sorted = true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void TimingStatistics::Sort() const
+{
+  if (sorted) return;
+  std::sort(samples.begin(), samples.end());
+  sorted = true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+double TimingStatistics::GetMin() const
+{
+  if (samples.empty()) return 0;
+  Sort();
+  return samples.front();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+double TimingStatistics::GetMax() const
+{
+  if (samples.empty()) return 0;
+  Sort();
+  return samples.back();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+double TimingStatistics::GetMean() const
+{
+  if (samples.empty()) return 0;
+  double sum = 0;
+  for (std::vector<double>::const_iterator it = samples.begin();
+       it != samples.end(); ++it)
+    sum += *it;
+  return sum / samples.size();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+double TimingStatistics::GetStdDev() const
+{
+  if (samples.size() < 2) return 0;
+  const double mean = GetMean();
+  double sum = 0;
+  for (std::vector<double>::const_iterator it = samples.begin();
+       it != samples.end(); ++it)
+    sum += (*it - mean) * (*it - mean);
+  return std::sqrt(sum / (samples.size() - 1));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+double TimingStatistics::GetPercentile(const double p) const
+{
+  if (samples.empty()) return 0;
+  Sort();
+  const double rank = std::min(std::max(p, 0.0), 100.0) / 100 *
+                      (samples.size() - 1);
+  const std::size_t lower = static_cast<std::size_t>(std::floor(rank));
+  const std::size_t upper = std::min(lower + 1, samples.size() - 1);
+  const double frac = rank - lower;
+  return samples[lower] * (1 - frac) + samples[upper] * frac;
+}
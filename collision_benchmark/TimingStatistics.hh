@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_TIMINGSTATISTICS_H
+#define COLLISION_BENCHMARK_TIMINGSTATISTICS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Collects samples of measured durations and computes summary
+ * statistics over them, such as the mean and percentiles.
+ *
+ * The unit of the samples is up to the caller, all statistics are
+ * returned in the same unit.
+ */
+class TimingStatistics
+{
+  public: TimingStatistics():
+          sorted(true) {}
+
+  // Adds the sample \e value
+  public: void Add(const double value);
+
+  // Removes all samples
+  public: void Clear();
+
+  // Returns the number of samples
+  public: std::size_t GetCount() const { return samples.size(); }
+
+  // Returns the smallest sample, or 0 if there are no samples
+  public: double GetMin() const;
+
+  // Returns the largest sample, or 0 if there are no samples
+  public: double GetMax() const;
+
+  // Returns the mean of the samples, or 0 if there are no samples
+  public: double GetMean() const;
+
+  // Returns the standard deviation of the samples, or 0 if there are
+  // less than two samples
+  public: double GetStdDev() const;
+
+  // Returns the \e p-th percentile of the samples, interpolating linearly
+  // between the closest ranks.
+  // \param p the percentile in [0, 100]. 50 is the median.
+  // \return the percentile, or 0 if there are no samples
+  public: double GetPercentile(const double p) const;
+
+  // sorts the samples if they are not sorted yet
+  private: void Sort() const;
+
+  // all samples, which are sorted on demand
+  private: mutable std::vector<double> samples;
+  // true if \e samples is sorted
+  private: mutable bool sorted;
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_TIMINGSTATISTICS_H
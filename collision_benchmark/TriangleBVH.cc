@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <collision_benchmark/TriangleBVH.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using collision_benchmark::TriangleBVH;
+
+namespace
+{
+typedef TriangleBVH::Vector3 Vector3;
+
+// compares the centroids of triangles along one axis
+struct CentroidLess
+{
+  CentroidLess(const std::vector<Vector3>& centroids_, const int axis_):
+    centroids(centroids_), axis(axis_) {}
+  bool operator()(const unsigned int a, const unsigned int b) const
+  {
+    return centroids[a][axis] < centroids[b][axis];
+  }
+  const std::vector<Vector3>& centroids;
+  const int axis;
+};
+
+// squared distance of \e p to the box [\e min, \e max]
+double SquaredBoxDistance(const Vector3& p,
+                          const Vector3& min, const Vector3& max)
+{
+  double dist = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    double d = std::max(std::max(min[i] - p[i], p[i] - max[i]), 0.0);
+    dist += d * d;
+  }
+  return dist;
+}
+
+// closest point to \e p on triangle \e t, see Ericson,
+// "Real-Time Collision Detection", 2005, chapter 5.1.5
+Vector3 ClosestPointOnTriangle(const Vector3& p,
+                               const TriangleBVH::Triangle& t)
+{
+  const Vector3& a = t.v[0];
+  const Vector3& b = t.v[1];
+  const Vector3& c = t.v[2];
+  Vector3 ab = b - a;
+  Vector3 ac = c - a;
+  Vector3 ap = p - a;
+  double d1 = ab.Dot(ap);
+  double d2 = ac.Dot(ap);
+  if (d1 <= 0 && d2 <= 0) return a;
+
+  Vector3 bp = p - b;
+  double d3 = ab.Dot(bp);
+  double d4 = ac.Dot(bp);
+  if (d3 >= 0 && d4 <= d3) return b;
+
+  double vc = d1 * d4 - d3 * d2;
+  if (vc <= 0 && d1 >= 0 && d3 <= 0)
+    return a + ab * (d1 / (d1 - d3));
+
+  Vector3 cp = p - c;
+  double d5 = ab.Dot(cp);
+  double d6 = ac.Dot(cp);
+  if (d6 >= 0 && d5 <= d6) return c;
+
+  double vb = d5 * d2 - d1 * d6;
+  if (vb <= 0 && d2 >= 0 && d6 <= 0)
+    return a + ac * (d2 / (d2 - d6));
+
+  double va = d3 * d6 - d5 * d4;
+  if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+    return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+  double denom = 1.0 / (va + vb + vc);
+  return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// returns true if the ray from \e origin in the direction with the
+// inverse \e invDir hits the box [\e min, \e max]
+bool RayHitsBox(const Vector3& origin, const Vector3& invDir,
+                const Vector3& min, const Vector3& max)
+{
+  double tMin = 0;
+  double tMax = std::numeric_limits<double>::max();
+  for (int i = 0; i < 3; ++i)
+  {
+    double t1 = (min[i] - origin[i]) * invDir[i];
+    double t2 = (max[i] - origin[i]) * invDir[i];
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+  }
+  return tMin <= tMax;
+}
+
+// returns true if the ray from \e origin in direction \e dir intersects
+// triangle \e t (Moeller and Trumbore, 1997)
+bool RayHitsTriangle(const Vector3& origin, const Vector3& dir,
+                     const TriangleBVH::Triangle& t)
+{
+  Vector3 e1 = t.v[1] - t.v[0];
+  Vector3 e2 = t.v[2] - t.v[0];
+  Vector3 p = dir.Cross(e2);
+  double det = e1.Dot(p);
+  if (std::fabs(det) < 1e-15) return false;
+  double invDet = 1.0 / det;
+  Vector3 s = origin - t.v[0];
+  double u = s.Dot(p) * invDet;
+  if (u < 0 || u > 1) return false;
+  Vector3 q = s.Cross(e1);
+  double v = dir.Dot(q) * invDet;
+  if (v < 0 || u + v > 1) return false;
+  return e2.Dot(q) * invDet > 0;
+}
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////
+void TriangleBVH::Build(const unsigned int maxLeafSize)
+{
+  nodes.clear();
+  if (triangles.empty()) return;
+
+  std::vector<Vector3> centroids;
+  centroids.reserve(triangles.size());
+  std::vector<unsigned int> order(triangles.size());
+  for (unsigned int i = 0; i < triangles.size(); ++i)
+  {
+    const Triangle& t = triangles[i];
+    centroids.push_back((t.v[0] + t.v[1] + t.v[2]) / 3.0);
+    order[i] = i;
+  }
+
+  nodes.reserve(2 * triangles.size() / std::max(maxLeafSize, 1u) + 1);
+  BuildNode(order, centroids, 0, order.size(), std::max(maxLeafSize, 1u));
+
+  // re-order the triangles so that leaves reference contiguous ranges
+  std::vector<Triangle> sorted;
+  sorted.reserve(triangles.size());
+  for (unsigned int i = 0; i < order.size(); ++i)
+    sorted.push_back(triangles[order[i]]);
+  triangles.swap(sorted);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+unsigned int TriangleBVH::BuildNode(std::vector<unsigned int>& order,
+                                    const std::vector<Vector3>& centroids,
+                                    const unsigned int begin,
+                                    const unsigned int end,
+                                    const unsigned int maxLeafSize)
+{
+  const double inf = std::numeric_limits<double>::max();
+  double min[3] = {inf, inf, inf};
+  double max[3] = {-inf, -inf, -inf};
+  double cMin[3] = {inf, inf, inf};
+  double cMax[3] = {-inf, -inf, -inf};
+  for (unsigned int i = begin; i < end; ++i)
+  {
+    const Triangle& t = triangles[order[i]];
+    const Vector3& c = centroids[order[i]];
+    for (int a = 0; a < 3; ++a)
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        min[a] = std::min(min[a], t.v[k][a]);
+        max[a] = std::max(max[a], t.v[k][a]);
+      }
+      cMin[a] = std::min(cMin[a], c[a]);
+      cMax[a] = std::max(cMax[a], c[a]);
+    }
+  }
+
+  Node node;
+  node.min.Set(min[0], min[1], min[2]);
+  node.max.Set(max[0], max[1], max[2]);
+
+  const unsigned int idx = nodes.size();
+  nodes.push_back(node);
+
+  // split along the axis of largest extent of the centroids
+  int axis = 0;
+  for (int a = 1; a < 3; ++a)
+    if (cMax[a] - cMin[a] > cMax[axis] - cMin[axis]) axis = a;
+
+  if ((end - begin <= maxLeafSize) || (cMax[axis] - cMin[axis] <= 0))
+  {
+    nodes[idx].index = begin;
+    nodes[idx].count = end - begin;
+    return idx;
+  }
+
+  const unsigned int mid = (begin + end) / 2;
+  std::nth_element(order.begin() + begin, order.begin() + mid,
+                   order.begin() + end, CentroidLess(centroids, axis));
+  BuildNode(order, centroids, begin, mid, maxLeafSize);
+  unsigned int second = BuildNode(order, centroids, mid, end, maxLeafSize);
+  nodes[idx].index = second;
+  nodes[idx].count = 0;
+  return idx;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool TriangleBVH::IsInside(const Vector3& p) const
+{
+  if (nodes.empty()) return false;
+  // use a direction which is unlikely to be parallel to any faces or to
+  // pass exactly through edges of regular meshes
+  static const Vector3 dir = Vector3(0.5773, 0.5774, 0.5776).Normalized();
+  static const Vector3 invDir(1.0 / dir.X(), 1.0 / dir.Y(), 1.0 / dir.Z());
+
+  unsigned int hits = 0;
+  std::vector<unsigned int> stack;
+  stack.reserve(64);
+  stack.push_back(0);
+  while (!stack.empty())
+  {
+    const unsigned int nodeIdx = stack.back();
+    const Node& node = nodes[nodeIdx];
+    stack.pop_back();
+    if (!RayHitsBox(p, invDir, node.min, node.max)) continue;
+    if (node.IsLeaf())
+    {
+      for (unsigned int i = node.index; i < node.index + node.count; ++i)
+        if (RayHitsTriangle(p, dir, triangles[i])) ++hits;
+    }
+    else
+    {
+      stack.push_back(node.index);
+      stack.push_back(nodeIdx + 1);
+    }
+  }
+  return (hits % 2) == 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+double TriangleBVH::Distance(const Vector3& p, Vector3 * closest) const
+{
+  double best = std::numeric_limits<double>::max();
+  if (nodes.empty()) return best;
+
+  std::vector<unsigned int> stack;
+  stack.reserve(64);
+  stack.push_back(0);
+  while (!stack.empty())
+  {
+    const unsigned int nodeIdx = stack.back();
+    const Node& node = nodes[nodeIdx];
+    stack.pop_back();
+    if (SquaredBoxDistance(p, node.min, node.max) >= best) continue;
+    if (node.IsLeaf())
+    {
+      for (unsigned int i = node.index; i < node.index + node.count; ++i)
+      {
+        Vector3 c = ClosestPointOnTriangle(p, triangles[i]);
+        double d = (c - p).SquaredLength();
+        if (d < best)
+        {
+          best = d;
+          if (closest) *closest = c;
+        }
+      }
+    }
+    else
+    {
+      // visit the closer child first
+      const Node& first = nodes[nodeIdx + 1];
+      const Node& second = nodes[node.index];
+      if (SquaredBoxDistance(p, first.min, first.max) <
+          SquaredBoxDistance(p, second.min, second.max))
+      {
+        stack.push_back(node.index);
+        stack.push_back(nodeIdx + 1);
+      }
+      else
+      {
+        stack.push_back(nodeIdx + 1);
+        stack.push_back(node.index);
+      }
+    }
+  }
+  return std::sqrt(best);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+double TriangleBVH::SignedDistance(const Vector3& p) const
+{
+  double d = Distance(p);
+  return IsInside(p) ? -d : d;
+}
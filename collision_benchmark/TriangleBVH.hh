@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_TRIANGLEBVH_H
+#define COLLISION_BENCHMARK_TRIANGLEBVH_H
+
+#include <collision_benchmark/MeshData.hh>
+
+#include <ignition/math/Vector3.hh>
+
+#include <memory>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Bounding volume hierarchy of axis-aligned boxes over the
+ * triangles of a mesh.
+ *
+ * The nodes are stored in one array in depth-first order, so that the first
+ * child of an inner node directly follows the node itself. The triangles are
+ * re-ordered such that each leaf references a contiguous range of them.
+ * All computations are done in double precision, independent of the
+ * precision of the mesh.
+ *
+ * The inside tests assume that the mesh is closed.
+ */
+class TriangleBVH
+{
+  public: typedef std::shared_ptr<TriangleBVH> Ptr;
+  public: typedef std::shared_ptr<const TriangleBVH> ConstPtr;
+
+  public: typedef ignition::math::Vector3d Vector3;
+
+  // Triangle with its three corners
+  public: struct Triangle
+  {
+    Vector3 v[3];
+  };
+
+  // Node of the hierarchy
+  public: struct Node
+  {
+    // bounding box of all triangles within the node
+    Vector3 min, max;
+    // index of the first triangle for leaf nodes,
+    // or index of the second child for inner nodes.
+    unsigned int index;
+    // number of triangles for leaf nodes, 0 for inner nodes.
+    unsigned int count;
+
+    inline bool IsLeaf() const { return count > 0; }
+  };
+
+  // Builds the hierarchy over the triangles of \e mesh.
+  // \param maxLeafSize maximum number of triangles in a leaf node
+  public: template<typename VP>
+          explicit TriangleBVH(const MeshData<VP, 3>& mesh,
+                               const unsigned int maxLeafSize = 4);
+
+  // Returns the nodes. The root node is at index 0. If the mesh has no
+  // triangles, there are no nodes.
+  public: const std::vector<Node>& GetNodes() const { return nodes; }
+
+  // Returns the triangles in the order they are referenced by the nodes.
+  public: const std::vector<Triangle>& GetTriangles() const
+          { return triangles; }
+
+  // Returns the vertices of the mesh
+  public: const std::vector<Vector3>& GetVertices() const { return vertices; }
+
+  // Calls \e triTest for the triangles of all leaf nodes for which
+  // \e nodeTest returns true, until \e triTest returns true.
+  // \e nodeTest is called with a Node, \e triTest with a Triangle.
+  // \return true if \e triTest returned true for any of the triangles
+  public: template<typename NodeTest, typename TriangleTest>
+          bool AnyTriangle(const NodeTest& nodeTest,
+                           const TriangleTest& triTest) const;
+
+  // Returns true if \e p is inside the mesh. Uses the parity of the number
+  // of intersections of a ray starting at \e p with the mesh.
+  public: bool IsInside(const Vector3& p) const;
+
+  // Returns the distance of \e p to the closest point on the mesh surface,
+  // which is written to \e closest if it is not NULL.
+  public: double Distance(const Vector3& p, Vector3 * closest = NULL) const;
+
+  // Returns the distance of \e p to the mesh surface, which is negative
+  // if \e p is inside the mesh.
+  public: double SignedDistance(const Vector3& p) const;
+
+  // Builds the hierarchy over \e triangles.
+  private: void Build(const unsigned int maxLeafSize);
+
+  // Recursively builds the node for the triangles at positions
+  // [\e begin, \e end) in \e order and returns the index of the node.
+  private: unsigned int BuildNode(std::vector<unsigned int>& order,
+                                  const std::vector<Vector3>& centroids,
+                                  const unsigned int begin,
+                                  const unsigned int end,
+                                  const unsigned int maxLeafSize);
+
+  private: std::vector<Node> nodes;
+
+  private: std::vector<Triangle> triangles;
+
+  private: std::vector<Vector3> vertices;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+template<typename VP>
+TriangleBVH::TriangleBVH(const MeshData<VP, 3>& mesh,
+                         const unsigned int maxLeafSize)
+{
+  typedef MeshData<VP, 3> MeshDataT;
+  const std::vector<typename MeshDataT::Vertex>& verts = mesh.GetVertices();
+  const std::vector<typename MeshDataT::Face>& faces = mesh.GetFaces();
+  vertices.reserve(verts.size());
+  for (typename std::vector<typename MeshDataT::Vertex>::const_iterator
+       it = verts.begin(); it != verts.end(); ++it)
+  {
+    vertices.push_back(Vector3(it->X(), it->Y(), it->Z()));
+  }
+  triangles.reserve(faces.size());
+  for (typename std::vector<typename MeshDataT::Face>::const_iterator
+       it = faces.begin(); it != faces.end(); ++it)
+  {
+    Triangle t;
+    for (int i = 0; i < 3; ++i) t.v[i] = vertices[it->val[i]];
+    triangles.push_back(t);
+  }
+  Build(maxLeafSize);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+template<typename NodeTest, typename TriangleTest>
+bool TriangleBVH::AnyTriangle(const NodeTest& nodeTest,
+                              const TriangleTest& triTest) const
+{
+  if (nodes.empty()) return false;
+  std::vector<unsigned int> stack;
+  stack.reserve(64);
+  stack.push_back(0);
+  while (!stack.empty())
+  {
+    const Node& node = nodes[stack.back()];
+    const unsigned int nodeIdx = stack.back();
+    stack.pop_back();
+    if (!nodeTest(node)) continue;
+    if (node.IsLeaf())
+    {
+      for (unsigned int i = node.index; i < node.index + node.count; ++i)
+        if (triTest(triangles[i])) return true;
+    }
+    else
+    {
+      stack.push_back(node.index);
+      stack.push_back(nodeIdx + 1);
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_TRIANGLEBVH_H
@@ -40,10 +40,21 @@ class WorldLoader
           engine(_engine) {}
 
   // \sa PhysicsWorldBaseInterface::LoadFromSDF
+  // Unlike PhysicsWorldBaseInterface::LoadFromSDF, \e sdf is not changed,
+  // so that it can be used as a template to load several worlds from,
+  // with this loader or others. This method may be called concurrently
+  // with the same \e sdf.
   public: virtual PhysicsWorldBaseInterface::Ptr
           LoadFromSDF(const sdf::ElementPtr& sdf,
                       const std::string& worldname="") const = 0;
 
+  // Reads the world in \e filename so that it can be loaded with
+  // LoadFromSDF(). Use this to parse a file only once when loading it
+  // several times, or with several loaders.
+  // \return the world element, or NULL if the file could not be read.
+  public: virtual sdf::ElementPtr
+          ReadWorldFile(const std::string& filename) const = 0;
+
   // \sa PhysicsWorldBaseInterface::LoadFromFile
   public: virtual PhysicsWorldBaseInterface::Ptr
           LoadFromFile(const std::string& filename,
@@ -26,6 +26,8 @@
 #include <collision_benchmark/ControlServer.hh>
 #include <collision_benchmark/BasicTypes.hh>
 #include <collision_benchmark/TypeHelper.hh>
+#include <collision_benchmark/Profiler.hh>
+#include <collision_benchmark/Logger.hh>
 
 #include <gazebo/gazebo.hh>
 #include <gazebo/transport/transport.hh>
@@ -91,6 +93,8 @@ class WorldManager
             Vector3> PhysicsWorldModelInterfaceT;
   public: typedef typename PhysicsWorldModelInterfaceT::ModelLoadResult
             ModelLoadResult;
+  public: typedef typename PhysicsWorldModelInterfaceT::ShapeModel
+            ShapeModel;
   public: typedef typename PhysicsWorldModelInterfaceT::Ptr
             PhysicsWorldModelInterfacePtr;
 
@@ -219,7 +223,7 @@ class WorldManager
     std::lock_guard<std::recursive_mutex> lock(this->worldsMutex);
     if (GetWorld(_world->GetName()))
     {
-      std::cerr << "World with this name already exists! " << std::endl;
+      LOG_ERROR("world_manager", "World with this name already exists! ");
       return -1;
     }
     if (this->worlds.empty() && this->mirrorWorld)
@@ -231,6 +235,41 @@ class WorldManager
     return this->worlds.size()-1;
   }
 
+  /// Removes the world with the name \e name from the manager, e.g. to give
+  /// it back to a WorldPool. The world itself is not changed. If it was
+  /// mirrored, the mirror world is set to mirror the first remaining world.
+  /// The indices of all worlds added after it decrease by one.
+  /// \return false if there is no world with this name
+  public: bool RemovePhysicsWorld(const std::string& name)
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->worldsMutex);
+    int idx = -1;
+    for (unsigned int i = 0; i < this->worlds.size(); ++i)
+    {
+      if (this->worlds[i]->GetName() == name)
+      {
+        idx = i;
+        break;
+      }
+    }
+    if (idx < 0) return false;
+    this->worlds.erase(this->worlds.begin() + idx);
+    if (idx < this->mirroredWorldIdx)
+    {
+      --this->mirroredWorldIdx;
+    }
+    else if (idx == this->mirroredWorldIdx)
+    {
+      this->mirroredWorldIdx = -1;
+      if (!this->worlds.empty() && this->mirrorWorld)
+      {
+        this->mirrorWorld->SetOriginalWorld(this->worlds.front());
+        this->mirroredWorldIdx = 0;
+      }
+    }
+    return true;
+  }
+
   public: bool SetMirroredWorld(const int _index)
   {
 
@@ -313,11 +352,11 @@ class WorldManager
        PhysicsWorldModelInterfacePtr w = ToWorldWithModel(*it);
        if (!w)
        {
-         std::cerr<<"Cannot cast world " << i << " to "
-                  << "interface PhysicsWorldModelInterface<"
-                  << GetTypeName<ModelID>()
-                  << ", "<<GetTypeName<ModelPartID>()
-                  << ", "<<GetTypeName<Vector3>()<<">" << std::endl;
+         LOG_ERROR("world_manager", "Cannot cast world " << i << " to "
+                                    << "interface PhysicsWorldModelInterface<"
+                                    << GetTypeName<ModelID>()
+                                    << ", "<<GetTypeName<ModelPartID>()
+                                    << ", "<<GetTypeName<Vector3>()<<">");
        }
        ret.push_back(w);
      }
@@ -342,12 +381,12 @@ class WorldManager
          w = ToWorldWithContact(*it);
        if (!w)
        {
-         std::cerr<<"Cannot cast world " << i << " to "
-                  << "interface PhysicsWorldContactInterface<"
-                  << ", "<<GetTypeName<ModelID>()
-                  << ", "<<GetTypeName<ModelPartID>()
-                  << ", "<<GetTypeName<Vector3>()
-                  << ", "<<GetTypeName<Wrench>()<<">" << std::endl;
+         LOG_ERROR("world_manager", "Cannot cast world " << i << " to "
+                                    << "interface PhysicsWorldContactInterface<"
+                                    << ", "<<GetTypeName<ModelID>()
+                                    << ", "<<GetTypeName<ModelPartID>()
+                                    << ", "<<GetTypeName<Vector3>()
+                                    << ", "<<GetTypeName<Wrench>()<<">");
        }
        ret.push_back(w);
      }
@@ -370,13 +409,13 @@ class WorldManager
        PhysicsWorldPtr w = ToPhysicsWorld(*it);
        if (!w)
        {
-         std::cerr<<"Cannot cast world " << i << " to "
-                  << "interface PhysicsWorld<"
-                  << GetTypeName<WorldState>()
-                  << ", "<<GetTypeName<ModelID>()
-                  << ", "<<GetTypeName<ModelPartID>()
-                  << ", "<<GetTypeName<Vector3>()
-                  << ", "<<GetTypeName<Wrench>()<<">" << std::endl;
+         LOG_ERROR("world_manager", "Cannot cast world " << i << " to "
+                                    << "interface PhysicsWorld<"
+                                    << GetTypeName<WorldState>()
+                                    << ", "<<GetTypeName<ModelID>()
+                                    << ", "<<GetTypeName<ModelPartID>()
+                                    << ", "<<GetTypeName<Vector3>()
+                                    << ", "<<GetTypeName<Wrench>()<<">");
        }
        ret.push_back(w);
      }
@@ -444,6 +483,33 @@ class WorldManager
         (&Self::AddModelFromShapeCB, modelname, shape, collShape);
   }
 
+  /// Calls PhysicsWorldModelInterface::AddModelsFromSDF
+  /// on all worlds.
+  /// \return the return values for each world, each of which contains
+  ///   the result for each model in \e sdfs.
+  public: std::vector<std::vector<ModelLoadResult> >
+          AddModelsFromSDF(const std::vector<sdf::ElementPtr>& sdfs,
+                           const std::vector<std::string>& modelnames
+                             = std::vector<std::string>())
+  {
+    return CallOnAllWorldsWithModel
+      <std::vector<ModelLoadResult>, const std::vector<sdf::ElementPtr>&,
+       const std::vector<std::string>&>
+        (&Self::AddModelsFromSdfCB, sdfs, modelnames);
+  }
+
+  /// Calls PhysicsWorldModelInterface::AddModelsFromShape
+  /// on all worlds.
+  /// \return the return values for each world, each of which contains
+  ///   the result for each model in \e models.
+  public: std::vector<std::vector<ModelLoadResult> >
+          AddModelsFromShape(const std::vector<ShapeModel>& models)
+  {
+    return CallOnAllWorldsWithModel
+      <std::vector<ModelLoadResult>, const std::vector<ShapeModel>&>
+        (&Self::AddModelsFromShapeCB, models);
+  }
+
   /// Calls PhysicsWorldModelInterface::SetBasicModelState on
   /// all worlds. Assumes that all worlds use the same model name.
   /// \return number of worlds in which the state was successfully set.
@@ -522,8 +588,8 @@ class WorldManager
   /// collision states / contact points between them checked.
   public: void SetDynamicsEnabled(const bool flag)
   {
-   std::cout << "WorldManager received request to set dynamics "
-             << "enable to " << flag << std::endl;
+   LOG_INFO("world_manager", "WorldManager received request to set dynamics "
+                             << "enable to " << flag);
    std::lock_guard<std::recursive_mutex> lock(this->worldsMutex);
    for (std::vector<PhysicsWorldBaseInterface::Ptr>::iterator
         it = this->worlds.begin();
@@ -546,6 +612,7 @@ class WorldManager
    // the callback functions of this class. Only block the worlds
    // vector while absolutey necessary.
    // std::cout<<"__________UPDATE__________"<<std::endl;
+   COLLISION_BENCHMARK_PROFILE_NAMED_SCOPE("WorldManager::Update");
    this->worldsMutex.lock();
    int numWorlds=this->worlds.size();
    this->worldsMutex.unlock();
@@ -609,7 +676,7 @@ class WorldManager
         boost::filesystem::path(directory) /
         boost::filesystem::path(subDirectory) /
         boost::filesystem::path(prefix + "_" + w->GetName() + "." + ext);
-      std::cout << "Writing to file " << filename << std::endl;
+      LOG_INFO("world_manager", "Writing to file " << filename);
       std::string resourceDir, resourceSubdir;
       if (copyResources)
       {
@@ -618,8 +685,8 @@ class WorldManager
       }
       if (!w->SaveToFile(filename.string(), directory, subDirectory))
       {
-        std::cerr << "ERROR: Could not save world " << w->GetName() <<
-                     " to file " << filename.string() << std::endl;
+        LOG_ERROR("world_manager", "Could not save world " << w->GetName() <<
+                                   " to file " << filename.string());
         ++fail;
       }
     }
@@ -628,23 +695,23 @@ class WorldManager
 
   private: void NotifyPause(const bool _flag)
   {
-    std::cout << "WorldManager Received PAUSE command: "
-              << _flag << std::endl;
+    LOG_INFO("world_manager", "WorldManager Received PAUSE command: "
+                              << _flag);
     SetPaused(_flag);
   }
 
   private: void NotifyUpdate(const int _numSteps)
   {
-    std::cout << "WorldManager Received UPDATE command with "
-              << _numSteps << " steps. " << std::endl;
+    LOG_DEBUG("world_manager", "WorldManager Received UPDATE command with "
+                               << _numSteps << " steps. ");
     Update(_numSteps, true);
   }
 
   private: void NotifyModelStateChange(const ModelID  &_id,
                                    const BasicState &_state)
   {
-     std::cout << "WorldManager received STATE CHANGE command "
-               << "for model " << _id << ": " << _state << std::endl;
+     LOG_INFO("world_manager", "WorldManager received STATE CHANGE command "
+                               << "for model " << _id << ": " << _state);
      // std::vector<bool> retVals =
        CallOnAllWorldsWithModel <bool, const ModelID&, const BasicState&>
         (&Self::SetBasicModelStateCB, _id, _state);
@@ -655,8 +722,7 @@ class WorldManager
                                   const bool _isString,
                                   const BasicState &_state)
   {
-     std::cout << "WorldManager received SDF MODEL command"
-               << std::endl;
+     LOG_INFO("world_manager", "WorldManager received SDF MODEL command");
      std::lock_guard<std::recursive_mutex> lock(this->worldsMutex);
      for (std::vector<PhysicsWorldBaseInterface::Ptr>::iterator
           it = this->worlds.begin();
@@ -709,7 +775,7 @@ class WorldManager
      std::lock_guard<std::recursive_mutex> lock(this->worldsMutex);
        if (worlds.empty())
        {
-         std::cerr<<"There are no worlds to be mirrored." << std::endl;
+         LOG_ERROR("world_manager", "There are no worlds to be mirrored.");
          return "";
        }
 
@@ -717,14 +783,14 @@ class WorldManager
      if (ctrl < 0)
      {
        // Switch to previous world
-       std::cout<<"WorldManager: Switching to prev world"<<std::endl;
+       LOG_INFO("world_manager", "WorldManager: Switching to prev world");
        if (mirroredWorldIdx > 0) --mirroredWorldIdx;
        else mirroredWorldIdx=worlds.size()-1; // go back to last world
      }
      else if (ctrl > 0)
      {
        // Switch to next world
-       std::cout<<"WorldManager: Switching to next world"<<std::endl;
+       LOG_INFO("world_manager", "WorldManager: Switching to next world");
        if (mirroredWorldIdx < (worlds.size()-1)) ++mirroredWorldIdx;
        else mirroredWorldIdx=0; // go back to first world
      }
@@ -733,8 +799,8 @@ class WorldManager
      {
        if (!mirrorWorld->GetOriginalWorld())
        {
-         std::cerr<<"Mirror world has no original world set, "
-                  <<"cannot return name." << std::endl;
+         LOG_ERROR("world_manager", "Mirror world has no original world set, "
+                                    <<"cannot return name.");
          return "";
        }
        return mirrorWorld->GetOriginalWorld()->GetName();
@@ -743,15 +809,14 @@ class WorldManager
      // update mirrored world
      if (this->SetMirroredWorld(mirroredWorldIdx))
      {
-       std::cout << "WorldManager: New world is "
-                 << mirrorWorld->GetOriginalWorld()->GetName()
-                 << std::endl;
+       LOG_INFO("world_manager", "WorldManager: New world is "
+                                 << mirrorWorld->GetOriginalWorld()->GetName());
      }
 
      if (!mirrorWorld->GetOriginalWorld())
      {
-       std::cerr<<"Mirror world has no original world set, "
-                <<"cannot return name." << std::endl;
+       LOG_ERROR("world_manager", "Mirror world has no original world set, "
+                                  <<"cannot return name.");
        return "";
      }
 
@@ -801,6 +866,23 @@ class WorldManager
     return w.AddModelFromShape(modelname, shape, collShape);
   }
 
+  // Helper callback to call AddModelsFromSDF on the world
+  private: static std::vector<ModelLoadResult>
+          AddModelsFromSdfCB(PhysicsWorldModelInterfaceT& w,
+                             const std::vector<sdf::ElementPtr>& sdfs,
+                             const std::vector<std::string>& modelnames)
+  {
+    return w.AddModelsFromSDF(sdfs, modelnames);
+  }
+
+  // Helper callback to call AddModelsFromShape on the world
+  private: static std::vector<ModelLoadResult>
+          AddModelsFromShapeCB(PhysicsWorldModelInterfaceT& w,
+                               const std::vector<ShapeModel>& models)
+  {
+    return w.AddModelsFromShape(models);
+  }
+
   // Helper callback to call SetBasicModelState on the world
   private: static bool SetBasicModelStateCB
               (PhysicsWorldModelInterfaceT& w,
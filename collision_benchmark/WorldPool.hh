@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef COLLISION_BENCHMARK_WORLDPOOL_H
+#define COLLISION_BENCHMARK_WORLDPOOL_H
+
+#include <collision_benchmark/PhysicsWorld.hh>
+#include <collision_benchmark/WorldLoader.hh>
+#include <collision_benchmark/Logger.hh>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace collision_benchmark
+{
+
+/**
+ * \brief Pool of pre-loaded worlds for each physics engine, which can be
+ * leased and returned to avoid loading a new world each time one is needed.
+ *
+ * All worlds are loaded from the same world file, which is parsed only once.
+ * A returned world is reset to the state it had after loading: all models
+ * are removed with PhysicsWorldBaseInterface::Clear(), the models of the
+ * world file are added again, the initial world state is restored, dynamics
+ * are enabled and the world is paused.
+ * This is much faster than loading a new world, e.g. for every test case.
+ *
+ * Settings which are not part of the world state, such as gravity and the
+ * step size of the physics engine, can't be restored by the pool itself, as
+ * there is no engine independent access to them. They are only restored
+ * with a function given to SetSaveSettings(). Without it, callers which
+ * change these settings have to restore them before returning the world.
+ *
+ * The worlds keep the names they were loaded with (see Lease()).
+ */
+template<class _WorldState, class _ModelID,
+        class _ModelPartID, class _Vector3, class _Wrench>
+class WorldPool
+{
+  public: typedef WorldPool<_WorldState, _ModelID,
+                            _ModelPartID, _Vector3, _Wrench> Self;
+  public: typedef std::shared_ptr<Self> Ptr;
+  public: typedef std::shared_ptr<const Self> ConstPtr;
+
+  public: typedef PhysicsWorld<_WorldState, _ModelID, _ModelPartID,
+                               _Vector3, _Wrench> PhysicsWorldT;
+  public: typedef typename PhysicsWorldT::Ptr PhysicsWorldPtr;
+  public: typedef typename PhysicsWorldT::WorldState WorldState;
+
+  // restores the settings saved by a SaveSettingsFunction
+  public: typedef std::function<void()> RestoreSettingsFunction;
+  // saves the settings of a world which are not part of its world state,
+  // and returns a function which restores them.
+  public: typedef std::function<RestoreSettingsFunction
+                                (const PhysicsWorldPtr& world)>
+          SaveSettingsFunction;
+
+  // for each physics engine identified by name,
+  // the world loader assigned to it.
+  public: typedef std::map<std::string, WorldLoader::ConstPtr> WorldLoader_M;
+
+  // \param _worldLoaders world loaders for all the physics engines.
+  // \param _worldfile the world file all worlds are loaded from
+  // \param _namePrefix prefix of the names of the worlds
+  public: WorldPool(const WorldLoader_M& _worldLoaders,
+                    const std::string& _worldfile,
+                    const std::string& _namePrefix = "pool"):
+          worldLoaders(_worldLoaders),
+          worldfile(_worldfile),
+          namePrefix(_namePrefix) {}
+
+  public: virtual ~WorldPool() {}
+
+  // Sets the function which saves the settings of each world after it
+  // has been loaded, so that they can be restored in Return().
+  // Only applies to worlds which are loaded afterwards.
+  public: void SetSaveSettings(const SaveSettingsFunction& _saveSettings)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->saveSettings = _saveSettings;
+  }
+
+  // Loads worlds with \e engine until there are at least \e n worlds
+  // which can be leased.
+  // \return the number of worlds which can be leased
+  public: unsigned int Preload(const std::string& engine, const unsigned int n)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::vector<PhysicsWorldPtr>& free = this->freeWorlds[engine];
+    while (free.size() < n)
+    {
+      PhysicsWorldPtr world = LoadWorld(engine);
+      if (!world) break;
+      free.push_back(world);
+    }
+    return free.size();
+  }
+
+  // Leases a world which uses \e engine. If no world is free, a new one
+  // is loaded and named ``<prefix>_<engine>_<number>``.
+  // The world is paused and has the state it had after loading.
+  // It has to be given back with Return().
+  // \return the world or NULL if no world could be loaded for \e engine
+  public: PhysicsWorldPtr Lease(const std::string& engine)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::vector<PhysicsWorldPtr>& free = this->freeWorlds[engine];
+    PhysicsWorldPtr world;
+    if (free.empty())
+    {
+      world = LoadWorld(engine);
+    }
+    else
+    {
+      world = free.back();
+      free.pop_back();
+    }
+    if (world) this->worlds[world->GetName()].leased = true;
+    return world;
+  }
+
+  // Returns a world which was leased with Lease(). It is reset to the
+  // state it had after loading and can be leased again. Its settings are
+  // only restored if they were saved (see SetSaveSettings()).
+  // \return false if \e world was not leased from this pool
+  public: bool Return(const PhysicsWorldPtr& world)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!world) return false;
+    typename std::map<std::string, PooledWorld>::iterator it =
+      this->worlds.find(world->GetName());
+    if ((it == this->worlds.end()) || !it->second.leased ||
+        (it->second.world.lock() != world)) return false;
+
+    world->SetPaused(true);
+    if (it->second.restoreSettings) it->second.restoreSettings();
+    world->Clear();
+    // Clear() also removed the models of the world file
+    for (std::vector<sdf::ElementPtr>::const_iterator
+         m = this->modelSDFs.begin(); m != this->modelSDFs.end(); ++m)
+    {
+      if (world->AddModelFromSDF((*m)->Clone()).opResult != SUCCESS)
+      {
+        LOG_ERROR("world_pool", "Could not add a model of "
+                                << this->worldfile << " to world "
+                                << world->GetName() << " again");
+      }
+    }
+    world->SetWorldState(it->second.initialState, false);
+    world->SetDynamicsEnabled(true);
+    world->ResetContactAnomalies();
+
+    it->second.leased = false;
+    this->freeWorlds[it->second.engine].push_back(world);
+    return true;
+  }
+
+  // \return the number of worlds with \e engine which can be leased
+  // without loading a new world.
+  public: unsigned int GetNumFree(const std::string& engine) const
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    typename std::map<std::string, std::vector<PhysicsWorldPtr> >
+      ::const_iterator it = this->freeWorlds.find(engine);
+    if (it == this->freeWorlds.end()) return 0;
+    return it->second.size();
+  }
+
+  // Loads a new world for \e engine and remembers its initial state.
+  // Needs to be called with the mutex locked.
+  private: PhysicsWorldPtr LoadWorld(const std::string& engine)
+  {
+    WorldLoader_M::const_iterator wlIt = this->worldLoaders.find(engine);
+    if (wlIt == this->worldLoaders.end()) return PhysicsWorldPtr();
+    WorldLoader::ConstPtr loader = wlIt->second;
+
+    if (!this->worldSDF)
+    {
+      this->worldSDF = loader->ReadWorldFile(this->worldfile);
+      if (!this->worldSDF) return PhysicsWorldPtr();
+      if (this->worldSDF->HasElement("model"))
+      {
+        for (sdf::ElementPtr m = this->worldSDF->GetElement("model"); m;
+             m = m->GetNextElement("model"))
+          this->modelSDFs.push_back(m);
+      }
+    }
+
+    std::stringstream name;
+    name << this->namePrefix << "_" << engine << "_"
+         << this->numLoaded[engine]++;
+    PhysicsWorldPtr world = std::dynamic_pointer_cast<PhysicsWorldT>
+      (loader->LoadFromSDF(this->worldSDF, name.str()));
+    if (!world) return PhysicsWorldPtr();
+
+    world->SetPaused(true);
+    PooledWorld& pooled = this->worlds[world->GetName()];
+    pooled.world = world;
+    pooled.engine = engine;
+    pooled.initialState = world->GetWorldState();
+    if (this->saveSettings) pooled.restoreSettings = this->saveSettings(world);
+    pooled.leased = false;
+    return world;
+  }
+
+  // information about each world loaded by the pool
+  private: struct PooledWorld
+  {
+    // the world, which may have been destroyed by the leaser
+    std::weak_ptr<PhysicsWorldT> world;
+    std::string engine;
+    // the state after the world was loaded
+    WorldState initialState;
+    // restores the settings after the world was loaded, may be empty
+    RestoreSettingsFunction restoreSettings;
+    // whether the world is currently leased
+    bool leased;
+  };
+
+  private: WorldLoader_M worldLoaders;
+  private: std::string worldfile;
+  private: std::string namePrefix;
+  // saves the settings of each loaded world, may be empty
+  private: SaveSettingsFunction saveSettings;
+
+  // the world file, parsed when the first world is loaded
+  private: sdf::ElementPtr worldSDF;
+  // the models of the world file, added again when a world is returned
+  private: std::vector<sdf::ElementPtr> modelSDFs;
+
+  // worlds which can be leased, by engine
+  private: std::map<std::string, std::vector<PhysicsWorldPtr> > freeWorlds;
+  // all worlds loaded by this pool, by name
+  private: std::map<std::string, PooledWorld> worlds;
+  // number of worlds loaded for each engine
+  private: std::map<std::string, unsigned int> numLoaded;
+
+  private: mutable std::mutex mutex;
+};
+
+}  // namespace
+
+#endif  // COLLISION_BENCHMARK_WORLDPOOL_H
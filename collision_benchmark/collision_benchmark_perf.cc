@@ -0,0 +1,520 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <collision_benchmark/GazeboWorldLoader.hh>
+#include <collision_benchmark/GazeboPhysicsWorld.hh>
+#include <collision_benchmark/GazeboMultipleWorldsServer.hh>
+#include <collision_benchmark/GazeboHelpers.hh>
+#include <collision_benchmark/SimplePhysicsWorld.hh>
+#include <collision_benchmark/WorldManager.hh>
+#include <collision_benchmark/WorldLoader.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+#include <collision_benchmark/SimpleTriMeshShape.hh>
+#include <collision_benchmark/MeshShapeGeneratorNative.hh>
+#include <collision_benchmark/TimingStatistics.hh>
+#include <collision_benchmark/Profiler.hh>
+#ifdef COLLISION_BENCHMARK_BULLET
+#include <collision_benchmark/BulletPhysicsWorld.hh>
+#endif
+
+#include <gazebo/common/common.hh>
+
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using collision_benchmark::GazeboPhysicsWorldTypes;
+using collision_benchmark::GazeboWorldLoader;
+using collision_benchmark::GazeboMultipleWorldsServer;
+using collision_benchmark::MultipleWorldsServer;
+using collision_benchmark::WorldLoader;
+using collision_benchmark::WorldManager;
+using collision_benchmark::Shape;
+using collision_benchmark::PrimitiveShape;
+using collision_benchmark::SimpleTriMeshShape;
+using collision_benchmark::SimplePhysicsWorld;
+using collision_benchmark::BasicState;
+using collision_benchmark::TimingStatistics;
+
+namespace po = boost::program_options;
+
+typedef MultipleWorldsServer<GazeboPhysicsWorldTypes::WorldState,
+                             GazeboPhysicsWorldTypes::ModelID,
+                             GazeboPhysicsWorldTypes::ModelPartID,
+                             GazeboPhysicsWorldTypes::Vector3,
+                             GazeboPhysicsWorldTypes::Wrench>
+                                GzMultipleWorldsServer;
+
+typedef WorldManager<GazeboPhysicsWorldTypes::WorldState,
+                     GazeboPhysicsWorldTypes::ModelID,
+                     GazeboPhysicsWorldTypes::ModelPartID,
+                     GazeboPhysicsWorldTypes::Vector3,
+                     GazeboPhysicsWorldTypes::Wrench>
+          GzWorldManager;
+
+typedef GzWorldManager::PhysicsWorldPtr GzPhysicsWorldPtr;
+
+// Result of timing one operation on one world for one shape pair
+struct Result
+{
+  std::string engine;
+  std::string shape1, shape2;
+  std::string operation;
+  TimingStatistics stats;
+};
+
+// Creates one of the shapes which can be specified on the command line.
+// All shapes fit into a unit cube centered at the origin.
+// \return NULL if the type is not known
+Shape::Ptr MakeShape(const std::string& type)
+{
+  if (type == "box")
+    return Shape::Ptr(PrimitiveShape::CreateBox(1, 1, 1));
+  if (type == "sphere")
+    return Shape::Ptr(PrimitiveShape::CreateSphere(0.5));
+  if (type == "cylinder")
+    return Shape::Ptr(PrimitiveShape::CreateCylinder(0.5, 1));
+  if (type == "mesh")
+  {
+    collision_benchmark::MeshShapeGeneratorNative<float> gen;
+    return Shape::Ptr(new SimpleTriMeshShape(gen.MakeSphere(0.5, 32, 32, true),
+                                             "sphere_mesh"));
+  }
+  return Shape::Ptr();
+}
+
+// Calls \e op \e warmup times without measuring, and then
+// \e repetitions times, adding the duration of each call
+// in microseconds to \e stats.
+template<typename Operation>
+void Measure(const Operation& op, const int warmup,
+             const int repetitions, TimingStatistics& stats)
+{
+  typedef std::chrono::steady_clock Clock;
+  for (int i = 0; i < warmup; ++i) op();
+  for (int i = 0; i < repetitions; ++i)
+  {
+    Clock::time_point start = Clock::now();
+    op();
+    Clock::time_point end = Clock::now();
+    stats.Add(std::chrono::duration<double, std::micro>(end - start).count());
+  }
+}
+
+// Measures all operations for the shapes \e type1 and \e type2 in \e world
+// and adds the results to \e results.
+// \param PhysicsWorldPtr shared pointer to any PhysicsWorld
+// \retval false the models could not be added to the world
+template<class PhysicsWorldPtr>
+bool MeasurePair(const PhysicsWorldPtr& world, const std::string& engine,
+                 const std::string& type1, const std::string& type2,
+                 const int warmup, const int repetitions,
+                 std::vector<Result>& results)
+{
+  typedef typename PhysicsWorldPtr::element_type PhysicsWorldT;
+  typedef typename PhysicsWorldT::ModelLoadResult ModelLoadResult;
+  const std::string m1 = "perf_model1";
+  const std::string m2 = "perf_model2";
+  Shape::Ptr shape1 = MakeShape(type1);
+  Shape::Ptr shape2 = MakeShape(type2);
+  ModelLoadResult res1 = world->AddModelFromShape(m1, shape1, shape1);
+  ModelLoadResult res2 = world->AddModelFromShape(m2, shape2, shape2);
+  if ((res1.opResult != collision_benchmark::SUCCESS) ||
+      (res2.opResult != collision_benchmark::SUCCESS))
+  {
+    std::cerr << "Could not add models " << type1 << " and " << type2
+              << " to world " << world->GetName() << std::endl;
+    world->RemoveModel(m1);
+    world->RemoveModel(m2);
+    return false;
+  }
+
+  // place the models such that they overlap by 0.1 along the x axis
+  BasicState state1, state2;
+  state1.SetPosition(0, 0, 0);
+  state1.SetRotation(0, 0, 0, 1);
+  state2.SetPosition(0.9, 0, 0);
+  state2.SetRotation(0, 0, 0, 1);
+  world->SetBasicModelState(m1, state1);
+  world->SetBasicModelState(m2, state2);
+  world->Update(1);
+
+  const typename PhysicsWorldT::WorldState worldState =
+    world->GetWorldState();
+
+  const std::string ops[] = {"Update", "GetContactInfo", "SetBasicModelState",
+                             "GetAABB", "GetWorldState", "SetWorldState"};
+  const int numOps = sizeof(ops) / sizeof(ops[0]);
+  for (int i = 0; i < numOps; ++i)
+  {
+    Result result;
+    result.engine = engine;
+    result.shape1 = type1;
+    result.shape2 = type2;
+    result.operation = ops[i];
+    if (ops[i] == "Update")
+    {
+      Measure([&world]() { world->Update(1); },
+              warmup, repetitions, result.stats);
+    }
+    else if (ops[i] == "GetContactInfo")
+    {
+      Measure([&world, &m1, &m2]() { world->GetContactInfo(m1, m2); },
+              warmup, repetitions, result.stats);
+    }
+    else if (ops[i] == "SetBasicModelState")
+    {
+      Measure([&world, &m2, &state2]()
+              { world->SetBasicModelState(m2, state2); },
+              warmup, repetitions, result.stats);
+    }
+    else if (ops[i] == "GetAABB")
+    {
+      typename PhysicsWorldT::Vector3 min, max;
+      Measure([&world, &m1, &min, &max]() { world->GetAABB(m1, min, max); },
+              warmup, repetitions, result.stats);
+    }
+    else if (ops[i] == "GetWorldState")
+    {
+      Measure([&world]() { world->GetWorldState(); },
+              warmup, repetitions, result.stats);
+    }
+    else if (ops[i] == "SetWorldState")
+    {
+      Measure([&world, &worldState]() { world->SetWorldState(worldState); },
+              warmup, repetitions, result.stats);
+    }
+    results.push_back(result);
+  }
+
+  world->RemoveModel(m1);
+  world->RemoveModel(m2);
+  return true;
+}
+
+// Writes \e results as JSON to \e out.
+void WriteJSON(const std::vector<Result>& results, const int warmup,
+               std::ostream& out)
+{
+  out << "{" << std::endl
+      << "  \"unit\": \"us\"," << std::endl
+      << "  \"warmup\": " << warmup << "," << std::endl
+      << "  \"results\": [" << std::endl;
+  for (std::vector<Result>::const_iterator it = results.begin();
+       it != results.end(); ++it)
+  {
+    const TimingStatistics& s = it->stats;
+    out << "    {\"engine\": \"" << it->engine << "\", "
+        << "\"shape1\": \"" << it->shape1 << "\", "
+        << "\"shape2\": \"" << it->shape2 << "\", "
+        << "\"operation\": \"" << it->operation << "\", "
+        << "\"repetitions\": " << s.GetCount() << ", "
+        << "\"mean\": " << s.GetMean() << ", "
+        << "\"stddev\": " << s.GetStdDev() << ", "
+        << "\"min\": " << s.GetMin() << ", "
+        << "\"p50\": " << s.GetPercentile(50) << ", "
+        << "\"p90\": " << s.GetPercentile(90) << ", "
+        << "\"p99\": " << s.GetPercentile(99) << ", "
+        << "\"max\": " << s.GetMax() << "}"
+        << ((it + 1 == results.end()) ? "" : ",") << std::endl;
+  }
+  out << "  ]" << std::endl << "}" << std::endl;
+}
+
+// Writes \e results as CSV to \e out, with one header line.
+void WriteCSV(const std::vector<Result>& results, std::ostream& out)
+{
+  out << "engine,shape1,shape2,operation,repetitions,"
+      << "mean_us,stddev_us,min_us,p50_us,p90_us,p99_us,max_us" << std::endl;
+  for (std::vector<Result>::const_iterator it = results.begin();
+       it != results.end(); ++it)
+  {
+    const TimingStatistics& s = it->stats;
+    out << it->engine << "," << it->shape1 << "," << it->shape2 << ","
+        << it->operation << "," << s.GetCount() << ","
+        << s.GetMean() << "," << s.GetStdDev() << "," << s.GetMin() << ","
+        << s.GetPercentile(50) << "," << s.GetPercentile(90) << ","
+        << s.GetPercentile(99) << "," << s.GetMax() << std::endl;
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  std::vector<std::string> selectedEngines;
+  std::vector<std::string> shapePairs;
+  int warmup = 100;
+  int repetitions = 1000;
+  std::string format = "json";
+  std::string outputFile;
+  std::string traceFile;
+  std::string emptyWorld = "test_worlds/void.world";
+
+  std::stringstream descShapes;
+  descShapes << "Shape pairs to measure, each given as <shape1>:<shape2>. "
+             << "Shapes can be [box, sphere, cylinder, mesh]. When not "
+             << "specified, all pairs of these shapes are measured.";
+
+  po::options_description desc("Allowed options");
+  desc.add_options()
+    ("help,h", "Produce help message")
+    ("engines,e",
+      po::value<std::vector<std::string>>(&selectedEngines)->multitoken(),
+      "Physics engines to measure. When not specified, all supported \
+engines are measured.")
+    ("shapes,s",
+      po::value<std::vector<std::string>>(&shapePairs)->multitoken(),
+      descShapes.str().c_str())
+    ("warmup,w", po::value<int>(&warmup),
+      "Number of calls before measuring each operation (default 100).")
+    ("repetitions,r", po::value<int>(&repetitions),
+      "Number of measured calls of each operation (default 1000).")
+    ("format,f", po::value<std::string>(&format),
+      "Output format, json or csv (default json).")
+    ("output,o", po::value<std::string>(&outputFile),
+      "File to write the results to. When not specified, \
+results are written to stdout.")
+    ("trace,t", po::value<std::string>(&traceFile),
+      "File to write a Chrome trace of all measurements to. Only available \
+if compiled with profiling (cmake -DPROFILING=ON).")
+    ("world,W", po::value<std::string>(&emptyWorld),
+      "Empty world which is loaded for each engine, searched for in the \
+GAZEBO_RESOURCE_PATH (default test_worlds/void.world).")
+    ("baseline,b", "Also measure a SimplePhysicsWorld, which uses no physics \
+engine, as baseline for the overhead of the interface. It only supports \
+primitives, so pairs with meshes are skipped.")
+#ifdef COLLISION_BENCHMARK_BULLET
+    ("bullet-direct,d", "Also measure a BulletPhysicsWorld, which uses the \
+collision world of Bullet without Gazebo. It is added to the same world \
+manager as the Gazebo worlds.")
+#endif
+    ;
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  if (vm.count("help"))
+  {
+    std::cout << argv[0] << " [options]" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  }
+
+  if ((format != "json") && (format != "csv"))
+  {
+    std::cerr << "Unknown output format " << format << std::endl;
+    return 1;
+  }
+
+  if ((warmup < 0) || (repetitions <= 0))
+  {
+    std::cerr << "Warm-up must be positive and repetitions "
+              << "larger than 0" << std::endl;
+    return 1;
+  }
+
+  if (selectedEngines.empty())
+  {
+    std::set<std::string> engines =
+      collision_benchmark::GetSupportedPhysicsEngines();
+    selectedEngines.assign(engines.begin(), engines.end());
+  }
+
+  std::vector<std::pair<std::string, std::string> > pairs;
+  if (shapePairs.empty())
+  {
+    const std::string types[] = {"box", "sphere", "cylinder", "mesh"};
+    const int numTypes = sizeof(types) / sizeof(types[0]);
+    for (int i = 0; i < numTypes; ++i)
+      for (int j = i; j < numTypes; ++j)
+        pairs.push_back(std::make_pair(types[i], types[j]));
+  }
+  for (std::vector<std::string>::iterator it = shapePairs.begin();
+       it != shapePairs.end(); ++it)
+  {
+    size_t sep = it->find(':');
+    std::string type1 = it->substr(0, sep);
+    std::string type2 = (sep == std::string::npos) ? type1 :
+                        it->substr(sep + 1);
+    if (!MakeShape(type1) || !MakeShape(type2))
+    {
+      std::cerr << "Unknown shape pair " << *it << std::endl;
+      return 1;
+    }
+    pairs.push_back(std::make_pair(type1, type2));
+  }
+
+  // create the server with contact calculation enforced, so that
+  // GetContactInfo() measures the actual computation.
+  const bool enforceContactCalc = true;
+  GzMultipleWorldsServer::WorldLoader_M loaders;
+  for (std::vector<std::string>::const_iterator
+       it = selectedEngines.begin(); it != selectedEngines.end(); ++it)
+  {
+    try
+    {
+      loaders[*it] =
+        WorldLoader::ConstPtr(new GazeboWorldLoader(*it, enforceContactCalc));
+    }
+    catch (collision_benchmark::Exception& e)
+    {
+      std::cerr << "Could not add support for engine "
+                << *it << ": " << e.what() << std::endl;
+    }
+  }
+  if (loaders.empty())
+  {
+    std::cerr << "Could not get support for any engine." << std::endl;
+    return 1;
+  }
+
+  WorldLoader::Ptr universalLoader(new GazeboWorldLoader(enforceContactCalc));
+  GzMultipleWorldsServer::Ptr server(
+    new GazeboMultipleWorldsServer(loaders, universalLoader));
+  int serverArgc = 1;
+  const char * serverArgv = "collision_benchmark_perf";
+  server->Start(serverArgc, &serverArgv);
+  // no mirror world, as it would add its own overhead to each update
+  server->Init("", false);
+
+  GzWorldManager::Ptr worldManager = server->GetWorldManager();
+  if (!worldManager) return 1;
+
+  std::string emptyWorldFile;
+  try
+  {
+    emptyWorldFile = gazebo::common::find_file(emptyWorld);
+  }
+  catch (gazebo::common::Exception& e)
+  {
+    std::cerr << e.GetErrorStr() << std::endl;
+  }
+  if (emptyWorldFile.empty())
+  {
+    std::cerr << "Could not find world " << emptyWorld << ", add the "
+              << "share directory of the installation to the "
+              << "GAZEBO_RESOURCE_PATH" << std::endl;
+    server->Stop();
+    return 1;
+  }
+
+  // load one empty world per engine, in the order of the engines
+  std::vector<std::string> engines;
+  for (GzMultipleWorldsServer::WorldLoader_M::const_iterator
+       it = loaders.begin(); it != loaders.end(); ++it)
+  {
+    const std::string worldname = "perf_" + it->first;
+    if (server->Load(emptyWorldFile, it->first, worldname) < 0)
+    {
+      std::cerr << "Could not load world for engine "
+                << it->first << std::endl;
+      continue;
+    }
+    engines.push_back(it->first);
+  }
+
+#ifdef COLLISION_BENCHMARK_BULLET
+  if (vm.count("bullet-direct"))
+  {
+    GzPhysicsWorldPtr bullet(
+      new collision_benchmark::BulletPhysicsWorld("perf_bullet_direct"));
+    if (worldManager->AddPhysicsWorld(bullet) >= 0)
+      engines.push_back("bullet_direct");
+  }
+#endif
+
+  // models must not move, so that all repetitions measure the same state
+  worldManager->SetDynamicsEnabled(false);
+  worldManager->SetPaused(false);
+
+  std::vector<GzPhysicsWorldPtr> worlds = worldManager->GetPhysicsWorlds();
+  if (worlds.size() != engines.size())
+  {
+    std::cerr << "Inconsistent number of worlds loaded" << std::endl;
+    return 1;
+  }
+
+#ifdef COLLISION_BENCHMARK_PROFILING
+  if (!traceFile.empty()) collision_benchmark::Profiler::StartTrace();
+#else
+  if (!traceFile.empty())
+    std::cerr << "Not compiled with profiling, no trace is written"
+              << std::endl;
+#endif
+
+  std::vector<Result> results;
+  for (size_t w = 0; w < worlds.size(); ++w)
+  {
+    for (std::vector<std::pair<std::string, std::string> >::iterator
+         it = pairs.begin(); it != pairs.end(); ++it)
+    {
+      std::cerr << "Measuring " << engines[w] << ": " << it->first
+                << " / " << it->second << std::endl;
+      MeasurePair(worlds[w], engines[w], it->first, it->second,
+                  warmup, repetitions, results);
+    }
+  }
+
+  if (vm.count("baseline"))
+  {
+    SimplePhysicsWorld::Ptr simple(new SimplePhysicsWorld("perf_simple"));
+    simple->SetDynamicsEnabled(false);
+    for (std::vector<std::pair<std::string, std::string> >::iterator
+         it = pairs.begin(); it != pairs.end(); ++it)
+    {
+      if ((it->first == "mesh") || (it->second == "mesh")) continue;
+      std::cerr << "Measuring baseline: " << it->first
+                << " / " << it->second << std::endl;
+      MeasurePair(simple, "simple", it->first, it->second,
+                  warmup, repetitions, results);
+    }
+  }
+
+  server->Stop();
+
+#ifdef COLLISION_BENCHMARK_PROFILING
+  // time spent in the instrumented sections during all measurements
+  collision_benchmark::Profiler::Dump(std::cerr);
+  if (!traceFile.empty())
+  {
+    collision_benchmark::Profiler::StopTrace();
+    collision_benchmark::Profiler::WriteTrace(traceFile);
+  }
+#endif
+
+  std::ofstream file;
+  if (!outputFile.empty())
+  {
+    file.open(outputFile.c_str());
+    if (!file.is_open())
+    {
+      std::cerr << "Could not open " << outputFile << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& out = outputFile.empty() ? std::cout : file;
+  if (format == "json") WriteJSON(results, warmup, out);
+  else WriteCSV(results, out);
+  return 0;
+}
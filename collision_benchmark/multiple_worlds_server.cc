@@ -27,7 +27,9 @@
 #include <collision_benchmark/GazeboControlServer.hh>
 
 #include <collision_benchmark/GazeboMultipleWorldsServer.hh>
+#include <collision_benchmark/RemoteWorldLoader.hh>
 #include <collision_benchmark/WorldLoader.hh>
+#include <collision_benchmark/Metrics.hh>
 
 #include <gazebo/gazebo.hh>
 #include <gazebo/physics/physics.hh>
@@ -35,6 +37,10 @@
 
 #include <boost/program_options.hpp>
 #include <atomic>
+#include <chrono>
+#include <map>
+#include <climits>
+#include <unistd.h>
 
 using collision_benchmark::PhysicsWorldBaseInterface;
 using collision_benchmark::PhysicsWorldStateInterface;
@@ -48,8 +54,10 @@ using collision_benchmark::GazeboControlServer;
 
 using collision_benchmark::WorldLoader;
 using collision_benchmark::GazeboWorldLoader;
+using collision_benchmark::RemoteWorldLoader;
 using collision_benchmark::MultipleWorldsServer;
 using collision_benchmark::GazeboMultipleWorldsServer;
+using collision_benchmark::Metrics;
 
 namespace po = boost::program_options;
 
@@ -75,6 +83,27 @@ std::atomic<bool> g_keypressed(false);
 // the server
 GzMultipleWorldsServer::Ptr g_server;
 
+// file to export the metrics to, empty if no metrics are exported
+std::string g_metricsFile;
+// interval in seconds for exporting the metrics
+double g_metricsInterval = 10;
+
+// Metrics of one world. The rates are computed over one export interval.
+struct WorldMetrics
+{
+  // iterations and simulation time at the last export
+  uint64_t lastIterations;
+  double lastSimTime;
+  // sum of the number of contacts over all loop iterations since the last
+  // export, and the number of loop iterations
+  uint64_t contactsSum, numSamples;
+
+  Metrics::Counter steps;
+  Metrics::Gauge stepsPerSec;
+  Metrics::Gauge realTimeFactor;
+  Metrics::Gauge contactsPerStep;
+};
+
 // waits until enter has been pressed and sets g_keypressed to true
 void WaitForEnter()
 {
@@ -102,6 +131,87 @@ void pauseCallback(bool pause)
   g_unpaused = !pause;
 }
 
+// Updates the metrics of all worlds, and exports them to g_metricsFile
+// if g_metricsInterval has passed since the last export.
+void UpdateMetrics(const GzWorldManager::Ptr& worldManager)
+{
+  typedef std::chrono::steady_clock Clock;
+  static std::map<std::string, WorldMetrics> metrics;
+  static Clock::time_point lastExport = Clock::now();
+  static Metrics::Counter updates =
+    Metrics::GetCounter("collision_benchmark_server_updates_total",
+                        "Number of updates of all worlds");
+  if (g_metricsFile.empty()) return;
+
+  updates.Increment();
+
+  const Clock::time_point now = Clock::now();
+  const double elapsed =
+    std::chrono::duration<double>(now - lastExport).count();
+  const bool doExport = (elapsed >= g_metricsInterval);
+
+  std::vector<GzWorldManager::PhysicsWorldPtr> worlds =
+    worldManager->GetPhysicsWorlds();
+  for (std::vector<GzWorldManager::PhysicsWorldPtr>::iterator
+       it = worlds.begin(); it != worlds.end(); ++it)
+  {
+    collision_benchmark::GazeboPhysicsWorldPtr gzPhysicsWorld =
+      std::dynamic_pointer_cast<GazeboPhysicsWorld>(*it);
+    if (!gzPhysicsWorld) continue;
+    GazeboPhysicsWorld::WorldPtr gzWorld = gzPhysicsWorld->GetWorld();
+    if (!gzWorld || !gzWorld->Physics()) continue;
+
+    const std::string name = gzWorld->Name();
+    std::map<std::string, WorldMetrics>::iterator mIt = metrics.find(name);
+    if (mIt == metrics.end())
+    {
+      Metrics::Labels labels;
+      labels["world"] = name;
+      labels["engine"] = gzWorld->Physics()->GetType();
+      WorldMetrics& m = metrics[name];
+      m.lastIterations = gzWorld->Iterations();
+      m.lastSimTime = gzWorld->SimTime().Double();
+      m.contactsSum = 0;
+      m.numSamples = 0;
+      m.steps = Metrics::GetCounter("collision_benchmark_world_steps_total",
+                                    "Number of steps of the world", labels);
+      m.stepsPerSec = Metrics::GetGauge
+        ("collision_benchmark_world_steps_per_second",
+         "Steps of the world per second of wall time", labels);
+      m.realTimeFactor = Metrics::GetGauge
+        ("collision_benchmark_world_real_time_factor",
+         "Simulation time divided by wall time", labels);
+      m.contactsPerStep = Metrics::GetGauge
+        ("collision_benchmark_world_contacts_per_step",
+         "Mean number of contacts of the world after a step", labels);
+      mIt = metrics.find(name);
+    }
+    WorldMetrics& m = mIt->second;
+    m.contactsSum +=
+      gzWorld->Physics()->GetContactManager()->GetContactCount();
+    ++m.numSamples;
+
+    if (!doExport) continue;
+    const uint64_t iterations = gzWorld->Iterations();
+    const double simTime = gzWorld->SimTime().Double();
+    const uint64_t steps = iterations - m.lastIterations;
+    m.steps.Increment(steps);
+    m.stepsPerSec.Set(steps / elapsed);
+    m.realTimeFactor.Set((simTime - m.lastSimTime) / elapsed);
+    m.contactsPerStep.Set(m.contactsSum / (double) m.numSamples);
+    m.lastIterations = iterations;
+    m.lastSimTime = simTime;
+    m.contactsSum = 0;
+    m.numSamples = 0;
+  }
+
+  if (doExport)
+  {
+    Metrics::WriteFile(g_metricsFile);
+    lastExport = now;
+  }
+}
+
 // will be called at each loop iteration
 void LoopIter(int iter)
 {
@@ -131,13 +241,29 @@ void LoopIter(int iter)
   --print;*/
 }
 
+// Returns the path of the physics_world_worker executable, which is
+// installed next to this one
+std::string GetWorkerExecutable()
+{
+  char path[PATH_MAX];
+  const ssize_t len = readlink("/proc/self/exe", path, sizeof(path) - 1);
+  if (len <= 0) return "physics_world_worker";
+  path[len] = '\0';
+  std::string dir(path);
+  return dir.substr(0, dir.rfind('/') + 1) + "physics_world_worker";
+}
+
 // Initializes the multiple worlds server
+// \param useProcesses if true, each world is run in its own worker
+//    process (see RemotePhysicsWorld).
 bool Init(const bool loadMirror,
           const bool allowControlViaMirror,
-          const bool enforceContactCalc)
+          const bool enforceContactCalc,
+          const bool useProcesses)
 {
   std::set<std::string> engines =
     collision_benchmark::GetSupportedPhysicsEngines();
+  const std::string workerExecutable = GetWorkerExecutable();
   GzMultipleWorldsServer::WorldLoader_M loaders;
   for (std::set<std::string>::const_iterator
        it = engines.begin(); it != engines.end(); ++it)
@@ -145,9 +271,15 @@ bool Init(const bool loadMirror,
     std::string engine = *it;
     try
     {
-      loaders[engine] =
-        WorldLoader::ConstPtr(new GazeboWorldLoader(engine,
-                                                    enforceContactCalc));
+      if (useProcesses)
+        loaders[engine] =
+          WorldLoader::ConstPtr(new RemoteWorldLoader(engine,
+                                                      enforceContactCalc,
+                                                      workerExecutable));
+      else
+        loaders[engine] =
+          WorldLoader::ConstPtr(new GazeboWorldLoader(engine,
+                                                      enforceContactCalc));
     }
     catch (collision_benchmark::Exception& e)
     {
@@ -163,7 +295,12 @@ bool Init(const bool loadMirror,
     return false;
   }
 
-  WorldLoader::Ptr universalLoader(new GazeboWorldLoader(enforceContactCalc));
+  WorldLoader::Ptr universalLoader;
+  if (useProcesses)
+    universalLoader.reset(new RemoteWorldLoader("", enforceContactCalc,
+                                                workerExecutable));
+  else
+    universalLoader.reset(new GazeboWorldLoader(enforceContactCalc));
 
   g_server.reset(new GazeboMultipleWorldsServer(loaders, universalLoader));
 
@@ -215,6 +352,7 @@ bool Run()
   {
     int numSteps=1;
     worldManager->Update(numSteps);
+    UpdateMetrics(worldManager);
     LoopIter(iter);
     ++iter;
   }
@@ -228,6 +366,7 @@ int main(int argc, char **argv)
 {
   std::vector<std::string> selectedEngines;
   std::vector<std::string> worldFiles;
+  unsigned int loadThreads = 0;
 
   // description for engine options as stream so line doesn't go over 80 chars.
   std::stringstream descEngines;
@@ -245,6 +384,21 @@ int main(int argc, char **argv)
       descEngines.str().c_str())
     ("keep-name,k", "keep the names of the worlds as specified in the files. \
 Only works when no engines are specified with -e.")
+    ("metrics,m", po::value<std::string>(&g_metricsFile),
+      "Periodically write metrics of the worlds (steps per second, \
+real time factor, contacts per step, forwarded messages) to this file in the \
+Prometheus text format, e.g. for the textfile collector of the node exporter.")
+    ("metrics-interval", po::value<double>(&g_metricsInterval),
+      "Interval in seconds for writing the metrics (default 10).")
+    ("load-threads", po::value<unsigned int>(&loadThreads),
+      "Maximum number of threads to load the worlds of the engines with. \
+Defaults to 1, which loads them one after another. With more threads, \
+the order of the world namespaces is not the order of the engines.")
+    ("processes,p", "Run each world in its own worker process, which \
+exchanges commands and results with this one through shared memory. \
+The worlds are then updated in parallel, and a crashing engine only stops \
+its own world. There is no mirror world to view with gzclient, and \
+the metrics of the worlds are not available.")
     ;
   po::options_description desc_hidden("Positional options");
   desc_hidden.add_options()
@@ -296,11 +450,14 @@ Only works when no engines are specified with -e.")
   }
 
   // Initialize server
-  bool loadMirror = true;
+  const bool useProcesses = vm.count("processes");
+  // the worlds of the worker processes can't be mirrored
+  bool loadMirror = !useProcesses;
   bool enforceContactCalc=false;
   bool allowControlViaMirror = true;
-  Init(loadMirror, allowControlViaMirror, enforceContactCalc);
+  Init(loadMirror, allowControlViaMirror, enforceContactCalc, useProcesses);
   assert(g_server);
+  if (loadThreads > 0) g_server->SetMaxLoadThreads(loadThreads);
 
   // load the worlds as given in command line arguments
   // with the engine names given
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2012-2016 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+/*
+ * Worker process which serves one physics world to a RemotePhysicsWorld.
+ * Started by RemotePhysicsWorld, with the arguments
+ *   <channel> <engine> <enforce contacts computation (0 or 1)>
+ * where the engine may be empty to use the engine specified in the world.
+ */
+
+#include <collision_benchmark/GazeboWorldLoader.hh>
+#include <collision_benchmark/PhysicsWorldWorker.hh>
+
+#include <gazebo/gazebo.hh>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using collision_benchmark::GazeboWorldLoader;
+using collision_benchmark::PhysicsWorldWorker;
+using collision_benchmark::WorldLoader;
+
+// Returns a TCP port which is currently free, or 0 if none could be found
+int GetFreePort()
+{
+  const int sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock < 0) return 0;
+  sockaddr_in addr;
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  socklen_t len = sizeof(addr);
+  int port = 0;
+  if ((bind(sock, (sockaddr*)&addr, sizeof(addr)) == 0) &&
+      (getsockname(sock, (sockaddr*)&addr, &len) == 0))
+    port = ntohs(addr.sin_port);
+  close(sock);
+  return port;
+}
+
+// Sets up the gazebo server with its master on a free port. The port is
+// only probed by GetFreePort(), so another process can take it before the
+// master binds it. In this case, the setup is tried again with another port.
+// \return false if the server could not be set up after several attempts
+bool SetupServer(const char * argv0)
+{
+  static const int maxAttempts = 10;
+  for (int i = 0; i < maxAttempts; ++i)
+  {
+    const int port = GetFreePort();
+    if (port == 0)
+    {
+      std::cerr << "Could not find a port for the gazebo master" << std::endl;
+      return false;
+    }
+    std::stringstream masterUri;
+    masterUri << "http://localhost:" << port;
+    setenv("GAZEBO_MASTER_URI", masterUri.str().c_str(), 1);
+
+    int serverArgc = 1;
+    const char * serverArgv = argv0;
+    try
+    {
+      if (gazebo::setupServer(serverArgc, (char**)&serverArgv)) return true;
+    }
+    catch (...)
+    {
+      // the master could not bind the port
+    }
+    std::cerr << "Could not setup server with master port " << port
+              << ", retrying." << std::endl;
+    gazebo::shutdown();
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  if (argc != 4)
+  {
+    std::cerr << "Usage: " << argv[0] << " <channel> <engine> "
+              << "<enforce contacts computation>" << std::endl;
+    std::cerr << "This program is started by RemotePhysicsWorld."
+              << std::endl;
+    return 1;
+  }
+  const std::string channel = argv[1];
+  const std::string engine = argv[2];
+  const bool enforceContactCalc = (std::string(argv[3]) == "1");
+
+  // Each worker runs its own gazebo server, which needs its own master
+  // so that it does not conflict with the server of the controlling process.
+  if (!SetupServer(argv[0]))
+  {
+    std::cerr << "Could not setup server" << std::endl;
+    return 1;
+  }
+
+  WorldLoader::ConstPtr loader;
+  try
+  {
+    if (engine.empty())
+      loader.reset(new GazeboWorldLoader(enforceContactCalc));
+    else
+      loader.reset(new GazeboWorldLoader(engine, enforceContactCalc));
+  }
+  catch (collision_benchmark::Exception& e)
+  {
+    std::cerr << "Could not add support for engine "
+              << engine << ": " << e.what() << std::endl;
+    gazebo::shutdown();
+    return 1;
+  }
+
+  PhysicsWorldWorker worker(channel, loader);
+  const bool success = worker.Run();
+  gazebo::shutdown();
+  return success ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+#include <collision_benchmark/BulletPhysicsWorld.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+#include <collision_benchmark/MultiCollisionShape.hh>
+#include <collision_benchmark/SimpleTriMeshShape.hh>
+#include <collision_benchmark/MeshShapeGeneratorNative.hh>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using collision_benchmark::BulletPhysicsWorld;
+using collision_benchmark::PrimitiveShape;
+using collision_benchmark::SimpleTriMeshShape;
+using collision_benchmark::MultiCollisionShape;
+using collision_benchmark::Shape;
+using collision_benchmark::BasicState;
+
+typedef collision_benchmark::MeshShapeGeneratorNative<float> Generator;
+typedef Shape::Pose3 Pose3;
+typedef BulletPhysicsWorld::Vector3 Vector3;
+typedef BulletPhysicsWorld::ContactInfoPtr ContactInfoPtr;
+
+// bullet computes contacts with a collision margin
+static const double tol = 1e-03;
+
+//////////////////////////////////////////////////////////////////////////////
+// Creates a world with two spheres of radius 1, "a" at the origin and
+// "b" at \e posB
+BulletPhysicsWorld::Ptr MakeSpheres(const Vector3& posB)
+{
+  BulletPhysicsWorld::Ptr world(new BulletPhysicsWorld());
+  Shape::Ptr a(PrimitiveShape::CreateSphere(1));
+  Shape::Ptr b(PrimitiveShape::CreateSphere(1));
+  b->SetPose(Pose3(posB, ignition::math::Quaterniond()));
+  EXPECT_EQ(world->AddModelFromShape("a", a).opResult,
+            collision_benchmark::SUCCESS);
+  EXPECT_EQ(world->AddModelFromShape("b", b).opResult,
+            collision_benchmark::SUCCESS);
+  return world;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(BulletPhysicsWorldTest, BulletObjects)
+{
+  BulletPhysicsWorld::Ptr world = MakeSpheres(Vector3(3, 0, 0));
+  EXPECT_TRUE(world->IsAdaptor());
+  ASSERT_TRUE(world->GetWorld() != NULL);
+  EXPECT_TRUE(world->GetPhysicsEngine() != NULL);
+  EXPECT_EQ(world->SetWorld(world->GetWorld()), collision_benchmark::ERROR);
+  EXPECT_EQ(world->GetWorld()->getNumCollisionObjects(), 2);
+
+  // the objects know the integer ID and name of their model
+  BulletPhysicsWorld::ModelPtr b = world->GetModel("b");
+  ASSERT_TRUE(b != NULL);
+  EXPECT_EQ(b->getUserIndex(), world->GetIntegerModelID("b"));
+  EXPECT_EQ(*static_cast<std::string*>(b->getUserPointer()), "b");
+  EXPECT_NEAR(b->getWorldTransform().getOrigin().x(), 3, 1e-09);
+
+  // changes of the pose are applied to the object
+  BasicState state;
+  state.SetPosition(0, 4, 0);
+  ASSERT_TRUE(world->SetBasicModelState("b", state));
+  EXPECT_NEAR(b->getWorldTransform().getOrigin().y(), 4, 1e-09);
+
+  ASSERT_TRUE(world->RemoveModel("a"));
+  EXPECT_EQ(world->GetWorld()->getNumCollisionObjects(), 1);
+  world->Clear();
+  EXPECT_EQ(world->GetWorld()->getNumCollisionObjects(), 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(BulletPhysicsWorldTest, ContactsAfterChanges)
+{
+  BulletPhysicsWorld::Ptr world = MakeSpheres(Vector3(1.5, 0, 0));
+
+  // the collision detection runs on the query without Update()
+  std::vector<ContactInfoPtr> contacts = world->GetContactInfo();
+  ASSERT_EQ(contacts.size(), 1u);
+  ASSERT_EQ(contacts[0]->contacts.size(), 1u);
+  EXPECT_NEAR(contacts[0]->contacts[0].depth, 0.5, tol);
+
+  // ... and again after models were moved
+  BasicState state;
+  state.SetPosition(1.8, 0, 0);
+  ASSERT_TRUE(world->SetBasicModelState("b", state));
+  contacts = world->GetContactInfo("b", "a");
+  ASSERT_EQ(contacts.size(), 1u);
+  EXPECT_NEAR(contacts[0]->contacts[0].depth, 0.2, tol);
+
+  // ... or added
+  Shape::Ptr c(PrimitiveShape::CreateBox(1, 1, 1));
+  c->SetPose(Pose3(0, 0, 1.4, 0, 0, 0));
+  ASSERT_EQ(world->AddModelFromShape("c", c).opResult,
+            collision_benchmark::SUCCESS);
+  EXPECT_EQ(world->GetContactInfo().size(), 2u);
+
+  world->SetPaused(true);
+  world->Update(1, true);
+  EXPECT_EQ(world->GetContactInfo().size(), 2u);
+  ASSERT_TRUE(world->RemoveModel("c"));
+  EXPECT_EQ(world->GetContactInfo().size(), 1u);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(BulletPhysicsWorldTest, NativeContacts)
+{
+  // the bounding boxes overlap, but the spheres don't
+  BulletPhysicsWorld::Ptr world = MakeSpheres(Vector3(1.6, 1.6, 0));
+
+  // bullet keeps a manifold for the pair, which has no points
+  std::vector<BulletPhysicsWorld::NativeContactPtr> manifolds =
+    world->GetNativeContacts("b", "a");
+  ASSERT_EQ(manifolds.size(), 1u);
+  EXPECT_EQ(manifolds[0]->getNumContacts(), 0);
+  EXPECT_EQ(world->GetContactInfo().size(), 0u);
+  EXPECT_EQ(world->GetContactAnomalies().numContacts, 0u);
+
+  BasicState state;
+  state.SetPosition(1, 1, 0);
+  ASSERT_TRUE(world->SetBasicModelState("b", state));
+  manifolds = world->GetNativeContacts();
+  ASSERT_EQ(manifolds.size(), 1u);
+  EXPECT_EQ(manifolds[0]->getNumContacts(), 1);
+  // the manifolds are copies
+  manifolds[0]->clearManifold();
+  EXPECT_EQ(world->GetContactInfo().size(), 1u);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(BulletPhysicsWorldTest, ScaledBounds)
+{
+  Generator gen;
+  BulletPhysicsWorld world;
+  Shape::Ptr mesh(new SimpleTriMeshShape(gen.MakeBox(2, 2, 2), "mesh"));
+  ASSERT_EQ(world.AddModelFromShape("mesh", mesh).opResult,
+            collision_benchmark::SUCCESS);
+  // compound of two boxes
+  Shape::Ptr part1(PrimitiveShape::CreateBox(1, 1, 1));
+  Shape::Ptr part2(PrimitiveShape::CreateBox(1, 1, 1));
+  part1->SetPose(Pose3(0, 0, 4, 0, 0, 0));
+  part2->SetPose(Pose3(0, 0, 6, 0, 0, 0));
+  std::vector<Shape::Ptr> parts;
+  parts.push_back(part1);
+  parts.push_back(part2);
+  Shape::Ptr compound(new MultiCollisionShape(part1, parts));
+  ASSERT_EQ(world.AddModelFromShape("compound", compound).opResult,
+            collision_benchmark::SUCCESS);
+
+  Vector3 min, max;
+  ASSERT_TRUE(world.GetAABB("mesh", min, max));
+  EXPECT_NEAR(max.Z(), 1, 0.1);
+  ASSERT_TRUE(world.GetAABB("compound", min, max));
+  EXPECT_NEAR(max.Z(), 6.5, 0.1);
+
+  // the cached bounds of meshes and compounds are updated with the scale
+  BasicState state;
+  state.SetScale(0.5, 0.5, 0.5);
+  ASSERT_TRUE(world.SetBasicModelState("mesh", state));
+  ASSERT_TRUE(world.SetBasicModelState("compound", state));
+  ASSERT_TRUE(world.GetAABB("mesh", min, max));
+  EXPECT_NEAR(max.Z(), 0.5, 0.1);
+  ASSERT_TRUE(world.GetAABB("compound", min, max));
+  EXPECT_NEAR(max.Z(), 3.25, 0.1);
+  EXPECT_NEAR(min.Z(), 1.75, 0.1);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(BulletPhysicsWorldTest, WorldState)
+{
+  BulletPhysicsWorld::Ptr world1 = MakeSpheres(Vector3(1.5, 0, 0));
+  BasicState state;
+  state.SetScale(2, 2, 2);
+  ASSERT_TRUE(world1->SetBasicModelState("a", state));
+  world1->Update(10);
+
+  // contacts are computed for the new state without Update()
+  BulletPhysicsWorld::Ptr world2 = MakeSpheres(Vector3(5, 0, 0));
+  EXPECT_EQ(world2->GetContactInfo().size(), 0u);
+  EXPECT_EQ(world2->SetWorldState(world1->GetWorldState()),
+            collision_benchmark::SUCCESS);
+  std::vector<ContactInfoPtr> contacts = world2->GetContactInfo();
+  ASSERT_EQ(contacts.size(), 1u);
+  // the scale of "a" was applied
+  EXPECT_NEAR(contacts[0]->contacts[0].depth, 1.5, tol);
+  EXPECT_EQ(world2->GetWorldState().GetIterations(), 10u);
+
+  // models can't be inserted from the state
+  ASSERT_TRUE(world2->RemoveModel("b"));
+  EXPECT_EQ(world2->SetWorldState(world1->GetWorldState()),
+            collision_benchmark::NOT_SUPPORTED);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
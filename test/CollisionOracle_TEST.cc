@@ -0,0 +1,246 @@
+#include <collision_benchmark/CollisionOracle.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+#include <collision_benchmark/SimpleTriMeshShape.hh>
+#include <collision_benchmark/MultiCollisionShape.hh>
+#include <collision_benchmark/MeshShapeGeneratorNative.hh>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using collision_benchmark::CollisionOracle;
+using collision_benchmark::Shape;
+using collision_benchmark::PrimitiveShape;
+using collision_benchmark::SimpleTriMeshShape;
+using collision_benchmark::MultiCollisionShape;
+
+typedef collision_benchmark::MeshShapeGeneratorNative<float> Generator;
+typedef CollisionOracle::Pose3 Pose3;
+
+//////////////////////////////////////////////////////////////////////////////
+// Returns a mesh shape with the cylinder along the z axis, like the
+// cylinder primitive
+Shape::Ptr MakeCylinderMesh(const double radius, const double length,
+                            const std::string& name)
+{
+  Generator gen;
+  Shape::Ptr mesh(new SimpleTriMeshShape(gen.MakeCylinder(radius, length,
+                                                          64, true), name));
+  // the generated cylinder is along the y axis
+  mesh->SetPose(Pose3(0, 0, 0, M_PI / 2, 0, 0));
+  std::vector<Shape::Ptr> parts(1, mesh);
+  return Shape::Ptr(new MultiCollisionShape(mesh, parts));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+Pose3 RandomPose(std::mt19937& rand, const double range)
+{
+  std::uniform_real_distribution<double> pos(-range, range);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  return Pose3(pos(rand), pos(rand), pos(rand),
+               angle(rand), angle(rand), angle(rand));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(CollisionOracleTest, Primitives)
+{
+  CollisionOracle oracle;
+  ASSERT_TRUE(oracle.AddShape("sphere", Shape::Ptr(
+    PrimitiveShape::CreateSphere(1))));
+  ASSERT_TRUE(oracle.AddShape("box", Shape::Ptr(
+    PrimitiveShape::CreateBox(2, 2, 2))));
+  ASSERT_TRUE(oracle.AddShape("cylinder", Shape::Ptr(
+    PrimitiveShape::CreateCylinder(1, 2))));
+  ASSERT_TRUE(oracle.AddShape("plane", Shape::Ptr(
+    PrimitiveShape::CreatePlane(0, 0, 1, 10, 10))));
+
+  double depth;
+  EXPECT_TRUE(oracle.Collide("sphere", Pose3(), "sphere",
+                             Pose3(1.5, 0, 0, 0, 0, 0), depth));
+  EXPECT_NEAR(depth, 0.5, 1e-09);
+  EXPECT_FALSE(oracle.Collide("sphere", Pose3(), "sphere",
+                              Pose3(0, 2.1, 0, 0, 0, 0), depth));
+  EXPECT_EQ(depth, 0);
+
+  EXPECT_TRUE(oracle.Collide("box", Pose3(), "sphere",
+                             Pose3(0, 0, 1.8, 0, 0, 0), depth));
+  EXPECT_NEAR(depth, 0.2, 1e-09);
+  EXPECT_FALSE(oracle.Collide("box", Pose3(), "sphere",
+                              Pose3(1.8, 1.8, 0, 0, 0, 0), depth));
+
+  // box rotated by 45 degrees about z reaches sqrt(2) along x
+  EXPECT_TRUE(oracle.Collide("box", Pose3(), "box",
+                             Pose3(2.3, 0, 0, 0, 0, M_PI / 4), depth));
+  EXPECT_NEAR(depth, 1 + sqrt(2) - 2.3, 1e-09);
+  EXPECT_FALSE(oracle.Collide("box", Pose3(), "box",
+                              Pose3(2.5, 0, 0, 0, 0, M_PI / 4), depth));
+
+  // cylinder lying on its side at height 0.9
+  EXPECT_TRUE(oracle.Collide("plane", Pose3(), "cylinder",
+                             Pose3(0, 0, 0.9, M_PI / 2, 0, 0), depth));
+  EXPECT_NEAR(depth, 0.1, 1e-09);
+  EXPECT_FALSE(oracle.Collide("cylinder", Pose3(0, 0, 1.1, 0, 0, 0),
+                              "plane", Pose3(), depth));
+
+  EXPECT_TRUE(oracle.Collide("cylinder", Pose3(), "cylinder",
+                             Pose3(1.9, 0, 0, 0, 0, 0), depth));
+  EXPECT_NEAR(depth, 0.1, 1e-04);
+  EXPECT_FALSE(oracle.Collide("cylinder", Pose3(), "cylinder",
+                              Pose3(2.1, 0, 1.5, 0, M_PI / 2, 0), depth));
+
+  EXPECT_THROW(oracle.Collide("plane", Pose3(), "plane", Pose3(), depth),
+               collision_benchmark::Exception);
+  EXPECT_THROW(oracle.Collide("none", Pose3(), "box", Pose3(), depth),
+               collision_benchmark::Exception);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Meshes of boxes have to give the same results as the box primitives
+TEST(CollisionOracleTest, BoxMeshes)
+{
+  Generator gen;
+  CollisionOracle oracle;
+  ASSERT_TRUE(oracle.AddShape("box1", Shape::Ptr(
+    PrimitiveShape::CreateBox(1, 2, 3))));
+  ASSERT_TRUE(oracle.AddShape("box2", Shape::Ptr(
+    PrimitiveShape::CreateBox(0.5, 1, 0.2))));
+  ASSERT_TRUE(oracle.AddShape("mesh1", Shape::Ptr(
+    new SimpleTriMeshShape(gen.MakeBox(1, 2, 3), "mesh1"))));
+  ASSERT_TRUE(oracle.AddShape("mesh2", Shape::Ptr(
+    new SimpleTriMeshShape(gen.MakeBox(0.5, 1, 0.2), "mesh2"))));
+
+  std::mt19937 rand(0);
+  int numColliding = 0;
+  for (int i = 0; i < 2000; ++i)
+  {
+    Pose3 pose1 = RandomPose(rand, 0.5);
+    Pose3 pose2 = RandomPose(rand, 2);
+    double depth, meshDepth;
+    bool collide = oracle.Collide("box1", pose1, "box2", pose2, depth);
+    if (collide) ++numColliding;
+    EXPECT_EQ(oracle.Collide("mesh1", pose1, "box2", pose2, meshDepth),
+              collide);
+    EXPECT_LE(meshDepth, depth + 1e-06);
+    EXPECT_EQ(oracle.Collide("box1", pose1, "mesh2", pose2, meshDepth),
+              collide);
+    EXPECT_LE(meshDepth, depth + 1e-06);
+    EXPECT_EQ(oracle.Collide("mesh1", pose1, "mesh2", pose2, meshDepth),
+              collide);
+    EXPECT_LE(meshDepth, depth + 1e-06);
+  }
+  EXPECT_GT(numColliding, 200);
+  EXPECT_LT(numColliding, 1800);
+
+  // a small box inside a big box mesh. The depth is estimated by how far
+  // the corners of the small box are inside.
+  double depth;
+  EXPECT_TRUE(oracle.Collide("mesh1", Pose3(), "box2",
+                             Pose3(0, 0, 0.5, 0, 0, 0), depth));
+  EXPECT_NEAR(depth, 0.25, 1e-06);
+  EXPECT_TRUE(oracle.Collide("mesh1", Pose3(), "mesh2",
+                             Pose3(0, 0, 0.5, 0, 0, 0), depth));
+  EXPECT_NEAR(depth, 0.25, 1e-06);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Meshes of cylinders are within the cylinder primitives, and they
+// collide if the primitives clearly penetrate
+TEST(CollisionOracleTest, CylinderMeshes)
+{
+  CollisionOracle oracle;
+  ASSERT_TRUE(oracle.AddShape("cylinder", Shape::Ptr(
+    PrimitiveShape::CreateCylinder(0.5, 2))));
+  ASSERT_TRUE(oracle.AddShape("box", Shape::Ptr(
+    PrimitiveShape::CreateBox(1, 0.5, 0.5))));
+  ASSERT_TRUE(oracle.AddShape("mesh",
+                              MakeCylinderMesh(0.5, 2, "cylinder_mesh")));
+
+  std::mt19937 rand(0);
+  const double tol = 0.01;
+  for (int i = 0; i < 1000; ++i)
+  {
+    Pose3 pose1 = RandomPose(rand, 0.5);
+    Pose3 pose2 = RandomPose(rand, 1.5);
+    double depth, meshDepth;
+    bool collide = oracle.Collide("cylinder", pose1, "box", pose2, depth);
+    bool meshCollide = oracle.Collide("mesh", pose1, "box", pose2, meshDepth);
+    if (meshCollide)
+    {
+      EXPECT_TRUE(collide);
+    }
+    if (collide && depth > tol)
+    {
+      EXPECT_TRUE(meshCollide);
+    }
+
+    collide = oracle.Collide("cylinder", pose1, "cylinder", pose2, depth);
+    meshCollide = oracle.Collide("mesh", pose1, "mesh", pose2, meshDepth);
+    if (meshCollide)
+    {
+      EXPECT_TRUE(collide);
+    }
+    if (collide && depth > tol)
+    {
+      EXPECT_TRUE(meshCollide);
+    }
+    EXPECT_LE(meshDepth, depth + tol);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// The parts of a convex decomposition are used as collision geometries
+TEST(CollisionOracleTest, CollisionParts)
+{
+  // L-shaped prism of height 1
+  const double poly[6][2] = {{1, 1}, {1, 3}, {0, 3}, {0, 0}, {3, 0}, {3, 1}};
+  const std::size_t n = 6;
+  SimpleTriMeshShape::MeshDataPtr lShape(new SimpleTriMeshShape::MeshDataT());
+  std::vector<SimpleTriMeshShape::Vertex>& verts = lShape->GetVertices();
+  std::vector<SimpleTriMeshShape::Face>& faces = lShape->GetFaces();
+  for (std::size_t i = 0; i < n; ++i)
+    verts.push_back(SimpleTriMeshShape::Vertex(poly[i][0], poly[i][1], 0));
+  for (std::size_t i = 0; i < n; ++i)
+    verts.push_back(SimpleTriMeshShape::Vertex(poly[i][0], poly[i][1], 1));
+  for (std::size_t i = 1; i + 1 < n; ++i)
+  {
+    faces.push_back(SimpleTriMeshShape::Face(0, i + 1, i));
+    faces.push_back(SimpleTriMeshShape::Face(n, n + i, n + i + 1));
+  }
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    std::size_t j = (i + 1) % n;
+    faces.push_back(SimpleTriMeshShape::Face(i, j, n + j));
+    faces.push_back(SimpleTriMeshShape::Face(i, n + j, n + i));
+  }
+
+  CollisionOracle oracle;
+  ASSERT_TRUE(oracle.AddShape("mesh", Shape::Ptr(
+    new SimpleTriMeshShape(lShape, "l_shape"))));
+  ASSERT_TRUE(oracle.AddShape("hull", Shape::Ptr(
+    MultiCollisionShape::CreateConvexHull(lShape, "l_shape"))));
+  ASSERT_TRUE(oracle.AddShape("parts", Shape::Ptr(
+    MultiCollisionShape::CreateConvexDecomposition(lShape, "l_shape", 0.05))));
+  ASSERT_TRUE(oracle.AddShape("sphere", Shape::Ptr(
+    PrimitiveShape::CreateSphere(0.3))));
+
+  // sphere in the notch of the L
+  Pose3 inNotch(1.8, 1.8, 0.5, 0, 0, 0);
+  double depth;
+  EXPECT_FALSE(oracle.Collide("mesh", Pose3(), "sphere", inNotch, depth));
+  EXPECT_TRUE(oracle.Collide("hull", Pose3(), "sphere", inNotch, depth));
+  EXPECT_FALSE(oracle.Collide("parts", Pose3(), "sphere", inNotch, depth));
+
+  Pose3 inLeg(0.5, 2, 0.5, 0, 0, 0);
+  EXPECT_TRUE(oracle.Collide("mesh", Pose3(), "sphere", inLeg, depth));
+  EXPECT_NEAR(depth, 0.8, 1e-06);
+  EXPECT_TRUE(oracle.Collide("parts", Pose3(), "sphere", inLeg, depth));
+  EXPECT_NEAR(depth, 0.8, 1e-06);
+}
+
+int main(int argc, char**argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,89 @@
+#include <collision_benchmark/ContactInfo.hh>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+typedef collision_benchmark::ContactAnomalies<std::string> ContactAnomalies;
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(ContactAnomaliesTest, Merge)
+{
+  ContactAnomalies a(2), b(2);
+  a.numContacts = 10;
+  a.numPoints = 40;
+  a.Add(ContactAnomalies::EMPTY_CONTACT, "a", "b");
+  a.Add(ContactAnomalies::NEGATIVE_DEPTH, "a", "c", -0.5);
+
+  b.numContacts = 5;
+  b.numPoints = 20;
+  b.Add(ContactAnomalies::EMPTY_CONTACT, "c", "d");
+  b.Add(ContactAnomalies::EMPTY_CONTACT, "e", "f");
+  b.Add(ContactAnomalies::ALL_POINTS_SKIPPED, "g", "h");
+
+  a.Merge(b);
+  EXPECT_EQ(a.numContacts, 15u);
+  EXPECT_EQ(a.numPoints, 60u);
+  EXPECT_EQ(a.GetCount(ContactAnomalies::EMPTY_CONTACT), 3u);
+  EXPECT_EQ(a.GetCount(ContactAnomalies::NEGATIVE_DEPTH), 1u);
+  EXPECT_EQ(a.GetCount(ContactAnomalies::ALL_POINTS_SKIPPED), 1u);
+  EXPECT_DOUBLE_EQ(a.GetRate(ContactAnomalies::EMPTY_CONTACT), 0.2);
+  EXPECT_DOUBLE_EQ(a.GetRate(ContactAnomalies::NEGATIVE_DEPTH), 1 / 60.0);
+
+  // at most two examples are kept per type
+  int numEmpty = 0;
+  for (const ContactAnomalies::Example& e : a.examples)
+  {
+    if (e.type == ContactAnomalies::EMPTY_CONTACT) ++numEmpty;
+  }
+  EXPECT_EQ(numEmpty, 2);
+  ASSERT_EQ(a.examples.size(), 4u);
+  EXPECT_EQ(a.examples[0].model1, "a");
+  EXPECT_DOUBLE_EQ(a.examples[1].depth, -0.5);
+  EXPECT_EQ(a.examples[2].model1, "c");
+  EXPECT_EQ(a.examples[3].model2, "h");
+
+  // merging into an empty instance gives the same counts
+  ContactAnomalies c(2);
+  c.Merge(a);
+  EXPECT_EQ(c.numContacts, 15u);
+  EXPECT_EQ(c.GetCount(ContactAnomalies::EMPTY_CONTACT), 3u);
+  EXPECT_EQ(c.examples.size(), 4u);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(ContactAnomaliesTest, RateWithoutContacts)
+{
+  ContactAnomalies a;
+  for (int i = 0; i < ContactAnomalies::NUM_TYPES; ++i)
+  {
+    EXPECT_EQ(a.GetRate(static_cast<ContactAnomalies::Type>(i)), 0);
+  }
+
+  // anomalies counted without any contacts or points looked at
+  a.Add(ContactAnomalies::EMPTY_CONTACT, "a", "b");
+  a.Add(ContactAnomalies::NEGATIVE_DEPTH, "a", "b", -1);
+  EXPECT_EQ(a.GetRate(ContactAnomalies::EMPTY_CONTACT), 0);
+  EXPECT_EQ(a.GetRate(ContactAnomalies::NEGATIVE_DEPTH), 0);
+
+  // the rate of negative depths is relative to the points only
+  a.numContacts = 4;
+  EXPECT_DOUBLE_EQ(a.GetRate(ContactAnomalies::EMPTY_CONTACT), 0.25);
+  EXPECT_EQ(a.GetRate(ContactAnomalies::NEGATIVE_DEPTH), 0);
+
+  // counts without examples
+  a.AddCount(ContactAnomalies::EMPTY_CONTACT, 1000000);
+  EXPECT_EQ(a.GetCount(ContactAnomalies::EMPTY_CONTACT), 1000001u);
+  EXPECT_EQ(a.examples.size(), 2u);
+
+  a.Clear();
+  EXPECT_EQ(a.numContacts, 0u);
+  EXPECT_EQ(a.GetCount(ContactAnomalies::EMPTY_CONTACT), 0u);
+  EXPECT_TRUE(a.examples.empty());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
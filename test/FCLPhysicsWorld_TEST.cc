@@ -0,0 +1,168 @@
+#include <collision_benchmark/FCLPhysicsWorld.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+#include <collision_benchmark/MultiCollisionShape.hh>
+#include <collision_benchmark/SimpleTriMeshShape.hh>
+#include <collision_benchmark/MeshShapeGeneratorNative.hh>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using collision_benchmark::FCLPhysicsWorld;
+using collision_benchmark::PrimitiveShape;
+using collision_benchmark::MultiCollisionShape;
+using collision_benchmark::SimpleTriMeshShape;
+using collision_benchmark::Shape;
+using collision_benchmark::BasicState;
+
+typedef collision_benchmark::MeshShapeGeneratorNative<float> Generator;
+typedef Shape::Pose3 Pose3;
+typedef FCLPhysicsWorld::Vector3 Vector3;
+typedef FCLPhysicsWorld::ContactInfoPtr ContactInfoPtr;
+
+// contacts of some shape pairs are computed with GJK/EPA
+static const double tol = 1e-03;
+
+//////////////////////////////////////////////////////////////////////////////
+// Returns a sphere of radius \e radius at \e pos
+Shape::Ptr Sphere(const double radius, const Vector3& pos)
+{
+  Shape::Ptr sphere(PrimitiveShape::CreateSphere(radius));
+  sphere->SetPose(Pose3(pos, ignition::math::Quaterniond()));
+  return sphere;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(FCLPhysicsWorldTest, MeshContacts)
+{
+  // meshes are BVH models, which give one contact point for each pair of
+  // intersecting triangles, up to the limit of Gazebo
+  Generator gen;
+  FCLPhysicsWorld world;
+  Shape::Ptr mesh1(new SimpleTriMeshShape(gen.MakeBox(2, 2, 2), "mesh1"));
+  Shape::Ptr mesh2(new SimpleTriMeshShape(gen.MakeBox(2, 2, 2), "mesh2"));
+  mesh2->SetPose(Pose3(0.5, 0.5, 1.5, 0, 0, 0));
+  ASSERT_EQ(world.AddModelFromShape("mesh1", mesh1).opResult,
+            collision_benchmark::SUCCESS);
+  ASSERT_EQ(world.AddModelFromShape("mesh2", mesh2).opResult,
+            collision_benchmark::SUCCESS);
+
+  std::vector<ContactInfoPtr> contacts = world.GetContactInfo();
+  ASSERT_EQ(contacts.size(), 1u);
+  EXPECT_GT(contacts[0]->contacts.size(), 1u);
+  EXPECT_LE(contacts[0]->contacts.size(), 20u);
+  EXPECT_EQ(world.GetContactAnomalies().numContacts, 1u);
+
+  // a model does not collide with itself
+  EXPECT_EQ(world.GetContactInfo("mesh1", "mesh1").size(), 0u);
+  EXPECT_EQ(world.GetContactInfo("mesh1", "unknown").size(), 0u);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(FCLPhysicsWorldTest, ScaledParts)
+{
+  FCLPhysicsWorld world;
+  // two spheres of radius 0.5 at x = -2 and x = 2
+  std::vector<Shape::Ptr> parts;
+  parts.push_back(Sphere(0.5, Vector3(-2, 0, 0)));
+  parts.push_back(Sphere(0.5, Vector3(2, 0, 0)));
+  Shape::Ptr compound(new MultiCollisionShape(parts[0], parts));
+  ASSERT_EQ(world.AddModelFromShape("compound", compound).opResult,
+            collision_benchmark::SUCCESS);
+  ASSERT_EQ(world.AddModelFromShape("probe",
+                                    Sphere(0.2, Vector3(1.2, 0, 0))).opResult,
+            collision_benchmark::SUCCESS);
+  EXPECT_EQ(world.GetContactInfo().size(), 0u);
+
+  // the positions of the parts are scaled along with their geometries,
+  // so the part at x = 1 with radius 0.25 touches the probe
+  BasicState state;
+  state.SetScale(0.5, 0.5, 0.5);
+  ASSERT_TRUE(world.SetBasicModelState("compound", state));
+  std::vector<ContactInfoPtr> contacts = world.GetContactInfo();
+  ASSERT_EQ(contacts.size(), 1u);
+  ASSERT_EQ(contacts[0]->contacts.size(), 1u);
+  EXPECT_NEAR(contacts[0]->contacts[0].depth, 0.25, tol);
+
+  Vector3 min, max;
+  ASSERT_TRUE(world.GetAABB("compound", min, max));
+  EXPECT_NEAR(min.X(), -1.25, tol);
+  EXPECT_NEAR(max.X(), 1.25, tol);
+  EXPECT_NEAR(max.Z(), 0.25, tol);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(FCLPhysicsWorldTest, HalfSpace)
+{
+  FCLPhysicsWorld world;
+  Shape::Ptr plane(PrimitiveShape::CreatePlane(0, 0, 1, 10, 10));
+  ASSERT_EQ(world.AddModelFromShape("ground", plane).opResult,
+            collision_benchmark::SUCCESS);
+  ASSERT_EQ(world.AddModelFromShape("sphere",
+                                    Sphere(1, Vector3(3, 0, 0.8))).opResult,
+            collision_benchmark::SUCCESS);
+
+  // the plane is a half space, not bounded by its size
+  Vector3 min, max;
+  ASSERT_TRUE(world.GetAABB("ground", min, max));
+  EXPECT_GT(max.X(), 1e06);
+  BasicState state;
+  state.SetPosition(100, 0, -0.5);
+  ASSERT_TRUE(world.SetBasicModelState("sphere", state));
+  std::vector<ContactInfoPtr> contacts = world.GetContactInfo();
+  ASSERT_EQ(contacts.size(), 1u);
+  EXPECT_EQ(contacts[0]->model1, "ground");
+  ASSERT_FALSE(contacts[0]->contacts.empty());
+  EXPECT_NEAR(contacts[0]->contacts[0].depth, 1.5, tol);
+  EXPECT_NEAR(contacts[0]->contacts[0].normal.Z(), 1, tol);
+
+  // planes are not scaled
+  state = BasicState();
+  state.SetScale(1, 1, 0.1);
+  ASSERT_TRUE(world.SetBasicModelState("ground", state));
+  contacts = world.GetContactInfo();
+  ASSERT_EQ(contacts.size(), 1u);
+  EXPECT_NEAR(contacts[0]->contacts[0].depth, 1.5, tol);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(FCLPhysicsWorldTest, WorldState)
+{
+  FCLPhysicsWorld world1("world1");
+  ASSERT_EQ(world1.AddModelFromShape("a", Sphere(1, Vector3())).opResult,
+            collision_benchmark::SUCCESS);
+  ASSERT_EQ(world1.AddModelFromShape("b",
+                                     Sphere(1, Vector3(2.5, 0, 0))).opResult,
+            collision_benchmark::SUCCESS);
+  BasicState state;
+  state.SetScale(2, 2, 2);
+  ASSERT_TRUE(world1.SetBasicModelState("a", state));
+  // Update() only advances the time
+  world1.Update(10);
+  EXPECT_NEAR(world1.GetWorldState().GetSimTime().Double(), 0.01, 1e-09);
+
+  // the geometries are created again with the scale of the state
+  FCLPhysicsWorld world2("world2");
+  ASSERT_EQ(world2.AddModelFromShape("a", Sphere(1, Vector3())).opResult,
+            collision_benchmark::SUCCESS);
+  ASSERT_EQ(world2.AddModelFromShape("b", Sphere(1, Vector3())).opResult,
+            collision_benchmark::SUCCESS);
+  EXPECT_EQ(world2.SetWorldState(world1.GetWorldState()),
+            collision_benchmark::SUCCESS);
+  std::vector<ContactInfoPtr> contacts = world2.GetContactInfo();
+  ASSERT_EQ(contacts.size(), 1u);
+  EXPECT_NEAR(contacts[0]->contacts[0].depth, 0.5, tol);
+  EXPECT_EQ(world2.GetWorldState().GetIterations(), 10u);
+
+  // models can't be inserted from the state
+  ASSERT_TRUE(world2.RemoveModel("b"));
+  EXPECT_EQ(world2.SetWorldState(world1.GetWorldState()),
+            collision_benchmark::NOT_SUPPORTED);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
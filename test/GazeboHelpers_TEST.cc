@@ -0,0 +1,51 @@
+#include <collision_benchmark/GazeboHelpers.hh>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using collision_benchmark::hasOuterSDFTag;
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(GazeboHelpersTest, OuterSDFTag)
+{
+  EXPECT_TRUE(hasOuterSDFTag("<sdf version='1.6'><model/></sdf>"));
+  EXPECT_TRUE(hasOuterSDFTag("<sdf>"));
+  EXPECT_TRUE(hasOuterSDFTag("<sdf/>"));
+  // leading whitespace
+  EXPECT_TRUE(hasOuterSDFTag(" \t\r\n  <sdf version='1.6'></sdf>"));
+  // XML declaration
+  EXPECT_TRUE(hasOuterSDFTag("<?xml version='1.0' ?>\n"
+                             "<sdf version='1.6'></sdf>"));
+  // leading comments, also with tags inside
+  EXPECT_TRUE(hasOuterSDFTag("<!-- a comment -->\n<!-- <model> -->"
+                             "<sdf version='1.6'></sdf>"));
+  EXPECT_TRUE(hasOuterSDFTag("<?xml version='1.0' ?>\n"
+                             "<!-- a comment -->\n"
+                             "<sdf version='1.6'></sdf>"));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(GazeboHelpersTest, NoOuterSDFTag)
+{
+  // other first elements
+  EXPECT_FALSE(hasOuterSDFTag("<sdfx version='1.6'></sdfx>"));
+  EXPECT_FALSE(hasOuterSDFTag("<model name='m'></model>"));
+  EXPECT_FALSE(hasOuterSDFTag("<model><sdf/></model>"));
+  EXPECT_FALSE(hasOuterSDFTag("<!-- <sdf> --><model/>"));
+  // no tag
+  EXPECT_FALSE(hasOuterSDFTag(""));
+  EXPECT_FALSE(hasOuterSDFTag("  \n"));
+  EXPECT_FALSE(hasOuterSDFTag("sdf"));
+  EXPECT_FALSE(hasOuterSDFTag("text <sdf></sdf>"));
+  EXPECT_FALSE(hasOuterSDFTag("<sdf"));
+  // unterminated declaration and comment
+  EXPECT_FALSE(hasOuterSDFTag("<?xml version='1.0' <sdf></sdf>"));
+  EXPECT_FALSE(hasOuterSDFTag("<!-- <sdf></sdf>"));
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
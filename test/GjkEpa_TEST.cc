@@ -0,0 +1,161 @@
+#include <collision_benchmark/ConvexSupport.hh>
+#include <collision_benchmark/CollisionOracle.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+#include <collision_benchmark/MeshShapeGeneratorNative.hh>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+using collision_benchmark::ConvexSupport;
+using collision_benchmark::ConvexSignedDistance;
+using collision_benchmark::SignedDistanceResult;
+using collision_benchmark::CollisionOracle;
+using collision_benchmark::Shape;
+using collision_benchmark::PrimitiveShape;
+
+typedef collision_benchmark::MeshShapeGeneratorNative<float> Generator;
+typedef ConvexSupport::Pose3 Pose3;
+typedef ConvexSupport::Vector3 Vector3;
+
+//////////////////////////////////////////////////////////////////////////////
+ConvexSupport::Ptr MakeSupport(PrimitiveShape * shape, const Pose3& pose)
+{
+  Shape::Ptr s(shape);
+  s->SetPose(pose);
+  ConvexSupport::Ptr support = ConvexSupport::Create(s);
+  EXPECT_TRUE(support != nullptr);
+  return support;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+Pose3 RandomPose(std::mt19937& rand, const double range)
+{
+  std::uniform_real_distribution<double> pos(-range, range);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  return Pose3(pos(rand), pos(rand), pos(rand),
+               angle(rand), angle(rand), angle(rand));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(GjkEpaTest, Spheres)
+{
+  ConvexSupport::Ptr s1 = MakeSupport(PrimitiveShape::CreateSphere(1),
+                                      Pose3());
+  ConvexSupport::Ptr s2 = MakeSupport(PrimitiveShape::CreateSphere(0.5),
+                                      Pose3(0, 2, 0, 0, 0, 0));
+  SignedDistanceResult res;
+  EXPECT_TRUE(ConvexSignedDistance(*s1, *s2, res));
+  EXPECT_NEAR(res.distance, 0.5, 1e-06);
+  EXPECT_NEAR(res.normal.Y(), 1, 1e-06);
+  EXPECT_NEAR(res.pointA.Y(), 1, 1e-03);
+  EXPECT_NEAR(res.pointB.Y(), 1.5, 1e-03);
+
+  s2->SetPose(Pose3(0, 0, -1.2, 0, 0, 0));
+  EXPECT_TRUE(ConvexSignedDistance(*s1, *s2, res));
+  EXPECT_NEAR(res.distance, -0.3, 1e-06);
+  EXPECT_NEAR(res.normal.Z(), -1, 1e-03);
+  EXPECT_NEAR(res.pointA.Z(), -1, 1e-03);
+  EXPECT_NEAR(res.pointB.Z(), -0.7, 1e-03);
+
+  // concentric spheres: all directions are equally deep, so EPA does not
+  // converge, but the depth must not be overestimated.
+  s2->SetPose(Pose3());
+  ConvexSignedDistance(*s1, *s2, res);
+  EXPECT_GE(res.distance, -1.5);
+  EXPECT_LT(res.distance, -1.45);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(GjkEpaTest, Cylinders)
+{
+  ConvexSupport::Ptr c1 = MakeSupport(PrimitiveShape::CreateCylinder(1, 2),
+                                      Pose3());
+  ConvexSupport::Ptr c2 = MakeSupport(PrimitiveShape::CreateCylinder(1, 2),
+                                      Pose3(1.9, 0, 0, 0, 0, 0));
+  SignedDistanceResult res;
+  EXPECT_TRUE(ConvexSignedDistance(*c1, *c2, res));
+  EXPECT_NEAR(res.distance, -0.1, 1e-05);
+  EXPECT_NEAR(res.normal.X(), 1, 1e-03);
+
+  // lying on its side on top of the other one
+  c2->SetPose(Pose3(0.3, 0, 1.95, M_PI / 2, 0, 0));
+  EXPECT_TRUE(ConvexSignedDistance(*c1, *c2, res));
+  EXPECT_NEAR(res.distance, -0.05, 1e-05);
+  EXPECT_NEAR(res.normal.Z(), 1, 1e-03);
+
+  c2->SetPose(Pose3(0.3, 0, 2.25, M_PI / 2, 0, 0));
+  EXPECT_TRUE(ConvexSignedDistance(*c1, *c2, res));
+  EXPECT_NEAR(res.distance, 0.25, 1e-05);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// The penetration depth of boxes and spheres has to be the one computed
+// by the CollisionOracle, which is exact for these pairs. Box meshes have
+// to give the same results as box primitives.
+TEST(GjkEpaTest, BoxesAndSpheres)
+{
+  Generator gen;
+  CollisionOracle oracle;
+  ASSERT_TRUE(oracle.AddShape("box1", Shape::Ptr(
+    PrimitiveShape::CreateBox(1, 2, 3))));
+  ASSERT_TRUE(oracle.AddShape("box2", Shape::Ptr(
+    PrimitiveShape::CreateBox(0.5, 1, 0.2))));
+  ASSERT_TRUE(oracle.AddShape("sphere", Shape::Ptr(
+    PrimitiveShape::CreateSphere(0.7))));
+  ConvexSupport::Ptr box1 = MakeSupport(PrimitiveShape::CreateBox(1, 2, 3),
+                                        Pose3());
+  ConvexSupport::Ptr box2 = MakeSupport(PrimitiveShape::CreateBox(0.5, 1, 0.2),
+                                        Pose3());
+  ConvexSupport::Ptr sphere = MakeSupport(PrimitiveShape::CreateSphere(0.7),
+                                          Pose3());
+  ConvexSupport::Ptr mesh2 = ConvexSupport::Create(*gen.MakeBox(0.5, 1, 0.2));
+  ASSERT_TRUE(mesh2 != nullptr);
+
+  std::mt19937 rand(0);
+  int numColliding = 0;
+  for (int i = 0; i < 1000; ++i)
+  {
+    Pose3 pose1 = RandomPose(rand, 0.5);
+    Pose3 pose2 = RandomPose(rand, 2);
+    box1->SetPose(pose1);
+    box2->SetPose(pose2);
+    mesh2->SetPose(pose2);
+    sphere->SetPose(pose2);
+
+    double depth;
+    SignedDistanceResult res, meshRes;
+    bool collide = oracle.Collide("box1", pose1, "box2", pose2, depth);
+    if (collide) ++numColliding;
+    EXPECT_TRUE(ConvexSignedDistance(*box1, *box2, res));
+    EXPECT_TRUE(ConvexSignedDistance(*box1, *mesh2, meshRes));
+    EXPECT_NEAR(res.distance, meshRes.distance, 1e-05);
+    if (collide)
+    {
+      EXPECT_NEAR(-res.distance, depth, 1e-05);
+      // moving the second box along the normal by the penetration depth
+      // separates the boxes
+      Pose3 moved(pose2.Pos() + res.normal * (depth + 1e-03), pose2.Rot());
+      EXPECT_FALSE(oracle.Collide("box1", pose1, "box2", moved, depth));
+    }
+    else
+    {
+      EXPECT_GT(res.distance, -1e-09);
+      EXPECT_NEAR((res.pointB - res.pointA).Length(), res.distance, 1e-05);
+    }
+
+    collide = oracle.Collide("box1", pose1, "sphere", pose2, depth);
+    EXPECT_TRUE(ConvexSignedDistance(*box1, *sphere, res));
+    if (collide) EXPECT_NEAR(-res.distance, depth, 1e-05);
+    else EXPECT_GT(res.distance, -1e-09);
+  }
+  EXPECT_GT(numColliding, 100);
+  EXPECT_LT(numColliding, 900);
+}
+
+int main(int argc, char**argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
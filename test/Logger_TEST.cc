@@ -0,0 +1,85 @@
+#include <collision_benchmark/Logger.hh>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using collision_benchmark::Logger;
+
+// returns the number of occurrences of \e pattern in \e str
+int Count(const std::string& str, const std::string& pattern)
+{
+  int cnt = 0;
+  for (size_t pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + 1))
+    ++cnt;
+  return cnt;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(LoggerTest, Levels)
+{
+  std::stringstream out;
+  Logger::SetOutput(&out);
+  Logger::SetLevel("levels_a", Logger::LEVEL_WARNING);
+  Logger::SetLevel("levels_b", Logger::LEVEL_DEBUG);
+  LOG_INFO("levels_a", "info a");
+  LOG_WARN("levels_a", "warning a " << 1);
+  LOG_DEBUG("levels_b", "debug b");
+  Logger::Flush();
+  Logger::SetOutput(NULL);
+
+  const std::string str = out.str();
+  EXPECT_EQ(str.find("info a"), std::string::npos);
+  EXPECT_NE(str.find("[WARNING] [levels_a] warning a 1"), std::string::npos);
+  EXPECT_NE(str.find("[DEBUG] [levels_b] debug b"), std::string::npos);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(LoggerTest, RateLimit)
+{
+  std::stringstream out;
+  Logger::SetOutput(&out);
+  // the second loop may start in a new one-second window
+  for (int i = 0; i < 100; ++i) LOG_ERROR("rate", "rate limited");
+  Logger::Flush();
+  Logger::SetOutput(NULL);
+  const int cnt = Count(out.str(), "rate limited");
+  EXPECT_GE(cnt, collision_benchmark::LogSite::MAX_PER_SECOND);
+  EXPECT_LE(cnt, 2 * collision_benchmark::LogSite::MAX_PER_SECOND);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(LoggerTest, Threads)
+{
+  const int numThreads = 8;
+  std::stringstream out;
+  Logger::SetOutput(&out);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t)
+  {
+    threads.push_back(std::thread([t]()
+      {
+        // one log site per thread, so no messages are suppressed
+        switch (t % 2)
+        {
+          case 0: LOG_INFO("threads", "even thread " << t); break;
+          default: LOG_INFO("threads", "odd thread " << t); break;
+        }
+      }));
+  }
+  for (std::vector<std::thread>::iterator it = threads.begin();
+       it != threads.end(); ++it)
+    it->join();
+  Logger::Flush();
+  Logger::SetOutput(NULL);
+  EXPECT_EQ(Count(out.str(), "[INFO] [threads]"), numThreads);
+}
+
+int main(int argc, char**argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,206 @@
+#include <collision_benchmark/MeshShapeGeneratorNative.hh>
+#include <collision_benchmark/MeshDecimation.hh>
+#include <collision_benchmark/ConvexDecomposition.hh>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+using collision_benchmark::MeshShapeGeneratorNative;
+
+typedef MeshShapeGeneratorNative<double> Generator;
+typedef Generator::TriMeshData TriMeshData;
+
+//////////////////////////////////////////////////////////////////////////////
+// Checks that there are no duplicate vertices, that every directed edge
+// is used at most once (consistent orientation) and, if \e closed, that
+// each edge has its opposite edge (watertight). Returns the signed volume
+// in \e volume, which is positive if faces point outwards.
+void CheckMesh(const TriMeshData::Ptr& mesh, const bool closed,
+               double& volume)
+{
+  ASSERT_NE(mesh.get(), nullptr);
+  const std::vector<TriMeshData::Vertex>& verts = mesh->GetVertices();
+  const std::vector<TriMeshData::Face>& faces = mesh->GetFaces();
+  ASSERT_FALSE(faces.empty());
+
+  for (std::size_t i = 0; i < verts.size(); ++i)
+    for (std::size_t j = i + 1; j < verts.size(); ++j)
+      ASSERT_GT(verts[i].Distance(verts[j]), 1e-06)
+        << "Duplicate vertices " << i << " and " << j;
+
+  typedef std::pair<std::size_t, std::size_t> Edge;
+  std::map<Edge, int> edges;
+  volume = 0;
+  for (std::vector<TriMeshData::Face>::const_iterator it = faces.begin();
+       it != faces.end(); ++it)
+  {
+    const TriMeshData::Face& f = *it;
+    for (int i = 0; i < 3; ++i)
+    {
+      ASSERT_LT(f.val[i], verts.size());
+      ++edges[Edge(f.val[i], f.val[(i + 1) % 3])];
+    }
+    volume += verts[f.val[0]].Dot(verts[f.val[1]].Cross(verts[f.val[2]])) / 6;
+  }
+
+  for (std::map<Edge, int>::const_iterator it = edges.begin();
+       it != edges.end(); ++it)
+  {
+    ASSERT_EQ(it->second, 1) << "Inconsistent face orientation";
+    if (closed)
+    {
+      ASSERT_EQ(edges.count(Edge(it->first.second, it->first.first)), 1u)
+        << "Mesh is not closed";
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(MeshShapeGeneratorNativeTest, ClosedShapes)
+{
+  Generator gen;
+  double vol;
+
+  CheckMesh(gen.MakeBox(1, 2, 3), true, vol);
+  EXPECT_NEAR(vol, 6, 1e-09);
+
+  CheckMesh(gen.MakeSphere(1, 30, 30, true), true, vol);
+  EXPECT_NEAR(vol, 4.0 / 3.0 * M_PI, 0.1);
+  EXPECT_EQ(gen.MakeSphere(1, 30, 30, true)->GetVertices().size(), 28u * 30 + 2);
+
+  CheckMesh(gen.MakeSphere(1, 30, 30, false), true, vol);
+  EXPECT_GT(vol, 0);
+
+  CheckMesh(gen.MakeCylinder(1, 2, 50, true), true, vol);
+  EXPECT_NEAR(vol, 2 * M_PI, 0.05);
+
+  CheckMesh(gen.MakeCone(1, 2, 50, 0, true, 0.2, 1, 0.5), true, vol);
+  EXPECT_NEAR(vol, 2 * M_PI / 3, 0.05);
+
+  CheckMesh(gen.MakeEllipsoid(1, 2, 3, 40, 40), true, vol);
+  EXPECT_NEAR(vol, 4.0 / 3.0 * M_PI * 6, 0.5);
+
+  CheckMesh(gen.MakeTorus(1, 0.2, 50, 30), true, vol);
+  EXPECT_NEAR(vol, 2 * M_PI * M_PI * 0.04, 0.01);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(MeshShapeGeneratorNativeTest, OpenShapes)
+{
+  Generator gen;
+  double vol;
+  CheckMesh(gen.MakeCylinder(1, 2, 20, false), false, vol);
+  CheckMesh(gen.MakeDisk(0, 1, 3, 20), false, vol);
+  CheckMesh(gen.MakeDisk(0.5, 1, 3, 20), false, vol);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(MeshDecimationTest, KeepsShape)
+{
+  Generator gen;
+  double vol;
+  TriMeshData::Ptr sphere = gen.MakeSphere(1, 100, 100, true);
+  TriMeshData::Ptr lowRes = collision_benchmark::DecimateMesh(*sphere, 500);
+  EXPECT_LE(lowRes->GetFaces().size(), 500u);
+  EXPECT_GT(lowRes->GetFaces().size(), 400u);
+  CheckMesh(lowRes, true, vol);
+  EXPECT_NEAR(vol, 4.0 / 3.0 * M_PI, 0.1);
+
+  // borders of open meshes are preserved
+  TriMeshData::Ptr disk = gen.MakeDisk(0.5, 1, 10, 50);
+  lowRes = collision_benchmark::DecimateMesh(*disk, 100);
+  EXPECT_LE(lowRes->GetFaces().size(), 100u);
+  CheckMesh(lowRes, false, vol);
+  const std::vector<TriMeshData::Vertex>& verts = lowRes->GetVertices();
+  for (std::size_t i = 0; i < verts.size(); ++i)
+  {
+    EXPECT_NEAR(verts[i].Z(), 0, 1e-06);
+    EXPECT_LT(verts[i].Length(), 1 + 1e-06);
+    EXPECT_GT(verts[i].Length(), 0.5 - 1e-06);
+  }
+
+  // no simplification needed
+  TriMeshData::Ptr box = gen.MakeBox(1, 1, 1);
+  EXPECT_EQ(collision_benchmark::DecimateMesh(*box, 12)->GetFaces().size(),
+            12u);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(ConvexDecompositionTest, ConvexHull)
+{
+  Generator gen;
+  double vol;
+  TriMeshData::Ptr hull =
+    collision_benchmark::ConvexHull(*gen.MakeSphere(1, 30, 30, true));
+  CheckMesh(hull, true, vol);
+  EXPECT_NEAR(vol, 4.0 / 3.0 * M_PI, 0.1);
+
+  // inner vertices are not part of the hull
+  TriMeshData::Ptr box = gen.MakeBox(1, 2, 3);
+  box->GetVertices().push_back(TriMeshData::Vertex(0.1, 0.2, 0.3));
+  hull = collision_benchmark::ConvexHull(*box);
+  CheckMesh(hull, true, vol);
+  EXPECT_EQ(hull->GetVertices().size(), 8u);
+  EXPECT_NEAR(vol, 6, 1e-09);
+
+  // flat meshes have no hull
+  EXPECT_EQ(collision_benchmark::ConvexHull(*gen.MakeDisk(0, 1, 3, 20)).get(),
+            nullptr);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(ConvexDecompositionTest, Decomposition)
+{
+  // L-shaped prism of height 1
+  const double poly[6][2] = {{1, 1}, {1, 3}, {0, 3}, {0, 0}, {3, 0}, {3, 1}};
+  const std::size_t n = 6;
+  TriMeshData::Ptr lShape(new TriMeshData());
+  std::vector<TriMeshData::Vertex>& verts = lShape->GetVertices();
+  std::vector<TriMeshData::Face>& faces = lShape->GetFaces();
+  for (std::size_t i = 0; i < n; ++i)
+    verts.push_back(TriMeshData::Vertex(poly[i][0], poly[i][1], 0));
+  for (std::size_t i = 0; i < n; ++i)
+    verts.push_back(TriMeshData::Vertex(poly[i][0], poly[i][1], 1));
+  // the caps are triangle fans around the reflex vertex 0
+  for (std::size_t i = 1; i + 1 < n; ++i)
+  {
+    faces.push_back(TriMeshData::Face(0, i + 1, i));
+    faces.push_back(TriMeshData::Face(n, n + i, n + i + 1));
+  }
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    std::size_t j = (i + 1) % n;
+    faces.push_back(TriMeshData::Face(i, j, n + j));
+    faces.push_back(TriMeshData::Face(i, n + j, n + i));
+  }
+
+  double vol;
+  CheckMesh(lShape, true, vol);
+  ASSERT_NEAR(vol, 5, 1e-09);
+
+  std::vector<TriMeshData::Ptr> parts =
+    collision_benchmark::ConvexDecomposition(*lShape, 0.05, 8);
+  EXPECT_EQ(parts.size(), 2u);
+  double sum = 0;
+  for (std::size_t i = 0; i < parts.size(); ++i)
+  {
+    CheckMesh(parts[i], true, vol);
+    sum += vol;
+  }
+  EXPECT_NEAR(sum, 5, 1e-06);
+
+  // a single part is the convex hull
+  parts = collision_benchmark::ConvexDecomposition(*lShape, 0.05, 1);
+  ASSERT_EQ(parts.size(), 1u);
+  CheckMesh(parts[0], true, vol);
+  EXPECT_NEAR(vol, 7, 1e-06);
+}
+
+int main(int argc, char**argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,60 @@
+#include <collision_benchmark/Metrics.hh>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using collision_benchmark::Metrics;
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(MetricsTest, CountersAndGauges)
+{
+  Metrics::Labels labels;
+  labels["world"] = "world_\"1\"";
+  labels["engine"] = "ode";
+  Metrics::Counter c = Metrics::GetCounter("test_steps_total",
+                                           "Steps done", labels);
+  c.Increment();
+  c.Increment(4);
+  // the same counter is returned for the same name and labels
+  EXPECT_EQ(Metrics::GetCounter("test_steps_total", "", labels).Get(), 5);
+
+  Metrics::Gauge g = Metrics::GetGauge("test_rtf", "Real time factor");
+  g.Set(0.5);
+
+  // a name can't be used for both types
+  Metrics::Gauge invalid = Metrics::GetGauge("test_steps_total", "");
+  invalid.Set(1);
+  EXPECT_EQ(c.Get(), 5);
+
+  std::stringstream str;
+  Metrics::Write(str);
+  const std::string text = str.str();
+  EXPECT_NE(text.find("# HELP test_steps_total Steps done\n"
+                      "# TYPE test_steps_total counter\n"
+                      "test_steps_total{engine=\"ode\","
+                      "world=\"world_\\\"1\\\"\"} 5\n"), std::string::npos);
+  EXPECT_NE(text.find("# TYPE test_rtf gauge\ntest_rtf 0.5\n"),
+            std::string::npos);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(MetricsTest, WriteFile)
+{
+  Metrics::GetGauge("test_file_gauge", "Gauge").Set(3);
+  const std::string filename = "metrics_test.prom";
+  ASSERT_TRUE(Metrics::WriteFile(filename));
+  std::ifstream file(filename.c_str());
+  std::stringstream str;
+  str << file.rdbuf();
+  EXPECT_NE(str.str().find("test_file_gauge 3\n"), std::string::npos);
+  std::remove(filename.c_str());
+}
+
+int main(int argc, char**argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
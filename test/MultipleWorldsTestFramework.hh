@@ -20,11 +20,15 @@
 #include <collision_benchmark/GazeboMultipleWorldsServer.hh>
 #include <collision_benchmark/GazeboWorldLoader.hh>
 #include <collision_benchmark/GazeboHelpers.hh>
+#include <collision_benchmark/Profiler.hh>
+#include <collision_benchmark/WorldPool.hh>
 
 #include <gtest/gtest.h>
 #include <gazebo/gazebo.hh>
 #include <gazebo/physics/physics.hh>
 
+#include <cstdlib>
+
 using collision_benchmark::GazeboPhysicsWorldTypes;
 
 class MultipleWorldsTestFramework : public ::testing::Test
@@ -46,6 +50,13 @@ class MultipleWorldsTestFramework : public ::testing::Test
                        GazeboPhysicsWorldTypes::Wrench>
             GzWorldManager;
 
+  typedef collision_benchmark::WorldPool<GazeboPhysicsWorldTypes::WorldState,
+                       GazeboPhysicsWorldTypes::ModelID,
+                       GazeboPhysicsWorldTypes::ModelPartID,
+                       GazeboPhysicsWorldTypes::Vector3,
+                       GazeboPhysicsWorldTypes::Wrench>
+            GzWorldPool;
+
   GzMultipleWorldsServer::Ptr GetServer() { return server; }
 
   protected:
@@ -58,8 +69,40 @@ class MultipleWorldsTestFramework : public ::testing::Test
   {
   }
 
+  // Returns true if the tests should lease their worlds from a pool instead
+  // of loading new worlds. This is enabled by setting the environment
+  // variable COLLISION_BENCHMARK_WORLD_POOL. The gazebo server is then
+  // shared by all tests of the process and shut down at exit.
+  static bool UseWorldPool()
+  {
+    return getenv("COLLISION_BENCHMARK_WORLD_POOL") != NULL;
+  }
+
+  // Leases a world with \e engine from the world pool. The world is
+  // returned to the pool in TearDown().
+  // \return the world, or NULL if the world pool is not used or the world
+  //  could not be loaded.
+  GzWorldManager::PhysicsWorldPtr LeaseWorld(const std::string& engine)
+  {
+    GzWorldPool::Ptr pool = GetShared().pool;
+    if (!pool) return GzWorldManager::PhysicsWorldPtr();
+    GzWorldManager::PhysicsWorldPtr world = pool->Lease(engine);
+    if (world) leasedWorlds.push_back(world);
+    return world;
+  }
+
   virtual void SetUp()
   {
+    if (UseWorldPool() && GetShared().server)
+    {
+      server = GetShared().server;
+#ifdef COLLISION_BENCHMARK_PROFILING
+      if (getenv("COLLISION_BENCHMARK_TRACE"))
+        collision_benchmark::Profiler::StartTrace();
+#endif
+      return;
+    }
+
     bool enforceContactCalc=true;
     std::set<std::string> engines =
       collision_benchmark::GetSupportedPhysicsEngines();
@@ -91,11 +134,56 @@ class MultipleWorldsTestFramework : public ::testing::Test
 
     server.reset(new collision_benchmark::GazeboMultipleWorldsServer(loaders));
     server->Start(1, &fakeProgramName);
+
+    if (UseWorldPool())
+    {
+      GetShared().server = server;
+      GetShared().pool.reset(new GzWorldPool(loaders,
+                                             "test_worlds/void.world"));
+      GetShared().pool->SetSaveSettings(SavePhysicsSettings);
+      std::atexit(ShutdownShared);
+    }
+
+#ifdef COLLISION_BENCHMARK_PROFILING
+    // record a trace of the test if a file is given in the environment
+    if (getenv("COLLISION_BENCHMARK_TRACE"))
+      collision_benchmark::Profiler::StartTrace();
+#endif
   }
 
   virtual void TearDown()
   {
-    if (server) server->Stop();
+    if (server)
+    {
+      PrintContactAnomalies();
+      if (GetShared().pool)
+      {
+        // the server is shared, so the next test must not find the worlds
+        // of this test in the world manager
+        GzWorldManager::Ptr worldManager = server->GetWorldManager();
+        std::vector<collision_benchmark::PhysicsWorldBaseInterface::Ptr>
+          worlds = worldManager->GetWorlds();
+        for (std::vector<collision_benchmark::PhysicsWorldBaseInterface::Ptr>
+             ::const_iterator it = worlds.begin(); it != worlds.end(); ++it)
+          worldManager->RemovePhysicsWorld((*it)->GetName());
+        for (std::vector<GzWorldManager::PhysicsWorldPtr>::iterator
+             it = leasedWorlds.begin(); it != leasedWorlds.end(); ++it)
+          GetShared().pool->Return(*it);
+      }
+      else
+      {
+        server->Stop();
+      }
+    }
+    leasedWorlds.clear();
+#ifdef COLLISION_BENCHMARK_PROFILING
+    const char * traceFile = getenv("COLLISION_BENCHMARK_TRACE");
+    if (traceFile)
+    {
+      collision_benchmark::Profiler::StopTrace();
+      collision_benchmark::Profiler::WriteTrace(std::string(traceFile));
+    }
+#endif
   }
 
 
@@ -113,11 +201,80 @@ class MultipleWorldsTestFramework : public ::testing::Test
   // \return false if there was an error preventing the refreshing.
   bool RefreshClient(const double timeoutSecs=-1);
 
+  // Prints the counts of inconsistent contacts reported by the engines
+  // of all worlds in which there were contacts.
+  void PrintContactAnomalies() const
+  {
+    typedef GzWorldManager::PhysicsWorldPtr PhysicsWorldPtr;
+    std::vector<PhysicsWorldPtr> worlds =
+      server->GetWorldManager()->GetPhysicsWorlds();
+    for (std::vector<PhysicsWorldPtr>::const_iterator
+         it = worlds.begin(); it != worlds.end(); ++it)
+    {
+      GzWorldManager::PhysicsWorldT::ContactAnomalies anomalies =
+        (*it)->GetContactAnomalies();
+      if (anomalies.numContacts == 0) continue;
+      std::cout << "Contact anomalies in world " << (*it)->GetName()
+                << ": " << anomalies << std::endl;
+    }
+  }
+
   private:
 
+  // Saves gravity and step size of the gazebo world \e world, so that the
+  // world pool can restore them when a test returns the world.
+  static GzWorldPool::RestoreSettingsFunction
+  SavePhysicsSettings(const GzWorldManager::PhysicsWorldPtr& world)
+  {
+    collision_benchmark::GazeboPhysicsWorldPtr gzWorld =
+      std::dynamic_pointer_cast<collision_benchmark::GazeboPhysicsWorld>
+        (world);
+    if (!gzWorld || !gzWorld->GetWorld())
+      return GzWorldPool::RestoreSettingsFunction();
+    const std::weak_ptr<gazebo::physics::World> weakWorld =
+      gzWorld->GetWorld();
+    const ignition::math::Vector3d gravity = gzWorld->GetWorld()->Gravity();
+    const double stepSize =
+      gzWorld->GetWorld()->Physics()->GetMaxStepSize();
+    return [weakWorld, gravity, stepSize]()
+      {
+        std::shared_ptr<gazebo::physics::World> w = weakWorld.lock();
+        if (!w) return;
+        w->SetGravity(gravity);
+        w->Physics()->SetMaxStepSize(stepSize);
+      };
+  }
+
+  // server and world pool shared by all tests if UseWorldPool() is true
+  struct Shared
+  {
+    GzMultipleWorldsServer::Ptr server;
+    GzWorldPool::Ptr pool;
+  };
+
+  static Shared& GetShared()
+  {
+    static Shared shared;
+    return shared;
+  }
+
+  // Releases the world pool and stops the shared server, called at exit.
+  static void ShutdownShared()
+  {
+    GetShared().pool.reset();
+    if (GetShared().server)
+    {
+      GetShared().server->Stop();
+      GetShared().server.reset();
+    }
+  }
+
   const char * fakeProgramName;
   GzMultipleWorldsServer::Ptr server;
 
+  // worlds leased with LeaseWorld() which are returned in TearDown()
+  std::vector<GzWorldManager::PhysicsWorldPtr> leasedWorlds;
+
   // node needed in RefreshClient()
   gazebo::transport::NodePtr node;
   // publisher needed in RefreshClient()
@@ -0,0 +1,124 @@
+// enable the macros for this test, independent of the build configuration
+#ifndef COLLISION_BENCHMARK_PROFILING
+#define COLLISION_BENCHMARK_PROFILING
+#endif
+
+#include <collision_benchmark/Profiler.hh>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using collision_benchmark::Profiler;
+
+// returns the statistics of section \e name, or statistics with count 0
+// if no durations were recorded for it
+Profiler::SectionStats GetStats(const std::string& name)
+{
+  std::vector<Profiler::SectionStats> stats = Profiler::GetStats();
+  for (std::vector<Profiler::SectionStats>::iterator it = stats.begin();
+       it != stats.end(); ++it)
+  {
+    if (it->name == name) return *it;
+  }
+  return Profiler::SectionStats();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(ProfilerTest, Sections)
+{
+  Profiler::SectionID s1 = Profiler::GetSection("Sections1");
+  Profiler::SectionID s2 = Profiler::GetSection("Sections2");
+  EXPECT_NE(s1, s2);
+  EXPECT_EQ(s1, Profiler::GetSection("Sections1"));
+
+  // sections without durations are not reported
+  EXPECT_EQ(GetStats("Sections1").count, 0);
+
+  for (int i = 1; i <= 100; ++i) Profiler::Record(s1, i * 1000);
+  Profiler::SectionStats stats = GetStats("Sections1");
+  EXPECT_EQ(stats.count, 100);
+  EXPECT_EQ(stats.totalNs, 5050000);
+  EXPECT_EQ(stats.maxNs, 100000);
+  EXPECT_DOUBLE_EQ(stats.GetMean(), 50500);
+  // percentiles are exact within a factor of 2
+  EXPECT_GE(stats.GetPercentile(50), 50000);
+  EXPECT_LE(stats.GetPercentile(50), 100000);
+  EXPECT_DOUBLE_EQ(stats.GetPercentile(100), 100000);
+
+  Profiler::Reset();
+  EXPECT_EQ(GetStats("Sections1").count, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(ProfilerTest, Threads)
+{
+  const int numThreads = 4;
+  const int numRecords = 10000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t)
+  {
+    threads.push_back(std::thread([]()
+      {
+        for (int i = 0; i < numRecords; ++i)
+        {
+          COLLISION_BENCHMARK_PROFILE_NAMED_SCOPE("Threads");
+        }
+      }));
+  }
+  for (std::vector<std::thread>::iterator it = threads.begin();
+       it != threads.end(); ++it)
+    it->join();
+
+  // durations of all finished threads are merged
+  EXPECT_EQ(GetStats("Threads").count, numThreads * numRecords);
+
+  std::stringstream str;
+  Profiler::Dump(str);
+  EXPECT_NE(str.str().find("Threads"), std::string::npos);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(ProfilerTest, Trace)
+{
+  Profiler::SectionID s = Profiler::GetSection("Trace/world1", "world1");
+  // events are only added while tracing
+  COLLISION_BENCHMARK_PROFILE_MARK("Before");
+  Profiler::StartTrace();
+  EXPECT_TRUE(Profiler::IsTracing());
+  {
+    COLLISION_BENCHMARK_PROFILE_SCOPE(s);
+    COLLISION_BENCHMARK_PROFILE_MARK("Marker \"1\"");
+  }
+  std::thread t([]()
+    {
+      COLLISION_BENCHMARK_PROFILE_NAMED_SCOPE("Trace/thread");
+    });
+  t.join();
+  Profiler::StopTrace();
+  EXPECT_FALSE(Profiler::IsTracing());
+  COLLISION_BENCHMARK_PROFILE_MARK("After");
+
+  std::stringstream str;
+  Profiler::WriteTrace(str);
+  const std::string trace = str.str();
+  EXPECT_NE(trace.find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(trace.find("\"Trace/world1\", \"ph\": \"X\""),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"Trace/thread\", \"ph\": \"X\""),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"Marker \\\"1\\\"\", \"ph\": \"i\""),
+            std::string::npos);
+  // one track for world1 in the main thread, and one for each thread
+  EXPECT_NE(trace.find("world1 / thread "), std::string::npos);
+  EXPECT_EQ(trace.find("Before"), std::string::npos);
+  EXPECT_EQ(trace.find("After"), std::string::npos);
+}
+
+int main(int argc, char**argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,241 @@
+#include <collision_benchmark/ShapePhysicsWorld.hh>
+#include <collision_benchmark/SimplePhysicsWorld.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using collision_benchmark::ShapePhysicsWorld;
+using collision_benchmark::PhysicsWorld;
+using collision_benchmark::SimplePhysicsWorldTypes;
+using collision_benchmark::PrimitiveShape;
+using collision_benchmark::Shape;
+using collision_benchmark::BasicState;
+using collision_benchmark::OpResult;
+
+// Engine data of the models in TestWorld
+struct TestModelData
+{
+  TestModelData(): numUpdates(0) {}
+  // number of calls of UpdateModel()
+  int numUpdates;
+};
+
+typedef ShapePhysicsWorld<PhysicsWorld<SimplePhysicsWorldTypes::WorldState,
+                                       SimplePhysicsWorldTypes::ModelID,
+                                       SimplePhysicsWorldTypes::ModelPartID,
+                                       SimplePhysicsWorldTypes::Vector3,
+                                       SimplePhysicsWorldTypes::Wrench>,
+                          TestModelData> TestWorldBase;
+
+// World without collisions to test the bookkeeping of ShapePhysicsWorld.
+// Boxes are not supported, and scales with a zero component are rejected.
+class TestWorld: public TestWorldBase
+{
+  public: TestWorld(): TestWorldBase("test_world", 0.01),
+                       numSteps(0), numDestroyed(0) {}
+
+  public: virtual WorldState GetWorldState() const { return WorldState(); }
+  public: virtual WorldState GetWorldStateDiff(const WorldState& other) const
+          { return other; }
+  public: virtual OpResult SetWorldState(const WorldState& state,
+                                         bool isDiff = false)
+          { return collision_benchmark::NOT_SUPPORTED; }
+  public: virtual bool GetAABB(const ModelID& id,
+                               Vector3& min, Vector3& max) const
+          { return false; }
+  public: virtual std::vector<ContactInfoPtr> GetContactInfo() const
+          { return std::vector<ContactInfoPtr>(); }
+  public: virtual std::vector<ContactInfoPtr>
+          GetContactInfo(const ModelID& m1, const ModelID& m2) const
+          { return std::vector<ContactInfoPtr>(); }
+
+  // Counts \e anomalies like a query for contacts would
+  public: void CountAnomalies(const ContactAnomalies& anomalies) const
+          { AddContactAnomalies(anomalies); }
+
+  // Returns the number of UpdateModel() calls of the model \e id
+  public: int GetNumUpdates(const ModelID& id) const
+          { return models.find(id)->second.numUpdates; }
+
+  protected: virtual OpResult CreateModel(const ModelID& id,
+                                          ModelEntry& model)
+  {
+    if (model.GetCollisionShape()->GetType() == Shape::BOX)
+      return collision_benchmark::NOT_SUPPORTED;
+    return collision_benchmark::SUCCESS;
+  }
+
+  protected: virtual bool UpdateModel(const ModelID& id, ModelEntry& model,
+                                      const Vector3& oldScale)
+  {
+    if (model.scale.X() == 0 || model.scale.Y() == 0 ||
+        model.scale.Z() == 0) return false;
+    ++model.numUpdates;
+    return true;
+  }
+
+  protected: virtual void DestroyModel(const ModelID& id, ModelEntry& model)
+          { ++numDestroyed; }
+
+  protected: virtual void Step() { ++numSteps; }
+
+  public: int numSteps;
+  public: int numDestroyed;
+};
+
+typedef TestWorld::Pose3 Pose3;
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(ShapePhysicsWorldTest, SDFNotSupported)
+{
+  TestWorld world;
+  EXPECT_FALSE(world.SupportsSDF());
+  EXPECT_TRUE(world.SupportsShapes());
+  // WorldManager passes SDF to all worlds, so it must not throw
+  EXPECT_EQ(world.LoadFromSDF(sdf::ElementPtr()),
+            collision_benchmark::NOT_SUPPORTED);
+  EXPECT_EQ(world.AddModelFromSDF(sdf::ElementPtr()).opResult,
+            collision_benchmark::NOT_SUPPORTED);
+  EXPECT_EQ(world.LoadFromFile("world.world"),
+            collision_benchmark::NOT_SUPPORTED);
+  EXPECT_EQ(world.LoadFromString("<sdf/>"),
+            collision_benchmark::NOT_SUPPORTED);
+  EXPECT_EQ(world.AddModelFromFile("model.sdf").opResult,
+            collision_benchmark::NOT_SUPPORTED);
+  EXPECT_EQ(world.AddModelFromString("<sdf/>").opResult,
+            collision_benchmark::NOT_SUPPORTED);
+  EXPECT_FALSE(world.SaveToFile("world.world"));
+  EXPECT_TRUE(world.GetAllModelIDs().empty());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(ShapePhysicsWorldTest, AddAndRemoveModels)
+{
+  TestWorld world;
+  Shape::Ptr sphere(PrimitiveShape::CreateSphere(1));
+  TestWorld::ModelLoadResult res = world.AddModelFromShape("a", sphere);
+  ASSERT_EQ(res.opResult, collision_benchmark::SUCCESS);
+  EXPECT_EQ(res.modelID, "a");
+  EXPECT_EQ(world.AddModelFromShape("a", sphere).opResult,
+            collision_benchmark::FAILED);
+  EXPECT_EQ(world.AddModelFromShape("", sphere).opResult,
+            collision_benchmark::FAILED);
+  EXPECT_EQ(world.AddModelFromShape("c", Shape::Ptr()).opResult,
+            collision_benchmark::FAILED);
+
+  // models with unsupported shapes are not kept
+  Shape::Ptr box(PrimitiveShape::CreateBox(1, 1, 1));
+  EXPECT_EQ(world.AddModelFromShape("box", box).opResult,
+            collision_benchmark::NOT_SUPPORTED);
+  EXPECT_EQ(world.AddModelFromShape("box", sphere, box).opResult,
+            collision_benchmark::NOT_SUPPORTED);
+  // ... but the shape is used for collisions only without collision shape
+  EXPECT_EQ(world.AddModelFromShape("b", box, sphere).opResult,
+            collision_benchmark::SUCCESS);
+  EXPECT_EQ(world.GetAllModelIDs(), std::vector<std::string>({"a", "b"}));
+
+  // integer IDs are not given twice
+  EXPECT_EQ(world.GetIntegerModelID("a"), 0);
+  EXPECT_EQ(world.GetIntegerModelID("b"), 1);
+  EXPECT_EQ(world.GetIntegerModelID("box"), -1);
+  EXPECT_TRUE(world.RemoveModel("a"));
+  EXPECT_FALSE(world.RemoveModel("a"));
+  EXPECT_EQ(world.numDestroyed, 1);
+  ASSERT_EQ(world.AddModelFromShape("a", sphere).opResult,
+            collision_benchmark::SUCCESS);
+  EXPECT_EQ(world.GetIntegerModelID("a"), 2);
+
+  world.Clear();
+  EXPECT_EQ(world.numDestroyed, 3);
+  EXPECT_TRUE(world.GetAllModelIDs().empty());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(ShapePhysicsWorldTest, BasicModelState)
+{
+  TestWorld world;
+  Shape::Ptr sphere(PrimitiveShape::CreateSphere(1));
+  sphere->SetPose(Pose3(1, 2, 3, 0, 0, M_PI / 2));
+  ASSERT_EQ(world.AddModelFromShape("sphere", sphere).opResult,
+            collision_benchmark::SUCCESS);
+
+  BasicState state;
+  ASSERT_TRUE(world.GetBasicModelState("sphere", state));
+  EXPECT_DOUBLE_EQ(state.position.y, 2);
+  EXPECT_NEAR(state.rotation.z, sqrt(0.5), 1e-09);
+  EXPECT_DOUBLE_EQ(state.scale.x, 1);
+
+  // only the enabled fields are changed
+  BasicState pos;
+  pos.SetPosition(4, 5, 6);
+  ASSERT_TRUE(world.SetBasicModelState("sphere", pos));
+  ASSERT_TRUE(world.GetBasicModelState("sphere", state));
+  EXPECT_DOUBLE_EQ(state.position.x, 4);
+  EXPECT_NEAR(state.rotation.z, sqrt(0.5), 1e-09);
+  EXPECT_DOUBLE_EQ(state.scale.z, 1);
+  EXPECT_EQ(world.GetNumUpdates("sphere"), 1);
+
+  // rejected changes are undone
+  BasicState scale;
+  scale.SetPosition(7, 8, 9);
+  scale.SetScale(0, 1, 1);
+  EXPECT_FALSE(world.SetBasicModelState("sphere", scale));
+  ASSERT_TRUE(world.GetBasicModelState("sphere", state));
+  EXPECT_DOUBLE_EQ(state.position.x, 4);
+  EXPECT_DOUBLE_EQ(state.scale.x, 1);
+  EXPECT_EQ(world.GetNumUpdates("sphere"), 1);
+
+  scale.SetScale(2, 3, 4);
+  ASSERT_TRUE(world.SetBasicModelState("sphere", scale));
+  ASSERT_TRUE(world.GetBasicModelState("sphere", state));
+  EXPECT_DOUBLE_EQ(state.position.x, 7);
+  EXPECT_DOUBLE_EQ(state.scale.y, 3);
+
+  EXPECT_FALSE(world.SetBasicModelState("nothing", pos));
+  EXPECT_FALSE(world.GetBasicModelState("nothing", state));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(ShapePhysicsWorldTest, Update)
+{
+  TestWorld world;
+  world.Update(3);
+  EXPECT_EQ(world.numSteps, 3);
+  world.Update(0);
+  world.Update(-1);
+  EXPECT_EQ(world.numSteps, 3);
+
+  world.SetPaused(true);
+  EXPECT_TRUE(world.IsPaused());
+  world.Update(2);
+  EXPECT_EQ(world.numSteps, 3);
+  world.Update(2, true);
+  EXPECT_EQ(world.numSteps, 5);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(ShapePhysicsWorldTest, ContactAnomalies)
+{
+  TestWorld world;
+  TestWorld::ContactAnomalies anomalies;
+  anomalies.numContacts = 2;
+  anomalies.numPoints = 5;
+  anomalies.Add(TestWorld::ContactAnomalies::EMPTY_CONTACT, "a", "b");
+  world.CountAnomalies(anomalies);
+  world.CountAnomalies(anomalies);
+  EXPECT_EQ(world.GetContactAnomalies().numContacts, 4u);
+  EXPECT_EQ(world.GetContactAnomalies().numPoints, 10u);
+  EXPECT_EQ(world.GetContactAnomalies().GetCount(
+            TestWorld::ContactAnomalies::EMPTY_CONTACT), 2u);
+  world.ResetContactAnomalies();
+  EXPECT_EQ(world.GetContactAnomalies().numContacts, 0u);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,108 @@
+#include <collision_benchmark/SharedMemoryRingBuffer.hh>
+
+#include <gtest/gtest.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <string>
+
+using collision_benchmark::SharedMemoryRingBuffer;
+
+// Returns a name for a shared memory segment which is unique to
+// this process
+std::string GetBufferName(const std::string& suffix)
+{
+  std::stringstream name;
+  name << "collision_benchmark_test_" << getpid() << "_" << suffix;
+  return name.str();
+}
+
+// Returns the i'th message of a sequence of messages of different lengths
+std::string GetMessage(const int i)
+{
+  return std::string(i % 37, 'a' + i % 26);
+}
+
+TEST(SharedMemoryRingBufferTest, PushPopInOrder)
+{
+  const std::string name = GetBufferName("order");
+  SharedMemoryRingBuffer::Ptr buffer =
+    SharedMemoryRingBuffer::Create(name, 100);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(buffer->GetName(), name);
+  EXPECT_EQ(buffer->GetCapacity(), 100);
+
+  // several rounds, so that the messages wrap around the end of the ring
+  for (int i = 0; i < 50; i += 2)
+  {
+    ASSERT_TRUE(buffer->Push(GetMessage(i)));
+    ASSERT_TRUE(buffer->Push(GetMessage(i + 1)));
+    std::string msg;
+    ASSERT_TRUE(buffer->Pop(msg));
+    EXPECT_EQ(msg, GetMessage(i));
+    ASSERT_TRUE(buffer->Pop(msg));
+    EXPECT_EQ(msg, GetMessage(i + 1));
+  }
+}
+
+TEST(SharedMemoryRingBufferTest, Timeouts)
+{
+  SharedMemoryRingBuffer::Ptr buffer =
+    SharedMemoryRingBuffer::Create(GetBufferName("timeouts"), 20);
+  ASSERT_NE(buffer, nullptr);
+
+  std::string msg;
+  EXPECT_FALSE(buffer->Pop(msg, 0.01));
+  // a message takes 4 bytes more than its length
+  EXPECT_FALSE(buffer->Push(std::string(17, 'x')));
+  ASSERT_TRUE(buffer->Push(std::string(10, 'x')));
+  EXPECT_FALSE(buffer->Push(std::string(3, 'y'), 0.01));
+  ASSERT_TRUE(buffer->Pop(msg, 0.01));
+  EXPECT_EQ(msg, std::string(10, 'x'));
+}
+
+TEST(SharedMemoryRingBufferTest, OpenMissing)
+{
+  EXPECT_EQ(SharedMemoryRingBuffer::Open(GetBufferName("missing")), nullptr);
+}
+
+TEST(SharedMemoryRingBufferTest, TwoProcesses)
+{
+  const std::string name = GetBufferName("processes");
+  SharedMemoryRingBuffer::Ptr buffer =
+    SharedMemoryRingBuffer::Create(name, 64);
+  ASSERT_NE(buffer, nullptr);
+
+  // many more messages than fit into the buffer at once
+  const int numMessages = 1000;
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0)
+  {
+    SharedMemoryRingBuffer::Ptr other = SharedMemoryRingBuffer::Open(name);
+    bool success = other != nullptr;
+    for (int i = 0; success && (i < numMessages); ++i)
+      success = other->Push(GetMessage(i), 10);
+    // exit without destructing the objects copied from the parent
+    _exit(success ? 0 : 1);
+  }
+
+  for (int i = 0; i < numMessages; ++i)
+  {
+    std::string msg;
+    ASSERT_TRUE(buffer->Pop(msg, 10));
+    ASSERT_EQ(msg, GetMessage(i));
+  }
+  int status = -1;
+  waitpid(pid, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+int main(int argc, char**argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
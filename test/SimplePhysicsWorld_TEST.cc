@@ -0,0 +1,219 @@
+#include <collision_benchmark/SimplePhysicsWorld.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+#include <collision_benchmark/MultiCollisionShape.hh>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using collision_benchmark::SimplePhysicsWorld;
+using collision_benchmark::PrimitiveShape;
+using collision_benchmark::MultiCollisionShape;
+using collision_benchmark::Shape;
+using collision_benchmark::BasicState;
+
+typedef SimplePhysicsWorld::Pose3 Pose3;
+typedef SimplePhysicsWorld::Vector3 Vector3;
+typedef SimplePhysicsWorld::ContactInfoPtr ContactInfoPtr;
+
+//////////////////////////////////////////////////////////////////////////////
+// Adds a shape at \e pose to \e world as model \e name
+void AddShape(SimplePhysicsWorld& world, const std::string& name,
+              Shape * shape, const Pose3& pose)
+{
+  Shape::Ptr s(shape);
+  s->SetPose(pose);
+  ASSERT_EQ(world.AddModelFromShape(name, s).opResult,
+            collision_benchmark::SUCCESS);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(SimplePhysicsWorldTest, ConvexContacts)
+{
+  SimplePhysicsWorld world;
+  AddShape(world, "b", PrimitiveShape::CreateSphere(1),
+           Pose3(1.5, 0, 0, 0, 0, 0));
+  AddShape(world, "a", PrimitiveShape::CreateSphere(1), Pose3());
+  AddShape(world, "c", PrimitiveShape::CreateBox(1, 1, 1),
+           Pose3(0, 0, 5, 0, 0, 0));
+
+  std::vector<ContactInfoPtr> contacts = world.GetContactInfo();
+  ASSERT_EQ(contacts.size(), 1u);
+  EXPECT_EQ(contacts[0]->model1, "a");
+  EXPECT_EQ(contacts[0]->model2, "b");
+  ASSERT_EQ(contacts[0]->contacts.size(), 1u);
+  EXPECT_NEAR(contacts[0]->contacts[0].depth, 0.5, 1e-06);
+  // normal points from model1 to model2
+  EXPECT_NEAR(contacts[0]->contacts[0].normal.X(), 1, 1e-06);
+  EXPECT_NEAR(contacts[0]->contacts[0].position.X(), 0.75, 1e-06);
+
+  EXPECT_EQ(world.GetContactInfo("a", "c").size(), 0u);
+  EXPECT_EQ(world.GetContactInfo("b", "a").size(), 1u);
+  EXPECT_EQ(world.GetContactAnomalies().numContacts, 2u);
+  EXPECT_EQ(world.GetContactAnomalies().numPoints, 2u);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(SimplePhysicsWorldTest, PlaneContacts)
+{
+  SimplePhysicsWorld world;
+  AddShape(world, "ground", PrimitiveShape::CreatePlane(0, 0, 1, 10, 10),
+           Pose3());
+  AddShape(world, "sphere", PrimitiveShape::CreateSphere(1),
+           Pose3(3, 0, 0.8, 0, 0, 0));
+  AddShape(world, "box", PrimitiveShape::CreateBox(2, 2, 2),
+           Pose3(-3, 0, 1.1, 0, 0, 0));
+
+  std::vector<ContactInfoPtr> contacts = world.GetContactInfo();
+  ASSERT_EQ(contacts.size(), 1u);
+  EXPECT_EQ(contacts[0]->model1, "ground");
+  EXPECT_EQ(contacts[0]->model2, "sphere");
+  ASSERT_EQ(contacts[0]->contacts.size(), 1u);
+  EXPECT_NEAR(contacts[0]->contacts[0].depth, 0.2, 1e-06);
+  EXPECT_NEAR(contacts[0]->contacts[0].normal.Z(), 1, 1e-06);
+
+  // the box is rotated so that an edge penetrates the ground
+  AddShape(world, "box2", PrimitiveShape::CreateBox(2, 2, 2),
+           Pose3(-6, 0, 1.3, M_PI / 4, 0, 0));
+  contacts = world.GetContactInfo("box2", "ground");
+  ASSERT_EQ(contacts.size(), 1u);
+  EXPECT_EQ(contacts[0]->model1, "box2");
+  EXPECT_NEAR(contacts[0]->contacts[0].depth, sqrt(2) - 1.3, 1e-06);
+  EXPECT_NEAR(contacts[0]->contacts[0].normal.Z(), -1, 1e-06);
+
+  Vector3 min, max;
+  ASSERT_TRUE(world.GetAABB("ground", min, max));
+  EXPECT_NEAR(max.Z(), 0, 1e-09);
+  ASSERT_TRUE(world.GetAABB("sphere", min, max));
+  EXPECT_NEAR(min.X(), 2, 1e-09);
+  EXPECT_NEAR(max.Z(), 1.8, 1e-09);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(SimplePhysicsWorldTest, FallingSphereComesToRest)
+{
+  SimplePhysicsWorld world;
+  AddShape(world, "ground", PrimitiveShape::CreatePlane(0, 0, 1, 10, 10),
+           Pose3());
+  AddShape(world, "sphere", PrimitiveShape::CreateSphere(0.5),
+           Pose3(0, 0, 2, 0, 0, 0));
+
+  world.SetPaused(true);
+  world.Update(100);
+  BasicState state;
+  ASSERT_TRUE(world.GetBasicModelState("sphere", state));
+  EXPECT_DOUBLE_EQ(state.position.z, 2);
+  world.Update(100, true);
+  ASSERT_TRUE(world.GetBasicModelState("sphere", state));
+  EXPECT_LT(state.position.z, 2);
+
+  world.SetPaused(false);
+  world.Update(2000);
+  ASSERT_TRUE(world.GetBasicModelState("sphere", state));
+  EXPECT_NEAR(state.position.z, 0.5, 1e-03);
+  EXPECT_NEAR(world.GetWorldState().models["sphere"].linearVel.Length(),
+              0, 0.1);
+  ASSERT_TRUE(world.GetBasicModelState("ground", state));
+  EXPECT_DOUBLE_EQ(state.position.z, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(SimplePhysicsWorldTest, Scale)
+{
+  SimplePhysicsWorld world;
+  world.SetDynamicsEnabled(false);
+  AddShape(world, "box", PrimitiveShape::CreateBox(1, 1, 1), Pose3());
+  // two spheres of radius 0.5 at x = -2 and x = 2
+  Shape::Ptr sphere1(PrimitiveShape::CreateSphere(0.5));
+  Shape::Ptr sphere2(PrimitiveShape::CreateSphere(0.5));
+  sphere1->SetPose(Pose3(-2, 0, 5, 0, 0, 0));
+  sphere2->SetPose(Pose3(2, 0, 5, 0, 0, 0));
+  std::vector<Shape::Ptr> parts;
+  parts.push_back(sphere1);
+  parts.push_back(sphere2);
+  ASSERT_EQ(world.AddModelFromShape("compound",
+              Shape::Ptr(new MultiCollisionShape(sphere1, parts))).opResult,
+            collision_benchmark::SUCCESS);
+  AddShape(world, "probe", PrimitiveShape::CreateSphere(0.2),
+           Pose3(1.2, 0, 2.5, 0, 0, 0));
+  EXPECT_EQ(world.GetContactInfo().size(), 0u);
+
+  BasicState state;
+  state.SetScale(2, 1, 4);
+  ASSERT_TRUE(world.SetBasicModelState("box", state));
+  Vector3 min, max;
+  ASSERT_TRUE(world.GetAABB("box", min, max));
+  EXPECT_NEAR(max.X(), 1, 1e-06);
+  EXPECT_NEAR(max.Y(), 0.5, 1e-06);
+  EXPECT_NEAR(min.Z(), -2, 1e-06);
+
+  // the positions of the parts are scaled with their dimensions, so the
+  // part at (1, 0, 2.5) with radius 0.25 touches the probe
+  state.SetScale(0.5, 0.5, 0.5);
+  ASSERT_TRUE(world.SetBasicModelState("compound", state));
+  ASSERT_TRUE(world.GetAABB("compound", min, max));
+  EXPECT_NEAR(min.X(), -1.25, 1e-06);
+  EXPECT_NEAR(max.X(), 1.25, 1e-06);
+  std::vector<ContactInfoPtr> contacts = world.GetContactInfo();
+  ASSERT_EQ(contacts.size(), 1u);
+  EXPECT_EQ(contacts[0]->model1, "compound");
+  ASSERT_EQ(contacts[0]->contacts.size(), 1u);
+  EXPECT_NEAR(contacts[0]->contacts[0].depth, 0.25, 1e-06);
+
+  // the scale is applied to models added from the state
+  SimplePhysicsWorld world2("world2");
+  EXPECT_EQ(world2.SetWorldState(world.GetWorldState()),
+            collision_benchmark::SUCCESS);
+  ASSERT_TRUE(world2.GetAABB("box", min, max));
+  EXPECT_NEAR(max.Z(), 2, 1e-06);
+  EXPECT_EQ(world2.GetContactInfo().size(), 1u);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(SimplePhysicsWorldTest, WorldState)
+{
+  SimplePhysicsWorld world1("world1");
+  AddShape(world1, "box", PrimitiveShape::CreateBox(1, 1, 1),
+           Pose3(1, 2, 3, 0, 0, 0));
+  AddShape(world1, "cylinder", PrimitiveShape::CreateCylinder(1, 2),
+           Pose3(-1, 2, 3, 0, 0, 0));
+  ASSERT_TRUE(world1.SetModelVelocity("box", Vector3(1, 0, 0)));
+  world1.Update(10);
+
+  // models which are not in the world are added from the state
+  SimplePhysicsWorld world2("world2");
+  EXPECT_EQ(world2.SetWorldState(world1.GetWorldState()),
+            collision_benchmark::SUCCESS);
+  EXPECT_EQ(world2.GetAllModelIDs(), world1.GetAllModelIDs());
+  BasicState s1, s2;
+  ASSERT_TRUE(world1.GetBasicModelState("box", s1));
+  ASSERT_TRUE(world2.GetBasicModelState("box", s2));
+  EXPECT_DOUBLE_EQ(s1.position.z, s2.position.z);
+  // velocities are part of the state
+  EXPECT_EQ(world1.GetWorldState().models["box"].linearVel,
+            world2.GetWorldState().models["box"].linearVel);
+  EXPECT_DOUBLE_EQ(world2.GetWorldState().models["box"].linearVel.X(), 1);
+  EXPECT_DOUBLE_EQ(world1.GetWorldState().simTime,
+                   world2.GetWorldState().simTime);
+
+  // the diff removes models which are not in the target state
+  ASSERT_TRUE(world1.RemoveModel("cylinder"));
+  SimplePhysicsWorld::WorldState diff =
+    world2.GetWorldStateDiff(world1.GetWorldState());
+  ASSERT_EQ(diff.deletions.size(), 1u);
+  EXPECT_EQ(world2.SetWorldState(diff, true), collision_benchmark::SUCCESS);
+  EXPECT_EQ(world2.GetAllModelIDs(), world1.GetAllModelIDs());
+
+  // models without shape can't be added
+  SimplePhysicsWorld::WorldState noShape;
+  noShape.models["empty"] = SimplePhysicsWorld::WorldState::ModelState();
+  EXPECT_EQ(world2.SetWorldState(noShape, true),
+            collision_benchmark::NOT_SUPPORTED);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
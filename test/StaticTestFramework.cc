@@ -4,6 +4,10 @@
 #include <collision_benchmark/SimpleTriMeshShape.hh>
 #include <collision_benchmark/BasicTypes.hh>
 #include <collision_benchmark/Helpers.hh>
+#include <collision_benchmark/Profiler.hh>
+#ifdef COLLISION_BENCHMARK_FCL
+#include <collision_benchmark/FCLPhysicsWorld.hh>
+#endif
 
 #include <ignition/math/Vector3.hh>
 
@@ -27,7 +31,9 @@ void StaticTestFramework::Init()
   GzMultipleWorldsServer::Ptr mServer = GetServer();
   ASSERT_NE(mServer.get(), nullptr) << "Could not create and start server";
 
-  bool loadMirror = true;
+  // the mirror world has to be loaded before all other worlds, which is
+  // not possible when the server and the world pool are shared by all tests.
+  bool loadMirror = !UseWorldPool();
   std::string mirrorName = "";
   if (loadMirror) mirrorName = "mirror";
   // with the tests, the mirror can be used to watch the test,
@@ -56,9 +62,40 @@ void StaticTestFramework::InitMultipleEngines
   GzWorldManager::Ptr worldManager = mServer->GetWorldManager();
   ASSERT_NE(worldManager.get(), nullptr) << "No valid world manager created";
 
-  // world to load
-  std::string worldfile = "test_worlds/void.world";
-  int numWorlds = mServer->Load(worldfile, engines);
+  // worlds which are not loaded with Gazebo are added after the others,
+  // so that the first world can be mirrored
+  std::vector<std::string> gzEngines;
+  std::vector<GzWorldManager::PhysicsWorldPtr> standaloneWorlds;
+  for (std::vector<std::string>::const_iterator it = engines.begin();
+       it != engines.end(); ++it)
+  {
+    GzWorldManager::PhysicsWorldPtr world =
+      CreateStandaloneWorld(*it, "world_" + *it);
+    if (world) standaloneWorlds.push_back(world);
+    else gzEngines.push_back(*it);
+  }
+
+  int numWorlds = 0;
+  if (UseWorldPool())
+  {
+    for (std::vector<std::string>::const_iterator it = gzEngines.begin();
+         it != gzEngines.end(); ++it)
+    {
+      GzWorldManager::PhysicsWorldPtr world = LeaseWorld(*it);
+      if (world && (worldManager->AddPhysicsWorld(world) >= 0)) ++numWorlds;
+    }
+  }
+  else if (!gzEngines.empty())
+  {
+    // world to load
+    std::string worldfile = "test_worlds/void.world";
+    numWorlds = mServer->Load(worldfile, gzEngines);
+  }
+  for (std::vector<GzWorldManager::PhysicsWorldPtr>::const_iterator
+       it = standaloneWorlds.begin(); it != standaloneWorlds.end(); ++it)
+  {
+    if (worldManager->AddPhysicsWorld(*it) >= 0) ++numWorlds;
+  }
   ASSERT_EQ(numWorlds, engines.size()) << "Could not prepare all engines";
 }
 
@@ -97,6 +134,19 @@ void StaticTestFramework::LoadOneEngine(const std::string& engine,
     std::stringstream _worldname;
     _worldname << "world_" << i << "_" << engine;
     std::string worldname=_worldname.str();
+    GzWorldManager::PhysicsWorldPtr world =
+      CreateStandaloneWorld(engine, worldname);
+    if (world)
+    {
+      worldManager->AddPhysicsWorld(world);
+      continue;
+    }
+    if (UseWorldPool())
+    {
+      world = LeaseWorld(engine);
+      if (world) worldManager->AddPhysicsWorld(world);
+      continue;
+    }
     mServer->Load(worldfile, engine, worldname);
   }
   int numWorldsInMgrNew = worldManager->GetNumWorlds();
@@ -105,6 +155,18 @@ void StaticTestFramework::LoadOneEngine(const std::string& engine,
 }
 
 
+////////////////////////////////////////////////////////////////
+GzWorldManager::PhysicsWorldPtr
+StaticTestFramework::CreateStandaloneWorld(const std::string& engine,
+                                           const std::string& worldname)
+{
+#ifdef COLLISION_BENCHMARK_FCL
+  if (engine == "fcl")
+    return GzWorldManager::PhysicsWorldPtr(
+      new collision_benchmark::FCLPhysicsWorld(worldname));
+#endif
+  return GzWorldManager::PhysicsWorldPtr();
+}
 
 ////////////////////////////////////////////////////////////////
 void StaticTestFramework::LoadShape(const Shape::Ptr& shape,
@@ -133,6 +195,20 @@ void StaticTestFramework::LoadShape(const Shape::Ptr& shape,
     ASSERT_EQ(mlRes.modelID, modelName)
       << "Model names should be equal";
   }
+
+  if (!oracle.AddShape(modelName, shape))
+  {
+    std::cout << "No ground truth will be available for model "
+              << modelName << std::endl;
+    oracle.RemoveShape(modelName);
+  }
+
+  convexShapes.erase(modelName);
+  if (std::dynamic_pointer_cast<collision_benchmark::PrimitiveShape>(shape) &&
+      (shape->GetType() != Shape::PLANE))
+  {
+    convexShapes[modelName] = collision_benchmark::ConvexSupport::Create(shape);
+  }
 }
 
 ////////////////////////////////////////////////////////////////
@@ -165,6 +241,10 @@ void StaticTestFramework::LoadShape(const Shape::Ptr& shape,
 
   ASSERT_EQ(res.modelID, modelName)
     << "Model names should be equal";
+
+  // the model may be different in the other worlds
+  oracle.RemoveShape(modelName);
+  convexShapes.erase(modelName);
 }
 
 
@@ -189,6 +269,27 @@ bool StaticTestFramework::GetAABBs(const std::string& modelName1,
 }
 
 
+////////////////////////////////////////////////////////////////
+bool StaticTestFramework::GetModelPose(const std::string& modelName,
+                                       Shape::Pose3& pose)
+{
+  GzMultipleWorldsServer::Ptr mServer = GetServer();
+  if (!mServer) return false;
+  GzWorldManager::Ptr worldManager = mServer->GetWorldManager();
+  if (!worldManager || (worldManager->GetNumWorlds() == 0)) return false;
+
+  GzWorldManager::PhysicsWorldModelInterfacePtr mWorld =
+   GzWorldManager::ToWorldWithModel(worldManager->GetWorld(0));
+  BasicState state;
+  if (!mWorld || !mWorld->GetBasicModelState(modelName, state))
+    return false;
+
+  pose.Pos().Set(state.position.x, state.position.y, state.position.z);
+  pose.Rot().Set(state.rotation.w, state.rotation.x,
+                 state.rotation.y, state.rotation.z);
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////
 void StaticTestFramework::AABBTestWorldsAgreement(const std::string& modelName1,
                                    const std::string& modelName2,
@@ -212,6 +313,32 @@ void StaticTestFramework::AABBTestWorldsAgreement(const std::string& modelName1,
 
   int numWorlds = worldManager->GetNumWorlds();
 
+  // the collision oracle provides the ground truth if it supports both models
+  groundTruthAgreement.clear();
+  bool useOracle = oracle.HasShape(modelName1) && oracle.HasShape(modelName2);
+  Shape::Pose3 pose1, pose2;
+  if (useOracle)
+  {
+    ASSERT_TRUE(GetModelPose(modelName1, pose1));
+    ASSERT_TRUE(GetModelPose(modelName2, pose2));
+  }
+  // number of scored states and number of disagreements with the
+  // ground truth by world name
+  unsigned int truthCnt = 0;
+  std::map<std::string, unsigned int> truthFails;
+
+  // the exact references for the contacts, if both models are convex
+  meanContactErrors.clear();
+  collision_benchmark::ConvexSupport::Ptr convex1, convex2;
+  if (convexShapes.count(modelName1) && convexShapes.count(modelName2))
+  {
+    convex1 = convexShapes[modelName1];
+    convex2 = convexShapes[modelName2];
+  }
+  // number of compared states and sum of contact errors by world name
+  std::map<std::string, unsigned int> errorCnt;
+  std::map<std::string, collision_benchmark::ContactError> errorSum;
+
   // set models to their initial pose
 
   collision_benchmark::GzAABB aabb1, aabb2;
@@ -257,6 +384,7 @@ void StaticTestFramework::AABBTestWorldsAgreement(const std::string& modelName1,
   for (double z = grid.min.Z(); z < grid.max.Z()+eps; z += cellSizeZ)
   {
     ++itCnt;
+    COLLISION_BENCHMARK_PROFILE_MARK("AABB grid cell " + std::to_string(itCnt));
     // std::cout<<"Placing model 2 at "<<x<<", "<<y<<", "<<z<<std::endl;
     bstate2.position.x = x;
     bstate2.position.y = y;
@@ -270,10 +398,51 @@ void StaticTestFramework::AABBTestWorldsAgreement(const std::string& modelName1,
 
     std::vector<std::string> colliding, notColliding;
     double maxContactDepth;
-    ASSERT_TRUE(collision_benchmark::CollisionState(modelName1, modelName2,
-                                                    worldManager, colliding,
-                                                    notColliding,
-                                                    maxContactDepth));
+    if (convex1 && convex2)
+    {
+      std::map<std::string, collision_benchmark::ContactError> errors;
+      ASSERT_TRUE(collision_benchmark::CollisionState(modelName1, modelName2,
+                                                      worldManager,
+                                                      convex1, convex2,
+                                                      colliding, notColliding,
+                                                      maxContactDepth,
+                                                      errors));
+      for (std::map<std::string, collision_benchmark::ContactError>::
+           const_iterator it = errors.begin(); it != errors.end(); ++it)
+      {
+        if (-it->second.refDistance < zeroDepthTol) continue;
+        ++errorCnt[it->first];
+        errorSum[it->first].depthError += it->second.depthError;
+        errorSum[it->first].normalError += it->second.normalError;
+      }
+    }
+    else
+    {
+      ASSERT_TRUE(collision_benchmark::CollisionState(modelName1, modelName2,
+                                                      worldManager, colliding,
+                                                      notColliding,
+                                                      maxContactDepth));
+    }
+
+    // compare to the ground truth, unless the models are just touching
+    std::string truthStr = "unknown";
+    if (useOracle)
+    {
+      pose2.Pos().Set(x, y, z);
+      double truthDepth;
+      bool truth = oracle.Collide(modelName1, pose1, modelName2, pose2,
+                                  truthDepth);
+      truthStr = truth ? "colliding" : "not colliding";
+      if (!truth || (truthDepth >= zeroDepthTol))
+      {
+        ++truthCnt;
+        const std::vector<std::string>& wrong =
+          truth ? notColliding : colliding;
+        for (std::vector<std::string>::const_iterator it = wrong.begin();
+             it != wrong.end(); ++it)
+          ++truthFails[*it];
+      }
+    }
 # if 0
     // For TESTING: stop at every colliding state
     int stopX = 5;
@@ -322,6 +491,7 @@ void StaticTestFramework::AABBTestWorldsAgreement(const std::string& modelName1,
       // str << " Collision: "<< VectorToString(colliding) << ", no collision: "
       //     << VectorToString(notColliding) << ".";
 
+      str << "Ground truth: " << truthStr << std::endl;
       str << "------ " << std::endl;
       str << "Colliding: " << std::endl
           << "------ " << std::endl;
@@ -380,5 +550,32 @@ void StaticTestFramework::AABBTestWorldsAgreement(const std::string& modelName1,
       ++failCnt;
     }
   }
+
+  if (truthCnt > 0)
+  {
+    std::cout << "Agreement with ground truth in " << truthCnt
+              << " states:" << std::endl;
+    for (int i = 0; i < numWorlds; ++i)
+    {
+      std::string name = worldManager->GetWorld(i)->GetName();
+      double agree = 1 - truthFails[name] / (double) truthCnt;
+      groundTruthAgreement[name] = agree;
+      std::cout << "  " << name << ": " << agree << std::endl;
+    }
+  }
+  if (!errorCnt.empty())
+  {
+    std::cout << "Mean contact errors (depth, normal angle):" << std::endl;
+    for (std::map<std::string, unsigned int>::const_iterator
+         it = errorCnt.begin(); it != errorCnt.end(); ++it)
+    {
+      collision_benchmark::ContactError& mean = meanContactErrors[it->first];
+      mean.depthError = errorSum[it->first].depthError / it->second;
+      mean.normalError = errorSum[it->first].normalError / it->second;
+      std::cout << "  " << it->first << ": " << mean.depthError << ", "
+                << mean.normalError << " (" << it->second << " states)"
+                << std::endl;
+    }
+  }
   std::cout<<"TwoModels test finished. "<<std::endl;
 }
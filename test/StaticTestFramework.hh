@@ -20,7 +20,10 @@
 #include <test/MultipleWorldsTestFramework.hh>
 #include <test/TestUtils.hh>
 #include <collision_benchmark/Shape.hh>
+#include <collision_benchmark/CollisionOracle.hh>
+#include <collision_benchmark/ConvexSupport.hh>
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -45,6 +48,8 @@ protected:
   void Init();
 
   // \brief Calls Init() and loads the empty world with all the given engines.
+  // Besides the Gazebo engines, this can be "fcl" if compiled with FCL,
+  // which adds a FCLPhysicsWorld (see CreateStandaloneWorld()).
   //
   // Throws gtest assertions so needs to be called from top-level
   // test function (nested function calls will not work correctly)
@@ -75,6 +80,10 @@ protected:
   // \brief Loads a shape into *all* worlds.
   // You must call Init(), InitMultipleEngines() or InitOneEngine()
   // before you can use this.
+  // If the shape is supported by the collision_benchmark::CollisionOracle,
+  // it is also used to compute the ground truth in
+  // AABBTestWorldsAgreement(). Convex primitives (spheres, boxes and
+  // cylinders) are also used to compute the contact errors.
   //
   // Throws gtest assertions so needs to be called from top-level
   // test function (nested function calls will not work correctly)
@@ -85,6 +94,8 @@ protected:
   // \brief Loads a shape into the worlds at the given index \e worldIdx.
   // You must call Init(), InitMultipleEngines() or InitOneEngine()
   // before you can use this.
+  // Because the model may differ between worlds, there will be no ground
+  // truth for the model in AABBTestWorldsAgreement().
   //
   // Throws gtest assertions so needs to be called from top-level
   // test function (nested function calls will not work correctly)
@@ -101,6 +112,20 @@ protected:
   // be moved along the 3D grid which is formed by the AABB of model 1,
   // expanded by half the dimensions of the AABB of model 2.
   //
+  // If both models were loaded with LoadShape() into all worlds and are
+  // supported by the collision_benchmark::CollisionOracle, each world is
+  // also scored against the ground truth computed by the oracle. The
+  // proportion of states in which each world agrees with the ground truth
+  // is printed at the end and can be retrieved with
+  // GetGroundTruthAgreement(). States in which the models penetrate less
+  // than \e zeroDepthTol according to the ground truth are not scored.
+  //
+  // If both models are convex primitives, the contacts of each world
+  // are also compared to the exact penetration depth and normal (see
+  // collision_benchmark::CollisionState()) in all states in which the
+  // models penetrate by at least \e zeroDepthTol. The mean errors are
+  // printed at the end and can be retrieved with GetMeanContactErrors().
+  //
   // Throws gtest assertions so needs to be called from top-level
   // test function (nested function calls will not work correctly)
   //
@@ -140,8 +165,38 @@ protected:
                 const std::string& outputBasePath = "",
                 const std::string& outputSubdir = "");
 
+  // Returns the proportion of states in which each world agreed with the
+  // ground truth in the last call of AABBTestWorldsAgreement(), by world
+  // name. Empty if there was no ground truth for the models.
+  const std::map<std::string, double>& GetGroundTruthAgreement() const
+  {
+    return groundTruthAgreement;
+  }
+
+  // Returns the mean contact errors of each world in the last call of
+  // AABBTestWorldsAgreement(), by world name. Empty if there were no
+  // exact references for the models.
+  const std::map<std::string, collision_benchmark::ContactError>&
+  GetMeanContactErrors() const
+  {
+    return meanContactErrors;
+  }
+
 private:
 
+  // Creates the world of an engine which is not loaded with Gazebo:
+  // "fcl" creates a collision_benchmark::FCLPhysicsWorld if compiled
+  // with FCL.
+  // \return NULL if \e engine has to be loaded with Gazebo
+  static GzWorldManager::PhysicsWorldPtr
+    CreateStandaloneWorld(const std::string& engine,
+                          const std::string& worldname);
+
+  // gets the pose of the model in the first world
+  // \return false if the model could not be found
+  bool GetModelPose(const std::string& modelName,
+                    collision_benchmark::Shape::Pose3& pose);
+
   // checks that AABB of model 1 and 2 are the same in all worlds and
   // returns the two AABBs
   // \param bbTol tolerance for comparison of bounding box sizes. The min/max
@@ -153,6 +208,19 @@ private:
                 collision_benchmark::GzAABB& m1,
                 collision_benchmark::GzAABB& m2);
 
+  // reference collision checker for the shapes loaded into all worlds
+  collision_benchmark::CollisionOracle oracle;
+
+  // convex primitives loaded into all worlds, by model name
+  std::map<std::string, collision_benchmark::ConvexSupport::Ptr> convexShapes;
+
+  // result of the last AABBTestWorldsAgreement(),
+  // see GetGroundTruthAgreement()
+  std::map<std::string, double> groundTruthAgreement;
+
+  // result of the last AABBTestWorldsAgreement(),
+  // see GetMeanContactErrors()
+  std::map<std::string, collision_benchmark::ContactError> meanContactErrors;
 };
 
 #endif  // COLLISION_BENCHMARK_TEST_STATICTESTFRAMEWORK_H
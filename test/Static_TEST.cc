@@ -70,6 +70,9 @@ TEST_F(StaticTest, BoxCylinderTest)
   selectedEngines.push_back("ode");
   selectedEngines.push_back("dart");
   // selectedEngines.push_back("simbody");
+#ifdef COLLISION_BENCHMARK_FCL
+  selectedEngines.push_back("fcl");
+#endif
 
   /*std::set<std::string> engines =
     collision_benchmark::GetSupportedPhysicsEngines();
@@ -103,6 +106,9 @@ TEST_F(StaticTest, CylinderAndTwoTriangles)
   selectedEngines.push_back("ode");
   selectedEngines.push_back("dart");
   // selectedEngines.push_back("simbody");
+#ifdef COLLISION_BENCHMARK_FCL
+  selectedEngines.push_back("fcl");
+#endif
 
   /*std::set<std::string> engines =
     collision_benchmark::GetSupportedPhysicsEngines();
@@ -137,6 +143,9 @@ TEST_F(StaticTest, SpherePrimMesh)
   selectedEngines.push_back("ode");
   selectedEngines.push_back("dart");
   // selectedEngines.push_back("simbody");
+#ifdef COLLISION_BENCHMARK_FCL
+  selectedEngines.push_back("fcl");
+#endif
 
   /*std::set<std::string> engines =
     collision_benchmark::GetSupportedPhysicsEngines();
@@ -219,6 +228,11 @@ INSTANTIATE_TEST_CASE_P(PhysicsEngines, StaticTestWithParam,
                         ::testing::Values("ode", "bullet", "dart"));
                         // PHYSICS_ENGINE_VALUES);
 
+#ifdef COLLISION_BENCHMARK_FCL
+// FCLPhysicsWorld, which is not loaded with Gazebo
+INSTANTIATE_TEST_CASE_P(FCL, StaticTestWithParam, ::testing::Values("fcl"));
+#endif
+
 int main(int argc, char**argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -9,6 +9,8 @@
 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <thread>
 #include <atomic>
@@ -20,6 +22,7 @@ using collision_benchmark::Quaternion;
 using collision_benchmark::PhysicsWorldBaseInterface;
 using collision_benchmark::MirrorWorld;
 using collision_benchmark::GzWorldManager;
+using collision_benchmark::SignedDistanceResult;
 
 std::atomic<bool> g_keypressed(false);
 
@@ -171,3 +174,82 @@ bool collision_benchmark::CollisionState(const std::string& modelName1,
   }
   return true;
 }
+
+// returns the pose of the model state \e state
+////////////////////////////////////////////////////////////////
+static Shape::Pose3 ToPose(const BasicState& state)
+{
+  Shape::Pose3 pose;
+  pose.Pos().Set(state.position.x, state.position.y, state.position.z);
+  pose.Rot().Set(state.rotation.w, state.rotation.x,
+                 state.rotation.y, state.rotation.z);
+  return pose;
+}
+
+////////////////////////////////////////////////////////////////
+bool collision_benchmark::CollisionState(const std::string& modelName1,
+                                       const std::string& modelName2,
+                                       const GzWorldManager::Ptr& worldManager,
+                                       const ConvexSupport::Ptr& shape1,
+                                       const ConvexSupport::Ptr& shape2,
+                                       std::vector<std::string>& colliding,
+                                       std::vector<std::string>& notColliding,
+                                       double& maxDepth,
+                                       std::map<std::string,
+                                                ContactError>& errors)
+{
+  errors.clear();
+  if (!CollisionState(modelName1, modelName2, worldManager,
+                      colliding, notColliding, maxDepth))
+    return false;
+  if (!shape1 || !shape2) return false;
+
+  std::vector<GzWorldManager::PhysicsWorldPtr>
+    worlds = worldManager->GetPhysicsWorlds();
+
+  std::vector<GzWorldManager::PhysicsWorldPtr>::iterator it;
+  for (it = worlds.begin(); it != worlds.end(); ++it)
+  {
+    GzWorldManager::PhysicsWorldPtr w = *it;
+    if (std::find(colliding.begin(), colliding.end(), w->GetName())
+        == colliding.end())
+      continue;
+
+    BasicState state1, state2;
+    if (!w->GetBasicModelState(modelName1, state1) ||
+        !w->GetBasicModelState(modelName2, state2))
+    {
+      std::cerr << "Could not get the model poses in world "
+                << w->GetName() << std::endl;
+      return false;
+    }
+    shape1->SetPose(ToPose(state1));
+    shape2->SetPose(ToPose(state2));
+    SignedDistanceResult ref;
+    ConvexSignedDistance(*shape1, *shape2, ref);
+
+    ContactError err;
+    err.refDistance = ref.distance;
+    double worldMaxDepth = 0;
+    std::vector<GzContactInfoPtr> contacts =
+      w->GetContactInfo(modelName1, modelName2);
+    for (std::vector<GzContactInfoPtr>::const_iterator
+         cit = contacts.begin(); cit != contacts.end(); ++cit)
+    {
+      const std::vector<GzContactInfo::Contact>& points = (*cit)->contacts;
+      for (std::vector<GzContactInfo::Contact>::const_iterator
+           pit = points.begin(); pit != points.end(); ++pit)
+      {
+        worldMaxDepth = std::max(worldMaxDepth, pit->depth);
+        double len = pit->normal.Length();
+        if (len <= 0) continue;
+        double cosAngle = std::min(1.0, fabs(pit->normal.Dot(ref.normal)) /
+                                        len);
+        err.normalError = std::max(err.normalError, acos(cosAngle));
+      }
+    }
+    err.depthError = fabs(worldMaxDepth - std::max(-ref.distance, 0.0));
+    errors[w->GetName()] = err;
+  }
+  return true;
+}
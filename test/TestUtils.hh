@@ -21,7 +21,9 @@
 // support only for gazebo types at the moment.
 // Make the helpers header-only to support all types.
 #include <collision_benchmark/GazeboPhysicsWorld.hh>
+#include <collision_benchmark/ConvexSupport.hh>
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -71,6 +73,42 @@ namespace collision_benchmark
                       std::vector<std::string>& notColliding,
                       double& maxDepth);
 
+  // Error of the contacts between two models in one world, relative to
+  // the exact penetration computed with collision_benchmark::GjkEpa()
+  struct ContactError
+  {
+    ContactError(): refDistance(0), depthError(0), normalError(0) {}
+    // reference signed distance between the models, which is the
+    // negative penetration depth if they intersect
+    double refDistance;
+    // absolute difference between the largest contact depth in the world
+    // and the reference penetration depth
+    double depthError;
+    // largest angle (in radians) between a contact normal in the world and
+    // the reference normal. The sign of the normals is not considered,
+    // because the engines use different conventions.
+    double normalError;
+  };
+
+  // Like CollisionState() above, and additionally compares the contacts
+  // of all worlds which determine collision to the exact reference
+  // computed with collision_benchmark::ConvexSignedDistance() for the
+  // convex shapes \e shape1 and \e shape2, which are placed at the poses
+  // of the models in the respective world.
+  // \param[out] errors the contact errors of all worlds in \e colliding,
+  //    by world name.
+  // \return false if there was an inconsistency or error in querying
+  //    the collision states or model poses in any world
+  bool CollisionState(const std::string& modelName1,
+                      const std::string& modelName2,
+                      const GzWorldManager::Ptr& worldManager,
+                      const ConvexSupport::Ptr& shape1,
+                      const ConvexSupport::Ptr& shape2,
+                      std::vector<std::string>& colliding,
+                      std::vector<std::string>& notColliding,
+                      double& maxDepth,
+                      std::map<std::string, ContactError>& errors);
+
   // checks that AABB of model 1 is the same in all worlds in
   // \e worldManager and returns the AABBs of the model if it is
   // the same in all worlds.
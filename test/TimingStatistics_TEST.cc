@@ -0,0 +1,49 @@
+#include <collision_benchmark/TimingStatistics.hh>
+
+#include <gtest/gtest.h>
+
+using collision_benchmark::TimingStatistics;
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(TimingStatisticsTest, Empty)
+{
+  TimingStatistics stats;
+  EXPECT_EQ(stats.GetCount(), 0);
+  EXPECT_EQ(stats.GetMin(), 0);
+  EXPECT_EQ(stats.GetMax(), 0);
+  EXPECT_EQ(stats.GetMean(), 0);
+  EXPECT_EQ(stats.GetStdDev(), 0);
+  EXPECT_EQ(stats.GetPercentile(50), 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST(TimingStatisticsTest, Percentiles)
+{
+  TimingStatistics stats;
+  // add 1..100 in an order which is not sorted
+  for (int i = 0; i < 100; ++i)
+    stats.Add((i * 37) % 100 + 1);
+  EXPECT_EQ(stats.GetCount(), 100);
+  EXPECT_DOUBLE_EQ(stats.GetMin(), 1);
+  EXPECT_DOUBLE_EQ(stats.GetMax(), 100);
+  EXPECT_DOUBLE_EQ(stats.GetMean(), 50.5);
+  EXPECT_NEAR(stats.GetStdDev(), 29.0115, 1e-04);
+  EXPECT_DOUBLE_EQ(stats.GetPercentile(0), 1);
+  EXPECT_DOUBLE_EQ(stats.GetPercentile(50), 50.5);
+  EXPECT_DOUBLE_EQ(stats.GetPercentile(90), 90.1);
+  EXPECT_DOUBLE_EQ(stats.GetPercentile(100), 100);
+
+  // adding after a query keeps the statistics correct
+  stats.Add(0);
+  EXPECT_DOUBLE_EQ(stats.GetMin(), 0);
+  EXPECT_DOUBLE_EQ(stats.GetPercentile(50), 50);
+
+  stats.Clear();
+  EXPECT_EQ(stats.GetCount(), 0);
+}
+
+int main(int argc, char**argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -406,8 +406,214 @@ TEST_F(WorldInterfaceTest, GazeboContacts)
       break;
     }
   }
+
+  // all contacts which were returned have been looked at for anomalies
+  GzPhysicsWorld::ContactAnomalies anomalies = world->GetContactAnomalies();
+  ASSERT_GE(anomalies.numContacts, 1);
+  ASSERT_GE(anomalies.numPoints, anomalies.numContacts -
+    anomalies.GetCount(GzPhysicsWorld::ContactAnomalies::EMPTY_CONTACT));
+  world->ResetContactAnomalies();
+  ASSERT_EQ(world->GetContactAnomalies().numContacts, 0);
+}
+
+/**
+ * Tests the cache of physics settings
+ */
+TEST_F(WorldInterfaceTest, PhysicsSettings)
+{
+  std::map<std::string,std::string> physicsEngines
+    = collision_benchmark::getPhysicsSettingsSdfForAllEngines();
+  for (std::map<std::string,std::string>::iterator it = physicsEngines.begin();
+       it!=physicsEngines.end(); ++it)
+  {
+    std::string engine = it->first;
+    sdf::ElementPtr physics = collision_benchmark::GetPhysicsSettings(engine);
+    ASSERT_NE(physics.get(), nullptr)
+      << "Could not get phyiscs settings for " << engine;
+    // the file is only read once
+    ASSERT_EQ(collision_benchmark::GetPhysicsSettings(engine, it->second),
+              physics) << "Physics settings were not cached";
+
+    sdf::ElementPtr variant = physics->Clone();
+    variant->GetElement("max_step_size")->Set(0.0005);
+    collision_benchmark::RegisterPhysicsSettings(engine, "small_steps",
+                                                 variant);
+    ASSERT_EQ(collision_benchmark::GetPhysicsSettings(engine, "small_steps"),
+              variant) << "Registered settings not found";
+  }
 }
 
+/**
+ * Tests adding several models at once
+ */
+TEST_F(WorldInterfaceTest, GazeboBulkModelLoading)
+{
+  std::string worldfile = "worlds/empty.world";
+  GzPhysicsWorld::Ptr world (new GazeboPhysicsWorld(false));
+  ASSERT_EQ(world->LoadFromFile(worldfile),collision_benchmark::SUCCESS)
+    << " Could not load world";
+
+  const int numModels = 50;
+  std::vector<GzPhysicsWorld::ShapeModel> models(numModels);
+  for (int i = 0; i < numModels; ++i)
+  {
+    std::stringstream name;
+    name << "bulk_box_" << i;
+    models[i].modelname = name.str();
+    models[i].shape.reset(PrimitiveShape::CreateBox(0.5, 0.5, 0.5));
+    models[i].shape->SetPose(Shape::Pose3(i, 0, 1, 0, 0, 0));
+  }
+  // a model without name can't be added and must not prevent the others
+  models[numModels / 2].modelname = "";
+
+  std::vector<GzPhysicsWorld::ModelLoadResult> res =
+    world->AddModelsFromShape(models);
+  ASSERT_EQ(res.size(), numModels) << "Need one result for each model";
+  for (int i = 0; i < numModels; ++i)
+  {
+    if (i == numModels / 2)
+    {
+      EXPECT_EQ(res[i].opResult, collision_benchmark::FAILED)
+        << "Model without name should not be added";
+      continue;
+    }
+    EXPECT_EQ(res[i].opResult, collision_benchmark::SUCCESS)
+      << "Could not add model " << models[i].modelname;
+    EXPECT_EQ(res[i].modelID, models[i].modelname)
+      << "Model was given the wrong name";
+    // all boxes are the same, so they share the SDF template of which
+    // only the name and the pose are changed
+    collision_benchmark::BasicState state;
+    ASSERT_TRUE(world->GetBasicModelState(res[i].modelID, state))
+      << "Could not get state of " << res[i].modelID;
+    EXPECT_NEAR(state.position.x, i, 1e-06)
+      << "Model " << res[i].modelID << " has the wrong pose";
+  }
+
+  int numOther = 0;
+  std::vector<GzPhysicsWorld::ModelID> ids = world->GetAllModelIDs();
+  for (std::vector<GzPhysicsWorld::ModelID>::const_iterator
+       it = ids.begin(); it != ids.end(); ++it)
+  {
+    if (it->find("bulk_box_") != 0) ++numOther;
+  }
+  ASSERT_EQ(ids.size() - numOther, numModels - 1)
+    << "Not all models were added to the world";
+}
+/**
+ * Tests re-using models after Clear() if recycling is enabled
+ */
+TEST_F(WorldInterfaceTest, GazeboModelRecycling)
+{
+  std::string worldfile = "worlds/empty.world";
+  collision_benchmark::GazeboPhysicsWorldPtr
+    world(new GazeboPhysicsWorld(false));
+  ASSERT_EQ(world->LoadFromFile(worldfile),collision_benchmark::SUCCESS)
+    << " Could not load world";
+  world->SetRecycleModels(true);
+  world->Clear();
+  ASSERT_TRUE(world->GetAllModelIDs().empty()) << "World should be empty";
+
+  const std::string modelName = "recycled_box";
+  Shape::Ptr box(PrimitiveShape::CreateBox(1, 1, 1));
+  ASSERT_EQ(world->AddModelFromShape(modelName, box, box).opResult,
+            collision_benchmark::SUCCESS) << "Could not add box";
+  int id = world->GetIntegerModelID(modelName);
+  ASSERT_GE(id, 0) << "Box has no ID";
+
+  world->Clear();
+  ASSERT_TRUE(world->GetAllModelIDs().empty())
+    << "Recycled model should not be reported";
+  ASSERT_LT(world->GetIntegerModelID(modelName), 0)
+    << "Recycled model should not be found";
+
+  // the same box is re-used
+  box->SetPose(Shape::Pose3(3, 0, 0, 0, 0, 0));
+  ASSERT_EQ(world->AddModelFromShape(modelName, box, box).opResult,
+            collision_benchmark::SUCCESS) << "Could not add box again";
+  ASSERT_EQ(world->GetIntegerModelID(modelName), id)
+    << "Model should have been re-used";
+  collision_benchmark::BasicState state;
+  ASSERT_TRUE(world->GetBasicModelState(modelName, state));
+  EXPECT_NEAR(state.position.x, 3, 1e-06) << "Pose was not set";
+
+  // a different shape with the same name needs a new model
+  ASSERT_TRUE(world->RemoveModel(modelName));
+  Shape::Ptr sphere(PrimitiveShape::CreateSphere(1));
+  ASSERT_EQ(world->AddModelFromShape(modelName, sphere, sphere).opResult,
+            collision_benchmark::SUCCESS) << "Could not add sphere";
+  ASSERT_NE(world->GetIntegerModelID(modelName), id)
+    << "Model of the box should not have been re-used";
+  ASSERT_EQ(world->GetAllModelIDs().size(), 1)
+    << "Only the sphere should be in the world";
+}
+
+/**
+ * Tests that recycled models are not part of the world states
+ */
+TEST_F(WorldInterfaceTest, GazeboRecycledWorldState)
+{
+  std::string worldfile = "worlds/empty.world";
+  collision_benchmark::GazeboPhysicsWorldPtr
+    recycling(new GazeboPhysicsWorld(false));
+  collision_benchmark::GazeboPhysicsWorldPtr
+    fresh(new GazeboPhysicsWorld(false));
+  ASSERT_EQ(recycling->LoadFromFile(worldfile),collision_benchmark::SUCCESS)
+    << " Could not load world";
+  ASSERT_EQ(fresh->LoadFromFile(worldfile),collision_benchmark::SUCCESS)
+    << " Could not load world";
+  recycling->SetRecycleModels(true);
+  recycling->Clear();
+  fresh->Clear();
+
+  Shape::Ptr box(PrimitiveShape::CreateBox(1, 1, 1));
+  Shape::Ptr sphere(PrimitiveShape::CreateSphere(1));
+  sphere->SetPose(Shape::Pose3(0, 0, 2, 0, 0, 0));
+  ASSERT_EQ(recycling->AddModelFromShape("box", box, box).opResult,
+            collision_benchmark::SUCCESS) << "Could not add box";
+  int boxID = recycling->GetIntegerModelID("box");
+  recycling->Clear();
+  ASSERT_EQ(recycling->AddModelFromShape("sphere", sphere, sphere).opResult,
+            collision_benchmark::SUCCESS) << "Could not add sphere";
+  ASSERT_EQ(fresh->AddModelFromShape("sphere", sphere, sphere).opResult,
+            collision_benchmark::SUCCESS) << "Could not add sphere";
+
+  // the states contain the same models
+  GzWorldState recyclingState = recycling->GetWorldState();
+  GzWorldState freshState = fresh->GetWorldState();
+  ASSERT_EQ(recyclingState.GetModelStates().size(),
+            freshState.GetModelStates().size());
+  EXPECT_TRUE(recyclingState.HasModelState("sphere"));
+  EXPECT_FALSE(recyclingState.HasModelState("box"))
+    << "Recycled model should not be in the state";
+  GzWorldState diff = recycling->GetWorldStateDiff(freshState);
+  EXPECT_TRUE(diff.Insertions().empty());
+  EXPECT_TRUE(diff.Deletions().empty())
+    << "Recycled model should not be deleted in the diff";
+
+  // the recycled model is kept when a state is set...
+  ASSERT_EQ(recycling->SetWorldState(freshState, false),
+            collision_benchmark::SUCCESS);
+  ASSERT_EQ(recycling->GetAllModelIDs().size(), 1);
+  ASSERT_EQ(fresh->SetWorldState(recyclingState, false),
+            collision_benchmark::SUCCESS);
+  ASSERT_EQ(fresh->GetAllModelIDs().size(), 1)
+    << "Recycled model should not have been transferred";
+  ASSERT_EQ(recycling->AddModelFromShape("box", box, box).opResult,
+            collision_benchmark::SUCCESS) << "Could not add box";
+  EXPECT_EQ(recycling->GetIntegerModelID("box"), boxID)
+    << "Recycled model should have been kept";
+
+  // ... unless the state has a model with the same name
+  recycling->Clear();
+  ASSERT_EQ(fresh->AddModelFromShape("box", box, box).opResult,
+            collision_benchmark::SUCCESS) << "Could not add box";
+  ASSERT_EQ(recycling->SetWorldState(fresh->GetWorldState(), false),
+            collision_benchmark::SUCCESS);
+  ASSERT_EQ(recycling->GetAllModelIDs().size(), 2);
+  EXPECT_GE(recycling->GetIntegerModelID("box"), 0)
+    << "Box should have been inserted from the state";
+}
 
 int main(int argc, char**argv)
 {
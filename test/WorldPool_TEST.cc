@@ -0,0 +1,70 @@
+#include <collision_benchmark/WorldManager.hh>
+#include <collision_benchmark/PrimitiveShape.hh>
+
+#include <gazebo/gazebo.hh>
+
+#include "StaticTestFramework.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using collision_benchmark::Shape;
+using collision_benchmark::PrimitiveShape;
+
+// The tests of this file run back to back with a shared server and
+// world pool, as all tests do when COLLISION_BENCHMARK_WORLD_POOL is set.
+class WorldPoolTest:
+  public StaticTestFramework {};
+
+// names of the worlds leased in the first test
+std::vector<std::string> firstWorlds;
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_F(WorldPoolTest, FirstFixture)
+{
+  InitOneEngine("ode", 2);
+  GzWorldManager::Ptr worldManager = GetServer()->GetWorldManager();
+  std::vector<GzWorldManager::PhysicsWorldPtr> worlds =
+    worldManager->GetPhysicsWorlds();
+  ASSERT_EQ(worlds.size(), 2u);
+  for (std::vector<GzWorldManager::PhysicsWorldPtr>::const_iterator
+       it = worlds.begin(); it != worlds.end(); ++it)
+    firstWorlds.push_back((*it)->GetName());
+
+  Shape::Ptr sphere(PrimitiveShape::CreateSphere(1));
+  LoadShape(sphere, "sphere");
+
+  // a removed world can be added again
+  ASSERT_TRUE(worldManager->RemovePhysicsWorld(firstWorlds[0]));
+  EXPECT_FALSE(worldManager->RemovePhysicsWorld(firstWorlds[0]));
+  ASSERT_EQ(worldManager->GetNumWorlds(), 1u);
+  ASSERT_GE(worldManager->AddPhysicsWorld(worlds[0]), 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+TEST_F(WorldPoolTest, SecondFixture)
+{
+  ASSERT_EQ(firstWorlds.size(), 2u) << "The first test did not run";
+  InitOneEngine("ode", 2);
+  std::vector<GzWorldManager::PhysicsWorldPtr> worlds =
+    GetServer()->GetWorldManager()->GetPhysicsWorlds();
+  ASSERT_EQ(worlds.size(), 2u);
+  for (std::vector<GzWorldManager::PhysicsWorldPtr>::const_iterator
+       it = worlds.begin(); it != worlds.end(); ++it)
+  {
+    EXPECT_NE(std::find(firstWorlds.begin(), firstWorlds.end(),
+                        (*it)->GetName()), firstWorlds.end())
+      << "World " << (*it)->GetName() << " was not re-used";
+    EXPECT_TRUE((*it)->GetAllModelIDs().empty())
+      << "Models of the first test were not removed";
+  }
+}
+
+int main(int argc, char**argv)
+{
+  setenv("COLLISION_BENCHMARK_WORLD_POOL", "1", 1);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}